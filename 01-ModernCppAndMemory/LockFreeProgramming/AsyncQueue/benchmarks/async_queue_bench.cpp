@@ -0,0 +1,179 @@
+#include "../include/async_queue.h"
+#include "ring_buffer.h"
+#include "mpmc_queue.h"
+#include "queue_benchmarks.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using Requests = RingBuffer<uint64_t, 1024>;
+using Replies = MPMCQueue<uint64_t, 1024>;
+
+// Consumers go idle this way in both designs: spin, then yield, then park
+constexpr uint32_t SPIN_ROUNDS = 64;
+constexpr uint32_t YIELD_ROUNDS = 128;
+
+// Sends one request and waits for its echo; returns the round trip in ns
+template <typename Send>
+static uint64_t round_trip(Send&& send, Replies& replies, uint64_t seq) {
+    unsigned spins = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (!send(seq)) {
+        queue_bench::relax(spins);
+    }
+    uint64_t reply = 0;
+    while (!replies.try_dequeue(reply)) {
+        queue_bench::relax(spins);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+}
+
+// Producer and consumer on one thread: push, then let the executor resume the
+// consumer. Measures the wake-up, the resumption and the pop, with no thread switch.
+static void BM_SameThreadHandoff(benchmark::State& state) {
+    SingleThreadExecutor executor;
+    auto queue = std::make_unique<AsyncQueue<Requests>>(executor);
+    uint64_t sum = 0;
+    auto consume = [&]() -> Job {
+        while (auto item = co_await queue->pop()) {
+            sum += *item;
+        }
+    };
+    executor.spawn(consume());
+    executor.run_ready();
+
+    uint64_t seq = 0;
+    for (auto _ : state) {
+        queue->try_push(++seq);
+        executor.run_ready();
+    }
+    benchmark::DoNotOptimize(sum);
+
+    queue->close();
+    executor.run_ready();
+    state.SetItemsProcessed(state.iterations());
+}
+
+// state.range(0) echo coroutines on one executor thread, each behind its own
+// AsyncQueue. Requests go to them in turn.
+static void BM_CoroutineRoundTrip(benchmark::State& state) {
+    const size_t consumers = static_cast<size_t>(state.range(0));
+    SingleThreadExecutor executor;
+    auto replies = std::make_unique<Replies>();
+    std::vector<std::unique_ptr<AsyncQueue<Requests>>> queues;
+    for (size_t i = 0; i < consumers; ++i) {
+        queues.push_back(std::make_unique<AsyncQueue<Requests>>(executor));
+    }
+
+    auto echo = [&](AsyncQueue<Requests>& queue) -> Job {
+        while (auto item = co_await queue.pop()) {
+            while (!replies->try_enqueue(*item)) {
+                cpu_pause();
+            }
+        }
+    };
+    for (auto& queue : queues) {
+        executor.spawn(echo(*queue));
+    }
+    std::thread runner([&]() {
+        queue_bench::pin_current_thread(1);
+        executor.run();
+    });
+
+    std::vector<uint64_t> samples_ns;
+    samples_ns.reserve(1 << 20);
+    uint64_t seq = 0;
+    for (auto _ : state) {
+        auto& queue = *queues[seq % consumers];
+        samples_ns.push_back(round_trip([&](uint64_t value) { return queue.try_push(value); }, *replies, ++seq));
+    }
+
+    for (auto& queue : queues) {
+        queue->close();
+    }
+    executor.stop();
+    runner.join();
+    // The echo coroutines may still be suspended past stop(); give them their last pass
+    executor.run_ready();
+
+    queue_bench::report_percentiles(state, samples_ns);
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(std::to_string(consumers) + " coroutines, 1 thread");
+}
+
+// The same echo service with one blocking thread per consumer
+static void BM_ThreadPerConsumerRoundTrip(benchmark::State& state) {
+    const size_t consumers = static_cast<size_t>(state.range(0));
+    struct Consumer {
+        Requests requests;
+        ThreadParker parker;
+        std::thread thread;
+    };
+    auto replies = std::make_unique<Replies>();
+    std::vector<std::unique_ptr<Consumer>> threads;
+    std::atomic<bool> stop{false};
+
+    for (size_t i = 0; i < consumers; ++i) {
+        threads.push_back(std::make_unique<Consumer>());
+        Consumer* consumer = threads.back().get();
+        consumer->thread = std::thread([&, consumer, i]() {
+            queue_bench::pin_current_thread(static_cast<unsigned>(i + 1));
+            uint64_t item = 0;
+            uint32_t idle = 0;
+            while (!stop.load(std::memory_order_acquire)) {
+                if (consumer->requests.try_dequeue(item)) {
+                    while (!replies->try_enqueue(item)) {
+                        cpu_pause();
+                    }
+                    idle = 0;
+                } else if (++idle < SPIN_ROUNDS) {
+                    cpu_pause();
+                } else if (idle < YIELD_ROUNDS) {
+                    std::this_thread::yield();
+                } else {
+                    consumer->parker.park([&]() {
+                        return !consumer->requests.empty() || stop.load(std::memory_order_acquire);
+                    });
+                    idle = 0;
+                }
+            }
+        });
+    }
+
+    std::vector<uint64_t> samples_ns;
+    samples_ns.reserve(1 << 20);
+    uint64_t seq = 0;
+    for (auto _ : state) {
+        Consumer& consumer = *threads[seq % consumers];
+        auto send = [&](uint64_t value) {
+            if (!consumer.requests.try_enqueue(value)) {
+                return false;
+            }
+            consumer.parker.notify();
+            return true;
+        };
+        samples_ns.push_back(round_trip(send, *replies, ++seq));
+    }
+
+    stop.store(true, std::memory_order_release);
+    for (auto& consumer : threads) {
+        consumer->parker.notify();
+        consumer->thread.join();
+    }
+
+    queue_bench::report_percentiles(state, samples_ns);
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(std::to_string(consumers) + " threads");
+}
+
+BENCHMARK(BM_SameThreadHandoff);
+BENCHMARK(BM_CoroutineRoundTrip)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+BENCHMARK(BM_ThreadPerConsumerRoundTrip)->Arg(1)->Arg(4)->Arg(16)->UseRealTime();
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
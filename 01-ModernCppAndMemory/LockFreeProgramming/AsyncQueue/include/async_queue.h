@@ -0,0 +1,249 @@
+/**
+ * @file async_queue.h
+ * @brief A queue whose consumer is a coroutine that suspends while the queue is empty
+ *
+ * AsyncQueue wraps any ConcurrentQueue, typically RingBuffer. Producers push
+ * from plain threads as before. The consumer is a coroutine running on an
+ * executor, and `co_await queue.pop()` suspends it instead of polling. The
+ * producer that publishes the next item hands the coroutine back to the
+ * executor, which resumes it on the executor's thread.
+ *
+ * The hand-off takes no lock. A suspending consumer publishes its handle in
+ * waiter_ and then looks at the queue again; a producer publishes its item
+ * and then looks at waiter_. A full fence on each side means at least one of
+ * them sees the other, and an exchange on waiter_ makes sure exactly one
+ * party resumes the consumer.
+ *
+ * A producer's wake-up can arrive late: the consumer may already have taken
+ * that producer's item without suspending and be waiting for the next one.
+ * So a producer does not schedule the consumer itself but a small resumer
+ * coroutine, which looks at the queue on the executor's thread and either
+ * resumes the consumer or parks it again.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "concurrent_queue.h"
+#include "single_thread_executor.h"
+
+/**
+ * @brief Awaitable single-consumer wrapper around a lock-free queue
+ *
+ * One coroutine at a time may await pop(), and it must run on the executor
+ * given to the constructor. Producers follow the wrapped queue's rules:
+ * RingBuffer takes one producer, MPMCQueue any number.
+ *
+ * @tparam Queue The underlying queue (RingBuffer, MPMCQueue, ...)
+ * @tparam Executor Where the consumer is resumed (SingleThreadExecutor)
+ */
+template <ConcurrentQueue Queue, typename Executor = SingleThreadExecutor>
+class AsyncQueue {
+public:
+    using value_type = typename Queue::value_type;
+
+    static_assert(std::is_default_constructible_v<value_type>, "value_type must be default constructible");
+
+    class PopAwaiter;
+
+    explicit AsyncQueue(Executor& executor) : executor_(executor), resumer_(run_resumer().release()) {
+        waiter_.data.store(nullptr, std::memory_order_relaxed);
+    }
+
+    AsyncQueue(const AsyncQueue&) = delete;
+    AsyncQueue& operator=(const AsyncQueue&) = delete;
+
+    // The resumer is only ever suspended here; see the executor's shutdown order
+    ~AsyncQueue() {
+        resumer_.destroy();
+    }
+
+    /**
+     * @brief Pushes an item and resumes the consumer if it is suspended
+     *
+     * While the consumer is running, this costs the wrapped queue's enqueue
+     * plus one fence and one load.
+     *
+     * @return false if the queue is full
+     */
+    template <typename U>
+    bool try_push(U&& value) {
+        if (!queue_.try_enqueue(std::forward<U>(value))) {
+            return false;
+        }
+        wake();
+        return true;
+    }
+
+    /**
+     * @brief Takes an item without suspending
+     *
+     * @return false if the queue is empty
+     */
+    bool try_pop(value_type& result) noexcept {
+        return queue_.try_dequeue(result);
+    }
+
+    /**
+     * @brief Waits for the next item
+     *
+     * `co_await queue.pop()` returns at once if an item is ready, and
+     * otherwise suspends until one is pushed. It yields std::nullopt once the
+     * queue is closed and every item pushed before close() has been popped.
+     */
+    PopAwaiter pop() noexcept {
+        return PopAwaiter(*this);
+    }
+
+    /**
+     * @brief Ends the stream; the consumer drains what is left, then pop() yields std::nullopt
+     *
+     * Producers must have stopped pushing: an item pushed after close() may
+     * never be popped.
+     */
+    void close() {
+        closed_.store(true, std::memory_order_release);
+        wake();
+    }
+
+    bool closed() const noexcept {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const noexcept {
+        return queue_.empty();
+    }
+
+    constexpr size_t capacity() const noexcept {
+        return queue_.capacity();
+    }
+
+    class PopAwaiter {
+    public:
+        explicit PopAwaiter(AsyncQueue& queue) noexcept : queue_(queue) {}
+
+        bool await_ready() noexcept {
+            return take();
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) noexcept {
+            assert(queue_.executor_.on_executor_thread() && "pop() must be awaited on the queue's executor");
+            assert(queue_.waiter_.data.load(std::memory_order_relaxed) == nullptr && "only one consumer may wait");
+
+            handle_ = handle;
+            queue_.awaiter_ = this;
+            return park();
+        }
+
+        // Only resumed once take() has succeeded: an item, or the end of the stream
+        std::optional<value_type> await_resume() noexcept {
+            return std::move(result_);
+        }
+
+    private:
+        friend class AsyncQueue;
+
+        /**
+         * @brief Publishes the consumer's handle and looks at the queue again
+         *
+         * Nothing else resumes the consumer while it runs on the executor's
+         * thread, so result_ is safe to write after publishing the handle.
+         *
+         * @return false if the consumer should go on at once
+         */
+        bool park() noexcept {
+            queue_.waiter_.data.store(handle_.address(), std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!take()) {
+                return true;
+            }
+
+            // An item arrived meanwhile. Take the handle back, unless a producer
+            // already has; it has then scheduled the resumer, so stay suspended
+            void* expected = handle_.address();
+            return !queue_.waiter_.data.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel,
+                                                                std::memory_order_relaxed);
+        }
+
+        // Whether the consumer has something to return, taking an item if need be
+        bool ready() noexcept {
+            return result_.has_value() || take();
+        }
+
+        // Fills result_ and returns true if there is an item, or the queue is closed and drained
+        bool take() noexcept {
+            value_type value;
+            if (queue_.try_pop(value)) {
+                result_.emplace(std::move(value));
+                return true;
+            }
+            if (!queue_.closed()) {
+                return false;
+            }
+            // Items pushed just before close() may have landed after the first look
+            if (queue_.try_pop(value)) {
+                result_.emplace(std::move(value));
+            }
+            return true;
+        }
+
+        AsyncQueue& queue_;
+        std::coroutine_handle<> handle_;
+        std::optional<value_type> result_;
+    };
+
+private:
+    // Each time the resumer runs, it hands over to the consumer or parks it again
+    struct Resume {
+        AsyncQueue& queue;
+
+        bool await_ready() const noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<>) noexcept {
+            PopAwaiter& awaiter = *queue.awaiter_;
+            if (awaiter.ready() || !awaiter.park()) {
+                return awaiter.handle_;
+            }
+            // Woken for an item the consumer had already taken; it is parked again
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    Job run_resumer() {
+        for (;;) {
+            co_await Resume{*this};
+        }
+    }
+
+    // Schedules the resumer if the consumer is suspended; called after publishing an item or closing
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiter_.data.load(std::memory_order_relaxed) == nullptr) {
+            return;
+        }
+        if (waiter_.data.exchange(nullptr, std::memory_order_acq_rel) != nullptr) {
+            executor_.schedule(resumer_);
+        }
+    }
+
+    Queue queue_;
+
+    // The suspended consumer's handle, or null while it is running
+    CacheLineAligned<std::atomic<void*>> waiter_;
+    std::atomic<bool> closed_{false};
+
+    Executor& executor_;
+
+    // The consumer's pending pop(), and the coroutine that resumes it; executor thread only
+    PopAwaiter* awaiter_ = nullptr;
+    std::coroutine_handle<> resumer_;
+};
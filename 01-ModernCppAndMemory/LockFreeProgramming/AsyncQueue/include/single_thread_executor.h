@@ -0,0 +1,217 @@
+/**
+ * @file single_thread_executor.h
+ * @brief A minimal executor that resumes coroutines on one thread
+ *
+ * Coroutines are spawned as Job objects and run until they suspend. Whoever
+ * wakes one, from any thread, calls schedule() to hand it back; the executor
+ * resumes it on its own thread. Handles scheduled from other threads go
+ * through an MPMCQueue, so waking a coroutine takes no lock. An idle
+ * executor spins, then yields, then parks in a ThreadParker.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <thread>
+#include <utility>
+
+#include "concurrency_primitives.h"
+#include "mpmc_queue.h"
+
+/**
+ * @brief A fire-and-forget coroutine, started by SingleThreadExecutor::spawn()
+ *
+ * The coroutine does not run until it is spawned, and its frame is freed
+ * when it finishes. An exception escaping it terminates the process.
+ */
+class Job {
+public:
+    struct promise_type {
+        Job get_return_object() noexcept {
+            return Job(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+
+    Job(Job&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+    Job(const Job&) = delete;
+    Job& operator=(const Job&) = delete;
+    Job& operator=(Job&&) = delete;
+
+    // A job that was never spawned is destroyed without running
+    ~Job() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    /**
+     * @brief Gives up ownership of the suspended coroutine
+     */
+    std::coroutine_handle<> release() noexcept {
+        return std::exchange(handle_, nullptr);
+    }
+
+private:
+    explicit Job(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * @brief Resumes scheduled coroutines, in order, on the thread that drives it
+ *
+ * Drive it with run() on a dedicated thread, or call run_ready() from an
+ * event loop of your own. schedule() may be called from any thread.
+ *
+ * @tparam RemoteCapacity Handles that other threads can have scheduled at once
+ *         (power of two); schedule() spins while that many are waiting
+ */
+template <size_t RemoteCapacity = 4096>
+class BasicSingleThreadExecutor {
+public:
+    BasicSingleThreadExecutor() = default;
+    BasicSingleThreadExecutor(const BasicSingleThreadExecutor&) = delete;
+    BasicSingleThreadExecutor& operator=(const BasicSingleThreadExecutor&) = delete;
+
+    /**
+     * @brief Destroys coroutines that are still scheduled, without resuming them
+     *
+     * Coroutines suspended elsewhere, for example waiting on an open
+     * AsyncQueue, are not known to the executor; close their queues and let
+     * them finish first.
+     */
+    ~BasicSingleThreadExecutor() {
+        void* address = nullptr;
+        while (remote_.try_dequeue(address)) {
+            std::coroutine_handle<>::from_address(address).destroy();
+        }
+        for (std::coroutine_handle<> handle : local_) {
+            handle.destroy();
+        }
+    }
+
+    /**
+     * @brief Starts a job; it first runs on the executor's next pass
+     */
+    void spawn(Job job) {
+        schedule(job.release());
+    }
+
+    /**
+     * @brief Queues a suspended coroutine to be resumed on the executor's thread
+     *
+     * From the executor's own thread this appends to a local queue. From any
+     * other thread it is a lock-free enqueue plus a check for a parked
+     * executor.
+     */
+    void schedule(std::coroutine_handle<> handle) {
+        if (current_ == this) {
+            local_.push_back(handle);
+            return;
+        }
+        ExponentialBackoff<> backoff;
+        while (!remote_.try_enqueue(handle.address())) {
+            backoff.pause();
+        }
+        parker_.notify();
+    }
+
+    /**
+     * @brief `co_await executor.yield()` lets every other ready coroutine run first
+     *
+     * A coroutine waiting on something another coroutine on the same
+     * executor must do, such as room in a queue it drains, yields instead of
+     * spinning; spinning would never let the other one run.
+     */
+    auto yield() noexcept {
+        struct YieldAwaiter {
+            BasicSingleThreadExecutor& executor;
+
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { executor.schedule(handle); }
+            void await_resume() const noexcept {}
+        };
+        return YieldAwaiter{*this};
+    }
+
+    /**
+     * @brief Resumes every coroutine scheduled so far, on the calling thread
+     *
+     * Coroutines scheduled while these run wait for the next call.
+     *
+     * @return The number of coroutines resumed
+     */
+    size_t run_ready() {
+        BasicSingleThreadExecutor* previous = std::exchange(current_, this);
+        void* address = nullptr;
+        while (remote_.try_dequeue(address)) {
+            local_.push_back(std::coroutine_handle<>::from_address(address));
+        }
+        const size_t count = local_.size();
+        for (size_t i = 0; i < count; ++i) {
+            std::coroutine_handle<> handle = local_.front();
+            local_.pop_front();
+            handle.resume();
+        }
+        current_ = previous;
+        return count;
+    }
+
+    /**
+     * @brief Runs scheduled coroutines on the calling thread until stop()
+     */
+    void run() {
+        uint32_t idle = 0;
+        while (!stop_.load(std::memory_order_acquire)) {
+            if (run_ready() > 0) {
+                idle = 0;
+            } else if (++idle < SPIN_ROUNDS) {
+                cpu_pause();
+            } else if (idle < YIELD_ROUNDS) {
+                std::this_thread::yield();
+            } else {
+                parker_.park([this]() { return !remote_.empty() || stop_.load(std::memory_order_acquire); });
+                idle = 0;
+            }
+        }
+    }
+
+    /**
+     * @brief Makes run() return after its current pass; callable from any thread
+     */
+    void stop() noexcept {
+        stop_.store(true, std::memory_order_release);
+        parker_.notify();
+    }
+
+    /**
+     * @brief Whether the calling thread is inside this executor's run() or run_ready()
+     */
+    bool on_executor_thread() const noexcept {
+        return current_ == this;
+    }
+
+private:
+    // Idle passes spent spinning, then yielding, before run() parks
+    static constexpr uint32_t SPIN_ROUNDS = 64;
+    static constexpr uint32_t YIELD_ROUNDS = 128;
+
+    // Set while a thread is resuming this executor's coroutines
+    static inline thread_local BasicSingleThreadExecutor* current_ = nullptr;
+
+    MPMCQueue<void*, RemoteCapacity> remote_;
+    std::deque<std::coroutine_handle<>> local_;
+    ThreadParker parker_;
+    std::atomic<bool> stop_{false};
+};
+
+using SingleThreadExecutor = BasicSingleThreadExecutor<>;
@@ -0,0 +1,71 @@
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../include/async_queue.h"
+#include "ring_buffer.h"
+#include "mpmc_queue.h"
+
+struct Fill {
+    uint64_t order_id = 0;
+    int64_t price = 0;
+    uint32_t quantity = 0;
+};
+
+using FillQueue = AsyncQueue<RingBuffer<Fill, 1024>>;
+using ReportQueue = AsyncQueue<MPMCQueue<uint64_t, 1024>>;
+
+// Drop copy: forwards every fill, and tells the reporter how much notional went out
+Job drop_copy(FillQueue& fills, ReportQueue& reports, uint64_t& forwarded, SingleThreadExecutor& executor) {
+    while (auto fill = co_await fills.pop()) {
+        ++forwarded;
+        // The reporter drains this queue on the same thread, so let it run rather than spin
+        while (!reports.try_push(static_cast<uint64_t>(fill->price) * fill->quantity)) {
+            co_await executor.yield();
+        }
+    }
+    reports.close();
+}
+
+// Reporting: totals the notional the drop copy sends it
+Job reporter(ReportQueue& reports, uint64_t& total, SingleThreadExecutor& executor) {
+    while (auto notional = co_await reports.pop()) {
+        total += *notional;
+    }
+    executor.stop();
+}
+
+int main() {
+    std::cout << "Async Queue Demo\n";
+    std::cout << "================\n\n";
+
+    constexpr uint64_t FILLS = 100000;
+
+    SingleThreadExecutor executor;
+    FillQueue fills(executor);
+    ReportQueue reports(executor);
+
+    uint64_t forwarded = 0;
+    uint64_t total = 0;
+    executor.spawn(drop_copy(fills, reports, forwarded, executor));
+    executor.spawn(reporter(reports, total, executor));
+
+    // Both coroutines share this one thread
+    std::thread service([&]() { executor.run(); });
+
+    // The matching engine publishes fills from its own thread, as it would to a polling consumer
+    uint64_t expected = 0;
+    for (uint64_t i = 0; i < FILLS; ++i) {
+        Fill fill{i, 100 + static_cast<int64_t>(i % 7), static_cast<uint32_t>(1 + i % 10)};
+        expected += static_cast<uint64_t>(fill.price) * fill.quantity;
+        while (!fills.try_push(fill)) {
+            std::this_thread::yield();
+        }
+    }
+    fills.close();
+    service.join();
+
+    std::cout << "Fills forwarded: " << forwarded << " of " << FILLS << "\n";
+    std::cout << "Notional reported: " << total << " (expected " << expected << ")\n";
+    return forwarded == FILLS && total == expected ? 0 : 1;
+}
@@ -0,0 +1,295 @@
+#include "../include/async_queue.h"
+#include "ring_buffer.h"
+#include "mpmc_queue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using RingQueue = AsyncQueue<RingBuffer<uint64_t, 64>>;
+
+// A RingBuffer that runs a hook between publishing an item and the wrapper's wake-up
+struct HookedRing : RingBuffer<uint64_t, 64> {
+    static inline std::function<void()> after_enqueue;
+
+    template <typename U>
+    bool try_enqueue(U&& value) {
+        if (!RingBuffer<uint64_t, 64>::try_enqueue(std::forward<U>(value))) {
+            return false;
+        }
+        if (after_enqueue) {
+            after_enqueue();
+        }
+        return true;
+    }
+};
+
+// Pops until the stream ends, recording every item
+template <typename Async>
+Job collect(Async& queue, std::vector<uint64_t>& received, bool& finished) {
+    while (auto item = co_await queue.pop()) {
+        received.push_back(*item);
+    }
+    finished = true;
+}
+
+}  // namespace
+
+// Test that jobs start on the next pass, in the order they were spawned
+TEST(SingleThreadExecutorTest, RunsJobsInOrder) {
+    SingleThreadExecutor executor;
+    std::vector<int> order;
+    auto job = [&](int id) -> Job {
+        order.push_back(id);
+        co_return;
+    };
+    executor.spawn(job(1));
+    executor.spawn(job(2));
+    executor.spawn(job(3));
+    EXPECT_TRUE(order.empty());
+
+    EXPECT_EQ(executor.run_ready(), 3u);
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+    EXPECT_EQ(executor.run_ready(), 0u);
+}
+
+// Test that a job spawned from another thread wakes a parked run() and runs on its thread
+TEST(SingleThreadExecutorTest, RemoteSpawnWakesParkedExecutor) {
+    SingleThreadExecutor executor;
+    std::thread::id executor_id;
+    std::thread runner([&]() {
+        executor_id = std::this_thread::get_id();
+        executor.run();
+    });
+
+    // Long enough for run() to give up spinning and park
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    std::atomic<bool> ran{false};
+    std::thread::id ran_on;
+    auto job = [&]() -> Job {
+        ran_on = std::this_thread::get_id();
+        ran.store(true, std::memory_order_release);
+        co_return;
+    };
+    executor.spawn(job());
+    while (!ran.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    executor.stop();
+    runner.join();
+    EXPECT_EQ(ran_on, executor_id);
+}
+
+// Test that yield() puts a job behind the others that are ready
+TEST(SingleThreadExecutorTest, YieldLetsOthersRun) {
+    SingleThreadExecutor executor;
+    std::vector<int> order;
+    auto yielder = [&]() -> Job {
+        order.push_back(1);
+        co_await executor.yield();
+        order.push_back(3);
+    };
+    auto other = [&]() -> Job {
+        order.push_back(2);
+        co_return;
+    };
+    executor.spawn(yielder());
+    executor.spawn(other());
+
+    EXPECT_EQ(executor.run_ready(), 2u);
+    EXPECT_EQ(order, (std::vector<int>{1, 2}));
+    EXPECT_EQ(executor.run_ready(), 1u);
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+// Test that a job that is never spawned is destroyed without running
+TEST(SingleThreadExecutorTest, UnspawnedJobDoesNotRun) {
+    bool ran = false;
+    auto job = [&]() -> Job {
+        ran = true;
+        co_return;
+    };
+    { Job unused = job(); }
+    EXPECT_FALSE(ran);
+}
+
+// Test that items already queued are popped without suspending
+TEST(AsyncQueueTest, ReadyItemsDoNotSuspend) {
+    SingleThreadExecutor executor;
+    auto queue = std::make_unique<RingQueue>(executor);
+    for (uint64_t i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(queue->try_push(i));
+    }
+
+    std::vector<uint64_t> received;
+    bool finished = false;
+    executor.spawn(collect(*queue, received, finished));
+    EXPECT_EQ(executor.run_ready(), 1u);
+    EXPECT_EQ(received, (std::vector<uint64_t>{1, 2, 3}));
+    EXPECT_FALSE(finished);
+
+    queue->close();
+    executor.run_ready();
+    EXPECT_TRUE(finished);
+}
+
+// Test that an empty queue suspends the consumer and a push schedules it again
+TEST(AsyncQueueTest, PushResumesSuspendedConsumer) {
+    SingleThreadExecutor executor;
+    auto queue = std::make_unique<RingQueue>(executor);
+    std::vector<uint64_t> received;
+    bool finished = false;
+    executor.spawn(collect(*queue, received, finished));
+
+    EXPECT_EQ(executor.run_ready(), 1u);
+    EXPECT_TRUE(received.empty());
+    EXPECT_EQ(executor.run_ready(), 0u);  // Suspended, not scheduled
+
+    ASSERT_TRUE(queue->try_push(uint64_t{7}));
+    ASSERT_TRUE(queue->try_push(uint64_t{8}));  // Consumer already scheduled; no second wake-up
+    EXPECT_EQ(executor.run_ready(), 1u);
+    EXPECT_EQ(received, (std::vector<uint64_t>{7, 8}));
+
+    queue->close();
+    EXPECT_EQ(executor.run_ready(), 1u);
+    EXPECT_TRUE(finished);
+}
+
+// Test that a wake-up arriving after the consumer took the item itself does not end the stream
+TEST(AsyncQueueTest, LateWakeParksConsumerAgain) {
+    SingleThreadExecutor executor;
+    auto queue = std::make_unique<AsyncQueue<HookedRing>>(executor);
+    std::vector<uint64_t> received;
+    bool finished = false;
+    executor.spawn(collect(*queue, received, finished));
+
+    // The consumer first runs between the enqueue and the producer's wake-up: it
+    // takes the item without suspending, then suspends on the empty queue
+    HookedRing::after_enqueue = [&]() { executor.run_ready(); };
+    ASSERT_TRUE(queue->try_push(uint64_t{1}));
+    HookedRing::after_enqueue = nullptr;
+    EXPECT_EQ(received, (std::vector<uint64_t>{1}));
+
+    // The late wake-up finds nothing to pop; the consumer must wait, not see the end
+    EXPECT_EQ(executor.run_ready(), 1u);
+    EXPECT_FALSE(finished);
+    EXPECT_EQ(executor.run_ready(), 0u);
+
+    ASSERT_TRUE(queue->try_push(uint64_t{2}));
+    executor.run_ready();
+    EXPECT_EQ(received, (std::vector<uint64_t>{1, 2}));
+    EXPECT_FALSE(finished);
+
+    queue->close();
+    executor.run_ready();
+    EXPECT_TRUE(finished);
+}
+
+// Test that close() lets the consumer drain what was pushed before ending the stream
+TEST(AsyncQueueTest, CloseDrainsBeforeEnding) {
+    SingleThreadExecutor executor;
+    auto queue = std::make_unique<RingQueue>(executor);
+    ASSERT_TRUE(queue->try_push(uint64_t{1}));
+    ASSERT_TRUE(queue->try_push(uint64_t{2}));
+    queue->close();
+
+    std::vector<uint64_t> received;
+    bool finished = false;
+    executor.spawn(collect(*queue, received, finished));
+    executor.run_ready();
+    EXPECT_TRUE(finished);
+    EXPECT_EQ(received, (std::vector<uint64_t>{1, 2}));
+}
+
+// Test that try_pop takes items without a coroutine
+TEST(AsyncQueueTest, TryPop) {
+    SingleThreadExecutor executor;
+    auto queue = std::make_unique<RingQueue>(executor);
+    uint64_t value = 0;
+    EXPECT_FALSE(queue->try_pop(value));
+    ASSERT_TRUE(queue->try_push(uint64_t{42}));
+    EXPECT_FALSE(queue->empty());
+    EXPECT_TRUE(queue->try_pop(value));
+    EXPECT_EQ(value, 42u);
+    EXPECT_TRUE(queue->empty());
+    EXPECT_EQ(queue->capacity(), 64u);
+}
+
+// Producers on their own threads, the consumer coroutine on a running executor
+template <typename Queue>
+static void check_cross_thread_transfer(size_t producers, uint64_t per_producer) {
+    using Async = AsyncQueue<Queue>;
+    SingleThreadExecutor executor;
+    auto queue = std::make_unique<Async>(executor);
+
+    std::thread::id executor_id;
+    std::atomic<bool> executor_ready{false};
+    std::thread runner([&]() {
+        executor_id = std::this_thread::get_id();
+        executor_ready.store(true, std::memory_order_release);
+        executor.run();
+    });
+    while (!executor_ready.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    // Items are (producer << 32) | sequence, so order can be checked per producer
+    std::vector<uint64_t> next(producers, 0);
+    uint64_t received = 0;
+    bool in_order = true;
+    bool on_executor = true;
+    std::atomic<bool> finished{false};
+    auto consume = [&]() -> Job {
+        while (auto item = co_await queue->pop()) {
+            const size_t producer = static_cast<size_t>(*item >> 32);
+            in_order = in_order && producer < producers && (*item & 0xFFFFFFFF) == next[producer]++;
+            on_executor = on_executor && std::this_thread::get_id() == executor_id;
+            ++received;
+        }
+        finished.store(true, std::memory_order_release);
+        executor.stop();
+    };
+    executor.spawn(consume());
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            for (uint64_t i = 0; i < per_producer; ++i) {
+                while (!queue->try_push((uint64_t{p} << 32) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    queue->close();
+    runner.join();
+
+    EXPECT_TRUE(finished.load());
+    EXPECT_TRUE(in_order);
+    EXPECT_TRUE(on_executor);
+    EXPECT_EQ(received, producers * per_producer);
+}
+
+// Test that a producer thread hands every item to a coroutine on another thread
+TEST(AsyncQueueTest, CrossThreadRingBuffer) {
+    check_cross_thread_transfer<RingBuffer<uint64_t, 64>>(1, 200000);
+}
+
+// Test that several producers can wake the same consumer through an MPMCQueue
+TEST(AsyncQueueTest, CrossThreadMPMCQueue) {
+    check_cross_thread_transfer<MPMCQueue<uint64_t, 64>>(4, 50000);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,20 @@
+# Links the allocation guard (alloc_guard.h / alloc_guard.cpp) into a target.
+#
+#   include(../Common/cmake/AllocGuard.cmake)
+#   target_enable_alloc_guard(my_test)
+#
+# The target gets counting replacements for the global operator new/delete and
+# ALLOC_GUARD_ENABLED defined. With GNU-style linkers malloc/calloc/realloc/free
+# are wrapped as well, so direct malloc calls from the target's own objects count too.
+
+set(ALLOC_GUARD_DIR ${CMAKE_CURRENT_LIST_DIR}/..)
+
+function(target_enable_alloc_guard target)
+    target_sources(${target} PRIVATE ${ALLOC_GUARD_DIR}/src/alloc_guard.cpp)
+    target_include_directories(${target} PRIVATE ${ALLOC_GUARD_DIR}/include)
+    target_compile_definitions(${target} PRIVATE ALLOC_GUARD_ENABLED)
+    if(UNIX AND NOT APPLE AND CMAKE_CXX_COMPILER_ID MATCHES "GNU|Clang")
+        target_compile_definitions(${target} PRIVATE ALLOC_GUARD_WRAP_MALLOC)
+        target_link_options(${target} PRIVATE "LINKER:--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free")
+    endif()
+endfunction()
@@ -0,0 +1,66 @@
+/**
+ * @file alloc_guard.h
+ * @brief Detects heap allocations on hot paths in tests and benchmarks
+ *
+ * Linking alloc_guard.cpp into an executable replaces the global operator
+ * new/delete (and, with GNU-style linkers, wraps malloc/calloc/realloc/free
+ * via --wrap) with versions that count every allocation made by the calling
+ * thread. A NoAllocScope then reports how many allocations happened while it
+ * was alive, or aborts the process on the first one.
+ *
+ * Use target_enable_alloc_guard() from Common/cmake/AllocGuard.cmake to link
+ * it; the scope's members live in alloc_guard.cpp, so using a scope without
+ * the replacement linked in fails to link instead of silently counting zero.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+enum class AllocGuardMode {
+    Count,  // Count allocations; the caller checks allocations()
+    Abort   // Print a message and abort on the first allocation
+};
+
+/**
+ * @brief Allocation counters of one thread since it started
+ */
+struct AllocGuardCounts {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytes = 0;
+};
+
+/**
+ * @brief The calling thread's counters
+ */
+AllocGuardCounts this_thread_alloc_counts() noexcept;
+
+/**
+ * @brief Whether malloc and friends are wrapped too, not just operator new/delete
+ */
+bool alloc_guard_wraps_malloc() noexcept;
+
+/**
+ * @brief Watches the calling thread's allocations for the lifetime of the scope
+ *
+ * Scopes nest; an Abort scope stays in force inside any inner Count scope.
+ * Only the constructing thread is watched, so create one scope per thread.
+ */
+class NoAllocScope {
+public:
+    explicit NoAllocScope(AllocGuardMode mode = AllocGuardMode::Count) noexcept;
+    ~NoAllocScope();
+
+    NoAllocScope(const NoAllocScope&) = delete;
+    NoAllocScope& operator=(const NoAllocScope&) = delete;
+
+    // Allocations, deallocations and bytes allocated by this thread since the scope began
+    uint64_t allocations() const noexcept;
+    uint64_t deallocations() const noexcept;
+    uint64_t bytes() const noexcept;
+
+private:
+    AllocGuardCounts start_;
+    AllocGuardMode mode_;
+};
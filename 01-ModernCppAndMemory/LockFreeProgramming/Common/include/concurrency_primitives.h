@@ -0,0 +1,180 @@
+/**
+ * @file concurrency_primitives.h
+ * @brief Low-level building blocks shared by the lock-free queues
+ *
+ * Both RingBuffer and MPMCQueue used to carry their own copy of these
+ * definitions, which made it impossible to include the two headers in the
+ * same translation unit. Timestamps come from tsc_clock.h.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Lets empty policy members take no space; MSVC ignores the standard spelling
+#if defined(_MSC_VER)
+#define NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+#else
+#define NO_UNIQUE_ADDRESS [[no_unique_address]]
+#endif
+
+// Ensure cache line alignment to prevent false sharing
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Separation that also defeats the adjacent-line prefetcher, which pulls in
+// cache lines in 128-byte pairs on many Intel cores
+constexpr size_t DESTRUCTIVE_INTERFERENCE_SIZE = 2 * CACHE_LINE_SIZE;
+
+/**
+ * @brief Pads and aligns a value to Alignment bytes, so nothing else shares its span
+ *
+ * @tparam Alignment Padding width; CACHE_LINE_SIZE or DESTRUCTIVE_INTERFERENCE_SIZE
+ */
+template<typename T, size_t Alignment = CACHE_LINE_SIZE>
+struct alignas(Alignment) CacheAligned {
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+                  "Alignment must be a power of 2 no smaller than alignof(T)");
+
+    T data;
+    
+    CacheAligned() noexcept = default;
+    explicit CacheAligned(const T& value) : data(value) {}
+    explicit CacheAligned(T&& value) : data(std::move(value)) {}
+    
+    operator T&() noexcept { return data; }
+    operator const T&() const noexcept { return data; }
+    
+    T& operator=(const T& value) noexcept {
+        data = value;
+        return data;
+    }
+    
+    T& operator=(T&& value) noexcept {
+        data = std::move(value);
+        return data;
+    }
+};
+
+// Helper class for cache line padding
+template<typename T>
+using CacheLineAligned = CacheAligned<T, CACHE_LINE_SIZE>;
+
+// Tells the core it is in a spin-wait loop: saves power and frees the
+// pipeline for a sibling hyperthread
+inline void cpu_pause() noexcept {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(_M_ARM64)
+    __yield();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+/**
+ * @brief Exponential backoff for retry loops
+ *
+ * Each pause() spins twice as long as the last, up to MaxSpins pause
+ * instructions, then yields the CPU instead. Call reset() after success.
+ */
+template<uint32_t MaxSpins = 1024>
+class ExponentialBackoff {
+    static_assert(MaxSpins > 0, "MaxSpins must be positive");
+
+public:
+    void pause() noexcept {
+        if (spins_ > MaxSpins) {
+            std::this_thread::yield();
+            return;
+        }
+        for (uint32_t i = 0; i < spins_; ++i) {
+            cpu_pause();
+        }
+        spins_ *= 2;
+    }
+
+    void reset() noexcept {
+        spins_ = 1;
+    }
+
+    // True once spinning has reached the cap and pause() yields
+    bool yielding() const noexcept {
+        return spins_ > MaxSpins;
+    }
+
+private:
+    uint32_t spins_ = 1;
+};
+
+/**
+ * @brief Puts idle threads to sleep until another thread publishes work for them
+ *
+ * A thread that has found nothing to do calls park() with a check for work,
+ * and whoever publishes work calls notify() afterwards. The sleeper counts
+ * itself before re-checking, and the notifier publishes before checking for
+ * sleepers. With a full fence on each side, at least one of them sees the
+ * other, so no wake-up is lost. While nobody sleeps, notify() costs one
+ * fence and one load.
+ *
+ * Used by the task pools' workers and the coroutine executor; any number of
+ * threads may park on one parker.
+ */
+class ThreadParker {
+public:
+    ThreadParker() noexcept {
+        epoch_.data.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sleeps until notify() unless ready() already returns true
+     *
+     * ready() must also report a stop request, so a thread parked at
+     * shutdown returns once notify_all() is called after the request.
+     */
+    template <typename Ready>
+    void park(Ready&& ready) {
+        sleepers_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const uint32_t epoch = epoch_.data.load(std::memory_order_relaxed);
+        if (!ready()) {
+            epoch_.data.wait(epoch, std::memory_order_acquire);
+        }
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Wakes one sleeping thread, if any; call after publishing work
+     */
+    void notify() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0) {
+            epoch_.data.fetch_add(1, std::memory_order_release);
+            epoch_.data.notify_one();
+        }
+    }
+
+    /**
+     * @brief Wakes every sleeping thread, e.g. after a stop request
+     */
+    void notify_all() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0) {
+            epoch_.data.fetch_add(1, std::memory_order_release);
+            epoch_.data.notify_all();
+        }
+    }
+
+private:
+    CacheLineAligned<std::atomic<uint32_t>> epoch_;
+    std::atomic<uint32_t> sleepers_{0};
+};
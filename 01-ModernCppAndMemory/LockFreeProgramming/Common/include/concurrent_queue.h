@@ -0,0 +1,58 @@
+/**
+ * @file concurrent_queue.h
+ * @brief The interface every queue in this module is measured and tested against
+ *
+ * RingBuffer, MPMCQueue and the baseline queues all expose the same
+ * non-blocking try_enqueue/try_dequeue pair, so the benchmark matrix and the
+ * conformance tests can be written once as templates over ConcurrentQueue.
+ */
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+
+/**
+ * @brief A bounded, non-blocking queue usable from more than one thread
+ *
+ * try_enqueue returns false when the queue is full and try_dequeue returns
+ * false when it is empty (or, for some implementations, when another consumer
+ * won the race for the element), so callers are expected to retry.
+ */
+template <typename Q>
+concept ConcurrentQueue = requires(Q& queue, const Q& const_queue,
+                                   const typename Q::value_type& in, typename Q::value_type& out) {
+    typename Q::value_type;
+    { queue.try_enqueue(in) } -> std::same_as<bool>;
+    { queue.try_dequeue(out) } -> std::same_as<bool>;
+    { const_queue.empty() } -> std::convertible_to<bool>;
+    { const_queue.capacity() } -> std::convertible_to<size_t>;
+};
+
+/**
+ * @brief Whether several threads may call try_enqueue concurrently
+ *
+ * Queues opt out by declaring `static constexpr bool multi_producer = false`.
+ */
+template <ConcurrentQueue Q>
+constexpr bool queue_supports_multi_producer() {
+    if constexpr (requires { Q::multi_producer; }) {
+        return Q::multi_producer;
+    } else {
+        return true;
+    }
+}
+
+/**
+ * @brief Whether several threads may call try_dequeue concurrently
+ *
+ * Queues opt out by declaring `static constexpr bool multi_consumer = false`.
+ */
+template <ConcurrentQueue Q>
+constexpr bool queue_supports_multi_consumer() {
+    if constexpr (requires { Q::multi_consumer; }) {
+        return Q::multi_consumer;
+    } else {
+        return true;
+    }
+}
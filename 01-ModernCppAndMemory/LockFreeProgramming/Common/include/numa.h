@@ -0,0 +1,299 @@
+/**
+ * @file numa.h
+ * @brief NUMA placement helpers built on the raw mbind/get_mempolicy syscalls
+ *
+ * Memory lands on the node of whichever thread first touches it. A queue
+ * constructed by the main thread can therefore sit on a socket that neither
+ * its producer nor its consumer runs on, and every access crosses the
+ * interconnect. These helpers move or allocate memory on a chosen node
+ * without linking libnuma.
+ *
+ * Every helper degrades gracefully: on a machine (or kernel, or container)
+ * without NUMA support, binding reports failure and leaves memory where
+ * first touch put it, node queries answer node 0, and allocation still
+ * succeeds. Single-node machines exercise that path by asking for a node
+ * that does not exist.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#endif
+
+// No particular node: leave placement to first touch
+constexpr int NUMA_NO_NODE = -1;
+
+namespace numa_detail {
+
+#ifdef __linux__
+// From <numaif.h>, which ships with libnuma rather than the kernel headers
+constexpr int MPOL_PREFERRED = 1;
+constexpr unsigned MPOL_MF_MOVE = 1u << 1;
+constexpr unsigned long MPOL_F_NODE = 1ul << 0;
+constexpr unsigned long MPOL_F_ADDR = 1ul << 1;
+constexpr unsigned long MPOL_F_MEMS_ALLOWED = 1ul << 2;
+
+// Node masks are passed as arrays of unsigned long; 1024 nodes is the kernel's usual maximum
+constexpr size_t MASK_WORDS = 1024 / (8 * sizeof(unsigned long));
+constexpr size_t BITS_PER_WORD = 8 * sizeof(unsigned long);
+
+inline size_t page_bytes() noexcept {
+    static const size_t bytes = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return bytes;
+}
+
+// Maps anonymous memory aligned to at least a page, or returns nullptr
+inline void* map_aligned(size_t bytes, size_t alignment) noexcept {
+    const size_t page = page_bytes();
+    if (alignment <= page) {
+        void* memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        return memory == MAP_FAILED ? nullptr : memory;
+    }
+    // Over-map, then trim the unaligned head and the unused tail
+    const size_t span = bytes + alignment - page;
+    void* memory = ::mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+    auto base = reinterpret_cast<uintptr_t>(memory);
+    uintptr_t aligned = (base + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    if (aligned > base) {
+        ::munmap(memory, aligned - base);
+    }
+    const size_t mapped = (bytes + page - 1) & ~(page - 1);
+    if (base + span > aligned + mapped) {
+        ::munmap(reinterpret_cast<void*>(aligned + mapped), base + span - aligned - mapped);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+#endif
+
+}  // namespace numa_detail
+
+/**
+ * @brief Number of memory nodes this process may use (at least 1)
+ */
+inline int numa_node_count() noexcept {
+#ifdef __linux__
+    static const int count = []() {
+        unsigned long mask[numa_detail::MASK_WORDS] = {};
+        if (::syscall(SYS_get_mempolicy, nullptr, mask, numa_detail::MASK_WORDS * numa_detail::BITS_PER_WORD,
+                      nullptr, numa_detail::MPOL_F_MEMS_ALLOWED) != 0) {
+            return 1;
+        }
+        int highest = 0;
+        for (size_t bit = 0; bit < numa_detail::MASK_WORDS * numa_detail::BITS_PER_WORD; ++bit) {
+            if (mask[bit / numa_detail::BITS_PER_WORD] & (1ul << (bit % numa_detail::BITS_PER_WORD))) {
+                highest = static_cast<int>(bit);
+            }
+        }
+        return highest + 1;
+    }();
+    return count;
+#else
+    return 1;
+#endif
+}
+
+/**
+ * @brief Node of the CPU the calling thread is running on right now
+ *
+ * Only stable for a pinned thread.
+ */
+inline int numa_current_node() noexcept {
+#ifdef __linux__
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return static_cast<int>(node);
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief Node a CPU belongs to, read from sysfs (0 if unknown)
+ */
+inline int numa_node_of_cpu(unsigned cpu) noexcept {
+#ifdef __linux__
+    char path[64];
+    std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u", cpu);
+    if (DIR* dir = ::opendir(path)) {
+        int node = 0;
+        while (dirent* entry = ::readdir(dir)) {
+            if (std::strncmp(entry->d_name, "node", 4) == 0 && entry->d_name[4] >= '0' && entry->d_name[4] <= '9') {
+                node = std::atoi(entry->d_name + 4);
+                break;
+            }
+        }
+        ::closedir(dir);
+        return node;
+    }
+#endif
+    (void)cpu;
+    return 0;
+}
+
+/**
+ * @brief Node the page holding an address resides on
+ *
+ * @return The node, or NUMA_NO_NODE if the page is not resident yet or the
+ *         kernel cannot say
+ */
+inline int numa_node_of(const void* address) noexcept {
+#ifdef __linux__
+    int node = NUMA_NO_NODE;
+    if (::syscall(SYS_get_mempolicy, &node, nullptr, 0, const_cast<void*>(address),
+                  numa_detail::MPOL_F_NODE | numa_detail::MPOL_F_ADDR) == 0) {
+        return node;
+    }
+#endif
+    (void)address;
+    return NUMA_NO_NODE;
+}
+
+/**
+ * @brief Prefers a node for a range and migrates the pages already resident
+ *
+ * The range is widened to whole pages, so neighbouring objects on the first
+ * and last page move with it. The policy is "preferred" rather than "bind",
+ * so a full node falls back to another instead of failing allocations.
+ *
+ * @return true if the kernel accepted the policy; false (memory untouched)
+ *         for NUMA_NO_NODE, a node that does not exist, or no NUMA support
+ */
+inline bool numa_bind(void* address, size_t bytes, int node) noexcept {
+#ifdef __linux__
+    if (node < 0 || node >= numa_node_count() || address == nullptr || bytes == 0) {
+        return false;
+    }
+    const uintptr_t page = numa_detail::page_bytes();
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(address) & ~(page - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(address) + bytes + page - 1) & ~(page - 1);
+
+    unsigned long mask[numa_detail::MASK_WORDS] = {};
+    mask[static_cast<size_t>(node) / numa_detail::BITS_PER_WORD] |=
+        1ul << (static_cast<size_t>(node) % numa_detail::BITS_PER_WORD);
+    return ::syscall(SYS_mbind, reinterpret_cast<void*>(begin), end - begin, numa_detail::MPOL_PREFERRED, mask,
+                     numa_detail::MASK_WORDS * numa_detail::BITS_PER_WORD, numa_detail::MPOL_MF_MOVE) == 0;
+#else
+    (void)address;
+    (void)bytes;
+    (void)node;
+    return false;
+#endif
+}
+
+/**
+ * @brief Maps fresh memory on a node and faults it in there
+ *
+ * Falls back to ordinary (first-touch) memory if the node cannot be used.
+ *
+ * @param alignment A power of two; page alignment is always given
+ * @throws std::bad_alloc if no memory could be mapped at all
+ */
+inline void* numa_allocate(size_t bytes, int node, size_t alignment = alignof(std::max_align_t)) {
+#ifdef __linux__
+    void* memory = numa_detail::map_aligned(bytes, alignment);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    numa_bind(memory, bytes, node);
+    // Touch each page from here so it is placed now, not on the hot path
+    auto* bytes_ptr = static_cast<volatile unsigned char*>(memory);
+    for (size_t offset = 0; offset < bytes; offset += numa_detail::page_bytes()) {
+        bytes_ptr[offset] = 0;
+    }
+    return memory;
+#else
+    (void)node;
+    return ::operator new(bytes, std::align_val_t(alignment));
+#endif
+}
+
+inline void numa_deallocate(void* memory, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept {
+#ifdef __linux__
+    (void)alignment;
+    if (memory != nullptr) {
+        ::munmap(memory, bytes);
+    }
+#else
+    (void)bytes;
+    ::operator delete(memory, std::align_val_t(alignment));
+#endif
+}
+
+/**
+ * @brief std::pmr resource handing out memory on one node, e.g. as a slab allocator's upstream
+ *
+ * Every allocation is its own mapping, so use it for large, long-lived blocks.
+ */
+class NumaMemoryResource : public std::pmr::memory_resource {
+public:
+    explicit NumaMemoryResource(int node) noexcept : node_(node) {}
+
+    int node() const noexcept {
+        return node_;
+    }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return numa_allocate(bytes, node_, alignment);
+    }
+
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override {
+        numa_deallocate(memory, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        auto* numa = dynamic_cast<const NumaMemoryResource*>(&other);
+        return numa != nullptr && numa->node_ == node_;
+    }
+
+    int node_;
+};
+
+/**
+ * @brief Deleter for objects built by numa_make_unique()
+ */
+template <typename T>
+struct NumaDeleter {
+    void operator()(T* object) const noexcept {
+        object->~T();
+        numa_deallocate(object, sizeof(T), alignof(T));
+    }
+};
+
+template <typename T>
+using NumaUniquePtr = std::unique_ptr<T, NumaDeleter<T>>;
+
+/**
+ * @brief Constructs an object (e.g. a queue) in memory placed on a node
+ *
+ * Pass numa_node_of_cpu() of the consumer's core to keep the slots next to
+ * the thread that reads them.
+ */
+template <typename T, typename... Args>
+NumaUniquePtr<T> numa_make_unique(int node, Args&&... args) {
+    void* memory = numa_allocate(sizeof(T), node, alignof(T));
+    try {
+        return NumaUniquePtr<T>(::new (memory) T(std::forward<Args>(args)...));
+    } catch (...) {
+        numa_deallocate(memory, sizeof(T), alignof(T));
+        throw;
+    }
+}
@@ -0,0 +1,123 @@
+/**
+ * @file queue_backoff.h
+ * @brief Contention backoff policies for the lock-free queues
+ *
+ * MPMCQueue takes a Backoff policy as a template parameter. It calls
+ * on_retry(attempt) each time a thread loses a race for head_ or tail_ and is
+ * about to try again, and on_complete(retries) when the operation returns.
+ * Spinning between attempts keeps a losing thread from hammering the contended
+ * line with another read and CAS straight away, so the winner's next access
+ * finds it still in its cache.
+ *
+ * NoBackoff retries immediately and occupies no storage.
+ * ExponentialBackoffPolicy doubles the spin with every attempt, up to a cap.
+ * AdaptiveBackoff learns a per-thread starting spin from how often its
+ * operations have had to retry.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "concurrency_primitives.h"
+#include "queue_stats.h"
+
+namespace queue_backoff_detail {
+
+inline void spin(uint32_t pauses) noexcept {
+    for (uint32_t i = 0; i < pauses; ++i) {
+        cpu_pause();
+    }
+}
+
+}  // namespace queue_backoff_detail
+
+/**
+ * @brief Backoff policy that retries immediately
+ */
+struct NoBackoff {
+    void on_retry(uint32_t /*attempt*/) noexcept {}
+    void on_complete(uint32_t /*retries*/) noexcept {}
+};
+
+/**
+ * @brief Backoff policy that spins 1, 2, 4, ... pause instructions, up to MaxSpins
+ *
+ * Stateless: every operation starts again from one pause.
+ *
+ * @tparam MaxSpins Longest spin between two attempts, in pause instructions
+ */
+template <uint32_t MaxSpins = 256>
+struct ExponentialBackoffPolicy {
+    static_assert(MaxSpins > 0, "MaxSpins must be positive");
+
+    void on_retry(uint32_t attempt) noexcept {
+        const uint32_t shift = std::min<uint32_t>(attempt, 31);
+        queue_backoff_detail::spin(std::min<uint32_t>(uint32_t{1} << shift, MaxSpins));
+    }
+    void on_complete(uint32_t /*retries*/) noexcept {}
+};
+
+/**
+ * @brief Exponential backoff whose starting spin follows the observed failure rate
+ *
+ * Each thread keeps a base spin in its own cache-line-aligned slot. A retry
+ * spins base << attempt pauses, up to MaxSpins. When an operation completes
+ * after more than one retry, the first wait was too short and the base
+ * doubles; after an operation with no retries, it shrinks by an eighth
+ * towards MinSpins. Under a steady load the base settles where most
+ * operations need at most one retry. Without contention it costs one relaxed
+ * load per operation.
+ *
+ * With more than MaxThreads threads, slots are shared modulo MaxThreads, as
+ * in CountingStats. The base is only a hint, so a lost update does no harm.
+ *
+ * @tparam MinSpins Smallest base spin, in pause instructions
+ * @tparam MaxSpins Longest spin between two attempts, in pause instructions
+ * @tparam MaxThreads Number of per-thread slots
+ */
+template <uint32_t MinSpins = 1, uint32_t MaxSpins = 1024, size_t MaxThreads = 64>
+class AdaptiveBackoff {
+    static_assert(MinSpins > 0 && MinSpins <= MaxSpins, "Need 0 < MinSpins <= MaxSpins");
+    static_assert(MaxThreads > 0, "MaxThreads must be greater than 0");
+
+public:
+    void on_retry(uint32_t attempt) noexcept {
+        const uint64_t base = local().base.load(std::memory_order_relaxed);
+        const uint32_t shift = std::min<uint32_t>(attempt, 31);
+        queue_backoff_detail::spin(static_cast<uint32_t>(std::min<uint64_t>(base << shift, MaxSpins)));
+    }
+
+    void on_complete(uint32_t retries) noexcept {
+        std::atomic<uint32_t>& base = local().base;
+        const uint32_t current = base.load(std::memory_order_relaxed);
+        if (retries > 1) {
+            base.store(static_cast<uint32_t>(std::min<uint64_t>(uint64_t{current} * 2, MaxSpins)),
+                       std::memory_order_relaxed);
+        } else if (retries == 0 && current > MinSpins) {
+            base.store(std::max(current - std::max(current / 8, 1u), MinSpins), std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief The calling thread's current base spin
+     */
+    uint32_t base_spins() noexcept {
+        return local().base.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint32_t> base{MinSpins};
+    };
+
+    Slot& local() noexcept {
+        return slots_[queue_stats_detail::this_thread_index() % MaxThreads];
+    }
+
+    std::array<Slot, MaxThreads> slots_{};
+};
@@ -0,0 +1,616 @@
+/**
+ * @file queue_benchmarks.h
+ * @brief Queue-agnostic Google Benchmark bodies shared by every queue in this module
+ *
+ * Each benchmark is a template over ConcurrentQueue, so the same code measures
+ * RingBuffer, MPMCQueue and the baseline queues. register_queue_matrix() adds the
+ * full single-thread / multi-thread / latency / burst / payload matrix for one
+ * queue family, register_contention_matrix() only its multi-thread and latency
+ * runs, and run_benchmarks() replaces BENCHMARK_MAIN() to accept the
+ * sustained-run flags. Executables linked with the allocation guard also fail
+ * if the single- or multi-threaded loops allocate for a trivially copyable T.
+ * The threaded benchmarks bind each queue to its consumer's NUMA node and
+ * report the node its memory ended up on.
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "concurrency_primitives.h"
+#include "concurrent_queue.h"
+#include "numa.h"
+#include "thread_affinity.h"
+
+#ifdef ALLOC_GUARD_ENABLED
+#include "alloc_guard.h"
+#endif
+
+namespace queue_bench {
+
+// Capacity used for every queue in the cross-queue matrix
+constexpr size_t kMatrixCapacity = 1024;
+
+// Sustained-run settings for the multi-threaded benchmarks.
+// Override with --sustained_ms=<ms> or --sustained_messages=<count> on the command line.
+struct SustainedConfig {
+    size_t duration_ms = 1000;  // Length of each run when running by duration
+    size_t messages = 0;        // When non-zero, run until this many messages are consumed instead
+};
+
+inline SustainedConfig g_sustained;
+
+// Watches the enqueue/dequeue loops for heap allocations when the executable
+// links the allocation guard (see alloc_guard.h); otherwise it compiles away
+#ifdef ALLOC_GUARD_ENABLED
+using HotPathScope = NoAllocScope;
+#else
+struct HotPathScope {
+    uint64_t allocations() const noexcept { return 0; }
+};
+#endif
+
+// Set when a benchmark saw an allocation on a path that must not allocate; fails run_benchmarks()
+inline std::atomic<bool> g_hot_path_allocated{false};
+
+/**
+ * @brief Reports hot-path allocations, failing the benchmark if T should never allocate
+ */
+template <typename T>
+void check_hot_path_allocations([[maybe_unused]] benchmark::State& state, [[maybe_unused]] uint64_t allocations) {
+#ifdef ALLOC_GUARD_ENABLED
+    state.counters["hot_path_allocs"] = static_cast<double>(allocations);
+    if (std::is_trivially_copyable_v<T> && allocations > 0) {
+        g_hot_path_allocated.store(true, std::memory_order_relaxed);
+        state.SkipWithError("Heap allocation on the enqueue/dequeue path");
+    }
+#endif
+}
+
+/**
+ * @brief Fixed-size trivially copyable message used for payload sweeps
+ *
+ * @tparam Bytes Total size of the message (at least 8 bytes for the sequence number)
+ */
+template <size_t Bytes>
+struct Payload {
+    static_assert(Bytes >= sizeof(uint64_t), "Payload must hold at least the sequence number");
+
+    uint64_t seq = 0;
+    std::array<std::byte, Bytes - sizeof(uint64_t)> body{};
+};
+
+// Builds the n-th message for a queue of T
+template <typename T>
+T make_item(uint64_t n) {
+    if constexpr (std::is_arithmetic_v<T>) {
+        return static_cast<T>(n);
+    } else {
+        T item{};
+        item.seq = n;
+        return item;
+    }
+}
+
+// Core pinning lives in thread_affinity.h; the benchmarks call it as queue_bench::pin_current_thread
+using ::pinned_core;
+using ::pin_current_thread;
+
+/**
+ * @brief Moves a queue to the node of the core its consumer is pinned to, and reports where it resides
+ *
+ * queue_node is -1 when the kernel cannot report placement; on a single-node
+ * machine both counters are 0.
+ */
+template <typename Q>
+void place_on_consumer_node(benchmark::State& state, Q& queue, unsigned consumer_core) {
+    const int node = numa_node_of_cpu(pinned_core(consumer_core));
+    numa_bind(&queue, sizeof(Q), node);
+    state.counters["consumer_node"] = node;
+    state.counters["queue_node"] = numa_node_of(&queue);
+}
+
+// Busy-spin for a while before yielding, so latency runs are not dominated by the scheduler
+inline void relax(unsigned& spins) {
+    if (++spins >= 256) {
+        spins = 0;
+        std::this_thread::yield();
+    }
+}
+
+/**
+ * @brief Persistent, pinned producer/consumer threads driving one queue
+ *
+ * Threads are spawned once per benchmark and parked between runs, so thread
+ * creation and joining never show up in the measurement. Each run lasts either
+ * a fixed duration or a fixed message count, and records how many items every
+ * producer and consumer handled.
+ */
+template <ConcurrentQueue Q>
+class SustainedRunner {
+public:
+    using T = typename Q::value_type;
+
+    struct Result {
+        double seconds = 0.0;
+        bool timed_out = false;
+        uint64_t hot_path_allocations = 0;
+        std::vector<size_t> produced;
+        std::vector<size_t> consumed;
+    };
+
+    SustainedRunner(Q& queue, size_t num_producers, size_t num_consumers)
+        : queue_(queue),
+          num_producers_(num_producers),
+          num_consumers_(num_consumers),
+          counts_(new CacheLineAligned<std::atomic<size_t>>[num_producers + num_consumers]) {
+        threads_.reserve(num_producers_ + num_consumers_);
+        for (size_t i = 0; i < num_producers_; ++i) {
+            threads_.emplace_back([this, i]() { worker(i, true); });
+        }
+        for (size_t i = 0; i < num_consumers_; ++i) {
+            threads_.emplace_back([this, i]() { worker(num_producers_ + i, false); });
+        }
+    }
+
+    ~SustainedRunner() {
+        shutdown_.store(true, std::memory_order_release);
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+        for (auto& t : threads_) {
+            if (t.joinable()) t.join();
+        }
+    }
+
+    SustainedRunner(const SustainedRunner&) = delete;
+    SustainedRunner& operator=(const SustainedRunner&) = delete;
+
+    /**
+     * @brief Runs one timed round on the parked threads
+     */
+    Result run(const SustainedConfig& config) {
+        const size_t total_threads = num_producers_ + num_consumers_;
+        for (size_t i = 0; i < total_threads; ++i) {
+            counts_[i].data.store(0, std::memory_order_relaxed);
+        }
+        messages_ = config.messages;
+        stop_.store(false, std::memory_order_relaxed);
+        abort_.store(false, std::memory_order_relaxed);
+        producers_done_.store(0, std::memory_order_relaxed);
+        threads_done_.store(0, std::memory_order_relaxed);
+        hot_path_allocations_.store(0, std::memory_order_relaxed);
+
+        // Release the workers
+        auto start_time = std::chrono::steady_clock::now();
+        generation_.fetch_add(1, std::memory_order_acq_rel);
+
+        // Generous upper bound so a broken queue cannot hang the benchmark
+        const auto deadline = start_time + std::chrono::milliseconds(config.duration_ms) + std::chrono::seconds(30);
+        if (config.messages == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(config.duration_ms));
+            stop_.store(true, std::memory_order_release);
+        }
+
+        Result result;
+        while (threads_done_.load(std::memory_order_acquire) < total_threads) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                result.timed_out = true;
+                abort_.store(true, std::memory_order_release);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        auto end_time = std::chrono::steady_clock::now();
+
+        result.seconds = std::chrono::duration<double>(end_time - start_time).count();
+        result.hot_path_allocations = hot_path_allocations_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < num_producers_; ++i) {
+            result.produced.push_back(counts_[i].data.load(std::memory_order_relaxed));
+        }
+        for (size_t i = 0; i < num_consumers_; ++i) {
+            result.consumed.push_back(counts_[num_producers_ + i].data.load(std::memory_order_relaxed));
+        }
+        return result;
+    }
+
+private:
+    void worker(size_t index, bool is_producer) {
+        pin_current_thread(static_cast<unsigned>(index));
+
+        uint64_t seen_generation = 0;
+        while (true) {
+            // Park until the next run (or shutdown)
+            uint64_t generation;
+            while ((generation = generation_.load(std::memory_order_acquire)) == seen_generation) {
+                std::this_thread::yield();
+            }
+            seen_generation = generation;
+            if (shutdown_.load(std::memory_order_acquire)) {
+                return;
+            }
+
+            HotPathScope guard;
+            const size_t count = is_producer ? produce(index) : consume();
+            hot_path_allocations_.fetch_add(guard.allocations(), std::memory_order_relaxed);
+            counts_[index].data.store(count, std::memory_order_relaxed);
+            if (is_producer) {
+                producers_done_.fetch_add(1, std::memory_order_acq_rel);
+            }
+            threads_done_.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+
+    size_t produce(size_t producer_id) {
+        // In message-count mode, split the total evenly with the remainder going to producer 0
+        size_t quota = SIZE_MAX;
+        if (messages_ != 0) {
+            quota = messages_ / num_producers_ + (producer_id == 0 ? messages_ % num_producers_ : 0);
+        }
+
+        size_t count = 0;
+        while (count < quota && !stop_.load(std::memory_order_relaxed)) {
+            if (queue_.try_enqueue(make_item<T>(count))) {
+                count++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        return count;
+    }
+
+    size_t consume() {
+        T value;
+        size_t count = 0;
+        while (!abort_.load(std::memory_order_relaxed)) {
+            if (queue_.try_dequeue(value)) {
+                benchmark::DoNotOptimize(value);
+                count++;
+            } else {
+                // Finished once every producer is done and the queue has been drained
+                if (producers_done_.load(std::memory_order_acquire) == num_producers_ && queue_.empty()) {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+        return count;
+    }
+
+    Q& queue_;
+    const size_t num_producers_;
+    const size_t num_consumers_;
+
+    // Per-thread item counts, one cache line each
+    std::unique_ptr<CacheLineAligned<std::atomic<size_t>>[]> counts_;
+    std::vector<std::thread> threads_;
+
+    size_t messages_ = 0;
+    std::atomic<uint64_t> generation_{0};
+    std::atomic<bool> shutdown_{false};
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> abort_{false};
+    std::atomic<size_t> producers_done_{0};
+    std::atomic<size_t> threads_done_{0};
+    std::atomic<uint64_t> hot_path_allocations_{0};
+};
+
+// Reports per-thread item counts plus their skew (max / mean, 1.0 means perfectly even)
+inline void report_thread_counts(benchmark::State& state, const std::string& prefix,
+                                 const std::vector<size_t>& counts) {
+    size_t sum = 0;
+    size_t max_count = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        state.counters[prefix + std::to_string(i)] = static_cast<double>(counts[i]);
+        sum += counts[i];
+        max_count = std::max(max_count, counts[i]);
+    }
+    const double mean = static_cast<double>(sum) / static_cast<double>(counts.size());
+    state.counters[prefix + "_skew"] = mean > 0.0 ? static_cast<double>(max_count) / mean : 0.0;
+}
+
+// Reports p50/p99/p99.9/max of a set of nanosecond samples
+inline void report_percentiles(benchmark::State& state, std::vector<uint64_t>& samples_ns) {
+    if (samples_ns.empty()) {
+        return;
+    }
+    std::sort(samples_ns.begin(), samples_ns.end());
+    auto percentile = [&](double p) {
+        size_t index = static_cast<size_t>(p * static_cast<double>(samples_ns.size() - 1));
+        return static_cast<double>(samples_ns[index]);
+    };
+    state.counters["p50_ns"] = percentile(0.50);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p999_ns"] = percentile(0.999);
+    state.counters["max_ns"] = static_cast<double>(samples_ns.back());
+}
+
+/**
+ * @brief Enqueue a batch then dequeue it again on a single thread
+ *
+ * state.range(0) is the batch size and must not exceed the queue capacity.
+ */
+template <ConcurrentQueue Q>
+void BM_SingleThreaded(benchmark::State& state) {
+    using T = typename Q::value_type;
+    const size_t batch = static_cast<size_t>(state.range(0));
+    auto queue = std::make_unique<Q>();
+
+    const T item = make_item<T>(1);
+    T out;
+    HotPathScope guard;
+    for (auto _ : state) {
+        for (size_t i = 0; i < batch; ++i) {
+            benchmark::DoNotOptimize(queue->try_enqueue(item));
+        }
+        for (size_t i = 0; i < batch; ++i) {
+            benchmark::DoNotOptimize(queue->try_dequeue(out));
+        }
+    }
+    check_hot_path_allocations<T>(state, guard.allocations());
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch * 2));  // Enqueue + dequeue
+}
+
+/**
+ * @brief Multi-threaded producer-consumer benchmark on persistent, pinned threads
+ *
+ * state.range(0) producers and state.range(1) consumers; register with
+ * UseManualTime() so only the run itself is timed.
+ */
+template <ConcurrentQueue Q>
+void BM_MultiThreaded(benchmark::State& state) {
+    // Number of producer and consumer threads
+    const size_t num_producers = static_cast<size_t>(state.range(0));
+    const size_t num_consumers = static_cast<size_t>(state.range(1));
+
+    if ((num_producers > 1 && !queue_supports_multi_producer<Q>()) ||
+        (num_consumers > 1 && !queue_supports_multi_consumer<Q>())) {
+        state.SkipWithError("Queue does not support this producer/consumer configuration");
+        return;
+    }
+
+    // The queue and worker threads live across all iterations
+    auto queue = std::make_unique<Q>();
+    place_on_consumer_node(state, *queue, static_cast<unsigned>(num_producers));  // The first consumer's core
+    SustainedRunner<Q> runner(*queue, num_producers, num_consumers);
+
+    std::vector<size_t> produced(num_producers, 0);
+    std::vector<size_t> consumed(num_consumers, 0);
+    size_t total_consumed = 0;
+    uint64_t hot_path_allocations = 0;
+
+    for (auto _ : state) {
+        auto result = runner.run(g_sustained);
+        hot_path_allocations += result.hot_path_allocations;
+        if (result.timed_out) {
+            state.SkipWithError("Run did not drain before the deadline");
+            break;
+        }
+        state.SetIterationTime(result.seconds);
+
+        for (size_t i = 0; i < num_producers; ++i) produced[i] += result.produced[i];
+        for (size_t i = 0; i < num_consumers; ++i) {
+            consumed[i] += result.consumed[i];
+            total_consumed += result.consumed[i];
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(total_consumed));
+    check_hot_path_allocations<typename Q::value_type>(state, hot_path_allocations);
+    if constexpr (requires { queue->stats().enqueue_retries; }) {
+        // Lost races per item: the coherence traffic on head and tail, when the queue counts it
+        const auto stats = queue->stats();
+        if (stats.enqueues > 0 && total_consumed > 0) {
+            state.counters["retries_per_item"] =
+                static_cast<double>(stats.enqueue_retries + stats.dequeue_retries) / static_cast<double>(total_consumed);
+        }
+    }
+    report_thread_counts(state, "p", produced);
+    report_thread_counts(state, "c", consumed);
+    state.SetLabel(std::to_string(num_producers) + "p-" + std::to_string(num_consumers) + "c");
+}
+
+/**
+ * @brief Round-trip latency through a pair of queues and an echo thread
+ *
+ * Every iteration sends one message and waits for its echo; the reported
+ * percentiles are round-trip times in nanoseconds.
+ */
+template <ConcurrentQueue Q>
+void BM_Latency(benchmark::State& state) {
+    using T = typename Q::value_type;
+    auto request = std::make_unique<Q>();
+    auto response = std::make_unique<Q>();
+    std::atomic<bool> stop(false);
+
+    std::thread echo([&]() {
+        pin_current_thread(1);
+        T value;
+        unsigned spins = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (request->try_dequeue(value)) {
+                while (!response->try_enqueue(value)) {
+                    relax(spins);
+                }
+            } else {
+                relax(spins);
+            }
+        }
+    });
+
+    std::vector<uint64_t> samples_ns;
+    samples_ns.reserve(1 << 20);
+
+    T item = make_item<T>(0);
+    T reply;
+    uint64_t seq = 0;
+    for (auto _ : state) {
+        item = make_item<T>(++seq);
+        unsigned spins = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (!request->try_enqueue(item)) {
+            relax(spins);
+        }
+        while (!response->try_dequeue(reply)) {
+            relax(spins);
+        }
+        auto end = std::chrono::steady_clock::now();
+        samples_ns.push_back(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    echo.join();
+
+    report_percentiles(state, samples_ns);
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Bursts of state.range(0) back-to-back messages drained by a consumer thread
+ *
+ * Each iteration enqueues one burst and waits until the consumer has caught
+ * up, which is how market data tends to arrive.
+ */
+template <ConcurrentQueue Q>
+void BM_Burst(benchmark::State& state) {
+    using T = typename Q::value_type;
+    const size_t burst = static_cast<size_t>(state.range(0));
+    auto queue = std::make_unique<Q>();
+    place_on_consumer_node(state, *queue, 1);
+    CacheLineAligned<std::atomic<size_t>> consumed;
+    consumed.data.store(0, std::memory_order_relaxed);
+    std::atomic<bool> stop(false);
+
+    std::thread consumer([&]() {
+        pin_current_thread(1);
+        T value;
+        unsigned spins = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (queue->try_dequeue(value)) {
+                benchmark::DoNotOptimize(value);
+                consumed.data.fetch_add(1, std::memory_order_release);
+            } else {
+                relax(spins);
+            }
+        }
+    });
+
+    size_t sent = 0;
+    for (auto _ : state) {
+        unsigned spins = 0;
+        for (size_t i = 0; i < burst; ++i) {
+            while (!queue->try_enqueue(make_item<T>(sent + i))) {
+                relax(spins);
+            }
+        }
+        sent += burst;
+        while (consumed.data.load(std::memory_order_acquire) < sent) {
+            relax(spins);
+        }
+    }
+
+    stop.store(true, std::memory_order_relaxed);
+    consumer.join();
+
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+}
+
+// Producer/consumer configurations used by the matrix
+inline constexpr std::array<std::pair<int, int>, 5> kThreadConfigs = {{
+    {1, 1}, {1, 4}, {2, 2}, {4, 1}, {4, 4},
+}};
+
+template <typename Family, size_t Bytes>
+void register_payload(const std::string& name) {
+    using PayloadQueue = typename Family::template queue<Payload<Bytes>, kMatrixCapacity>;
+    const std::string prefix = name + "/Payload" + std::to_string(Bytes);
+
+    benchmark::RegisterBenchmark((prefix + "/SingleThreaded").c_str(), BM_SingleThreaded<PayloadQueue>)
+        ->Arg(256);
+    benchmark::RegisterBenchmark((prefix + "/MultiThreaded").c_str(), BM_MultiThreaded<PayloadQueue>)
+        ->Args({1, 1})->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond);
+}
+
+// The multi-threaded and latency benchmarks only: the ones that contend on head and tail
+template <typename Family>
+void register_contention_matrix(const std::string& name) {
+    using IntQueue = typename Family::template queue<int, kMatrixCapacity>;
+
+    for (auto [producers, consumers] : kThreadConfigs) {
+        if ((producers > 1 && !queue_supports_multi_producer<IntQueue>()) ||
+            (consumers > 1 && !queue_supports_multi_consumer<IntQueue>())) {
+            continue;
+        }
+        benchmark::RegisterBenchmark((name + "/MultiThreaded").c_str(), BM_MultiThreaded<IntQueue>)
+            ->Args({producers, consumers})->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond);
+    }
+
+    benchmark::RegisterBenchmark((name + "/Latency").c_str(), BM_Latency<IntQueue>)->UseRealTime();
+}
+
+/**
+ * @brief Registers the full benchmark matrix for one queue family
+ *
+ * A family exposes `template <typename T, size_t Capacity> using queue = ...;`
+ * so the matrix can instantiate it for several payload types.
+ */
+template <typename Family>
+void register_queue_matrix(const std::string& name) {
+    using IntQueue = typename Family::template queue<int, kMatrixCapacity>;
+
+    benchmark::RegisterBenchmark((name + "/SingleThreaded").c_str(), BM_SingleThreaded<IntQueue>)
+        ->RangeMultiplier(4)->Range(64, 1024);
+    register_contention_matrix<Family>(name);
+    benchmark::RegisterBenchmark((name + "/Burst").c_str(), BM_Burst<IntQueue>)
+        ->Arg(16)->Arg(256)->UseRealTime();
+
+    register_payload<Family, 8>(name);
+    register_payload<Family, 64>(name);
+    register_payload<Family, 256>(name);
+    register_payload<Family, 1024>(name);
+}
+
+// Strips the sustained-run flags before handing the rest to Google Benchmark
+inline void parse_sustained_flags(int& argc, char** argv) {
+    int out = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--sustained_ms=", 15) == 0) {
+            g_sustained.duration_ms = std::strtoull(argv[i] + 15, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--sustained_messages=", 21) == 0) {
+            g_sustained.messages = std::strtoull(argv[i] + 21, nullptr, 10);
+        } else {
+            argv[out++] = argv[i];
+        }
+    }
+    argc = out;
+}
+
+/**
+ * @brief Drop-in replacement for BENCHMARK_MAIN() that understands the sustained-run flags
+ */
+inline int run_benchmarks(int argc, char** argv) {
+    parse_sustained_flags(argc, argv);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return g_hot_path_allocated.load(std::memory_order_relaxed) ? 1 : 0;
+}
+
+}  // namespace queue_bench
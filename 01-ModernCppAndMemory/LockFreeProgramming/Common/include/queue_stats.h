@@ -0,0 +1,153 @@
+/**
+ * @file queue_stats.h
+ * @brief Telemetry policies for the lock-free queues
+ *
+ * RingBuffer and MPMCQueue take a Stats policy as a template parameter and
+ * call its hooks from the hot paths. NoStats compiles every hook away and
+ * occupies no storage; CountingStats keeps per-thread counters on separate
+ * cache lines and sums them when read.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "concurrency_primitives.h"
+
+/**
+ * @brief Aggregated telemetry for one queue, as returned by stats()
+ */
+struct QueueStatsSnapshot {
+    uint64_t enqueues = 0;             // Successful enqueues
+    uint64_t dequeues = 0;             // Successful dequeues
+    uint64_t full_failures = 0;        // try_enqueue calls rejected because the queue was full
+    uint64_t empty_polls = 0;          // try_dequeue calls that found the queue empty
+    uint64_t enqueue_retries = 0;      // Producer CAS failures / stale head reloads
+    uint64_t dequeue_retries = 0;      // Consumer CAS failures / stale tail reloads
+    size_t high_water_mark = 0;        // Largest occupancy observed by a producer
+};
+
+/**
+ * @brief Stats policy that records nothing
+ *
+ * Every hook is an empty inline function and the queues hold the policy as a
+ * NO_UNIQUE_ADDRESS member, so a queue with NoStats is the same size and
+ * generates the same code as one without a policy at all.
+ */
+struct NoStats {
+    static constexpr bool enabled = false;
+
+    void on_enqueue(size_t /*occupancy*/) noexcept {}
+    void on_dequeue() noexcept {}
+    void on_full() noexcept {}
+    void on_empty() noexcept {}
+    void on_enqueue_retry() noexcept {}
+    void on_dequeue_retry() noexcept {}
+
+    QueueStatsSnapshot snapshot() const noexcept { return {}; }
+    void reset() noexcept {}
+};
+
+namespace queue_stats_detail {
+
+// Hands each thread a small integer the first time it touches any CountingStats
+inline size_t this_thread_index() noexcept {
+    static std::atomic<size_t> next_index{0};
+    thread_local const size_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+}  // namespace queue_stats_detail
+
+/**
+ * @brief Stats policy with per-thread counters
+ *
+ * Each thread increments counters in its own cache-line-aligned slot, so
+ * producers and consumers never write to the same line. snapshot() sums the
+ * slots (and takes the maximum high-water mark); it is safe to call from any
+ * thread while the queue is in use, but the counters are not read as one
+ * atomic snapshot.
+ *
+ * With more than MaxThreads threads, slots are shared modulo MaxThreads. The
+ * counts stay exact (increments are atomic) but those threads share a line.
+ *
+ * @tparam MaxThreads Number of per-thread slots
+ */
+template <size_t MaxThreads = 64>
+class CountingStats {
+    static_assert(MaxThreads > 0, "MaxThreads must be greater than 0");
+
+public:
+    static constexpr bool enabled = true;
+
+    void on_enqueue(size_t occupancy) noexcept {
+        Slot& slot = local();
+        bump(slot.enqueues);
+        // Only this thread (or the few sharing its slot) raises this value; an
+        // occasional lost update under sharing only loses a maximum, not a count
+        if (occupancy > slot.high_water_mark.load(std::memory_order_relaxed)) {
+            slot.high_water_mark.store(occupancy, std::memory_order_relaxed);
+        }
+    }
+    void on_dequeue() noexcept { bump(local().dequeues); }
+    void on_full() noexcept { bump(local().full_failures); }
+    void on_empty() noexcept { bump(local().empty_polls); }
+    void on_enqueue_retry() noexcept { bump(local().enqueue_retries); }
+    void on_dequeue_retry() noexcept { bump(local().dequeue_retries); }
+
+    QueueStatsSnapshot snapshot() const noexcept {
+        QueueStatsSnapshot total;
+        for (const Slot& slot : slots_) {
+            total.enqueues += slot.enqueues.load(std::memory_order_relaxed);
+            total.dequeues += slot.dequeues.load(std::memory_order_relaxed);
+            total.full_failures += slot.full_failures.load(std::memory_order_relaxed);
+            total.empty_polls += slot.empty_polls.load(std::memory_order_relaxed);
+            total.enqueue_retries += slot.enqueue_retries.load(std::memory_order_relaxed);
+            total.dequeue_retries += slot.dequeue_retries.load(std::memory_order_relaxed);
+            size_t high_water_mark = slot.high_water_mark.load(std::memory_order_relaxed);
+            if (high_water_mark > total.high_water_mark) {
+                total.high_water_mark = high_water_mark;
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @brief Zeroes every counter; only meaningful while the queue is idle
+     */
+    void reset() noexcept {
+        for (Slot& slot : slots_) {
+            slot.enqueues.store(0, std::memory_order_relaxed);
+            slot.dequeues.store(0, std::memory_order_relaxed);
+            slot.full_failures.store(0, std::memory_order_relaxed);
+            slot.empty_polls.store(0, std::memory_order_relaxed);
+            slot.enqueue_retries.store(0, std::memory_order_relaxed);
+            slot.dequeue_retries.store(0, std::memory_order_relaxed);
+            slot.high_water_mark.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        std::atomic<uint64_t> enqueues{0};
+        std::atomic<uint64_t> dequeues{0};
+        std::atomic<uint64_t> full_failures{0};
+        std::atomic<uint64_t> empty_polls{0};
+        std::atomic<uint64_t> enqueue_retries{0};
+        std::atomic<uint64_t> dequeue_retries{0};
+        std::atomic<size_t> high_water_mark{0};
+    };
+
+    static void bump(std::atomic<uint64_t>& counter) noexcept {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Slot& local() noexcept {
+        return slots_[queue_stats_detail::this_thread_index() % MaxThreads];
+    }
+
+    std::array<Slot, MaxThreads> slots_{};
+};
@@ -0,0 +1,99 @@
+/**
+ * @file ready_mask.h
+ * @brief One bit per queue that may hold items, set by producers and cleared by consumers
+ *
+ * FanInQueue, PriorityBandQueue and QueueSet let a consumer find the queues
+ * with work by reading a few words instead of touching every queue. A
+ * producer sets its queue's bit after a push; a consumer that finds the
+ * queue empty clears the bit. Both go through ReadyMask, so the fence
+ * protocol that keeps items from being stranded lives in one place.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "concurrency_primitives.h"
+
+/**
+ * @brief Ready bits for Bits queues, on cache lines of their own
+ *
+ * The consumer clears a bit and then looks at the queue again; the producer
+ * publishes its item and then looks at the bit. A full fence on each side
+ * makes sure at least one of them sees the other, so no item is left in a
+ * queue whose bit is clear. A producer writes a word only to set a clear
+ * bit, so while a queue stays busy its producers only read the line, and it
+ * stays shared between their caches.
+ *
+ * @tparam Bits Number of queues
+ */
+template <size_t Bits>
+class alignas(CACHE_LINE_SIZE) ReadyMask {
+    static_assert(Bits > 0, "Bits must be greater than 0");
+
+public:
+    static constexpr size_t WORDS = (Bits + 63) / 64;
+
+    ReadyMask() noexcept {
+        for (auto& word : words_) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    ReadyMask(const ReadyMask&) = delete;
+    ReadyMask& operator=(const ReadyMask&) = delete;
+
+    /**
+     * @brief Sets a queue's bit after a push, unless it is already set
+     *
+     * @return true if this call set the bit, i.e. the queue has just become ready
+     */
+    bool mark(size_t index) noexcept {
+        auto& word = words_[index / 64];
+        const uint64_t bit = uint64_t{1} << (index % 64);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ((word.load(std::memory_order_relaxed) & bit) != 0) {
+            return false;
+        }
+        word.fetch_or(bit, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Clears the bit of a queue found empty, keeping it if still_ready() says an item arrived meanwhile
+     *
+     * @return true if the bit was set again
+     */
+    template <typename StillReady>
+    bool settle(size_t index, StillReady&& still_ready) noexcept {
+        auto& word = words_[index / 64];
+        const uint64_t bit = uint64_t{1} << (index % 64);
+        word.fetch_and(~bit, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!still_ready()) {
+            return false;
+        }
+        word.fetch_or(bit, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Clears a bit unconditionally, e.g. when its queue is unregistered
+     */
+    void clear(size_t index) noexcept {
+        words_[index / 64].fetch_and(~(uint64_t{1} << (index % 64)), std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Bits 64 * w to 64 * w + 63
+     */
+    uint64_t load(size_t w = 0) const noexcept {
+        return words_[w].load(std::memory_order_acquire);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, WORDS> words_;
+};
@@ -0,0 +1,68 @@
+/**
+ * @file seqlock_payload.h
+ * @brief A trivially copyable value held as 64-bit atomic words, for seqlock-style racy copies
+ *
+ * A seqlock reader copies the value while the writer may be changing it, and
+ * throws the copy away if the version moved. Copying a plain T that way is a
+ * data race, which is undefined behaviour (and what ThreadSanitizer reports),
+ * whatever fences surround it. Holding the value as relaxed atomic words
+ * makes the racy copy well defined; on x86 and ARM the relaxed loads and
+ * stores compile to plain moves. SeqLock and RetransmitRing keep their
+ * payloads this way.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Seqlock payloads need lock-free 64-bit atomics, which are also address-free for shared memory");
+
+/**
+ * @brief A trivially copyable value stored as 64-bit atomic words
+ *
+ * store() and load() copy word by word with relaxed operations, so a load
+ * racing a store is well defined; it may just return a mix of old and new
+ * words, which the surrounding version check detects. Order the copies with
+ * fences around them, as SeqLock does.
+ */
+template <typename T>
+class SeqLockPayload {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    SeqLockPayload() noexcept {
+        for (auto& word : words_) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    SeqLockPayload(const SeqLockPayload&) = delete;
+    SeqLockPayload& operator=(const SeqLockPayload&) = delete;
+
+    void store(const T& value) noexcept {
+        std::array<uint64_t, WORDS> staged{};
+        std::memcpy(staged.data(), &value, sizeof(T));
+        for (size_t i = 0; i < WORDS; ++i) {
+            words_[i].store(staged[i], std::memory_order_relaxed);
+        }
+    }
+
+    void load(T& out) const noexcept {
+        std::array<uint64_t, WORDS> staged;
+        for (size_t i = 0; i < WORDS; ++i) {
+            staged[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        std::memcpy(static_cast<void*>(&out), staged.data(), sizeof(T));
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, WORDS> words_;
+};
@@ -0,0 +1,38 @@
+/**
+ * @file thread_affinity.h
+ * @brief Pins the calling thread to one core, for benchmarks that must not migrate
+ *
+ * The queue benchmark harness pins its producers and consumers with these,
+ * and so do the MemoryManagement experiments, which measure cache-line
+ * traffic between fixed cores without needing the rest of the harness.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+// Core a thread asking for core_id is pinned to (wraps around the available hardware threads)
+inline unsigned pinned_core(unsigned core_id) {
+    return core_id % std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Pin the calling thread to a single core
+inline void pin_current_thread(unsigned core_id) {
+    core_id = pinned_core(core_id);
+#ifdef _WIN32
+    SetThreadAffinityMask(GetCurrentThread(), (1ULL << core_id));
+#else
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core_id, &cpuset);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+#endif
+}
@@ -0,0 +1,62 @@
+/**
+ * @file thread_slot.h
+ * @brief Small, recycled per-thread indices for per-thread state arrays
+ *
+ * Structures that keep per-thread state in a fixed array (the ObjectPool
+ * caches, the slab allocator's heaps) need each live thread to own one index
+ * exclusively. A thread claims the lowest free slot on first use and returns
+ * it when it exits, so a thread started later inherits the slot and whatever
+ * state an exited thread left in it, instead of that state being stranded.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Threads that can hold a slot at once, across the whole process
+constexpr size_t MAX_THREAD_SLOTS = 256;
+constexpr size_t NO_THREAD_SLOT = SIZE_MAX;
+
+namespace thread_slot_detail {
+
+inline std::array<std::atomic<bool>, MAX_THREAD_SLOTS>& slot_table() noexcept {
+    static std::array<std::atomic<bool>, MAX_THREAD_SLOTS> table{};
+    return table;
+}
+
+// Claims a slot on construction and gives it back on destruction (thread exit)
+struct ThreadSlot {
+    size_t index = NO_THREAD_SLOT;
+
+    ThreadSlot() noexcept {
+        auto& table = slot_table();
+        for (size_t i = 0; i < table.size(); ++i) {
+            bool expected = false;
+            if (!table[i].load(std::memory_order_relaxed) &&
+                table[i].compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                index = i;
+                return;
+            }
+        }
+    }
+
+    ~ThreadSlot() {
+        if (index != NO_THREAD_SLOT) {
+            // Release: the next owner sees everything this thread wrote to its per-slot state
+            slot_table()[index].store(false, std::memory_order_release);
+        }
+    }
+};
+
+}  // namespace thread_slot_detail
+
+/**
+ * @brief The calling thread's slot, or NO_THREAD_SLOT if all MAX_THREAD_SLOTS are taken
+ */
+inline size_t this_thread_slot() noexcept {
+    thread_local thread_slot_detail::ThreadSlot slot;
+    return slot.index;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file tsc_clock.h
+ * @brief Time stamp counter reads and calibration to nanoseconds
+ *
+ * Reading the TSC takes a few nanoseconds and no system call, which makes it
+ * cheap enough to stamp messages on the hot path. The raw tick rate is not
+ * exposed by the CPU, so TscClock measures it against std::chrono::steady_clock.
+ * The result is only trustworthy on CPUs with an invariant TSC (constant rate
+ * across P-states and C-states, synchronised across cores); invariant() reports
+ * whether this CPU claims one.
+ *
+ * On non-x86 targets read_tsc() falls back to steady_clock nanoseconds, so the
+ * calibrated rate is simply 1 tick per ns.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define TSC_CLOCK_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#endif
+
+/**
+ * @brief Reads the time stamp counter
+ *
+ * Not serialising: the read may be reordered with nearby loads and stores by
+ * a few tens of cycles, which is negligible for queue residency times.
+ */
+inline uint64_t read_tsc() noexcept {
+#ifdef TSC_CLOCK_X86
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief Converts TSC ticks to nanoseconds using a measured tick rate
+ */
+class TscClock {
+public:
+    /**
+     * @brief Measures the TSC rate against steady_clock
+     *
+     * Runs `rounds` busy-wait windows of `window` each and keeps the median
+     * rate, so one preempted round does not skew the result. Each end point
+     * brackets the TSC read between two steady_clock reads to bound the skew
+     * between the two clocks.
+     */
+    static TscClock calibrate(std::chrono::milliseconds window = std::chrono::milliseconds(20), int rounds = 5) {
+        constexpr int MAX_ROUNDS = 15;
+        rounds = std::clamp(rounds, 1, MAX_ROUNDS);
+
+        std::array<double, MAX_ROUNDS> rates{};
+        for (int round = 0; round < rounds; ++round) {
+            auto [start_ns, start_tsc] = paired_read();
+            auto deadline = std::chrono::steady_clock::now() + window;
+            while (std::chrono::steady_clock::now() < deadline) {
+                // Busy-wait so the core stays awake for the whole window
+            }
+            auto [end_ns, end_tsc] = paired_read();
+            rates[round] = static_cast<double>(end_tsc - start_tsc) / static_cast<double>(end_ns - start_ns);
+        }
+
+        std::sort(rates.begin(), rates.begin() + rounds);
+        return TscClock(rates[rounds / 2]);
+    }
+
+    /**
+     * @brief A process-wide clock, calibrated on first use (about 100 ms)
+     */
+    static const TscClock& shared() {
+        static const TscClock clock = calibrate();
+        return clock;
+    }
+
+    /**
+     * @brief Whether the CPU advertises an invariant TSC (CPUID 0x80000007, EDX bit 8)
+     */
+    static bool invariant() noexcept {
+#ifdef TSC_CLOCK_X86
+#if defined(_MSC_VER)
+        int regs[4] = {};
+        __cpuid(regs, 0x80000000);
+        if (static_cast<unsigned>(regs[0]) < 0x80000007u) {
+            return false;
+        }
+        __cpuid(regs, 0x80000007);
+        return (regs[3] & (1 << 8)) != 0;
+#else
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+            return false;
+        }
+        return (edx & (1u << 8)) != 0;
+#endif
+#else
+        return true;  // steady_clock fallback is invariant by definition
+#endif
+    }
+
+    explicit TscClock(double ticks_per_ns) noexcept : ticks_per_ns_(ticks_per_ns) {}
+
+    double ticks_per_ns() const noexcept { return ticks_per_ns_; }
+
+    double to_ns(uint64_t ticks) const noexcept {
+        return static_cast<double>(ticks) / ticks_per_ns_;
+    }
+
+    uint64_t to_ticks(double ns) const noexcept {
+        return static_cast<uint64_t>(ns * ticks_per_ns_);
+    }
+
+private:
+    struct PairedRead {
+        int64_t ns;
+        uint64_t tsc;
+    };
+
+    static int64_t steady_ns() noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Takes the tightest of a few steady/TSC/steady brackets
+    static PairedRead paired_read() noexcept {
+        PairedRead best{0, 0};
+        int64_t best_width = INT64_MAX;
+        for (int i = 0; i < 5; ++i) {
+            int64_t before = steady_ns();
+            uint64_t tsc = read_tsc();
+            int64_t after = steady_ns();
+            if (after - before < best_width) {
+                best_width = after - before;
+                best = {before + (after - before) / 2, tsc};
+            }
+        }
+        return best;
+    }
+
+    double ticks_per_ns_;
+};
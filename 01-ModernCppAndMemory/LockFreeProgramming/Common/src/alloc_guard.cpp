@@ -0,0 +1,239 @@
+/**
+ * @file alloc_guard.cpp
+ * @brief Counting replacements for the global allocation functions (see alloc_guard.h)
+ *
+ * Compile into each executable that uses NoAllocScope. Define
+ * ALLOC_GUARD_WRAP_MALLOC and link with
+ * -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free to also count
+ * direct malloc calls from the executable's own object files.
+ */
+
+#include "alloc_guard.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+struct ThreadCounters {
+    AllocGuardCounts counts;
+    uint32_t abort_depth;
+};
+
+// Constant-initialised and trivially destructible, so it is safe to touch from
+// inside operator new at any point of a thread's life
+thread_local constinit ThreadCounters t_counters{};
+
+void record_allocation(size_t bytes) noexcept {
+    t_counters.counts.allocations++;
+    t_counters.counts.bytes += bytes;
+    if (t_counters.abort_depth > 0) {
+        t_counters.abort_depth = 0;
+        std::fputs("alloc_guard: heap allocation inside NoAllocScope(AllocGuardMode::Abort)\n", stderr);
+        std::abort();
+    }
+}
+
+void record_deallocation(void* pointer) noexcept {
+    if (pointer != nullptr) {
+        t_counters.counts.deallocations++;
+    }
+}
+
+}  // namespace
+
+#ifdef ALLOC_GUARD_WRAP_MALLOC
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* pointer, size_t size);
+void __real_free(void* pointer);
+
+void* __wrap_malloc(size_t size) {
+    record_allocation(size);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    record_allocation(count * size);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+    record_deallocation(pointer);
+    record_allocation(size);
+    return __real_realloc(pointer, size);
+}
+
+void __wrap_free(void* pointer) {
+    record_deallocation(pointer);
+    __real_free(pointer);
+}
+}
+
+#define ALLOC_GUARD_MALLOC __real_malloc
+#define ALLOC_GUARD_FREE __real_free
+#else
+#define ALLOC_GUARD_MALLOC std::malloc
+#define ALLOC_GUARD_FREE std::free
+#endif
+
+namespace {
+
+void* raw_allocate(size_t size, size_t alignment) noexcept {
+    if (size == 0) {
+        size = 1;
+    }
+    if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        return ALLOC_GUARD_MALLOC(size);
+    }
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    void* pointer = nullptr;
+    return ::posix_memalign(&pointer, alignment, size) == 0 ? pointer : nullptr;
+#endif
+}
+
+void raw_free(void* pointer, size_t alignment) noexcept {
+#ifdef _WIN32
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+        _aligned_free(pointer);
+        return;
+    }
+#else
+    (void)alignment;
+#endif
+    ALLOC_GUARD_FREE(pointer);
+}
+
+void* allocate_or_null(size_t size, size_t alignment) noexcept {
+    record_allocation(size);
+    while (true) {
+        if (void* pointer = raw_allocate(size, alignment)) {
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            return nullptr;
+        }
+        try {
+            handler();
+        } catch (...) {
+            return nullptr;
+        }
+    }
+}
+
+void* allocate_or_throw(size_t size, size_t alignment) {
+    record_allocation(size);
+    while (true) {
+        if (void* pointer = raw_allocate(size, alignment)) {
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void deallocate(void* pointer, size_t alignment) noexcept {
+    record_deallocation(pointer);
+    if (pointer != nullptr) {
+        raw_free(pointer, alignment);
+    }
+}
+
+constexpr size_t DEFAULT_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+}  // namespace
+
+// Replaceable global allocation functions
+
+void* operator new(size_t size) { return allocate_or_throw(size, DEFAULT_ALIGNMENT); }
+void* operator new[](size_t size) { return allocate_or_throw(size, DEFAULT_ALIGNMENT); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate_or_null(size, DEFAULT_ALIGNMENT); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate_or_null(size, DEFAULT_ALIGNMENT); }
+void* operator new(size_t size, std::align_val_t alignment) {
+    return allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return allocate_or_throw(size, static_cast<size_t>(alignment));
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate_or_null(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocate_or_null(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* pointer) noexcept { deallocate(pointer, DEFAULT_ALIGNMENT); }
+void operator delete[](void* pointer) noexcept { deallocate(pointer, DEFAULT_ALIGNMENT); }
+void operator delete(void* pointer, size_t) noexcept { deallocate(pointer, DEFAULT_ALIGNMENT); }
+void operator delete[](void* pointer, size_t) noexcept { deallocate(pointer, DEFAULT_ALIGNMENT); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer, DEFAULT_ALIGNMENT); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { deallocate(pointer, DEFAULT_ALIGNMENT); }
+void operator delete(void* pointer, std::align_val_t alignment) noexcept {
+    deallocate(pointer, static_cast<size_t>(alignment));
+}
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept {
+    deallocate(pointer, static_cast<size_t>(alignment));
+}
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept {
+    deallocate(pointer, static_cast<size_t>(alignment));
+}
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept {
+    deallocate(pointer, static_cast<size_t>(alignment));
+}
+void operator delete(void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    deallocate(pointer, static_cast<size_t>(alignment));
+}
+void operator delete[](void* pointer, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    deallocate(pointer, static_cast<size_t>(alignment));
+}
+
+// Public interface
+
+AllocGuardCounts this_thread_alloc_counts() noexcept {
+    return t_counters.counts;
+}
+
+bool alloc_guard_wraps_malloc() noexcept {
+#ifdef ALLOC_GUARD_WRAP_MALLOC
+    return true;
+#else
+    return false;
+#endif
+}
+
+NoAllocScope::NoAllocScope(AllocGuardMode mode) noexcept : start_(t_counters.counts), mode_(mode) {
+    if (mode_ == AllocGuardMode::Abort) {
+        t_counters.abort_depth++;
+    }
+}
+
+NoAllocScope::~NoAllocScope() {
+    if (mode_ == AllocGuardMode::Abort && t_counters.abort_depth > 0) {
+        t_counters.abort_depth--;
+    }
+}
+
+uint64_t NoAllocScope::allocations() const noexcept {
+    return t_counters.counts.allocations - start_.allocations;
+}
+
+uint64_t NoAllocScope::deallocations() const noexcept {
+    return t_counters.counts.deallocations - start_.deallocations;
+}
+
+uint64_t NoAllocScope::bytes() const noexcept {
+    return t_counters.counts.bytes - start_.bytes;
+}
@@ -0,0 +1,124 @@
+#include "../include/deadline_ring.h"
+#include "queue_benchmarks.h"
+#include "ring_buffer.h"
+#include "tsc_clock.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+struct Quote {
+    uint64_t deadline = 0;
+    uint64_t sent = 0;     // When the quote left the exchange
+    uint64_t price = 0;
+};
+
+constexpr size_t CAPACITY = 4096;
+constexpr double TTL_NS = 50000.0;
+constexpr double HANDLE_NS = 1000.0;
+// One quote in LATE_EVERY has been held up upstream for twice the TTL
+constexpr uint64_t LATE_EVERY = 8;
+
+// Every quote is handed to the consumer, however old
+struct PlainRing {
+    RingBuffer<Quote, CAPACITY> ring;
+
+    explicit PlainRing(bool) {}
+    bool push(const Quote& quote, uint64_t) { return ring.try_enqueue(quote); }
+    bool pop(Quote& quote, uint64_t) { return ring.try_dequeue(quote); }
+    uint64_t expired() const { return 0; }
+    uint64_t refused() const { return 0; }
+};
+
+struct Deadline {
+    DeadlineRing<Quote, CAPACITY> ring;
+
+    explicit Deadline(bool refuse_stale) : ring(refuse_stale) {}
+    bool push(const Quote& quote, uint64_t now) { return ring.try_enqueue(quote, now); }
+    bool pop(Quote& quote, uint64_t now) { return ring.try_dequeue(quote, now); }
+    uint64_t expired() const { return ring.expired(); }
+    uint64_t refused() const { return ring.refused(); }
+};
+
+/**
+ * @brief A consumer that can handle one quote per microsecond, fed faster than that
+ *
+ * One thread plays both sides, so the numbers are free of scheduler noise.
+ * Each iteration, state.range(0) quotes arrive, each with a 50 us deadline
+ * from the time it left the exchange, and the consumer takes one and spends
+ * 1 us on it. state.range(1) makes the producer refuse stale quotes. Reports
+ * the age of handled quotes, how many of them were already stale, and the
+ * drops per handled quote: ring full, expired in the ring, refused on arrival.
+ */
+template <typename Queue>
+static void BM_Overload(benchmark::State& state) {
+    const TscClock& clock = TscClock::shared();
+    const uint64_t ttl = clock.to_ticks(TTL_NS);
+    const uint64_t handle_ticks = clock.to_ticks(HANDLE_NS);
+    const uint64_t arrivals = static_cast<uint64_t>(state.range(0));
+    auto queue = std::make_unique<Queue>(state.range(1) != 0);
+
+    std::vector<uint64_t> samples_ns;
+    samples_ns.reserve(1 << 22);
+    uint64_t sequence = 0;
+    uint64_t full = 0;
+    uint64_t handled = 0;
+    uint64_t stale_handled = 0;
+    uint64_t sink = 0;
+    for (auto _ : state) {
+        uint64_t now = read_tsc();
+        for (uint64_t i = 0; i < arrivals; ++i) {
+            const uint64_t sent = ++sequence % LATE_EVERY == 0 ? now - 2 * ttl : now;
+            if (!queue->push(Quote{sent + ttl, sent, sequence}, now)) {
+                ++full;
+            }
+        }
+        now = read_tsc();
+        Quote quote;
+        if (queue->pop(quote, now)) {
+            const uint64_t age = now - quote.sent;
+            samples_ns.push_back(static_cast<uint64_t>(clock.to_ns(age)));
+            stale_handled += age >= ttl ? 1 : 0;
+            ++handled;
+            // Handling the quote
+            while (read_tsc() - now < handle_ticks) {
+                sink += quote.price;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(sink);
+    // push() also fails for a refused quote; those are counted apart
+    full -= queue->refused();
+    const double per_handled = handled > 0 ? static_cast<double>(handled) : 1.0;
+    queue_bench::report_percentiles(state, samples_ns);
+    state.counters["stale_handled"] = static_cast<double>(stale_handled) / per_handled;
+    state.counters["full_drops"] = static_cast<double>(full) / per_handled;
+    state.counters["expired"] = static_cast<double>(queue->expired()) / per_handled;
+    state.counters["refused"] = static_cast<double>(queue->refused()) / per_handled;
+    state.SetItemsProcessed(static_cast<int64_t>(handled));
+}
+
+// Cost of one enqueue/dequeue pair with nothing expiring
+template <typename Queue>
+static void BM_RoundTrip(benchmark::State& state) {
+    auto queue = std::make_unique<Queue>(false);
+    const Quote fresh{~uint64_t{0}, 0, 1};
+    Quote quote;
+    for (auto _ : state) {
+        const uint64_t now = read_tsc();
+        queue->push(fresh, now);
+        queue->pop(quote, now);
+        benchmark::DoNotOptimize(quote);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_Overload, PlainRing)->Args({2, 0})->Args({4, 0})->Name("BM_Overload/RingBuffer");
+BENCHMARK_TEMPLATE(BM_Overload, Deadline)->Args({2, 0})->Args({4, 0})->Name("BM_Overload/DeadlineRing");
+BENCHMARK_TEMPLATE(BM_Overload, Deadline)->Args({2, 1})->Args({4, 1})->Name("BM_Overload/DeadlineRing/refuse");
+
+BENCHMARK_TEMPLATE(BM_RoundTrip, PlainRing)->Name("BM_RoundTrip/RingBuffer");
+BENCHMARK_TEMPLATE(BM_RoundTrip, Deadline)->Name("BM_RoundTrip/DeadlineRing");
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
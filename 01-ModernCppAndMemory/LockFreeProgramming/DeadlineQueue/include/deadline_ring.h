@@ -0,0 +1,212 @@
+/**
+ * @file deadline_ring.h
+ * @brief SPSC ring whose elements carry a TSC deadline; expired ones are dropped, not returned
+ *
+ * A quote that has waited too long in a queue is worth nothing, and handling
+ * it takes time from the fresh quotes behind it. Under overload, a plain
+ * RingBuffer hands every one of them to the consumer anyway, so the backlog
+ * and the age of what is handled keep growing. DeadlineRing::try_dequeue()
+ * skips every expired element in front of the first fresh one and releases
+ * them all with a single store.
+ *
+ * The deadlines are kept in an array of their own, next to the slots, so the
+ * skip reads eight deadlines per cache line and never touches the skipped
+ * messages.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "concurrency_primitives.h"
+#include "tsc_clock.h"
+
+/**
+ * @brief Reads the deadline from a `deadline` member
+ *
+ * The default for DeadlineRing; pass another functor for messages that keep
+ * their deadline under a different name, or derive it from a timestamp.
+ */
+struct DeadlineMember {
+    template <typename T>
+    uint64_t operator()(const T& value) const noexcept {
+        return value.deadline;
+    }
+};
+
+/**
+ * @brief Single-producer, single-consumer ring that drops elements past their deadline
+ *
+ * An element with deadline d is expired once the TSC reaches d. Expired
+ * elements are counted in expired() and never returned. With refuse_stale
+ * set, try_enqueue() also refuses elements that are already expired, and
+ * counts them in refused().
+ *
+ * @tparam T The type of elements stored in the ring
+ * @tparam Capacity The fixed capacity of the ring (must be a power of 2)
+ * @tparam DeadlineOf Functor returning an element's deadline in TSC ticks
+ */
+template <typename T, size_t Capacity, typename DeadlineOf = DeadlineMember>
+class DeadlineRing {
+    static_assert(Capacity > 0, "Capacity must be greater than 0");
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+    static_assert(std::is_move_constructible_v<T>, "T must be move constructible");
+
+public:
+    using value_type = T;
+
+    /**
+     * @param refuse_stale Make try_enqueue() refuse elements whose deadline has passed
+     */
+    explicit DeadlineRing(bool refuse_stale = false) noexcept : refuse_stale_(refuse_stale) {
+        head_.data.store(0, std::memory_order_relaxed);
+        tail_.data.store(0, std::memory_order_relaxed);
+        expired_.store(0, std::memory_order_relaxed);
+        refused_.store(0, std::memory_order_relaxed);
+    }
+
+    DeadlineRing(const DeadlineRing&) = delete;
+    DeadlineRing& operator=(const DeadlineRing&) = delete;
+
+    /**
+     * @brief Enqueues an element; producer only
+     *
+     * Reads the TSC only when refuse_stale is set.
+     *
+     * @return false if the ring is full, or if the element is stale and refuse_stale is set
+     */
+    template <typename U>
+    bool try_enqueue(U&& value) noexcept {
+        return try_enqueue(std::forward<U>(value), refuse_stale_ ? read_tsc() : 0);
+    }
+
+    /**
+     * @brief As try_enqueue(U&&), with the producer's own reading of the TSC
+     */
+    template <typename U>
+    bool try_enqueue(U&& value, uint64_t now) noexcept {
+        const uint64_t deadline = deadline_of_(value);
+        if (refuse_stale_ && deadline <= now) {
+            refused_.store(refused_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        const size_t head = head_.data.load(std::memory_order_relaxed);
+        if (head - tail_.data.load(std::memory_order_acquire) >= Capacity) {
+            return false;
+        }
+        buffer_[head & MASK] = std::forward<U>(value);
+        deadlines_[head & MASK] = deadline;
+        head_.data.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Takes the oldest element whose deadline is still ahead of now; consumer only
+     *
+     * Every expired element in front of it is skipped and counted, in one
+     * pass over the deadlines, and released together with it.
+     *
+     * @return false if every element in the ring had expired (they are all dropped)
+     */
+    bool try_dequeue(T& result, uint64_t now = read_tsc()) noexcept {
+        const size_t tail = tail_.data.load(std::memory_order_relaxed);
+        const size_t head = head_.data.load(std::memory_order_acquire);
+        const size_t next = skip_expired(tail, head, now);
+        if (next == head) {
+            if (next != tail) {
+                tail_.data.store(next, std::memory_order_release);
+            }
+            return false;
+        }
+        result = std::move(buffer_[next & MASK]);
+        tail_.data.store(next + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Drops every expired element at the front without taking a fresh one; consumer only
+     *
+     * @return The number of elements dropped
+     */
+    size_t purge(uint64_t now = read_tsc()) noexcept {
+        const size_t tail = tail_.data.load(std::memory_order_relaxed);
+        const size_t head = head_.data.load(std::memory_order_acquire);
+        const size_t next = skip_expired(tail, head, now);
+        if (next != tail) {
+            tail_.data.store(next, std::memory_order_release);
+        }
+        return next - tail;
+    }
+
+    /**
+     * @brief Elements in the ring, expired or not; a snapshot
+     */
+    size_t size() const noexcept {
+        const size_t head = head_.data.load(std::memory_order_acquire);
+        const size_t tail = tail_.data.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Elements dropped by the consumer because their deadline passed in the ring
+     */
+    uint64_t expired() const noexcept {
+        return expired_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Elements the producer refused because they were stale on arrival
+     */
+    uint64_t refused() const noexcept {
+        return refused_.load(std::memory_order_relaxed);
+    }
+
+    bool refuses_stale() const noexcept {
+        return refuse_stale_;
+    }
+
+    static constexpr size_t capacity() noexcept {
+        return Capacity;
+    }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    /**
+     * @brief Returns the position of the first element at or after tail that has not expired, or head
+     */
+    size_t skip_expired(size_t tail, size_t head, uint64_t now) noexcept {
+        size_t next = tail;
+        while (next != head && deadlines_[next & MASK] <= now) {
+            ++next;
+        }
+        if (next != tail) {
+            // Only the consumer writes the counter, so a plain add is enough
+            expired_.store(expired_.load(std::memory_order_relaxed) + (next - tail), std::memory_order_relaxed);
+        }
+        return next;
+    }
+
+    // Producer side: head, then a line the consumer never writes
+    CacheLineAligned<std::atomic<size_t>> head_;
+    std::atomic<uint64_t> refused_;
+    const bool refuse_stale_;
+    NO_UNIQUE_ADDRESS DeadlineOf deadline_of_;
+
+    // Consumer side: tail, then its drop count
+    CacheLineAligned<std::atomic<size_t>> tail_;
+    std::atomic<uint64_t> expired_;
+
+    // Deadlines in TSC ticks, parallel to buffer_
+    alignas(CACHE_LINE_SIZE) std::array<uint64_t, Capacity> deadlines_{};
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> buffer_{};
+};
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../include/deadline_ring.h"
+#include "tsc_clock.h"
+
+struct Quote {
+    uint64_t deadline = 0;
+    uint64_t sent = 0;
+    uint32_t symbol = 0;
+};
+
+int main() {
+    std::cout << "Deadline Ring Demo\n";
+    std::cout << "==================\n\n";
+
+    const TscClock& clock = TscClock::shared();
+    const uint64_t ttl = clock.to_ticks(50000.0);      // A quote is useless after 50 us
+    const uint64_t handle = clock.to_ticks(2000.0);    // The strategy needs 2 us per quote
+
+    auto ring = std::make_unique<DeadlineRing<Quote, 4096>>();
+    std::atomic<bool> stop{false};
+    uint64_t full = 0;
+
+    // The feed handler bursts far faster than the strategy can keep up
+    std::thread feed([&]() {
+        for (uint32_t symbol = 0; !stop.load(std::memory_order_relaxed); ++symbol) {
+            const uint64_t now = read_tsc();
+            if (!ring->try_enqueue(Quote{now + ttl, now, symbol % 500}, now)) {
+                ++full;
+            }
+            if (symbol % 64 == 0) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::vector<double> ages_us;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+    Quote quote;
+    while (std::chrono::steady_clock::now() < deadline) {
+        const uint64_t now = read_tsc();
+        if (ring->try_dequeue(quote, now)) {
+            ages_us.push_back(clock.to_ns(now - quote.sent) / 1000.0);
+            while (read_tsc() - now < handle) {
+                // Pricing the quote
+            }
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    stop.store(true, std::memory_order_relaxed);
+    feed.join();
+
+    std::sort(ages_us.begin(), ages_us.end());
+    std::cout << "Handled: " << ages_us.size() << " quotes\n";
+    std::cout << "Expired in the ring: " << ring->expired() << ", ring full: " << full << "\n";
+    if (!ages_us.empty()) {
+        std::cout << "Age when handled: p50 " << ages_us[ages_us.size() / 2] << " us, max " << ages_us.back()
+                  << " us (TTL 50 us)\n";
+    }
+    return 0;
+}
@@ -0,0 +1,158 @@
+#include "../include/deadline_ring.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+struct Quote {
+    uint64_t deadline = 0;
+    uint64_t id = 0;
+};
+
+using QuoteRing = DeadlineRing<Quote, 8>;
+
+// Test that fresh elements come out in FIFO order and nothing is counted as dropped
+TEST(DeadlineRingTest, FreshElementsInOrder) {
+    QuoteRing ring;
+    for (uint64_t i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(ring.try_enqueue(Quote{1000, i}));
+    }
+    Quote quote;
+    for (uint64_t i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(ring.try_dequeue(quote, 500));
+        EXPECT_EQ(quote.id, i);
+    }
+    EXPECT_FALSE(ring.try_dequeue(quote, 500));
+    EXPECT_EQ(ring.expired(), 0u);
+}
+
+// Test that expired elements in front of a fresh one are skipped in one call and counted
+TEST(DeadlineRingTest, SkipsExpiredInFront) {
+    QuoteRing ring;
+    ASSERT_TRUE(ring.try_enqueue(Quote{100, 1}));
+    ASSERT_TRUE(ring.try_enqueue(Quote{200, 2}));
+    ASSERT_TRUE(ring.try_enqueue(Quote{300, 3}));
+    ASSERT_TRUE(ring.try_enqueue(Quote{400, 4}));
+
+    Quote quote;
+    ASSERT_TRUE(ring.try_dequeue(quote, 250));
+    EXPECT_EQ(quote.id, 3u);
+    EXPECT_EQ(ring.expired(), 2u);
+    EXPECT_EQ(ring.size(), 1u);
+
+    // A deadline equal to now has expired
+    EXPECT_FALSE(ring.try_dequeue(quote, 400));
+    EXPECT_EQ(ring.expired(), 3u);
+    EXPECT_TRUE(ring.empty());
+}
+
+// Test that a stale element behind a fresh one is only dropped once it reaches the front
+TEST(DeadlineRingTest, OnlyTheFrontIsScanned) {
+    QuoteRing ring;
+    ASSERT_TRUE(ring.try_enqueue(Quote{1000, 1}));
+    ASSERT_TRUE(ring.try_enqueue(Quote{100, 2}));
+    ASSERT_TRUE(ring.try_enqueue(Quote{1000, 3}));
+
+    Quote quote;
+    ASSERT_TRUE(ring.try_dequeue(quote, 500));
+    EXPECT_EQ(quote.id, 1u);
+    EXPECT_EQ(ring.expired(), 0u);
+    ASSERT_TRUE(ring.try_dequeue(quote, 500));
+    EXPECT_EQ(quote.id, 3u);
+    EXPECT_EQ(ring.expired(), 1u);
+}
+
+// Test that purge() frees the slots of expired elements, so a full ring takes new ones again
+TEST(DeadlineRingTest, PurgeFreesSlots) {
+    QuoteRing ring;
+    for (uint64_t i = 0; i < QuoteRing::capacity(); ++i) {
+        ASSERT_TRUE(ring.try_enqueue(Quote{100 + i, i}));
+    }
+    EXPECT_FALSE(ring.try_enqueue(Quote{1000, 99}));
+
+    EXPECT_EQ(ring.purge(104), 5u);
+    EXPECT_EQ(ring.size(), QuoteRing::capacity() - 5);
+    for (uint64_t i = 0; i < 5; ++i) {
+        EXPECT_TRUE(ring.try_enqueue(Quote{1000, 100 + i}));
+    }
+    EXPECT_FALSE(ring.try_enqueue(Quote{1000, 99}));
+    EXPECT_EQ(ring.purge(104), 0u);
+}
+
+// Test that refuse_stale turns away elements already past their deadline, and only then
+TEST(DeadlineRingTest, RefuseStale) {
+    QuoteRing lenient;
+    EXPECT_TRUE(lenient.try_enqueue(Quote{100, 1}, 200));
+    EXPECT_EQ(lenient.refused(), 0u);
+
+    QuoteRing strict(true);
+    EXPECT_TRUE(strict.refuses_stale());
+    EXPECT_FALSE(strict.try_enqueue(Quote{100, 1}, 200));
+    EXPECT_FALSE(strict.try_enqueue(Quote{200, 2}, 200));
+    EXPECT_TRUE(strict.try_enqueue(Quote{300, 3}, 200));
+    EXPECT_EQ(strict.refused(), 2u);
+    EXPECT_EQ(strict.size(), 1u);
+
+    // Without an explicit now, the producer reads the TSC
+    EXPECT_FALSE(strict.try_enqueue(Quote{0, 4}));
+    EXPECT_TRUE(strict.try_enqueue(Quote{~uint64_t{0}, 5}));
+    EXPECT_EQ(strict.refused(), 3u);
+}
+
+// Test that a custom functor can derive the deadline from a timestamp
+TEST(DeadlineRingTest, CustomDeadlineOf) {
+    struct Stamped {
+        uint64_t sent = 0;
+    };
+    struct SentPlusTtl {
+        uint64_t operator()(const Stamped& value) const noexcept {
+            return value.sent + 50;
+        }
+    };
+    DeadlineRing<Stamped, 4, SentPlusTtl> ring;
+    ASSERT_TRUE(ring.try_enqueue(Stamped{10}));
+    ASSERT_TRUE(ring.try_enqueue(Stamped{100}));
+    Stamped value;
+    ASSERT_TRUE(ring.try_dequeue(value, 60));
+    EXPECT_EQ(value.sent, 100u);
+    EXPECT_EQ(ring.expired(), 1u);
+}
+
+// Test that every element is either delivered in order or counted as expired, with the producer on another thread
+TEST(DeadlineRingTest, ConcurrentProducerConsumer) {
+    constexpr uint64_t COUNT = 200000;
+    DeadlineRing<Quote, 256> ring;
+
+    // Ids divisible by 3 are born expired; the consumer's clock stays at 1000
+    std::thread producer([&]() {
+        for (uint64_t i = 0; i < COUNT; ++i) {
+            const Quote quote{i % 3 == 0 ? uint64_t{0} : uint64_t{2000}, i};
+            while (!ring.try_enqueue(quote)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t received = 0;
+    uint64_t last = 0;
+    bool in_order = true;
+    Quote quote;
+    while (received + ring.expired() < COUNT) {
+        if (ring.try_dequeue(quote, 1000)) {
+            in_order = in_order && (received == 0 || quote.id > last) && quote.id % 3 != 0;
+            last = quote.id;
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(ring.expired(), (COUNT + 2) / 3);
+    EXPECT_EQ(received, COUNT - ring.expired());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
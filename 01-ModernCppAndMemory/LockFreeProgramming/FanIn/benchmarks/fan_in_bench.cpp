@@ -0,0 +1,101 @@
+#include "../include/fan_in_queue.h"
+#include "mpmc_queue.h"
+#include "queue_benchmarks.h"
+#include "thread_slot.h"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <string>
+
+/**
+ * @brief Presents a FanInQueue as a ConcurrentQueue, so the shared MPSC runs can drive it
+ *
+ * Each producer thread gets its own lane on first use, found through its
+ * thread slot. The consumer takes items one at a time round-robin, or, with
+ * Batched, refills a local buffer with drain().
+ */
+template <typename T, size_t LaneCapacity, bool Batched>
+class FanInAdapter {
+public:
+    using value_type = T;
+    static constexpr bool multi_consumer = false;
+
+    // One drain() pass visits at most LANES lanes, so a batch always fits the buffer
+    static constexpr size_t LANES = 16;
+    static constexpr size_t PER_LANE = 8;
+    static constexpr size_t BATCH = LANES * PER_LANE;
+
+    bool try_enqueue(const T& value) noexcept {
+        // Only the thread holding the slot touches its entry
+        auto& lane = lanes_[this_thread_slot()];
+        if (lane == nullptr) {
+            lane = queue_.register_lane();
+        }
+        return lane->try_enqueue(value);
+    }
+
+    bool try_dequeue(T& result) noexcept {
+        if constexpr (Batched) {
+            if (next_ == count_) {
+                next_ = 0;
+                count_ = 0;
+                queue_.drain([this](T&& value) { buffer_[count_++] = std::move(value); }, PER_LANE);
+                if (count_ == 0) {
+                    return false;
+                }
+            }
+            result = std::move(buffer_[next_++]);
+            return true;
+        } else {
+            return queue_.try_dequeue(result);
+        }
+    }
+
+    bool empty() const noexcept {
+        return next_ == count_ && queue_.empty();
+    }
+
+    constexpr size_t capacity() const noexcept {
+        return LaneCapacity;
+    }
+
+private:
+    FanInQueue<T, LaneCapacity, LANES> queue_;
+    std::array<typename FanInQueue<T, LaneCapacity, LANES>::Lane*, MAX_THREAD_SLOTS> lanes_{};
+
+    // Consumer-side batch (Batched only)
+    std::array<T, BATCH> buffer_{};
+    size_t next_ = 0;
+    size_t count_ = 0;
+};
+
+struct FanInRoundRobinFamily {
+    template <typename T, size_t Capacity>
+    using queue = FanInAdapter<T, Capacity, false>;
+};
+
+struct FanInBatchedFamily {
+    template <typename T, size_t Capacity>
+    using queue = FanInAdapter<T, Capacity, true>;
+};
+
+struct MPMCQueueFamily {
+    template <typename T, size_t Capacity>
+    using queue = MPMCQueue<T, Capacity>;
+};
+
+// Many producers, one consumer: the shared head_ against one lane per producer
+template <typename Family>
+static void register_mpsc(const std::string& name) {
+    using IntQueue = typename Family::template queue<int, queue_bench::kMatrixCapacity>;
+    for (int producers : {2, 4, 8, 16}) {
+        benchmark::RegisterBenchmark((name + "/MPSC").c_str(), queue_bench::BM_MultiThreaded<IntQueue>)
+            ->Args({producers, 1})->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond);
+    }
+}
+
+int main(int argc, char** argv) {
+    register_mpsc<MPMCQueueFamily>("MPMCQueue");
+    register_mpsc<FanInRoundRobinFamily>("FanInRoundRobin");
+    register_mpsc<FanInBatchedFamily>("FanInBatched");
+    return queue_bench::run_benchmarks(argc, argv);
+}
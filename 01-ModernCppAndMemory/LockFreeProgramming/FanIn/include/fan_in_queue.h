@@ -0,0 +1,277 @@
+/**
+ * @file fan_in_queue.h
+ * @brief Multi-producer, single-consumer fan-in over per-producer SPSC lanes
+ *
+ * With MPMCQueue used as an MPSC queue, every producer competes for the same
+ * head_ with a CAS, and the line holding it moves between cores on every
+ * push. Here each producer owns a lane, an SPSC RingBuffer, so producers never
+ * write to a line another producer writes. The single consumer polls the
+ * lanes, one item at a time round-robin or a batch per lane.
+ *
+ * A ready bitmask, one bit per lane, lets the consumer find lanes that may
+ * hold items with one load, and skip idle lanes without touching them.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "concurrency_primitives.h"
+#include "ready_mask.h"
+#include "ring_buffer.h"
+
+/**
+ * @brief Fan-in of up to MaxLanes SPSC lanes into one consumer
+ *
+ * Producers call register_lane() once, push through the returned Lane, and
+ * call unregister_lane() when they are done. One thread at a time may
+ * consume, with try_dequeue() or drain().
+ *
+ * @tparam T The type of elements stored in the queue
+ * @tparam LaneCapacity Capacity of each lane (must be a power of 2)
+ * @tparam MaxLanes Lanes that can be registered at once (at most 64, one bit each)
+ */
+template <typename T, size_t LaneCapacity, size_t MaxLanes = 64>
+class FanInQueue {
+    static_assert(MaxLanes > 0 && MaxLanes <= 64, "MaxLanes must be between 1 and 64");
+
+public:
+    using value_type = T;
+
+    /**
+     * @brief One producer's lane; only its owner may push to it
+     */
+    class Lane {
+    public:
+        /**
+         * @brief Pushes an item into this lane
+         *
+         * @return false if the lane is full
+         */
+        template <typename U>
+        bool try_enqueue(U&& value) noexcept {
+            if (!ring_.try_enqueue(std::forward<U>(value))) {
+                return false;
+            }
+            owner_.ready_.mark(index_);
+            return true;
+        }
+
+        size_t index() const noexcept {
+            return index_;
+        }
+
+        size_t size() const noexcept {
+            return ring_.size();
+        }
+
+    private:
+        friend class FanInQueue;
+
+        explicit Lane(FanInQueue& owner) noexcept : owner_(owner) {}
+
+        RingBuffer<T, LaneCapacity> ring_;
+        FanInQueue& owner_;
+        size_t index_ = 0;
+        // Set by unregister_lane(); the consumer frees the lane once it is drained
+        std::atomic<bool> retired_{false};
+    };
+
+    FanInQueue() noexcept {
+        for (auto& lane : lanes_) {
+            lane.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    FanInQueue(const FanInQueue&) = delete;
+    FanInQueue& operator=(const FanInQueue&) = delete;
+
+    /**
+     * @brief Frees every lane, including items never dequeued
+     */
+    ~FanInQueue() {
+        for (auto& lane : lanes_) {
+            delete lane.load(std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Claims a free lane for the calling producer; callable from any thread
+     *
+     * Allocates the lane, so call it at startup rather than on the hot path.
+     *
+     * @return The new lane, or nullptr if all MaxLanes are taken
+     */
+    Lane* register_lane() {
+        std::unique_ptr<Lane> lane(new Lane(*this));
+        for (size_t i = 0; i < MaxLanes; ++i) {
+            Lane* expected = nullptr;
+            if (lanes_[i].load(std::memory_order_relaxed) != nullptr) {
+                continue;
+            }
+            lane->index_ = i;
+            // Release: a consumer that finds the lane sees it fully built
+            if (lanes_[i].compare_exchange_strong(expected, lane.get(), std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+                return lane.release();
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Hands a lane back; the producer must not touch it afterwards
+     *
+     * Items still in the lane are delivered as usual. The consumer frees the
+     * lane, and its index becomes available again, once it is drained.
+     */
+    void unregister_lane(Lane* lane) noexcept {
+        // The consumer may free the lane as soon as it sees retired_, so read the index first
+        const size_t index = lane->index_;
+        lane->retired_.store(true, std::memory_order_release);
+        ready_.mark(index);
+    }
+
+    /**
+     * @brief Takes one item, visiting ready lanes round-robin
+     *
+     * Each call starts at the lane after the one that last delivered an item,
+     * so a busy producer cannot starve the others.
+     *
+     * @return false if every lane is empty
+     */
+    bool try_dequeue(T& result) noexcept {
+        uint64_t ready = ready_.load();
+        while (ready != 0) {
+            const uint64_t after_cursor = ready & (~uint64_t{0} << cursor_);
+            const size_t index = static_cast<size_t>(std::countr_zero(after_cursor != 0 ? after_cursor : ready));
+            ready &= ~(uint64_t{1} << index);
+
+            Lane* lane = lanes_[index].load(std::memory_order_acquire);
+            if (lane == nullptr) {
+                settle_free(index);
+                continue;
+            }
+            if (lane->ring_.try_dequeue(result)) {
+                cursor_ = (index + 1) % MaxLanes;
+                return true;
+            }
+            settle(index, lane);
+        }
+        return false;
+    }
+
+    /**
+     * @brief Takes up to max_per_lane items from every ready lane, in lane order
+     *
+     * Reads the bitmask once for the whole pass, so it costs less per item
+     * than try_dequeue() when lanes hold several items each.
+     *
+     * @param handler Called with each item, as handler(T&&)
+     * @return The number of items handed to handler
+     */
+    template <typename Handler>
+    size_t drain(Handler&& handler, size_t max_per_lane = 64) {
+        uint64_t ready = ready_.load();
+        size_t total = 0;
+        T value;
+        while (ready != 0) {
+            const size_t index = static_cast<size_t>(std::countr_zero(ready));
+            ready &= ready - 1;
+
+            Lane* lane = lanes_[index].load(std::memory_order_acquire);
+            if (lane == nullptr) {
+                settle_free(index);
+                continue;
+            }
+            size_t taken = 0;
+            while (taken < max_per_lane && lane->ring_.try_dequeue(value)) {
+                handler(std::move(value));
+                ++taken;
+            }
+            if (taken < max_per_lane) {
+                settle(index, lane);
+            }
+            total += taken;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Whether every lane is empty; exact only on the consumer's thread with producers idle
+     */
+    bool empty() const noexcept {
+        for (const auto& slot : lanes_) {
+            const Lane* lane = slot.load(std::memory_order_acquire);
+            if (lane != nullptr && !lane->ring_.empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Lanes that may hold items, one bit per lane index
+     */
+    uint64_t ready_mask() const noexcept {
+        return ready_.load();
+    }
+
+    /**
+     * @brief Lanes currently registered, including retired lanes not yet drained
+     */
+    size_t lane_count() const noexcept {
+        size_t count = 0;
+        for (const auto& slot : lanes_) {
+            count += slot.load(std::memory_order_relaxed) != nullptr ? 1 : 0;
+        }
+        return count;
+    }
+
+    static constexpr size_t lane_capacity() noexcept {
+        return LaneCapacity;
+    }
+
+    static constexpr size_t max_lanes() noexcept {
+        return MaxLanes;
+    }
+
+private:
+    /**
+     * @brief Clears the bit of a lane found empty, and frees the lane if it was retired
+     */
+    void settle(size_t index, Lane* lane) noexcept {
+        // Read before the emptiness check: once retired, nothing more will arrive
+        const bool retired = lane->retired_.load(std::memory_order_acquire);
+        if (!ready_.settle(index, [lane]() { return !lane->ring_.empty(); }) && retired) {
+            lanes_[index].store(nullptr, std::memory_order_release);
+            delete lane;
+        }
+    }
+
+    /**
+     * @brief Clears the bit of a free index
+     *
+     * unregister_lane() sets the bit one last time, which can land after the
+     * lane was drained and freed. A new lane may also have been registered at
+     * the index meanwhile, so look again after clearing.
+     */
+    void settle_free(size_t index) noexcept {
+        ready_.settle(index, [this, index]() { return lanes_[index].load(std::memory_order_acquire) != nullptr; });
+    }
+
+    // Lanes that may hold items; written by producers only when a bit is clear
+    ReadyMask<MaxLanes> ready_;
+
+    // Registered lanes by index; written only on registration and when a retired lane is freed
+    alignas(CACHE_LINE_SIZE) std::array<std::atomic<Lane*>, MaxLanes> lanes_;
+
+    // Lane the next try_dequeue() starts from (consumer only)
+    alignas(CACHE_LINE_SIZE) size_t cursor_ = 0;
+};
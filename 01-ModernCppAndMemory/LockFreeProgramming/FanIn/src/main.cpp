@@ -0,0 +1,83 @@
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../include/fan_in_queue.h"
+
+struct Quote {
+    uint16_t venue = 0;
+    uint16_t session = 0;
+    uint32_t sequence = 0;
+    int64_t bid = 0;
+    int64_t ask = 0;
+};
+
+int main() {
+    std::cout << "Fan-In Queue Demo\n";
+    std::cout << "=================\n\n";
+
+    constexpr size_t VENUES = 4;
+    constexpr uint32_t QUOTES = 200000;
+
+    // One feed handler per venue, each with its own lane into the book builder
+    FanInQueue<Quote, 1024, 8> quotes;
+    std::atomic<size_t> feeds_done{0};
+    std::vector<std::thread> feeds;
+    for (uint32_t venue = 0; venue < VENUES; ++venue) {
+        feeds.emplace_back([&, venue]() {
+            auto* lane = quotes.register_lane();
+            uint16_t session = 0;
+            uint32_t sequence = 0;
+            for (uint32_t i = 0; i < QUOTES; ++i) {
+                // Venue 3 drops its session halfway and reconnects on a fresh lane.
+                // Order only holds within a lane, which is why sequence numbers restart.
+                if (venue == 3 && i == QUOTES / 2) {
+                    quotes.unregister_lane(lane);
+                    lane = quotes.register_lane();
+                    ++session;
+                    sequence = 0;
+                }
+                Quote quote{static_cast<uint16_t>(venue), session, sequence++, 10000 + i % 50, 10001 + i % 50};
+                while (!lane->try_enqueue(quote)) {
+                    std::this_thread::yield();
+                }
+            }
+            quotes.unregister_lane(lane);
+            feeds_done.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    // The book builder drains a batch from every venue with data, skipping idle ones
+    std::array<std::array<uint32_t, 2>, VENUES> next{};  // Next sequence, per venue and session
+    std::array<uint32_t, VENUES> received{};
+    std::array<bool, VENUES> gap{};
+    size_t passes = 0;
+    while (true) {
+        const bool finished = feeds_done.load(std::memory_order_acquire) == VENUES;
+        const size_t taken = quotes.drain([&](Quote&& quote) {
+            gap[quote.venue] = gap[quote.venue] || quote.sequence != next[quote.venue][quote.session]++;
+            ++received[quote.venue];
+        });
+        ++passes;
+        if (taken == 0) {
+            if (finished && quotes.empty()) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+    for (auto& feed : feeds) {
+        feed.join();
+    }
+    quotes.drain([](Quote&&) {});  // Frees the lanes retired last
+
+    for (size_t venue = 0; venue < VENUES; ++venue) {
+        std::cout << "Venue " << venue << ": " << received[venue] << " quotes"
+                  << (gap[venue] ? " (sequence gap!)" : ", in sequence") << "\n";
+    }
+    std::cout << "Drain passes: " << passes << "\n";
+    std::cout << "Lanes still registered: " << quotes.lane_count() << "\n";
+    return 0;
+}
@@ -0,0 +1,213 @@
+#include "../include/fan_in_queue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using SmallFanIn = FanInQueue<uint64_t, 16, 4>;
+
+// Test that lanes get distinct indices until MaxLanes are taken
+TEST(FanInQueueTest, RegisterUpToMaxLanes) {
+    SmallFanIn queue;
+    std::vector<SmallFanIn::Lane*> lanes;
+    for (size_t i = 0; i < SmallFanIn::max_lanes(); ++i) {
+        lanes.push_back(queue.register_lane());
+        ASSERT_NE(lanes.back(), nullptr);
+        EXPECT_EQ(lanes.back()->index(), i);
+    }
+    EXPECT_EQ(queue.register_lane(), nullptr);
+    EXPECT_EQ(queue.lane_count(), SmallFanIn::max_lanes());
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.ready_mask(), 0u);
+}
+
+// Test that try_dequeue takes one item from each ready lane in turn
+TEST(FanInQueueTest, RoundRobin) {
+    SmallFanIn queue;
+    auto* a = queue.register_lane();
+    auto* b = queue.register_lane();
+    for (uint64_t i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(a->try_enqueue(i));
+        ASSERT_TRUE(b->try_enqueue(i * 10));
+    }
+
+    std::vector<uint64_t> order;
+    uint64_t value = 0;
+    while (queue.try_dequeue(value)) {
+        order.push_back(value);
+    }
+    EXPECT_EQ(order, (std::vector<uint64_t>{1, 10, 2, 20, 3, 30}));
+    EXPECT_EQ(queue.ready_mask(), 0u);
+}
+
+// Test that drain() takes at most max_per_lane items from each lane per pass
+TEST(FanInQueueTest, DrainBatchesPerLane) {
+    SmallFanIn queue;
+    auto* a = queue.register_lane();
+    auto* b = queue.register_lane();
+    for (uint64_t i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(a->try_enqueue(i));
+        ASSERT_TRUE(b->try_enqueue(i * 10));
+    }
+
+    std::vector<uint64_t> order;
+    auto collect = [&](uint64_t&& value) { order.push_back(value); };
+    EXPECT_EQ(queue.drain(collect, 2), 4u);
+    EXPECT_EQ(order, (std::vector<uint64_t>{1, 2, 10, 20}));
+    EXPECT_EQ(queue.ready_mask(), 0b11u);  // Both lanes still hold an item
+
+    EXPECT_EQ(queue.drain(collect, 2), 2u);
+    EXPECT_EQ(order, (std::vector<uint64_t>{1, 2, 10, 20, 3, 30}));
+    EXPECT_EQ(queue.ready_mask(), 0u);
+    EXPECT_EQ(queue.drain(collect), 0u);
+}
+
+// Test that only lanes with items have their bit set
+TEST(FanInQueueTest, ReadyMaskTracksLanes) {
+    SmallFanIn queue;
+    std::vector<SmallFanIn::Lane*> lanes;
+    for (size_t i = 0; i < 4; ++i) {
+        lanes.push_back(queue.register_lane());
+    }
+    ASSERT_TRUE(lanes[2]->try_enqueue(uint64_t{7}));
+    EXPECT_EQ(queue.ready_mask(), 0b100u);
+    ASSERT_TRUE(lanes[0]->try_enqueue(uint64_t{8}));
+    EXPECT_EQ(queue.ready_mask(), 0b101u);
+
+    uint64_t value = 0;
+    ASSERT_TRUE(queue.try_dequeue(value));
+    EXPECT_EQ(value, 8u);
+    ASSERT_TRUE(queue.try_dequeue(value));
+    EXPECT_EQ(value, 7u);
+    EXPECT_FALSE(queue.try_dequeue(value));
+    EXPECT_EQ(queue.ready_mask(), 0u);
+}
+
+// Test that a full lane refuses items without affecting the others
+TEST(FanInQueueTest, FullLane) {
+    SmallFanIn queue;
+    auto* a = queue.register_lane();
+    auto* b = queue.register_lane();
+    for (uint64_t i = 0; i < SmallFanIn::lane_capacity(); ++i) {
+        ASSERT_TRUE(a->try_enqueue(i));
+    }
+    EXPECT_FALSE(a->try_enqueue(uint64_t{99}));
+    EXPECT_EQ(a->size(), SmallFanIn::lane_capacity());
+    EXPECT_TRUE(b->try_enqueue(uint64_t{99}));
+}
+
+// Test that a retired lane is still drained, then freed so its index can be reused
+TEST(FanInQueueTest, UnregisterDrainsThenFrees) {
+    SmallFanIn queue;
+    auto* a = queue.register_lane();
+    auto* b = queue.register_lane();
+    ASSERT_TRUE(a->try_enqueue(uint64_t{1}));
+    ASSERT_TRUE(a->try_enqueue(uint64_t{2}));
+    queue.unregister_lane(a);
+    EXPECT_EQ(queue.lane_count(), 2u);
+
+    uint64_t value = 0;
+    ASSERT_TRUE(queue.try_dequeue(value));
+    EXPECT_EQ(value, 1u);
+    ASSERT_TRUE(queue.try_dequeue(value));
+    EXPECT_EQ(value, 2u);
+    EXPECT_FALSE(queue.try_dequeue(value));
+    EXPECT_EQ(queue.lane_count(), 1u);
+
+    // An idle lane that retires is freed on the next visit
+    queue.unregister_lane(b);
+    EXPECT_FALSE(queue.try_dequeue(value));
+    EXPECT_EQ(queue.lane_count(), 0u);
+
+    auto* c = queue.register_lane();
+    ASSERT_NE(c, nullptr);
+    EXPECT_EQ(c->index(), 0u);
+}
+
+// Producers push numbered items and re-register halfway; the consumer checks order per lane
+template <typename Consume>
+static void check_concurrent_fan_in(Consume&& consume_some) {
+    constexpr size_t PRODUCERS = 8;
+    constexpr uint64_t PER_PRODUCER = 50000;
+    FanInQueue<uint64_t, 256, 16> queue;
+
+    std::atomic<size_t> done{0};
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p]() {
+            auto* lane = queue.register_lane();
+            for (uint64_t i = 0; i < PER_PRODUCER; ++i) {
+                if (i == PER_PRODUCER / 2) {
+                    queue.unregister_lane(lane);
+                    while ((lane = queue.register_lane()) == nullptr) {
+                        std::this_thread::yield();
+                    }
+                }
+                while (!lane->try_enqueue((uint64_t{p} << 32) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+            queue.unregister_lane(lane);
+            done.fetch_add(1, std::memory_order_release);
+        });
+    }
+
+    // Order holds per lane: items from a producer's second lane may overtake
+    // what is left in its first, so track the two halves separately
+    std::vector<uint64_t> next(2 * PRODUCERS, 0);
+    for (size_t p = 0; p < PRODUCERS; ++p) {
+        next[2 * p + 1] = PER_PRODUCER / 2;
+    }
+    bool in_order = true;
+    uint64_t received = 0;
+    auto check = [&](uint64_t item) {
+        const size_t producer = static_cast<size_t>(item >> 32);
+        const uint64_t sequence = item & 0xFFFFFFFF;
+        const size_t lane = 2 * producer + (sequence >= PER_PRODUCER / 2 ? 1 : 0);
+        in_order = in_order && producer < PRODUCERS && sequence == next[lane]++;
+        ++received;
+    };
+    while (true) {
+        const bool finished = done.load(std::memory_order_acquire) == PRODUCERS;
+        if (consume_some(queue, check) == 0) {
+            if (finished && queue.empty()) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+    // One more pass frees lanes that retired after their last item was taken
+    consume_some(queue, check);
+
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(received, PRODUCERS * PER_PRODUCER);
+    EXPECT_EQ(queue.lane_count(), 0u);
+}
+
+// Test that try_dequeue delivers every item once, in order per lane
+TEST(FanInQueueTest, ConcurrentRoundRobin) {
+    check_concurrent_fan_in([](auto& queue, auto& check) -> size_t {
+        uint64_t value = 0;
+        size_t count = 0;
+        while (count < 64 && queue.try_dequeue(value)) {
+            check(value);
+            ++count;
+        }
+        return count;
+    });
+}
+
+// Test that drain() delivers every item once, in order per lane
+TEST(FanInQueueTest, ConcurrentDrain) {
+    check_concurrent_fan_in([](auto& queue, auto& check) -> size_t {
+        return queue.drain([&](uint64_t&& value) { check(value); }, 32);
+    });
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,196 @@
+#include "../include/key_dispatcher.h"
+#include "mpmc_queue.h"
+#include "queue_benchmarks.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+struct Update {
+    uint64_t symbol = 0;
+    uint64_t sequence = 0;
+};
+
+constexpr size_t CONSUMERS = 4;
+constexpr size_t SYMBOLS = 1024;
+constexpr size_t MESSAGES = 200000;
+
+/**
+ * @brief Symbol ids drawn from a Zipf distribution with exponent s (0 is uniform)
+ *
+ * Symbol ranks are shuffled onto ids, so the hottest symbols do not all
+ * land in neighbouring buckets.
+ */
+static std::vector<uint64_t> zipf_symbols(double s, size_t count) {
+    std::vector<double> cdf(SYMBOLS);
+    double total = 0.0;
+    for (size_t rank = 0; rank < SYMBOLS; ++rank) {
+        total += 1.0 / std::pow(static_cast<double>(rank + 1), s);
+        cdf[rank] = total;
+    }
+    std::vector<uint64_t> ids(SYMBOLS);
+    for (size_t i = 0; i < SYMBOLS; ++i) {
+        ids[i] = i;
+    }
+    std::mt19937_64 rng(42);
+    std::shuffle(ids.begin(), ids.end(), rng);
+
+    std::uniform_real_distribution<double> uniform(0.0, total);
+    std::vector<uint64_t> symbols(count);
+    for (auto& symbol : symbols) {
+        const size_t rank = static_cast<size_t>(std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)) - cdf.begin());
+        symbol = ids[std::min(rank, SYMBOLS - 1)];
+    }
+    return symbols;
+}
+
+// A book update: a little arithmetic on the symbol's own state
+static void apply_update(std::vector<uint64_t>& books, const Update& update) {
+    uint64_t value = books[update.symbol];
+    for (int i = 0; i < 32; ++i) {
+        value = value * 6364136223846793005ull + update.sequence;
+    }
+    books[update.symbol] = value;
+}
+
+/**
+ * @brief Consumer threads that live for the whole benchmark and count what each one applied
+ */
+class ConsumerThreads {
+public:
+    template <typename TakeBatch>
+    explicit ConsumerThreads(TakeBatch take_batch) {
+        for (size_t c = 0; c < CONSUMERS; ++c) {
+            applied_[c].data.store(0, std::memory_order_relaxed);
+            threads_.emplace_back([this, c, take_batch]() mutable {
+                queue_bench::pin_current_thread(static_cast<unsigned>(c + 1));
+                std::vector<uint64_t> books(SYMBOLS, 0);
+                unsigned spins = 0;
+                while (!stop_.load(std::memory_order_acquire)) {
+                    const size_t taken = take_batch(c, [&](Update&& update) { apply_update(books, update); });
+                    if (taken == 0) {
+                        queue_bench::relax(spins);
+                    } else {
+                        spins = 0;
+                        applied_[c].data.fetch_add(taken, std::memory_order_release);
+                    }
+                }
+            });
+        }
+    }
+
+    ~ConsumerThreads() {
+        stop_.store(true, std::memory_order_release);
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    uint64_t applied(size_t consumer) const noexcept {
+        return applied_[consumer].data.load(std::memory_order_acquire);
+    }
+
+    uint64_t total() const noexcept {
+        uint64_t sum = 0;
+        for (size_t c = 0; c < CONSUMERS; ++c) {
+            sum += applied(c);
+        }
+        return sum;
+    }
+
+    // The busiest consumer's share over the mean share: 1.0 is perfect balance
+    double imbalance() const noexcept {
+        uint64_t busiest = 0;
+        for (size_t c = 0; c < CONSUMERS; ++c) {
+            busiest = std::max(busiest, applied(c));
+        }
+        const double mean = static_cast<double>(total()) / CONSUMERS;
+        return mean > 0 ? static_cast<double>(busiest) / mean : 0.0;
+    }
+
+private:
+    std::array<CacheLineAligned<std::atomic<uint64_t>>, CONSUMERS> applied_;
+    std::atomic<bool> stop_{false};
+    std::vector<std::thread> threads_;
+};
+
+using Dispatcher = KeyDispatcher<Update, 1024, CONSUMERS>;
+
+// Key-affine dispatch; state.range(0) is the Zipf exponent x100, range(1) turns rebalancing on
+static void BM_KeyDispatch(benchmark::State& state) {
+    const double s = static_cast<double>(state.range(0)) / 100.0;
+    const bool rebalancing = state.range(1) != 0;
+    const auto symbols = zipf_symbols(s, MESSAGES);
+    auto dispatcher = std::make_unique<Dispatcher>();
+    ConsumerThreads consumers([&dispatcher](size_t c, auto&& handler) { return dispatcher->drain(c, handler, 32); });
+    queue_bench::pin_current_thread(0);
+
+    uint64_t sent = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < MESSAGES; ++i) {
+            const Update update{symbols[i], sent++};
+            unsigned spins = 0;
+            while (!dispatcher->try_dispatch(update)) {
+                queue_bench::relax(spins);
+            }
+            if (rebalancing && (i & 4095) == 0) {
+                dispatcher->rebalance();
+            }
+        }
+        unsigned spins = 0;
+        while (consumers.total() < sent) {
+            dispatcher->advance();
+            queue_bench::relax(spins);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+    state.counters["imbalance"] = consumers.imbalance();
+    state.counters["moves"] = static_cast<double>(dispatcher->moves_started());
+    state.SetLabel("zipf " + std::to_string(s).substr(0, 4) + (rebalancing ? ", rebalancing" : ", static"));
+}
+
+// The same flow through one MPMCQueue: no per-symbol order, but any consumer takes any event
+static void BM_SharedMPMC(benchmark::State& state) {
+    const double s = static_cast<double>(state.range(0)) / 100.0;
+    const auto symbols = zipf_symbols(s, MESSAGES);
+    auto queue = std::make_unique<MPMCQueue<Update, 1024>>();
+    ConsumerThreads consumers([&queue](size_t, auto&& handler) -> size_t {
+        size_t taken = 0;
+        Update update;
+        while (taken < 32 && queue->try_dequeue(update)) {
+            handler(std::move(update));
+            ++taken;
+        }
+        return taken;
+    });
+    queue_bench::pin_current_thread(0);
+
+    uint64_t sent = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < MESSAGES; ++i) {
+            const Update update{symbols[i], sent++};
+            unsigned spins = 0;
+            while (!queue->try_enqueue(update)) {
+                queue_bench::relax(spins);
+            }
+        }
+        unsigned spins = 0;
+        while (consumers.total() < sent) {
+            queue_bench::relax(spins);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(sent));
+    state.counters["imbalance"] = consumers.imbalance();
+    state.SetLabel("zipf " + std::to_string(s).substr(0, 4) + ", unordered");
+}
+
+BENCHMARK(BM_KeyDispatch)
+    ->Args({0, 0})->Args({99, 0})->Args({99, 1})->Args({120, 0})->Args({120, 1})
+    ->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SharedMPMC)->Arg(0)->Arg(99)->Arg(120)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
@@ -0,0 +1,346 @@
+/**
+ * @file key_dispatcher.h
+ * @brief Key-affine dispatch of events to per-consumer RingBuffers
+ *
+ * With MPMCQueue, each message goes to whichever consumer wins the CAS, so
+ * two updates for the same symbol can be applied out of order by two
+ * threads. Here every key hashes to a bucket, and every bucket belongs to
+ * one consumer, so all events for a key go through one SPSC ring and reach
+ * one thread in order.
+ *
+ * Buckets can move between consumers to even out the load of hot symbols.
+ * A move only takes effect at a safe point, once the old consumer has
+ * finished with every event of the bucket it was sent. Until then the
+ * bucket's new events wait in a small stash on the producer side.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "concurrency_primitives.h"
+#include "ring_buffer.h"
+
+/**
+ * @brief Reads the routing key from a `symbol` member
+ *
+ * The default key for KeyDispatcher; pass another functor to route on a
+ * different field.
+ */
+struct SymbolMember {
+    template <typename T>
+    uint64_t operator()(const T& value) const noexcept {
+        return static_cast<uint64_t>(value.symbol);
+    }
+};
+
+/**
+ * @brief Routes events from one producer to Consumers SPSC rings, by key
+ *
+ * One thread dispatches, and also owns the routing table, so rebalance()
+ * and move_bucket() are called on that thread. Consumer c, and only that
+ * thread, takes its events with try_dequeue(c, ...) or drain(c, ...).
+ *
+ * @tparam T The type of elements dispatched
+ * @tparam Capacity Capacity of each consumer's ring (must be a power of 2)
+ * @tparam Consumers Number of consumers (at most 256)
+ * @tparam KeyOf Functor returning an item's uint64_t routing key
+ * @tparam Buckets Hash buckets; the unit of rebalancing (must be a power of 2)
+ * @tparam StashCapacity Events of a moving bucket that can wait for its safe point
+ */
+template <typename T, size_t Capacity, size_t Consumers, typename KeyOf = SymbolMember, size_t Buckets = 1024,
+          size_t StashCapacity = 256>
+class KeyDispatcher {
+    static_assert(Consumers > 0 && Consumers <= 256, "Consumers must be between 1 and 256");
+    static_assert(Buckets >= Consumers && (Buckets & (Buckets - 1)) == 0,
+                  "Buckets must be a power of 2 no smaller than Consumers");
+    static_assert(StashCapacity > 0, "StashCapacity must be positive");
+
+public:
+    using value_type = T;
+
+    static constexpr size_t NO_BUCKET = SIZE_MAX;
+
+    /**
+     * @brief Spreads the buckets over the consumers round-robin
+     */
+    KeyDispatcher() noexcept {
+        for (size_t b = 0; b < Buckets; ++b) {
+            owner_[b] = static_cast<uint8_t>(b % Consumers);
+        }
+        for (auto& lane : lanes_) {
+            lane.completed.data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    KeyDispatcher(const KeyDispatcher&) = delete;
+    KeyDispatcher& operator=(const KeyDispatcher&) = delete;
+
+    /**
+     * @brief Sends an item to the consumer that owns its key; producer thread only
+     *
+     * @return false if that consumer's ring (or the stash of a moving bucket) is full
+     */
+    template <typename U>
+    bool try_dispatch(U&& item) noexcept {
+        const size_t bucket = bucket_of(key_of_(item));
+        if (move_.bucket != NO_BUCKET) {
+            advance();
+            if (bucket == move_.bucket) {
+                if (stash_size_ == StashCapacity) {
+                    return false;
+                }
+                stash_[(stash_head_ + stash_size_++) % StashCapacity] = std::forward<U>(item);
+                ++hits_[bucket];
+                return true;
+            }
+        }
+
+        const size_t consumer = owner_[bucket];
+        if (!lanes_[consumer].ring.try_enqueue(std::forward<U>(item))) {
+            return false;
+        }
+        last_sent_[bucket] = ++sent_[consumer];
+        ++hits_[bucket];
+        return true;
+    }
+
+    /**
+     * @brief Takes the next event for a consumer; that consumer's thread only
+     *
+     * Calling again tells the dispatcher the previous event is fully
+     * processed, which is what lets a bucket leave this consumer.
+     *
+     * @return false if the consumer has nothing waiting
+     */
+    bool try_dequeue(size_t consumer, T& result) noexcept {
+        Lane& lane = lanes_[consumer];
+        lane.completed.data.store(lane.taken, std::memory_order_release);
+        if (!lane.ring.try_dequeue(result)) {
+            return false;
+        }
+        ++lane.taken;
+        return true;
+    }
+
+    /**
+     * @brief Hands up to max_items events to handler, then marks them processed
+     *
+     * @param handler Called with each item, as handler(T&&)
+     * @return The number of items handed to handler
+     */
+    template <typename Handler>
+    size_t drain(size_t consumer, Handler&& handler, size_t max_items = 64) {
+        Lane& lane = lanes_[consumer];
+        size_t taken = 0;
+        T value;
+        while (taken < max_items && lane.ring.try_dequeue(value)) {
+            handler(std::move(value));
+            ++taken;
+        }
+        lane.taken += taken;
+        lane.completed.data.store(lane.taken, std::memory_order_release);
+        return taken;
+    }
+
+    /**
+     * @brief Starts moving a bucket to another consumer; producer thread only
+     *
+     * The bucket's events keep their order: new ones are stashed until the
+     * current owner has processed all the events it already has for it.
+     *
+     * @return false if another move is still in progress
+     */
+    bool move_bucket(size_t bucket, size_t to) noexcept {
+        if (move_.bucket != NO_BUCKET) {
+            return false;
+        }
+        if (owner_[bucket] != to) {
+            move_ = Move{bucket, owner_[bucket], to, last_sent_[bucket], false};
+            ++moves_started_;
+            advance();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Moves one hot bucket from the busiest consumer to the idlest, if that evens out the load
+     *
+     * Looks at the events dispatched per bucket since the last call, then
+     * halves those counts so the picture follows the recent flow. Call it
+     * periodically on the producer thread; it reads every bucket, so not on
+     * every event.
+     *
+     * @param min_imbalance Smallest busiest/idlest load ratio worth a move
+     * @return The bucket being moved, or NO_BUCKET
+     */
+    size_t rebalance(double min_imbalance = 1.25) noexcept {
+        if (move_.bucket != NO_BUCKET) {
+            return NO_BUCKET;
+        }
+        std::array<uint64_t, Consumers> load{};
+        for (size_t b = 0; b < Buckets; ++b) {
+            load[owner_[b]] += hits_[b];
+        }
+        size_t busiest = 0;
+        size_t idlest = 0;
+        for (size_t c = 1; c < Consumers; ++c) {
+            busiest = load[c] > load[busiest] ? c : busiest;
+            idlest = load[c] < load[idlest] ? c : idlest;
+        }
+
+        // The best bucket to move takes the gap closest to half; anything over the full gap makes it worse
+        size_t chosen = NO_BUCKET;
+        if (static_cast<double>(load[busiest]) > min_imbalance * static_cast<double>(load[idlest])) {
+            const uint64_t gap = load[busiest] - load[idlest];
+            uint64_t best_distance = gap / 2;
+            for (size_t b = 0; b < Buckets; ++b) {
+                if (owner_[b] != busiest || hits_[b] == 0 || hits_[b] >= gap) {
+                    continue;
+                }
+                const uint64_t distance = hits_[b] > gap / 2 ? hits_[b] - gap / 2 : gap / 2 - hits_[b];
+                if (distance < best_distance || chosen == NO_BUCKET) {
+                    best_distance = distance;
+                    chosen = b;
+                }
+            }
+        }
+        for (auto& hits : hits_) {
+            hits /= 2;
+        }
+        if (chosen != NO_BUCKET) {
+            move_bucket(chosen, idlest);
+        }
+        return chosen;
+    }
+
+    /**
+     * @brief Finishes a pending move once its safe point is reached; producer thread only
+     *
+     * try_dispatch() calls this while a move is pending. Call it directly
+     * when the producer is idle, so a move does not wait for the next event.
+     *
+     * @return true if no move is pending any more
+     */
+    bool advance() noexcept {
+        if (move_.bucket == NO_BUCKET) {
+            return true;
+        }
+        if (!move_.released) {
+            if (lanes_[move_.from].completed.data.load(std::memory_order_acquire) < move_.fence) {
+                return false;
+            }
+            move_.released = true;
+        }
+        // The old owner is done with the bucket: send the stash to the new one, in order
+        auto& to = lanes_[move_.to];
+        while (stash_size_ > 0 && to.ring.try_enqueue(std::move(stash_[stash_head_]))) {
+            stash_head_ = (stash_head_ + 1) % StashCapacity;
+            --stash_size_;
+            last_sent_[move_.bucket] = ++sent_[move_.to];
+        }
+        if (stash_size_ > 0) {
+            return false;
+        }
+        owner_[move_.bucket] = static_cast<uint8_t>(move_.to);
+        move_.bucket = NO_BUCKET;
+        return true;
+    }
+
+    /**
+     * @brief The bucket a key falls in (Fibonacci hashing, so sequential symbol ids spread out)
+     */
+    static size_t bucket_of(uint64_t key) noexcept {
+        if constexpr (Buckets == 1) {
+            return 0;
+        } else {
+            return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - BUCKET_BITS));
+        }
+    }
+
+    /**
+     * @brief The consumer a bucket's new events go to; producer thread only
+     */
+    size_t owner_of(size_t bucket) const noexcept {
+        return owner_[bucket];
+    }
+
+    /**
+     * @brief The bucket being moved, or NO_BUCKET
+     */
+    size_t moving_bucket() const noexcept {
+        return move_.bucket;
+    }
+
+    // Events dispatched to a consumer so far; producer thread only
+    uint64_t dispatched(size_t consumer) const noexcept {
+        return sent_[consumer];
+    }
+
+    // Bucket moves started by move_bucket() or rebalance()
+    uint64_t moves_started() const noexcept {
+        return moves_started_;
+    }
+
+    // Events of the moving bucket waiting for its safe point
+    size_t stashed() const noexcept {
+        return stash_size_;
+    }
+
+    bool empty(size_t consumer) const noexcept {
+        return lanes_[consumer].ring.empty();
+    }
+
+    static constexpr size_t consumers() noexcept {
+        return Consumers;
+    }
+
+    static constexpr size_t buckets() noexcept {
+        return Buckets;
+    }
+
+private:
+    static constexpr int BUCKET_BITS = std::countr_zero(Buckets);
+
+    struct Move {
+        size_t bucket = NO_BUCKET;
+        size_t from = 0;
+        size_t to = 0;
+        // The bucket's last event in the old owner's sequence; the safe point is when it is processed
+        uint64_t fence = 0;
+        bool released = false;
+    };
+
+    // One consumer's ring, and how far it has got through it
+    struct Lane {
+        RingBuffer<T, Capacity> ring;
+        // Events the consumer has finished with, published for the producer
+        CacheLineAligned<std::atomic<uint64_t>> completed;
+        // Events the consumer has taken (consumer only)
+        alignas(CACHE_LINE_SIZE) uint64_t taken = 0;
+    };
+
+    std::array<Lane, Consumers> lanes_;
+
+    // Producer-side state: who owns each bucket, how many events went to each
+    // consumer, and each bucket's last event counted in its owner's sequence
+    alignas(CACHE_LINE_SIZE) std::array<uint8_t, Buckets> owner_{};
+    std::array<uint64_t, Consumers> sent_{};
+    std::array<uint64_t, Buckets> last_sent_{};
+    std::array<uint64_t, Buckets> hits_{};
+
+    Move move_;
+    uint64_t moves_started_ = 0;
+
+    // Events of the moving bucket, oldest at stash_head_
+    std::array<T, StashCapacity> stash_{};
+    size_t stash_head_ = 0;
+    size_t stash_size_ = 0;
+
+    NO_UNIQUE_ADDRESS KeyOf key_of_;
+};
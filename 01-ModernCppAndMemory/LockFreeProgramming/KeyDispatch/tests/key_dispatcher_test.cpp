@@ -0,0 +1,243 @@
+#include "../include/key_dispatcher.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct Update {
+    uint64_t symbol = 0;
+    uint64_t sequence = 0;
+};
+
+using SmallDispatcher = KeyDispatcher<Update, 64, 2, SymbolMember, 16, 4>;
+
+// Finds a symbol whose bucket is not in `avoid`
+template <typename Dispatcher>
+static uint64_t symbol_outside(const std::vector<size_t>& avoid, uint64_t start = 1) {
+    for (uint64_t symbol = start;; ++symbol) {
+        const size_t bucket = Dispatcher::bucket_of(symbol);
+        bool taken = false;
+        for (size_t other : avoid) {
+            taken = taken || other == bucket;
+        }
+        if (!taken) {
+            return symbol;
+        }
+    }
+}
+
+// Test that every event for a symbol reaches the owner of its bucket, in order
+TEST(KeyDispatcherTest, SameKeySameConsumer) {
+    SmallDispatcher dispatcher;
+    for (uint64_t i = 0; i < 40; ++i) {
+        ASSERT_TRUE(dispatcher.try_dispatch(Update{i % 8, i}));
+    }
+
+    std::vector<uint64_t> next(8, 0);  // Symbol s carries sequences s, s + 8, s + 16, ...
+    for (size_t s = 0; s < 8; ++s) {
+        next[s] = s;
+    }
+    for (size_t consumer = 0; consumer < 2; ++consumer) {
+        Update update;
+        while (dispatcher.try_dequeue(consumer, update)) {
+            EXPECT_EQ(dispatcher.owner_of(SmallDispatcher::bucket_of(update.symbol)), consumer);
+            EXPECT_EQ(update.sequence, next[update.symbol]);
+            next[update.symbol] += 8;
+        }
+    }
+    EXPECT_EQ(dispatcher.dispatched(0) + dispatcher.dispatched(1), 40u);
+}
+
+// Test that a moved bucket's new events wait until the old owner has processed its last one
+TEST(KeyDispatcherTest, MoveWaitsForSafePoint) {
+    SmallDispatcher dispatcher;
+    const uint64_t symbol = 1;
+    const size_t bucket = SmallDispatcher::bucket_of(symbol);
+    const size_t from = dispatcher.owner_of(bucket);
+    const size_t to = 1 - from;
+
+    for (uint64_t i = 0; i < 3; ++i) {
+        ASSERT_TRUE(dispatcher.try_dispatch(Update{symbol, i}));
+    }
+    ASSERT_TRUE(dispatcher.move_bucket(bucket, to));
+    EXPECT_EQ(dispatcher.moving_bucket(), bucket);
+    EXPECT_FALSE(dispatcher.move_bucket(bucket, from));  // One move at a time
+
+    ASSERT_TRUE(dispatcher.try_dispatch(Update{symbol, 3}));
+    ASSERT_TRUE(dispatcher.try_dispatch(Update{symbol, 4}));
+    EXPECT_EQ(dispatcher.stashed(), 2u);
+    EXPECT_TRUE(dispatcher.empty(to));
+
+    // Taking the third event is not enough: it may still be in the handler
+    Update update;
+    for (uint64_t i = 0; i < 3; ++i) {
+        ASSERT_TRUE(dispatcher.try_dequeue(from, update));
+        EXPECT_EQ(update.sequence, i);
+    }
+    EXPECT_FALSE(dispatcher.advance());
+
+    // Coming back for more marks it done; the stash then goes to the new owner
+    EXPECT_FALSE(dispatcher.try_dequeue(from, update));
+    EXPECT_TRUE(dispatcher.advance());
+    EXPECT_EQ(dispatcher.owner_of(bucket), to);
+    EXPECT_EQ(dispatcher.moving_bucket(), SmallDispatcher::NO_BUCKET);
+    EXPECT_EQ(dispatcher.stashed(), 0u);
+
+    ASSERT_TRUE(dispatcher.try_dispatch(Update{symbol, 5}));
+    for (uint64_t i = 3; i <= 5; ++i) {
+        ASSERT_TRUE(dispatcher.try_dequeue(to, update));
+        EXPECT_EQ(update.sequence, i);
+    }
+}
+
+// Test that a bucket with nothing in flight moves at once, and a full stash pushes back
+TEST(KeyDispatcherTest, IdleBucketMovesImmediately) {
+    SmallDispatcher dispatcher;
+    const uint64_t symbol = 2;
+    const size_t bucket = SmallDispatcher::bucket_of(symbol);
+    const size_t to = 1 - dispatcher.owner_of(bucket);
+    ASSERT_TRUE(dispatcher.move_bucket(bucket, to));
+    EXPECT_EQ(dispatcher.owner_of(bucket), to);
+    EXPECT_EQ(dispatcher.moving_bucket(), SmallDispatcher::NO_BUCKET);
+
+    // Move it back while an event is in flight, then overfill the 4-slot stash
+    ASSERT_TRUE(dispatcher.try_dispatch(Update{symbol, 0}));
+    ASSERT_TRUE(dispatcher.move_bucket(bucket, 1 - to));
+    for (uint64_t i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(dispatcher.try_dispatch(Update{symbol, i}));
+    }
+    EXPECT_FALSE(dispatcher.try_dispatch(Update{symbol, 5}));
+
+    // Other buckets are not held up by the move
+    const uint64_t other = symbol_outside<SmallDispatcher>({bucket});
+    EXPECT_TRUE(dispatcher.try_dispatch(Update{other, 0}));
+}
+
+// Test that rebalance() moves the bucket that best evens out the two loads
+TEST(KeyDispatcherTest, RebalanceMovesBestBucket) {
+    SmallDispatcher dispatcher;
+    // Two buckets on consumer 0 and one on consumer 1
+    std::vector<size_t> used;
+    std::vector<uint64_t> symbols;
+    for (size_t owner : {0, 0, 1}) {
+        uint64_t symbol = 1;
+        while (true) {
+            symbol = symbol_outside<SmallDispatcher>(used, symbol);
+            if (dispatcher.owner_of(SmallDispatcher::bucket_of(symbol)) == owner) {
+                break;
+            }
+            ++symbol;
+        }
+        used.push_back(SmallDispatcher::bucket_of(symbol));
+        symbols.push_back(symbol);
+    }
+
+    // Loads 60 + 30 against 10: moving the 30 leaves 60 against 40, the closest to even
+    Update update;
+    const std::array<uint64_t, 3> counts = {60, 30, 10};
+    for (size_t s = 0; s < 3; ++s) {
+        for (uint64_t i = 0; i < counts[s]; ++i) {
+            ASSERT_TRUE(dispatcher.try_dispatch(Update{symbols[s], i}));
+            // Keep the rings from filling up; consumers only ever take what is there
+            if (dispatcher.dispatched(0) % 32 == 0) {
+                while (dispatcher.try_dequeue(0, update)) {}
+            }
+        }
+    }
+
+    EXPECT_EQ(dispatcher.rebalance(), used[1]);
+    EXPECT_EQ(dispatcher.moves_started(), 1u);
+    while (dispatcher.try_dequeue(0, update)) {}
+    EXPECT_TRUE(dispatcher.advance());
+    EXPECT_EQ(dispatcher.owner_of(used[1]), 1u);
+    EXPECT_EQ(dispatcher.owner_of(used[0]), 0u);
+}
+
+// Test that a single bucket hotter than the whole gap is left alone
+TEST(KeyDispatcherTest, RebalanceKeepsLoneHotBucket) {
+    SmallDispatcher dispatcher;
+    for (uint64_t i = 0; i < 50; ++i) {
+        ASSERT_TRUE(dispatcher.try_dispatch(Update{7, i}));
+    }
+    EXPECT_EQ(dispatcher.rebalance(), SmallDispatcher::NO_BUCKET);
+    EXPECT_EQ(dispatcher.moves_started(), 0u);
+}
+
+// Test that per-symbol order holds across consumers while buckets keep moving
+TEST(KeyDispatcherTest, ConcurrentOrderAcrossMoves) {
+    constexpr size_t CONSUMERS = 4;
+    constexpr uint64_t SYMBOLS = 64;
+    constexpr uint64_t EVENTS = 400000;
+    using Dispatcher = KeyDispatcher<Update, 256, CONSUMERS, SymbolMember, 64, 64>;
+    auto dispatcher = std::make_unique<Dispatcher>();
+
+    // Written by whichever consumer owns the symbol; a move hands it over at the safe point
+    std::vector<uint64_t> next(SYMBOLS, 0);
+    std::atomic<bool> in_order{true};
+    std::atomic<uint64_t> received{0};
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < CONSUMERS; ++c) {
+        consumers.emplace_back([&, c]() {
+            auto check = [&](Update&& update) {
+                if (update.sequence != next[update.symbol]++) {
+                    in_order.store(false, std::memory_order_relaxed);
+                }
+                received.fetch_add(1, std::memory_order_relaxed);
+            };
+            Update update;
+            while (true) {
+                const bool finished = done.load(std::memory_order_acquire);
+                // Half the consumers drain in batches, half take one event at a time
+                size_t taken = 0;
+                if (c % 2 == 0) {
+                    taken = dispatcher->drain(c, check, 16);
+                } else if (dispatcher->try_dequeue(c, update)) {
+                    check(std::move(update));
+                    taken = 1;
+                }
+                if (taken == 0) {
+                    if (finished && dispatcher->empty(c)) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Skewed flow: a third of the events go to symbol 0, the rest spread out
+    std::vector<uint64_t> sequence(SYMBOLS, 0);
+    for (uint64_t i = 0; i < EVENTS; ++i) {
+        const uint64_t symbol = i % 3 == 0 ? 0 : (i * 7) % SYMBOLS;
+        const Update update{symbol, sequence[symbol]++};
+        while (!dispatcher->try_dispatch(update)) {
+            std::this_thread::yield();
+        }
+        if (i % 2000 == 0) {
+            dispatcher->rebalance(1.05);
+        }
+        if (i % 5000 == 0) {
+            const size_t bucket = Dispatcher::bucket_of(symbol);
+            dispatcher->move_bucket(bucket, (dispatcher->owner_of(bucket) + 1) % CONSUMERS);
+        }
+    }
+    while (!dispatcher->advance()) {
+        std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& thread : consumers) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(in_order.load());
+    EXPECT_EQ(received.load(), EVENTS);
+    EXPECT_GT(dispatcher->moves_started(), 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
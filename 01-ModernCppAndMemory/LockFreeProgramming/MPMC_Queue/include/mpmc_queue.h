@@ -14,68 +14,27 @@
 #include <optional>
 #include <type_traits>
 #include <cstddef>
+#include <cstdint>
 #include <new>
 
-// Alignment set once
-
-// Ensure cache line alignment to prevent false sharing
-constexpr size_t CACHE_LINE_SIZE = 64;
-
-// Helper class for cache line padding
-template<typename T>
-struct alignas(CACHE_LINE_SIZE) CacheLineAligned {
-    T data;
-    
-    CacheLineAligned() noexcept = default;
-    explicit CacheLineAligned(const T& value) : data(value) {}
-    explicit CacheLineAligned(T&& value) : data(std::move(value)) {}
-    
-    operator T&() noexcept { return data; }
-    operator const T&() const noexcept { return data; }
-    
-    T& operator=(const T& value) noexcept {
-        data = value;
-        return data;
-    }
-    
-    T& operator=(T&& value) noexcept {
-        data = std::move(value);
-        return data;
-    }
-};
-
-// Alignment width set at instantiation
-/**
- * @brief Aligns a value to the specified power of two
- * 
- * @tparam T The type to align
- * @tparam Alignment The alignment value (must be a power of two)
- */
-/*
-template <typename T, size_t Alignment>
-struct alignas(Alignment) CacheAligned {
-    T value;
-
-    CacheAligned() noexcept = default;
-    explicit CacheAligned(const T& v) noexcept : value(v) {}
-    explicit CacheAligned(T&& v) noexcept : value(std::move(v)) {}
-
-    operator T&() noexcept { return value; }
-    operator const T&() const noexcept { return value; }
-    
-    T* operator&() noexcept { return &value; }
-    const T* operator&() const noexcept { return &value; }
-};
-*/
+#include "concurrency_primitives.h"
+#include "numa.h"
+#include "queue_backoff.h"
+#include "queue_stats.h"
 
 /**
  * @brief Lock-free multi-producer multi-consumer queue
  * 
  * @tparam T The type of elements stored in the queue
  * @tparam Capacity The maximum number of elements the queue can hold (must be a power of two)
- * @tparam CacheLineSize The cache line size for alignment (default: 64 bytes)
+ * @tparam CacheLineSize Padding around head_ and tail_ (default: 64 bytes; 128 also keeps
+ *         them apart from the adjacent-line prefetcher, see DESTRUCTIVE_INTERFERENCE_SIZE)
+ * @tparam Stats Telemetry policy (NoStats or CountingStats<>, see queue_stats.h)
+ * @tparam Backoff What a thread does after losing a race for head_ or tail_ (NoBackoff,
+ *         ExponentialBackoffPolicy<> or AdaptiveBackoff<>, see queue_backoff.h)
  */
-template <typename T, size_t Capacity, size_t CacheLineSize = 64>
+template <typename T, size_t Capacity, size_t CacheLineSize = CACHE_LINE_SIZE, typename Stats = NoStats,
+          typename Backoff = NoBackoff>
 class MPMCQueue {
     static_assert(Capacity > 0, "Capacity must be positive");
     static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
@@ -83,10 +42,18 @@ class MPMCQueue {
                   "T must be nothrow copy or move assignable");
 
 public:
+    using value_type = T;
+
+    // Bytes that separate tail_, head_ and the slots
+    static constexpr size_t padding = CacheLineSize;
+
     /**
      * @brief Constructs an empty queue
      */
-    MPMCQueue() noexcept : head_(0), tail_(0) {
+    MPMCQueue() noexcept {
+        tail_.data.store(0, std::memory_order_relaxed);
+        head_.data.store(0, std::memory_order_relaxed);
+
         // Initialize all sequence counters
         for (size_t i = 0; i < Capacity; ++i) {
             slots_[i].sequence.store(i, std::memory_order_relaxed);
@@ -109,7 +76,8 @@ public:
      */
     template <typename U>
     bool enqueue(U&& value) noexcept {
-        size_t head = head_.load(std::memory_order_relaxed);
+        size_t head = head_.data.load(std::memory_order_relaxed);
+        uint32_t retries = 0;
         
         while (true) {
             // Get the slot at the current head position
@@ -124,18 +92,24 @@ public:
                 // The slot is either not yet consumed or already enqueued
                 if (diff < 0) {
                     // The queue is full
+                    stats_.on_full();
+                    backoff_.on_complete(retries);
                     return false;
                 }
                 
                 // Another thread has already moved the head, try again with the updated head
-                head = head_.load(std::memory_order_relaxed);
+                stats_.on_enqueue_retry();
+                backoff_.on_retry(retries++);
+                head = head_.data.load(std::memory_order_relaxed);
                 continue;
             }
             
             // Try to claim this slot by incrementing the head
-            if (!head_.compare_exchange_weak(head, head + 1, 
+            if (!head_.data.compare_exchange_weak(head, head + 1, 
                                             std::memory_order_relaxed)) {
                 // Another thread claimed the slot, try again
+                stats_.on_enqueue_retry();
+                backoff_.on_retry(retries++);
                 continue;
             }
             
@@ -144,6 +118,12 @@ public:
             
             // Mark the slot as ready for dequeue by setting the sequence to the next expected value
             slot.sequence.store(head + 1, std::memory_order_release);
+            if constexpr (Stats::enabled) {
+                // Reading tail_ costs a shared cache line, so only do it when counting
+                size_t tail = tail_.data.load(std::memory_order_relaxed);
+                stats_.on_enqueue(head + 1 > tail ? head + 1 - tail : 0);
+            }
+            backoff_.on_complete(retries);
             return true;
         }
     }
@@ -155,7 +135,8 @@ public:
      * @return true if an element was dequeued, false if the queue is empty
      */
     bool dequeue(T& result) noexcept {
-        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t tail = tail_.data.load(std::memory_order_relaxed);
+        uint32_t retries = 0;
         
         while (true) {
             // Get the slot at the current tail position
@@ -170,18 +151,24 @@ public:
                 // The slot is either not yet enqueued or already dequeued
                 if (diff < 0) {
                     // The queue is empty
+                    stats_.on_empty();
+                    backoff_.on_complete(retries);
                     return false;
                 }
                 
                 // Another thread has already moved the tail, try again with the updated tail
-                tail = tail_.load(std::memory_order_relaxed);
+                stats_.on_dequeue_retry();
+                backoff_.on_retry(retries++);
+                tail = tail_.data.load(std::memory_order_relaxed);
                 continue;
             }
             
             // Try to claim this slot by incrementing the tail
-            if (!tail_.compare_exchange_weak(tail, tail + 1, 
+            if (!tail_.data.compare_exchange_weak(tail, tail + 1, 
                                             std::memory_order_relaxed)) {
                 // Another thread claimed the slot, try again
+                stats_.on_dequeue_retry();
+                backoff_.on_retry(retries++);
                 continue;
             }
             
@@ -190,10 +177,27 @@ public:
             
             // Mark the slot as ready for enqueue by setting the sequence to the next expected value
             slot.sequence.store(tail + Capacity, std::memory_order_release);
+            stats_.on_dequeue();
+            backoff_.on_complete(retries);
             return true;
         }
     }
 
+    /**
+     * @brief Same as enqueue(), named to match RingBuffer so both satisfy ConcurrentQueue
+     */
+    template <typename U>
+    bool try_enqueue(U&& value) noexcept {
+        return enqueue(std::forward<U>(value));
+    }
+
+    /**
+     * @brief Same as dequeue(T&), named to match RingBuffer so both satisfy ConcurrentQueue
+     */
+    bool try_dequeue(T& result) noexcept {
+        return dequeue(result);
+    }
+
     /**
      * @brief Attempts to dequeue an element
      * 
@@ -214,8 +218,8 @@ public:
      * @return true if the queue appears to be empty
      */
     bool empty() const noexcept {
-        return head_.load(std::memory_order_relaxed) == 
-               tail_.load(std::memory_order_relaxed);
+        return head_.data.load(std::memory_order_relaxed) == 
+               tail_.data.load(std::memory_order_relaxed);
     }
 
     /**
@@ -227,6 +231,19 @@ public:
         return Capacity;
     }
 
+    /**
+     * @brief Moves the queue's memory to a NUMA node
+     * 
+     * The default is the calling thread's node, so a pinned consumer can call
+     * it once at startup to pull the slots onto its own socket. Call it before
+     * traffic starts; pages are migrated, not copied under the queue's feet.
+     * 
+     * @return false if the node cannot be used (memory stays where it is)
+     */
+    bool bind_to_node(int node = numa_current_node()) noexcept {
+        return numa_bind(this, sizeof(*this), node);
+    }
+
     /**
      * @brief Estimates the current number of elements in the queue
      * 
@@ -234,11 +251,29 @@ public:
      * @return The estimated number of elements
      */
     size_t size() const noexcept {
-        size_t head = head_.load(std::memory_order_relaxed);
-        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.data.load(std::memory_order_relaxed);
+        size_t tail = tail_.data.load(std::memory_order_relaxed);
         return head >= tail ? head - tail : 0;
     }
 
+    /**
+     * @brief Returns the telemetry gathered so far (all zero with NoStats)
+     * 
+     * @note Retries count both failed CAS attempts and reloads after another
+     *       thread moved the counter; the high-water mark is an estimate
+     * @return Counters summed over all threads
+     */
+    QueueStatsSnapshot stats() const noexcept {
+        return stats_.snapshot();
+    }
+
+    /**
+     * @brief Zeroes the telemetry counters; call only while the queue is idle
+     */
+    void reset_stats() noexcept {
+        stats_.reset();
+    }
+
 private:
     struct Slot {
         std::atomic<size_t> sequence;
@@ -249,11 +284,17 @@ private:
     static constexpr size_t mask_ = Capacity - 1;
 
     // Consumer counter
-    alignas(CacheLineSize) std::atomic<size_t> tail_;
+    CacheAligned<std::atomic<size_t>, CacheLineSize> tail_;
     
-    // Producer counter
-    alignas(CacheLineSize) std::atomic<size_t> head_;
+    // Producer counter; padded at the end too, so the first slot is not on its line
+    CacheAligned<std::atomic<size_t>, CacheLineSize> head_;
     
     // Storage for elements and their sequence counters
     std::array<Slot, Capacity> slots_;
+
+    // Telemetry; takes no space with NoStats
+    NO_UNIQUE_ADDRESS Stats stats_;
+
+    // Contention policy; takes no space with NoBackoff or ExponentialBackoffPolicy
+    NO_UNIQUE_ADDRESS Backoff backoff_;
 };
@@ -1,5 +1,8 @@
 #include "../include/mpmc_queue.h"
+#include "alloc_guard.h"
 #include <gtest/gtest.h>
+#include <cstdlib>
+#include <memory>
 #include <thread>
 #include <vector>
 #include <atomic>
@@ -280,6 +283,290 @@ TEST(MPMCQueueTest, MultiThreaded) {
         << "Queue should be empty after processing all items";
 }
 
+// Test that the no-op stats policy adds no storage
+TEST(MPMCQueueTest, NoStatsHasNoOverhead) {
+    EXPECT_EQ(sizeof(MPMCQueue<int, 64>), sizeof(MPMCQueue<int, 64, 64, NoStats>));
+    struct PlainSlot {
+        std::atomic<size_t> sequence;
+        int element;
+    };
+    struct Plain {
+        CacheLineAligned<std::atomic<size_t>> tail;
+        CacheLineAligned<std::atomic<size_t>> head;
+        std::array<PlainSlot, 64> slots;
+    };
+    EXPECT_EQ(sizeof(MPMCQueue<int, 64>), sizeof(Plain));
+}
+
+// Test that the padding width is set per instance and still behaves as a queue
+TEST(MPMCQueueTest, PaddingWidth) {
+    using Wide = MPMCQueue<int, 64, DESTRUCTIVE_INTERFERENCE_SIZE>;
+    EXPECT_EQ((MPMCQueue<int, 64>::padding), 64u);
+    EXPECT_EQ(Wide::padding, 128u);
+    EXPECT_EQ(alignof(Wide), 128u);
+    // Two 128-byte counters ahead of the slots instead of two 64-byte ones
+    EXPECT_EQ(sizeof(Wide) - sizeof(MPMCQueue<int, 64>), 2 * 128u - 2 * 64u);
+
+    Wide queue;
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_TRUE(queue.try_enqueue(i));
+    }
+    EXPECT_FALSE(queue.try_enqueue(64));
+    int value = -1;
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_TRUE(queue.try_dequeue(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+// Test the counting stats policy on a single thread
+TEST(MPMCQueueTest, CountingStats) {
+    MPMCQueue<int, 4, 64, CountingStats<>> queue;
+    int value;
+
+    EXPECT_FALSE(queue.dequeue(value));  // Empty poll
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue.enqueue(i));
+    }
+    EXPECT_FALSE(queue.enqueue(4));      // Full
+    EXPECT_TRUE(queue.dequeue(value));
+
+    QueueStatsSnapshot stats = queue.stats();
+    EXPECT_EQ(stats.enqueues, 4u);
+    EXPECT_EQ(stats.dequeues, 1u);
+    EXPECT_EQ(stats.full_failures, 1u);
+    EXPECT_EQ(stats.empty_polls, 1u);
+    EXPECT_EQ(stats.enqueue_retries, 0u);
+    EXPECT_EQ(stats.high_water_mark, 4u);
+
+    queue.reset_stats();
+    EXPECT_EQ(queue.stats().enqueues, 0u);
+}
+
+// Test that counts from several producers and consumers are aggregated without loss
+TEST(MPMCQueueTest, CountingStatsMultiThreaded) {
+    constexpr size_t NUM_THREADS = 4;
+    constexpr size_t NUM_ITEMS_PER_PRODUCER = 5000;
+    constexpr size_t TOTAL_ITEMS = NUM_THREADS * NUM_ITEMS_PER_PRODUCER;
+    MPMCQueue<int, 64, 64, CountingStats<>> queue;
+    std::atomic<size_t> total_consumed(0);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&]() {
+            for (size_t i = 0; i < NUM_ITEMS_PER_PRODUCER; ++i) {
+                while (!queue.enqueue(static_cast<int>(i))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&]() {
+            int value;
+            while (total_consumed.load(std::memory_order_relaxed) < TOTAL_ITEMS) {
+                if (queue.dequeue(value)) {
+                    total_consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    QueueStatsSnapshot stats = queue.stats();
+    EXPECT_EQ(stats.enqueues, TOTAL_ITEMS);
+    EXPECT_EQ(stats.dequeues, TOTAL_ITEMS);
+    EXPECT_LE(stats.high_water_mark, queue.capacity());
+}
+
+namespace {
+
+// Trivially copyable message, as carried on the hot path
+struct Quote {
+    uint64_t sequence;
+    int64_t price;
+    uint32_t quantity;
+};
+
+}  // namespace
+
+// Test that the guard itself sees allocations, so a zero count below means something
+TEST(MPMCQueueTest, AllocationGuardDetectsAllocations) {
+    NoAllocScope scope;
+    int* volatile pointer = new int(1);
+    delete pointer;
+    EXPECT_EQ(scope.allocations(), 1u);
+    EXPECT_EQ(scope.deallocations(), 1u);
+
+    if (alloc_guard_wraps_malloc()) {
+        void* volatile block = std::malloc(32);
+        std::free(block);
+        EXPECT_EQ(scope.allocations(), 2u);
+    }
+}
+
+// Test that enqueue and dequeue never touch the heap for trivially copyable T
+TEST(MPMCQueueTest, HotPathIsAllocationFree) {
+    auto queue = std::make_unique<MPMCQueue<Quote, 64>>();
+    auto counted = std::make_unique<MPMCQueue<Quote, 64, 64, CountingStats<>>>();
+    Quote quote{};
+
+    NoAllocScope scope(AllocGuardMode::Abort);
+    for (uint64_t round = 0; round < 100; ++round) {
+        while (queue->try_enqueue(Quote{round, 100, 1})) {
+        }
+        EXPECT_EQ(queue->size(), 64u);
+        while (queue->try_dequeue(quote)) {
+        }
+        EXPECT_FALSE(queue->dequeue().has_value());
+
+        EXPECT_TRUE(counted->try_enqueue(quote));
+        EXPECT_TRUE(counted->try_dequeue(quote));
+    }
+    EXPECT_EQ(counted->stats().enqueues, 100u);
+    EXPECT_EQ(scope.allocations(), 0u);
+}
+
+// Test the same under concurrency, with every producer and consumer thread guarded
+TEST(MPMCQueueTest, ConcurrentHotPathIsAllocationFree) {
+    constexpr size_t NUM_ITEMS = 20000;
+    auto queue = std::make_unique<MPMCQueue<Quote, 256>>();
+    std::atomic<size_t> consumed(0);
+    std::atomic<uint64_t> allocations(0);
+
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() {
+        NoAllocScope scope(AllocGuardMode::Count);
+        for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+            while (!queue->try_enqueue(Quote{i, 100, 1})) {
+                std::this_thread::yield();
+            }
+        }
+        allocations.fetch_add(scope.allocations());
+    });
+    for (int c = 0; c < 2; ++c) {
+        threads.emplace_back([&]() {
+            NoAllocScope scope(AllocGuardMode::Count);
+            Quote quote;
+            while (consumed.load(std::memory_order_relaxed) < NUM_ITEMS) {
+                if (queue->try_dequeue(quote)) {
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            allocations.fetch_add(scope.allocations());
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(consumed.load(), NUM_ITEMS);
+    EXPECT_EQ(allocations.load(), 0u);
+}
+
+// Test that the stateless backoff policies add no storage
+TEST(MPMCQueueTest, BackoffPolicySize) {
+    EXPECT_EQ(sizeof(MPMCQueue<int, 64>), (sizeof(MPMCQueue<int, 64, 64, NoStats, NoBackoff>)));
+    EXPECT_EQ(sizeof(MPMCQueue<int, 64>), (sizeof(MPMCQueue<int, 64, 64, NoStats, ExponentialBackoffPolicy<>>)));
+}
+
+// Test that the adaptive base doubles after contended operations and decays after clean ones
+TEST(MPMCQueueTest, AdaptiveBackoffTracksFailureRate) {
+    AdaptiveBackoff<2, 64> backoff;
+    EXPECT_EQ(backoff.base_spins(), 2u);
+
+    backoff.on_complete(1);  // One retry is what the base aims for
+    EXPECT_EQ(backoff.base_spins(), 2u);
+    for (int i = 0; i < 3; ++i) {
+        backoff.on_complete(3);
+    }
+    EXPECT_EQ(backoff.base_spins(), 16u);
+    for (int i = 0; i < 10; ++i) {
+        backoff.on_complete(5);
+    }
+    EXPECT_EQ(backoff.base_spins(), 64u);  // Capped at MaxSpins
+
+    backoff.on_complete(0);
+    EXPECT_EQ(backoff.base_spins(), 56u);
+    for (int i = 0; i < 100; ++i) {
+        backoff.on_complete(0);
+    }
+    EXPECT_EQ(backoff.base_spins(), 2u);  // Floored at MinSpins
+
+    // Spins stay bounded however many attempts a thread makes
+    for (uint32_t attempt = 0; attempt < 40; ++attempt) {
+        backoff.on_retry(attempt);
+    }
+}
+
+// Runs 4 producers and 4 consumers through a small queue and checks nothing is lost or duplicated
+template <typename Queue>
+void check_contended_transfer() {
+    constexpr size_t NUM_THREADS = 4;
+    constexpr size_t NUM_ITEMS_PER_PRODUCER = 20000;
+    constexpr size_t TOTAL_ITEMS = NUM_THREADS * NUM_ITEMS_PER_PRODUCER;
+    auto queue = std::make_unique<Queue>();
+    std::atomic<size_t> total_consumed(0);
+    std::atomic<uint64_t> sum(0);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&, t]() {
+            for (size_t i = 0; i < NUM_ITEMS_PER_PRODUCER; ++i) {
+                while (!queue->enqueue(static_cast<int>(t * NUM_ITEMS_PER_PRODUCER + i))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        threads.emplace_back([&]() {
+            int value;
+            while (total_consumed.load(std::memory_order_relaxed) < TOTAL_ITEMS) {
+                if (queue->dequeue(value)) {
+                    sum.fetch_add(static_cast<uint64_t>(value), std::memory_order_relaxed);
+                    total_consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(total_consumed.load(), TOTAL_ITEMS);
+    EXPECT_EQ(sum.load(), TOTAL_ITEMS * (TOTAL_ITEMS - 1) / 2);
+    EXPECT_TRUE(queue->empty());
+}
+
+// Test that backing off between attempts never loses or duplicates an item
+TEST(MPMCQueueTest, ExponentialBackoffMultiThreaded) {
+    check_contended_transfer<MPMCQueue<int, 16, 64, NoStats, ExponentialBackoffPolicy<>>>();
+}
+
+TEST(MPMCQueueTest, AdaptiveBackoffMultiThreaded) {
+    check_contended_transfer<MPMCQueue<int, 16, 64, CountingStats<>, AdaptiveBackoff<>>>();
+}
+
+// Test NUMA placement, including the fallback for a node that does not exist
+TEST(MPMCQueueTest, BindToNode) {
+    auto queue = numa_make_unique<MPMCQueue<int, 1024>>(numa_current_node());
+    EXPECT_TRUE(queue->try_enqueue(42));
+    EXPECT_FALSE(queue->bind_to_node(numa_node_count()));
+    if (numa_node_of(queue.get()) != NUMA_NO_NODE) {
+        EXPECT_TRUE(queue->bind_to_node());
+        EXPECT_EQ(numa_node_of(queue.get()), numa_current_node());
+    }
+    int value = 0;
+    EXPECT_TRUE(queue->try_dequeue(value));
+    EXPECT_EQ(value, 42);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,112 @@
+#include "../include/priority_band_queue.h"
+#include "mpmc_queue.h"
+#include "queue_benchmarks.h"
+#include "tsc_clock.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+struct GatewayMessage {
+    uint64_t tsc = 0;      // When a cancel was enqueued; 0 for market data
+    uint64_t payload = 0;
+};
+
+constexpr size_t CAPACITY = 1024;
+constexpr size_t CANCEL_BAND = 0;
+constexpr size_t MARKET_DATA_BAND = 3;
+
+// Stands in for handling one message: a few dozen dependent multiplies
+static uint64_t handle(const GatewayMessage& message) {
+    uint64_t value = message.payload;
+    for (int i = 0; i < 16; ++i) {
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    return value;
+}
+
+// One FIFO for everything: a cancel waits behind whatever market data is queued
+struct SingleQueue {
+    MPMCQueue<GatewayMessage, CAPACITY> queue;
+
+    explicit SingleQueue(uint32_t) {}
+    bool push(size_t, const GatewayMessage& message) { return queue.try_enqueue(message); }
+    bool pop(GatewayMessage& message) { return queue.try_dequeue(message); }
+};
+
+struct Banded {
+    PriorityBandQueue<GatewayMessage, CAPACITY, 4> queue;
+
+    explicit Banded(uint32_t starvation_limit) : queue(starvation_limit) {}
+    bool push(size_t band, const GatewayMessage& message) { return queue.try_enqueue(band, message); }
+    bool pop(GatewayMessage& message) { return queue.try_dequeue(message); }
+};
+
+/**
+ * @brief Time from enqueueing a cancel to dequeuing it, while market data keeps the low band full
+ *
+ * One thread plays both sides, so the result is the queueing delay alone,
+ * free of scheduler noise: every market data message taken is handled and
+ * replaced at once, keeping the low band saturated. state.range(0) is the
+ * starvation limit (0 for strict priority).
+ */
+template <typename Queue>
+static void BM_CancelUnderSaturation(benchmark::State& state) {
+    const TscClock& clock = TscClock::shared();
+    auto queue = std::make_unique<Queue>(static_cast<uint32_t>(state.range(0)));
+    // One slot short of full, so the single queue still has room for the cancel
+    uint64_t payload = 0;
+    while (payload < CAPACITY - 1) {
+        queue->push(MARKET_DATA_BAND, GatewayMessage{0, ++payload});
+    }
+
+    std::vector<uint64_t> samples_ns;
+    samples_ns.reserve(1 << 20);
+    uint64_t overtaken_by = 0;
+    uint64_t sink = 0;
+    for (auto _ : state) {
+        const uint64_t sent = read_tsc();
+        while (!queue->push(CANCEL_BAND, GatewayMessage{sent, 0})) {
+        }
+        GatewayMessage message;
+        while (true) {
+            if (!queue->pop(message)) {
+                continue;
+            }
+            sink += handle(message);
+            if (message.tsc != 0) {
+                samples_ns.push_back(static_cast<uint64_t>(clock.to_ns(read_tsc() - message.tsc)));
+                break;
+            }
+            ++overtaken_by;
+            queue->push(MARKET_DATA_BAND, GatewayMessage{0, ++payload});
+        }
+    }
+    benchmark::DoNotOptimize(sink);
+    queue_bench::report_percentiles(state, samples_ns);
+    state.counters["md_ahead"] = static_cast<double>(overtaken_by) / static_cast<double>(state.iterations());
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Cost of one enqueue/dequeue pair when only one band is in use
+template <typename Queue>
+static void BM_RoundTrip(benchmark::State& state) {
+    auto queue = std::make_unique<Queue>(static_cast<uint32_t>(state.range(0)));
+    GatewayMessage message;
+    for (auto _ : state) {
+        queue->push(MARKET_DATA_BAND, GatewayMessage{0, 1});
+        queue->pop(message);
+        benchmark::DoNotOptimize(message);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_CancelUnderSaturation, SingleQueue)->Arg(0)->Name("BM_CancelUnderSaturation/SingleMPMC");
+BENCHMARK_TEMPLATE(BM_CancelUnderSaturation, Banded)->Arg(0)->Name("BM_CancelUnderSaturation/Banded/strict");
+BENCHMARK_TEMPLATE(BM_CancelUnderSaturation, Banded)->Arg(4)->Name("BM_CancelUnderSaturation/Banded/limit4");
+
+BENCHMARK_TEMPLATE(BM_RoundTrip, SingleQueue)->Arg(0)->Name("BM_RoundTrip/SingleMPMC");
+BENCHMARK_TEMPLATE(BM_RoundTrip, Banded)->Arg(0)->Name("BM_RoundTrip/Banded");
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
@@ -0,0 +1,198 @@
+/**
+ * @file priority_band_queue.h
+ * @brief MPMC queue with a small fixed number of priority bands
+ *
+ * Each band is an MPMCQueue. A bitmap with one bit per band marks the bands
+ * that may hold items, so a consumer finds the highest ready band with one
+ * load and one count-trailing-zeros (tzcnt on x86), however many bands are
+ * idle. Cancels and risk kills in band 0 overtake market data queued in a
+ * lower band instead of waiting behind it.
+ *
+ * Strict priority can starve the lower bands under sustained high-band
+ * traffic. An optional starvation limit lets a lower band through after a
+ * run of dequeues from the top band.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "concurrency_primitives.h"
+#include "mpmc_queue.h"
+#include "ready_mask.h"
+
+/**
+ * @brief Multi-producer, multi-consumer queue of Bands priority bands, band 0 first
+ *
+ * Any thread may enqueue to any band, and any thread may dequeue. Items in
+ * the same band come out in FIFO order, as from MPMCQueue.
+ *
+ * @tparam T The type of elements stored in the queue
+ * @tparam Capacity Capacity of each band (must be a power of 2)
+ * @tparam Bands Number of bands (at most 64, one bit each)
+ */
+template <typename T, size_t Capacity, size_t Bands = 4>
+class PriorityBandQueue {
+    static_assert(Bands > 0 && Bands <= 64, "Bands must be between 1 and 64");
+
+public:
+    using value_type = T;
+
+    // Strict priority: a lower band is served only when every higher band is empty
+    static constexpr uint32_t NO_STARVATION_LIMIT = 0;
+
+    /**
+     * @param starvation_limit After this many dequeues in a row from the top
+     *        band while a lower band was waiting, the next dequeue serves a
+     *        lower band instead; lower bands take turns. 0 keeps strict priority.
+     */
+    explicit PriorityBandQueue(uint32_t starvation_limit = NO_STARVATION_LIMIT) noexcept
+        : starvation_limit_(starvation_limit) {
+        streak_.data.store(0, std::memory_order_relaxed);
+        last_relief_.store(0, std::memory_order_relaxed);
+        reliefs_.store(0, std::memory_order_relaxed);
+    }
+
+    PriorityBandQueue(const PriorityBandQueue&) = delete;
+    PriorityBandQueue& operator=(const PriorityBandQueue&) = delete;
+
+    /**
+     * @brief Enqueues an item into a band; 0 is the highest priority
+     *
+     * @return false if that band is full, or band is not below Bands
+     */
+    template <typename U>
+    bool try_enqueue(size_t band, U&& value) noexcept {
+        if (band >= Bands || !bands_[band].try_enqueue(std::forward<U>(value))) {
+            return false;
+        }
+        ready_.mark(band);
+        return true;
+    }
+
+    /**
+     * @brief Takes an item from the highest ready band, unless a lower band is due for relief
+     *
+     * @return false if every band is empty
+     */
+    bool try_dequeue(T& result) noexcept {
+        size_t band = 0;
+        return try_dequeue(result, band);
+    }
+
+    /**
+     * @brief As try_dequeue(T&), and reports which band the item came from
+     */
+    bool try_dequeue(T& result, size_t& band) noexcept {
+        uint64_t ready = ready_.load();
+        while (ready != 0) {
+            bool relief = false;
+            band = pick(ready, relief);
+            if (bands_[band].try_dequeue(result)) {
+                if (relief) {
+                    reliefs_.fetch_add(1, std::memory_order_relaxed);
+                }
+                return true;
+            }
+            settle(band);
+            ready &= ~(uint64_t{1} << band);
+        }
+        return false;
+    }
+
+    /**
+     * @brief Whether every band is empty; only a hint while other threads are active
+     */
+    bool empty() const noexcept {
+        for (const auto& band : bands_) {
+            if (!band.empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Bands that may hold items, one bit per band
+     */
+    uint64_t ready_mask() const noexcept {
+        return ready_.load();
+    }
+
+    size_t size(size_t band) const noexcept {
+        assert(band < Bands && "no such band");
+        return bands_[band].size();
+    }
+
+    /**
+     * @brief Dequeues that served a lower band because of the starvation limit
+     */
+    uint64_t reliefs() const noexcept {
+        return reliefs_.load(std::memory_order_relaxed);
+    }
+
+    uint32_t starvation_limit() const noexcept {
+        return starvation_limit_;
+    }
+
+    static constexpr size_t capacity() noexcept {
+        return Capacity;
+    }
+
+    static constexpr size_t bands() noexcept {
+        return Bands;
+    }
+
+private:
+    /**
+     * @brief Chooses the band to dequeue from, given the ready bitmap
+     *
+     * The run counter is shared by all consumers and updated with relaxed
+     * operations, so with several consumers the limit is approximate.
+     */
+    size_t pick(uint64_t ready, bool& relief) noexcept {
+        const size_t top = static_cast<size_t>(std::countr_zero(ready));
+        const uint64_t lower = ready & ~(uint64_t{1} << top);
+        if (starvation_limit_ == NO_STARVATION_LIMIT || lower == 0) {
+            return top;
+        }
+        if (streak_.data.fetch_add(1, std::memory_order_relaxed) + 1 < starvation_limit_) {
+            return top;
+        }
+        // Relief: the first waiting band after the one relieved last, wrapping around
+        streak_.data.store(0, std::memory_order_relaxed);
+        const size_t last = last_relief_.load(std::memory_order_relaxed);
+        const uint64_t after = last + 1 < 64 ? lower & (~uint64_t{0} << (last + 1)) : 0;
+        const size_t band = static_cast<size_t>(std::countr_zero(after != 0 ? after : lower));
+        last_relief_.store(band, std::memory_order_relaxed);
+        relief = true;
+        return band;
+    }
+
+    /**
+     * @brief Clears the bit of a band found empty, keeping it if an item arrived meanwhile
+     *
+     * MPMCQueue::empty() compares the counters, so an item a producer has
+     * claimed but not yet written also keeps the bit set.
+     */
+    void settle(size_t band) noexcept {
+        ready_.settle(band, [this, band]() { return !bands_[band].empty(); });
+    }
+
+    // Bands that may hold items; producers write it only when their bit is clear
+    ReadyMask<Bands> ready_;
+
+    // Starvation protection, touched only while a lower band is waiting
+    CacheLineAligned<std::atomic<uint32_t>> streak_;
+    std::atomic<size_t> last_relief_;
+    std::atomic<uint64_t> reliefs_;
+    const uint32_t starvation_limit_;
+
+    std::array<MPMCQueue<T, Capacity>, Bands> bands_;
+};
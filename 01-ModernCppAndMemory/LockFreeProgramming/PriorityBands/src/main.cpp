@@ -0,0 +1,66 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include "../include/priority_band_queue.h"
+#include "tsc_clock.h"
+
+enum Band : size_t { RISK_KILL = 0, CANCEL = 1, NEW_ORDER = 2, MARKET_DATA = 3 };
+
+struct GatewayEvent {
+    uint64_t tsc = 0;
+    uint32_t order_id = 0;
+};
+
+int main() {
+    std::cout << "Priority Band Queue Demo\n";
+    std::cout << "========================\n\n";
+
+    const TscClock& clock = TscClock::shared();
+    // Every 64th dequeue in a row from a busier band lets a waiting lower band through
+    auto queue = std::make_unique<PriorityBandQueue<GatewayEvent, 1024, 4>>(64);
+    std::atomic<bool> stop{false};
+
+    // Market data floods its band; cancels and the odd risk kill trickle in above it
+    std::thread market_data([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            queue->try_enqueue(MARKET_DATA, GatewayEvent{read_tsc(), 0});
+        }
+    });
+    std::thread orders([&]() {
+        for (uint32_t id = 1; !stop.load(std::memory_order_relaxed); ++id) {
+            const size_t band = id % 50 == 0 ? RISK_KILL : (id % 2 == 0 ? CANCEL : NEW_ORDER);
+            while (!queue->try_enqueue(band, GatewayEvent{read_tsc(), id})) {
+                std::this_thread::yield();
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+    });
+
+    // The gateway's send loop
+    std::array<uint64_t, 4> count{};
+    std::array<double, 4> waited_ns{};
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+    GatewayEvent event;
+    size_t band = 0;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (queue->try_dequeue(event, band)) {
+            ++count[band];
+            waited_ns[band] += clock.to_ns(read_tsc() - event.tsc);
+        }
+    }
+    stop.store(true, std::memory_order_relaxed);
+    market_data.join();
+    orders.join();
+
+    const char* names[4] = {"Risk kill", "Cancel", "New order", "Market data"};
+    for (size_t b = 0; b < 4; ++b) {
+        std::cout << names[b] << ": " << count[b] << " sent, mean wait "
+                  << (count[b] > 0 ? waited_ns[b] / static_cast<double>(count[b]) / 1000.0 : 0.0) << " us\n";
+    }
+    std::cout << "Starvation reliefs: " << queue->reliefs() << "\n";
+    return 0;
+}
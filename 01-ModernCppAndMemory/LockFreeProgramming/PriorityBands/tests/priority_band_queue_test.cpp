@@ -0,0 +1,171 @@
+#include "../include/priority_band_queue.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using SmallBands = PriorityBandQueue<uint64_t, 16, 4>;
+
+// Takes everything, recording the band of each item
+template <typename Queue>
+static std::vector<size_t> drain_bands(Queue& queue) {
+    std::vector<size_t> bands;
+    uint64_t value = 0;
+    size_t band = 0;
+    while (queue.try_dequeue(value, band)) {
+        bands.push_back(band);
+    }
+    return bands;
+}
+
+// Test that the highest ready band is always served first
+TEST(PriorityBandQueueTest, HighestBandFirst) {
+    SmallBands queue;
+    ASSERT_TRUE(queue.try_enqueue(3, uint64_t{30}));
+    ASSERT_TRUE(queue.try_enqueue(1, uint64_t{10}));
+    ASSERT_TRUE(queue.try_enqueue(2, uint64_t{20}));
+    ASSERT_TRUE(queue.try_enqueue(0, uint64_t{0}));
+    EXPECT_EQ(queue.ready_mask(), 0b1111u);
+
+    std::vector<uint64_t> order;
+    uint64_t value = 0;
+    while (queue.try_dequeue(value)) {
+        order.push_back(value);
+    }
+    EXPECT_EQ(order, (std::vector<uint64_t>{0, 10, 20, 30}));
+    EXPECT_EQ(queue.ready_mask(), 0u);
+    EXPECT_TRUE(queue.empty());
+}
+
+// Test that items within one band keep FIFO order, and a late high item still overtakes
+TEST(PriorityBandQueueTest, FifoWithinBand) {
+    SmallBands queue;
+    for (uint64_t i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(queue.try_enqueue(2, i));
+    }
+    uint64_t value = 0;
+    ASSERT_TRUE(queue.try_dequeue(value));
+    EXPECT_EQ(value, 1u);
+
+    ASSERT_TRUE(queue.try_enqueue(0, uint64_t{99}));
+    ASSERT_TRUE(queue.try_dequeue(value));
+    EXPECT_EQ(value, 99u);
+    ASSERT_TRUE(queue.try_dequeue(value));
+    EXPECT_EQ(value, 2u);
+    ASSERT_TRUE(queue.try_dequeue(value));
+    EXPECT_EQ(value, 3u);
+    EXPECT_FALSE(queue.try_dequeue(value));
+}
+
+// Test that a full band refuses items without affecting the others
+TEST(PriorityBandQueueTest, FullBand) {
+    SmallBands queue;
+    for (uint64_t i = 0; i < SmallBands::capacity(); ++i) {
+        ASSERT_TRUE(queue.try_enqueue(3, i));
+    }
+    EXPECT_FALSE(queue.try_enqueue(3, uint64_t{99}));
+    EXPECT_EQ(queue.size(3), SmallBands::capacity());
+    EXPECT_TRUE(queue.try_enqueue(0, uint64_t{99}));
+    EXPECT_EQ(queue.ready_mask(), 0b1001u);
+}
+
+// Test that an out-of-range band is refused instead of indexing past the bands
+TEST(PriorityBandQueueTest, RejectsUnknownBand) {
+    SmallBands queue;
+    EXPECT_FALSE(queue.try_enqueue(SmallBands::bands(), uint64_t{1}));
+    EXPECT_FALSE(queue.try_enqueue(64, uint64_t{1}));
+    EXPECT_EQ(queue.ready_mask(), 0u);
+    uint64_t value = 0;
+    EXPECT_FALSE(queue.try_dequeue(value));
+}
+
+// Test that strict priority drains every higher band before a lower one
+TEST(PriorityBandQueueTest, StrictPriority) {
+    SmallBands queue;
+    for (uint64_t i = 0; i < 4; ++i) {
+        ASSERT_TRUE(queue.try_enqueue(0, i));
+        ASSERT_TRUE(queue.try_enqueue(3, i));
+    }
+    EXPECT_EQ(drain_bands(queue), (std::vector<size_t>{0, 0, 0, 0, 3, 3, 3, 3}));
+    EXPECT_EQ(queue.reliefs(), 0u);
+}
+
+// Test that the starvation limit lets the waiting lower bands through in turn
+TEST(PriorityBandQueueTest, StarvationLimitRotatesLowerBands) {
+    SmallBands queue(3);
+    for (uint64_t i = 0; i < 10; ++i) {
+        ASSERT_TRUE(queue.try_enqueue(0, i));
+    }
+    for (uint64_t i = 0; i < 2; ++i) {
+        ASSERT_TRUE(queue.try_enqueue(2, i));
+        ASSERT_TRUE(queue.try_enqueue(3, i));
+    }
+    // Every third dequeue goes to a lower band, alternating between 2 and 3
+    EXPECT_EQ(drain_bands(queue), (std::vector<size_t>{0, 0, 2, 0, 0, 3, 0, 0, 2, 0, 0, 3, 0, 0}));
+    EXPECT_EQ(queue.reliefs(), 4u);
+}
+
+// Test that the limit only counts while a lower band is waiting
+TEST(PriorityBandQueueTest, StarvationLimitIdleWithoutBacklog) {
+    SmallBands queue(2);
+    for (uint64_t i = 0; i < 5; ++i) {
+        ASSERT_TRUE(queue.try_enqueue(0, i));
+    }
+    EXPECT_EQ(drain_bands(queue), (std::vector<size_t>{0, 0, 0, 0, 0}));
+    EXPECT_EQ(queue.reliefs(), 0u);
+}
+
+// Test that every item is delivered exactly once with producers on every band and several consumers
+TEST(PriorityBandQueueTest, ConcurrentProducersAndConsumers) {
+    constexpr size_t PRODUCERS = 4;
+    constexpr size_t CONSUMERS = 2;
+    constexpr uint64_t PER_PRODUCER = 50000;
+    PriorityBandQueue<uint64_t, 256, 4> queue(8);
+
+    std::vector<std::atomic<uint8_t>> seen(PRODUCERS * PER_PRODUCER);
+    std::atomic<size_t> producers_done{0};
+    std::atomic<uint64_t> received{0};
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < PRODUCERS; ++p) {
+        threads.emplace_back([&, p]() {
+            for (uint64_t i = 0; i < PER_PRODUCER; ++i) {
+                while (!queue.try_enqueue(p, p * PER_PRODUCER + i)) {
+                    std::this_thread::yield();
+                }
+            }
+            producers_done.fetch_add(1, std::memory_order_release);
+        });
+    }
+    for (size_t c = 0; c < CONSUMERS; ++c) {
+        threads.emplace_back([&]() {
+            uint64_t value = 0;
+            while (true) {
+                const bool finished = producers_done.load(std::memory_order_acquire) == PRODUCERS;
+                if (queue.try_dequeue(value)) {
+                    seen[value].fetch_add(1, std::memory_order_relaxed);
+                    received.fetch_add(1, std::memory_order_relaxed);
+                } else if (finished && queue.empty()) {
+                    break;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(received.load(), PRODUCERS * PER_PRODUCER);
+    size_t duplicates = 0;
+    for (auto& count : seen) {
+        duplicates += count.load() != 1 ? 1 : 0;
+    }
+    EXPECT_EQ(duplicates, 0u);
+    EXPECT_EQ(queue.ready_mask(), 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,59 @@
+#include "ring_buffer.h"
+#include "mpmc_queue.h"
+#include "../include/baseline_queues.h"
+#include "queue_benchmarks.h"
+
+// Queue families: each maps (element type, capacity) to a concrete queue so the
+// matrix can instantiate it for the payload sweeps as well as for int.
+struct RingBufferFamily {
+    template <typename T, size_t Capacity>
+    using queue = RingBuffer<T, Capacity>;
+};
+
+struct MPMCQueueFamily {
+    template <typename T, size_t Capacity>
+    using queue = MPMCQueue<T, Capacity>;
+};
+
+// The same queues with head and tail 128 bytes apart instead of 64
+struct RingBuffer128Family {
+    template <typename T, size_t Capacity>
+    using queue = RingBuffer<T, Capacity, NoStats, DESTRUCTIVE_INTERFERENCE_SIZE>;
+};
+
+struct MPMCQueue128Family {
+    template <typename T, size_t Capacity>
+    using queue = MPMCQueue<T, Capacity, DESTRUCTIVE_INTERFERENCE_SIZE>;
+};
+
+struct MutexQueueFamily {
+    template <typename T, size_t Capacity>
+    using queue = baseline::MutexQueue<T, Capacity>;
+};
+
+struct TwoLockQueueFamily {
+    template <typename T, size_t Capacity>
+    using queue = baseline::TwoLockQueue<T, Capacity>;
+};
+
+struct MSQueueFamily {
+    template <typename T, size_t Capacity>
+    using queue = baseline::MSQueue<T, Capacity>;
+};
+
+int main(int argc, char** argv) {
+    // Queues under test
+    queue_bench::register_queue_matrix<RingBufferFamily>("RingBuffer");
+    queue_bench::register_queue_matrix<MPMCQueueFamily>("MPMCQueue");
+
+    // Padding width: compare against the 64-byte runs above
+    queue_bench::register_contention_matrix<RingBuffer128Family>("RingBufferPad128");
+    queue_bench::register_contention_matrix<MPMCQueue128Family>("MPMCQueuePad128");
+
+    // Baselines
+    queue_bench::register_queue_matrix<MutexQueueFamily>("MutexQueue");
+    queue_bench::register_queue_matrix<TwoLockQueueFamily>("TwoLockQueue");
+    queue_bench::register_queue_matrix<MSQueueFamily>("MSQueue");
+
+    return queue_bench::run_benchmarks(argc, argv);
+}
@@ -0,0 +1,378 @@
+/**
+ * @file baseline_queues.h
+ * @brief Reference queues every lock-free queue in this module is compared against
+ *
+ * - MutexQueue:   bounded circular buffer behind one mutex, with condition variables
+ *                 for callers that want to block
+ * - TwoLockQueue: Michael & Scott's two-lock linked queue (separate head and tail locks)
+ * - MSQueue:      Michael & Scott's non-blocking linked queue
+ *
+ * All three satisfy ConcurrentQueue and are bounded by Capacity so they can be
+ * measured against RingBuffer and MPMCQueue under identical conditions. The two
+ * linked queues draw their nodes from a preallocated NodePool instead of the heap,
+ * which keeps allocator cost out of the comparison and, as in the original paper,
+ * makes node memory type-stable so the lock-free queue needs no reclamation scheme.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "concurrency_primitives.h"
+#include "seqlock_payload.h"
+
+namespace baseline {
+
+/**
+ * @brief Bounded circular buffer protected by a single mutex
+ *
+ * try_enqueue/try_dequeue never wait for space or data; enqueue_wait/dequeue_wait
+ * block on the condition variables instead.
+ */
+template <typename T, size_t Capacity>
+class MutexQueue {
+    static_assert(Capacity > 0, "Capacity must be greater than 0");
+
+public:
+    using value_type = T;
+
+    MutexQueue() : buffer_(Capacity) {}
+
+    MutexQueue(const MutexQueue&) = delete;
+    MutexQueue& operator=(const MutexQueue&) = delete;
+
+    bool try_enqueue(const T& item) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (size_ == Capacity) {
+                return false;
+            }
+            push_locked(item);
+        }
+        not_empty_.notify_one();
+        return true;
+    }
+
+    bool try_dequeue(T& result) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (size_ == 0) {
+                return false;
+            }
+            pop_locked(result);
+        }
+        not_full_.notify_one();
+        return true;
+    }
+
+    // Blocks until there is room for the item
+    void enqueue_wait(const T& item) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_full_.wait(lock, [this] { return size_ < Capacity; });
+            push_locked(item);
+        }
+        not_empty_.notify_one();
+    }
+
+    // Blocks until an item is available
+    void dequeue_wait(T& result) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            not_empty_.wait(lock, [this] { return size_ > 0; });
+            pop_locked(result);
+        }
+        not_full_.notify_one();
+    }
+
+    bool empty() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return size_ == 0;
+    }
+
+    constexpr size_t capacity() const noexcept {
+        return Capacity;
+    }
+
+private:
+    void push_locked(const T& item) {
+        buffer_[(head_ + size_) % Capacity] = item;
+        size_++;
+    }
+
+    void pop_locked(T& result) {
+        result = std::move(buffer_[head_]);
+        head_ = (head_ + 1) % Capacity;
+        size_--;
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::vector<T> buffer_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+/**
+ * @brief Fixed set of list nodes handed out through a lock-free free list
+ *
+ * Links are 32-bit node indices packed with a 32-bit modification tag into one
+ * 64-bit word (the "counted pointers" of Michael & Scott), so a CAS cannot succeed
+ * against a node that was popped and pushed back in the meantime (ABA).
+ */
+template <typename T>
+class NodePool {
+public:
+    static constexpr uint32_t kNull = UINT32_MAX;
+
+    struct Node {
+        std::atomic<uint64_t> next{0};       // Tagged link used by the queue
+        std::atomic<uint32_t> free_next{0};  // Link used while the node sits in the free list
+        T value{};
+    };
+
+    static constexpr uint64_t pack(uint32_t index, uint32_t tag) noexcept {
+        return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+    static constexpr uint32_t index_of(uint64_t tagged) noexcept {
+        return static_cast<uint32_t>(tagged);
+    }
+    static constexpr uint32_t tag_of(uint64_t tagged) noexcept {
+        return static_cast<uint32_t>(tagged >> 32);
+    }
+
+    explicit NodePool(size_t count) : nodes_(new Node[count]) {
+        // Chain every node into the free list
+        for (size_t i = 0; i < count; ++i) {
+            nodes_[i].free_next.store(i + 1 < count ? static_cast<uint32_t>(i + 1) : kNull,
+                                      std::memory_order_relaxed);
+        }
+        free_.data.store(pack(count > 0 ? 0 : kNull, 0), std::memory_order_relaxed);
+    }
+
+    Node& operator[](uint32_t index) noexcept {
+        return nodes_[index];
+    }
+
+    // Returns a node index, or kNull when the pool is exhausted
+    uint32_t allocate() noexcept {
+        uint64_t top = free_.data.load(std::memory_order_acquire);
+        while (index_of(top) != kNull) {
+            uint32_t next = nodes_[index_of(top)].free_next.load(std::memory_order_relaxed);
+            if (free_.data.compare_exchange_weak(top, pack(next, tag_of(top) + 1),
+                                                 std::memory_order_acquire,
+                                                 std::memory_order_acquire)) {
+                return index_of(top);
+            }
+        }
+        return kNull;
+    }
+
+    void release(uint32_t index) noexcept {
+        uint64_t top = free_.data.load(std::memory_order_relaxed);
+        do {
+            nodes_[index].free_next.store(index_of(top), std::memory_order_relaxed);
+        } while (!free_.data.compare_exchange_weak(top, pack(index, tag_of(top) + 1),
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed));
+    }
+
+private:
+    std::unique_ptr<Node[]> nodes_;
+    CacheLineAligned<std::atomic<uint64_t>> free_;
+};
+
+/**
+ * @brief Michael & Scott two-lock queue
+ *
+ * A singly linked list with a dummy head node; producers only take the tail
+ * lock and consumers only take the head lock, so one producer and one consumer
+ * never contend with each other.
+ */
+template <typename T, size_t Capacity>
+class TwoLockQueue {
+    using Pool = NodePool<T>;
+    static constexpr uint32_t kNull = Pool::kNull;
+
+public:
+    using value_type = T;
+
+    TwoLockQueue() : pool_(Capacity + 1) {
+        // The list always holds one dummy node
+        uint32_t dummy = pool_.allocate();
+        pool_[dummy].next.store(Pool::pack(kNull, 0), std::memory_order_relaxed);
+        head_.data = dummy;
+        tail_.data = dummy;
+    }
+
+    TwoLockQueue(const TwoLockQueue&) = delete;
+    TwoLockQueue& operator=(const TwoLockQueue&) = delete;
+
+    bool try_enqueue(const T& item) {
+        uint32_t node = pool_.allocate();
+        if (node == kNull) {
+            return false;
+        }
+        pool_[node].value = item;
+        pool_[node].next.store(Pool::pack(kNull, 0), std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(tail_lock_.data);
+        // Release pairs with the consumer's acquire load of next, publishing the value
+        pool_[tail_.data].next.store(Pool::pack(node, 0), std::memory_order_release);
+        tail_.data = node;
+        return true;
+    }
+
+    bool try_dequeue(T& result) {
+        uint32_t old_head;
+        {
+            std::lock_guard<std::mutex> lock(head_lock_.data);
+            old_head = head_.data;
+            uint32_t next = Pool::index_of(pool_[old_head].next.load(std::memory_order_acquire));
+            if (next == kNull) {
+                return false;
+            }
+            result = std::move(pool_[next].value);
+            head_.data = next;  // next becomes the new dummy
+        }
+        pool_.release(old_head);
+        return true;
+    }
+
+    bool empty() const {
+        std::lock_guard<std::mutex> lock(head_lock_.data);
+        return Pool::index_of(pool_[head_.data].next.load(std::memory_order_acquire)) == kNull;
+    }
+
+    constexpr size_t capacity() const noexcept {
+        return Capacity;
+    }
+
+private:
+    mutable Pool pool_;
+    mutable CacheLineAligned<std::mutex> head_lock_;
+    CacheLineAligned<uint32_t> head_;
+    CacheLineAligned<std::mutex> tail_lock_;
+    CacheLineAligned<uint32_t> tail_;
+};
+
+/**
+ * @brief Michael & Scott non-blocking queue
+ *
+ * head_ and tail_ are tagged node indices updated with CAS; a lagging tail is
+ * helped forward by whichever thread notices it. Dequeue copies the value out
+ * before its CAS (the node may be recycled immediately afterwards), so that copy
+ * can race a producer refilling the node. Nodes hold the value as a
+ * SeqLockPayload, whose relaxed atomic words make the racy copy well defined; a
+ * torn copy is discarded when the CAS fails. T must be trivially copyable.
+ */
+template <typename T, size_t Capacity>
+class MSQueue {
+    static_assert(std::is_trivially_copyable_v<T>, "MSQueue copies values out before claiming them");
+
+    using Pool = NodePool<SeqLockPayload<T>>;
+    static constexpr uint32_t kNull = Pool::kNull;
+
+public:
+    using value_type = T;
+
+    MSQueue() : pool_(Capacity + 1) {
+        uint32_t dummy = pool_.allocate();
+        pool_[dummy].next.store(Pool::pack(kNull, 0), std::memory_order_relaxed);
+        head_.data.store(Pool::pack(dummy, 0), std::memory_order_relaxed);
+        tail_.data.store(Pool::pack(dummy, 0), std::memory_order_relaxed);
+    }
+
+    MSQueue(const MSQueue&) = delete;
+    MSQueue& operator=(const MSQueue&) = delete;
+
+    bool try_enqueue(const T& item) noexcept {
+        uint32_t node = pool_.allocate();
+        if (node == kNull) {
+            return false;
+        }
+        pool_[node].value.store(item);
+        uint64_t old_next = pool_[node].next.load(std::memory_order_relaxed);
+        pool_[node].next.store(Pool::pack(kNull, Pool::tag_of(old_next) + 1), std::memory_order_relaxed);
+
+        uint64_t tail;
+        while (true) {
+            tail = tail_.data.load(std::memory_order_acquire);
+            uint64_t next = pool_[Pool::index_of(tail)].next.load(std::memory_order_acquire);
+            if (tail != tail_.data.load(std::memory_order_acquire)) {
+                continue;
+            }
+            if (Pool::index_of(next) == kNull) {
+                // Tail is the last node: try to link the new node after it
+                if (pool_[Pool::index_of(tail)].next.compare_exchange_weak(
+                        next, Pool::pack(node, Pool::tag_of(next) + 1),
+                        std::memory_order_release, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else {
+                // Tail is lagging behind: help move it forward
+                tail_.data.compare_exchange_weak(tail, Pool::pack(Pool::index_of(next), Pool::tag_of(tail) + 1),
+                                                 std::memory_order_release, std::memory_order_relaxed);
+            }
+        }
+        // Swing tail to the new node (another thread may already have done it)
+        tail_.data.compare_exchange_strong(tail, Pool::pack(node, Pool::tag_of(tail) + 1),
+                                           std::memory_order_release, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool try_dequeue(T& result) noexcept {
+        uint64_t head;
+        while (true) {
+            head = head_.data.load(std::memory_order_acquire);
+            uint64_t tail = tail_.data.load(std::memory_order_acquire);
+            uint64_t next = pool_[Pool::index_of(head)].next.load(std::memory_order_acquire);
+            if (head != head_.data.load(std::memory_order_acquire)) {
+                continue;
+            }
+            if (Pool::index_of(head) == Pool::index_of(tail)) {
+                if (Pool::index_of(next) == kNull) {
+                    return false;  // Empty
+                }
+                // Tail is lagging behind: help move it forward
+                tail_.data.compare_exchange_weak(tail, Pool::pack(Pool::index_of(next), Pool::tag_of(tail) + 1),
+                                                 std::memory_order_release, std::memory_order_relaxed);
+            } else {
+                // Read the value before the CAS, otherwise another dequeue might recycle the node
+                T value;
+                pool_[Pool::index_of(next)].value.load(value);
+                if (head_.data.compare_exchange_weak(head, Pool::pack(Pool::index_of(next), Pool::tag_of(head) + 1),
+                                                     std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    result = value;
+                    break;
+                }
+            }
+        }
+        pool_.release(Pool::index_of(head));
+        return true;
+    }
+
+    bool empty() const noexcept {
+        uint64_t head = head_.data.load(std::memory_order_acquire);
+        return Pool::index_of(pool_[Pool::index_of(head)].next.load(std::memory_order_acquire)) == kNull;
+    }
+
+    constexpr size_t capacity() const noexcept {
+        return Capacity;
+    }
+
+private:
+    mutable Pool pool_;
+    CacheLineAligned<std::atomic<uint64_t>> head_;
+    CacheLineAligned<std::atomic<uint64_t>> tail_;
+};
+
+}  // namespace baseline
@@ -0,0 +1,173 @@
+#include "ring_buffer.h"
+#include "mpmc_queue.h"
+#include "../include/baseline_queues.h"
+#include "concurrent_queue.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <memory>
+
+// Every queue must satisfy the concept the benchmark matrix is written against
+static_assert(ConcurrentQueue<RingBuffer<int, 16>>);
+static_assert(ConcurrentQueue<MPMCQueue<int, 16>>);
+static_assert(ConcurrentQueue<baseline::MutexQueue<int, 16>>);
+static_assert(ConcurrentQueue<baseline::TwoLockQueue<int, 16>>);
+static_assert(ConcurrentQueue<baseline::MSQueue<int, 16>>);
+
+static_assert(!queue_supports_multi_producer<RingBuffer<int, 16>>());
+static_assert(queue_supports_multi_producer<MPMCQueue<int, 16>>());
+
+// The same suite runs against every queue
+template <typename Q>
+class QueueConformanceTest : public ::testing::Test {
+protected:
+    static constexpr size_t CAPACITY = 64;
+
+    // Some queues may fail a dequeue spuriously when racing other consumers, so retry a few times
+    static bool dequeue_with_retry(Q& queue, int& value) {
+        for (int attempt = 0; attempt < 16; ++attempt) {
+            if (queue.try_dequeue(value)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::unique_ptr<Q> queue_ = std::make_unique<Q>();
+};
+
+using QueueTypes = ::testing::Types<
+    RingBuffer<int, 64>,
+    MPMCQueue<int, 64>,
+    RingBuffer<int, 64, NoStats, DESTRUCTIVE_INTERFERENCE_SIZE>,
+    MPMCQueue<int, 64, DESTRUCTIVE_INTERFERENCE_SIZE>,
+    baseline::MutexQueue<int, 64>,
+    baseline::TwoLockQueue<int, 64>,
+    baseline::MSQueue<int, 64>>;
+TYPED_TEST_SUITE(QueueConformanceTest, QueueTypes);
+
+// Test that a new queue is empty
+TYPED_TEST(QueueConformanceTest, EmptyOnConstruction) {
+    auto& queue = *this->queue_;
+    int value = 0;
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.capacity(), TestFixture::CAPACITY);
+    EXPECT_FALSE(queue.try_dequeue(value));
+}
+
+// Test first-in first-out ordering on a single thread
+TYPED_TEST(QueueConformanceTest, FifoOrder) {
+    auto& queue = *this->queue_;
+    int value = 0;
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(queue.try_enqueue(i));
+    }
+    EXPECT_FALSE(queue.empty());
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(TestFixture::dequeue_with_retry(queue, value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+// Test that a full queue rejects further items until one is removed
+TYPED_TEST(QueueConformanceTest, RejectsWhenFull) {
+    auto& queue = *this->queue_;
+    int value = 0;
+
+    for (size_t i = 0; i < TestFixture::CAPACITY; ++i) {
+        EXPECT_TRUE(queue.try_enqueue(static_cast<int>(i)));
+    }
+    EXPECT_FALSE(queue.try_enqueue(-1));
+
+    EXPECT_TRUE(TestFixture::dequeue_with_retry(queue, value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(queue.try_enqueue(-1));
+}
+
+// Test repeated fill/drain cycles across the wrap-around point
+TYPED_TEST(QueueConformanceTest, Wraparound) {
+    auto& queue = *this->queue_;
+    int value = 0;
+
+    for (int iteration = 0; iteration < 10; ++iteration) {
+        for (size_t i = 0; i < TestFixture::CAPACITY; ++i) {
+            EXPECT_TRUE(queue.try_enqueue(static_cast<int>(i + iteration * 100)));
+        }
+        for (size_t i = 0; i < TestFixture::CAPACITY; ++i) {
+            EXPECT_TRUE(TestFixture::dequeue_with_retry(queue, value));
+            EXPECT_EQ(value, static_cast<int>(i + iteration * 100));
+        }
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+// Test that concurrent producers and consumers neither lose nor duplicate items,
+// and that each producer's items come out in the order they went in
+TYPED_TEST(QueueConformanceTest, ConcurrentNoLossNoDuplicates) {
+    using Q = TypeParam;
+    auto& queue = *this->queue_;
+
+    constexpr size_t NUM_ITEMS_PER_PRODUCER = 20000;
+    const size_t num_producers = queue_supports_multi_producer<Q>() ? 2 : 1;
+    const size_t num_consumers = queue_supports_multi_consumer<Q>() ? 2 : 1;
+    const size_t total_items = NUM_ITEMS_PER_PRODUCER * num_producers;
+
+    std::atomic<size_t> total_consumed(0);
+    std::vector<std::atomic<int>> seen(total_items);
+    std::atomic<bool> order_violation(false);
+
+    auto producer_func = [&](size_t producer_id) {
+        for (size_t i = 0; i < NUM_ITEMS_PER_PRODUCER; ++i) {
+            int value = static_cast<int>(producer_id * NUM_ITEMS_PER_PRODUCER + i);
+            while (!queue.try_enqueue(value)) {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    auto consumer_func = [&]() {
+        std::vector<int> last_seen(num_producers, -1);
+        int value = 0;
+        while (total_consumed.load(std::memory_order_relaxed) < total_items) {
+            if (queue.try_dequeue(value)) {
+                seen[value].fetch_add(1, std::memory_order_relaxed);
+                size_t producer_id = static_cast<size_t>(value) / NUM_ITEMS_PER_PRODUCER;
+                if (value <= last_seen[producer_id]) {
+                    order_violation.store(true, std::memory_order_relaxed);
+                }
+                last_seen[producer_id] = value;
+                total_consumed.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_producers; ++i) {
+        threads.emplace_back(producer_func, i);
+    }
+    for (size_t i = 0; i < num_consumers; ++i) {
+        threads.emplace_back(consumer_func);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(total_consumed.load(), total_items);
+    EXPECT_FALSE(order_violation.load()) << "Items from one producer were dequeued out of order";
+    for (size_t i = 0; i < total_items; ++i) {
+        ASSERT_EQ(seen[i].load(), 1) << "Item " << i << " was seen " << seen[i].load() << " times";
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
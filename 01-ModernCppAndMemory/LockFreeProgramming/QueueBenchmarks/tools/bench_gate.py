@@ -0,0 +1,364 @@
+#!/usr/bin/env python3
+"""
+Benchmark driver and regression gate for the queue benchmarks.
+
+`run` executes one or more Google Benchmark binaries with repetitions and
+JSON output, stamps the result with the machine and build it came from (CPU
+model, frequency governor, compiler, commit) and archives it. If a baseline
+file is given, the new result is compared against it and the script exits
+with status 1 when throughput or p99 latency regressed.
+
+`compare` does only the comparison, for two archived result files.
+
+A benchmark counts as regressed when both hold for one of its metrics:
+  - the median moved in the bad direction by more than --threshold, and
+  - a two-sided Mann-Whitney U test over the repetitions gives p < --alpha,
+so a single noisy repetition cannot fail the gate, and neither can a
+statistically real but negligible shift.
+
+Only the Python standard library is used, so the gate runs on any box that
+can build the benchmarks.
+"""
+
+import argparse
+import datetime
+import itertools
+import json
+import math
+import os
+import platform
+import statistics
+import subprocess
+import sys
+
+# Metrics the gate looks at: (JSON field, higher_is_better)
+GATED_METRICS = [
+    ("items_per_second", True),
+    ("p99_ns", False),
+]
+
+EXIT_OK = 0
+EXIT_REGRESSION = 1
+EXIT_ERROR = 2
+
+
+# ---------------------------------------------------------------------------
+# Machine and build description
+# ---------------------------------------------------------------------------
+
+def read_first_line(path):
+    try:
+        with open(path) as f:
+            return f.readline().strip()
+    except OSError:
+        return "unknown"
+
+
+def cpu_model():
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                if line.startswith("model name"):
+                    return line.split(":", 1)[1].strip()
+    except OSError:
+        pass
+    return platform.processor() or "unknown"
+
+
+def cpu_governor():
+    return read_first_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor")
+
+
+def git_commit(source_dir):
+    try:
+        commit = subprocess.run(["git", "rev-parse", "--short=12", "HEAD"], cwd=source_dir,
+                                capture_output=True, text=True, check=True).stdout.strip()
+        dirty = subprocess.run(["git", "status", "--porcelain", "--untracked-files=no"], cwd=source_dir,
+                               capture_output=True, text=True, check=True).stdout.strip()
+        return commit + ("-dirty" if dirty else "")
+    except (OSError, subprocess.CalledProcessError):
+        return "unknown"
+
+
+def machine_context(args):
+    return {
+        "cpu_model": cpu_model(),
+        "cpu_governor": cpu_governor(),
+        "kernel": platform.release(),
+        "compiler": args.compiler or "unknown",
+        "build_type": args.build_type or "unknown",
+        "commit": git_commit(args.source_dir),
+    }
+
+
+# ---------------------------------------------------------------------------
+# Running and archiving
+# ---------------------------------------------------------------------------
+
+def run_binary(binary, args, context, out_path):
+    cmd = [
+        binary,
+        "--benchmark_repetitions=%d" % args.repetitions,
+        "--benchmark_enable_random_interleaving=true",
+        "--benchmark_out=%s" % out_path,
+        "--benchmark_out_format=json",
+        "--sustained_ms=%d" % args.sustained_ms,
+    ]
+    if args.filter:
+        cmd.append("--benchmark_filter=%s" % args.filter)
+    for key, value in context.items():
+        cmd.append("--benchmark_context=%s=%s" % (key, value))
+
+    print("bench_gate: running %s" % " ".join(cmd), flush=True)
+    subprocess.run(cmd, check=True)
+    with open(out_path) as f:
+        return json.load(f)
+
+
+def cmd_run(args):
+    context = machine_context(args)
+    os.makedirs(args.results_dir, exist_ok=True)
+    stamp = datetime.datetime.now().strftime("%Y%m%d-%H%M%S")
+
+    merged = None
+    for binary in args.bench:
+        name = os.path.basename(binary)
+        raw_path = os.path.join(args.results_dir, "%s_%s_%s.raw.json" % (stamp, context["commit"], name))
+        try:
+            result = run_binary(binary, args, context, raw_path)
+        except (OSError, subprocess.CalledProcessError) as e:
+            print("bench_gate: %s failed: %s" % (binary, e), file=sys.stderr)
+            return EXIT_ERROR
+        os.remove(raw_path)
+        if merged is None:
+            merged = result
+        else:
+            merged["benchmarks"].extend(result["benchmarks"])
+
+    out_path = os.path.join(args.results_dir, "%s_%s.json" % (stamp, context["commit"]))
+    with open(out_path, "w") as f:
+        json.dump(merged, f, indent=2)
+    print("bench_gate: archived %s" % out_path)
+
+    if args.update_baseline:
+        if not args.baseline:
+            print("bench_gate: --update-baseline needs --baseline", file=sys.stderr)
+            return EXIT_ERROR
+        os.makedirs(os.path.dirname(os.path.abspath(args.baseline)), exist_ok=True)
+        with open(args.baseline, "w") as f:
+            json.dump(merged, f, indent=2)
+        print("bench_gate: baseline updated at %s" % args.baseline)
+        return EXIT_OK
+
+    if not args.baseline:
+        return EXIT_OK
+    if not os.path.exists(args.baseline):
+        print("bench_gate: no baseline at %s; rerun with --update-baseline to create one" % args.baseline)
+        return EXIT_OK
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    return compare(baseline, merged, args.threshold, args.alpha)
+
+
+# ---------------------------------------------------------------------------
+# Statistics
+# ---------------------------------------------------------------------------
+
+def rank(values):
+    """Average ranks (1-based), with tied values sharing the mean of their ranks."""
+    order = sorted(range(len(values)), key=lambda i: values[i])
+    ranks = [0.0] * len(values)
+    i = 0
+    while i < len(order):
+        j = i
+        while j + 1 < len(order) and values[order[j + 1]] == values[order[i]]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[order[k]] = (i + j) / 2.0 + 1.0
+        i = j + 1
+    return ranks
+
+
+def exact_u_distribution(n1, n2):
+    """Number of arrangements giving each U value, for untied samples of size n1 and n2."""
+    # counts[m][n][u] via the classic recurrence, built up one sample size at a time
+    counts = {(0, n): [1] for n in range(n2 + 1)}
+    for m in range(1, n1 + 1):
+        counts[(m, 0)] = [1]
+        for n in range(1, n2 + 1):
+            with_last_x = [0] * n + counts[(m - 1, n)]  # last element from sample 1 beats all n of sample 2
+            without = counts[(m, n - 1)]
+            size = max(len(with_last_x), len(without))
+            counts[(m, n)] = [(with_last_x[u] if u < len(with_last_x) else 0) +
+                              (without[u] if u < len(without) else 0) for u in range(size)]
+    return counts[(n1, n2)]
+
+
+def mann_whitney_u(a, b):
+    """Two-sided Mann-Whitney U test. Returns (U for sample a, p-value)."""
+    n1, n2 = len(a), len(b)
+    if n1 == 0 or n2 == 0:
+        return 0.0, 1.0
+
+    ranks = rank(list(a) + list(b))
+    u1 = sum(ranks[:n1]) - n1 * (n1 + 1) / 2.0
+    u_min = min(u1, n1 * n2 - u1)
+    has_ties = len(set(a) | set(b)) < n1 + n2
+
+    # Small untied samples: exact distribution; otherwise the normal approximation
+    if not has_ties and n1 <= 20 and n2 <= 20:
+        dist = exact_u_distribution(n1, n2)
+        total = math.comb(n1 + n2, n1)
+        tail = sum(dist[:int(u_min) + 1])
+        return u1, min(1.0, 2.0 * tail / total)
+
+    n = n1 + n2
+    tie_term = 0.0
+    for _, group in itertools.groupby(sorted(list(a) + list(b))):
+        t = len(list(group))
+        tie_term += t ** 3 - t
+    sigma = math.sqrt(n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1))))
+    if sigma == 0.0:
+        return u1, 1.0
+    z = (abs(u1 - n1 * n2 / 2.0) - 0.5) / sigma  # Continuity correction
+    return u1, min(1.0, math.erfc(max(z, 0.0) / math.sqrt(2.0)))
+
+
+# ---------------------------------------------------------------------------
+# Comparison
+# ---------------------------------------------------------------------------
+
+def collect_samples(result):
+    """Per-repetition values of each gated metric, keyed by benchmark name."""
+    samples = {}
+    for bench in result.get("benchmarks", []):
+        if bench.get("run_type", "iteration") != "iteration" or bench.get("error_occurred"):
+            continue
+        name = bench.get("run_name", bench["name"])
+        for metric, _ in GATED_METRICS:
+            if metric in bench:
+                samples.setdefault((name, metric), []).append(float(bench[metric]))
+    return samples
+
+
+def warn_on_context_mismatch(baseline, current):
+    keys = ["cpu_model", "cpu_governor", "compiler", "build_type", "num_cpus"]
+    base_ctx, cur_ctx = baseline.get("context", {}), current.get("context", {})
+    for key in keys:
+        if str(base_ctx.get(key)) != str(cur_ctx.get(key)):
+            print("bench_gate: warning: %s differs (baseline %r, current %r); results may not be comparable"
+                  % (key, base_ctx.get(key), cur_ctx.get(key)))
+    if cur_ctx.get("cpu_scaling_enabled"):
+        print("bench_gate: warning: CPU frequency scaling is enabled; expect noisy results")
+
+
+def compare(baseline, current, threshold, alpha):
+    warn_on_context_mismatch(baseline, current)
+    print("bench_gate: baseline commit %s, current commit %s" %
+          (baseline.get("context", {}).get("commit", "?"), current.get("context", {}).get("commit", "?")))
+
+    base_samples = collect_samples(baseline)
+    cur_samples = collect_samples(current)
+    higher_is_better = dict(GATED_METRICS)
+
+    regressions = []
+    rows = []
+    underpowered = False
+    for key in sorted(cur_samples):
+        if key not in base_samples:
+            continue
+        name, metric = key
+        before, after = base_samples[key], cur_samples[key]
+        base_median, cur_median = statistics.median(before), statistics.median(after)
+        if base_median == 0.0:
+            continue
+        change = (cur_median - base_median) / base_median
+        worse = -change if higher_is_better[metric] else change
+        _, p_value = mann_whitney_u(before, after)
+        if 2.0 / math.comb(len(before) + len(after), len(before)) >= alpha:
+            underpowered = True
+
+        if worse > threshold and p_value < alpha:
+            verdict = "REGRESSED"
+            regressions.append(key)
+        elif -worse > threshold and p_value < alpha:
+            verdict = "improved"
+        else:
+            verdict = ""
+        rows.append((name, metric, base_median, cur_median, change, p_value, verdict))
+
+    if not rows:
+        print("bench_gate: no benchmarks in common with the baseline")
+        return EXIT_OK
+
+    name_width = max(len(r[0]) for r in rows)
+    print("%-*s  %-16s %14s %14s %8s %7s" % (name_width, "Benchmark", "Metric", "Baseline", "Current", "Change", "p"))
+    for name, metric, before, after, change, p_value, verdict in rows:
+        print("%-*s  %-16s %14.4g %14.4g %+7.1f%% %7.3f  %s" %
+              (name_width, name, metric, before, after, change * 100.0, p_value, verdict))
+
+    if underpowered:
+        print("bench_gate: warning: too few repetitions for p < %.3f to be reachable; use at least 4 (8 recommended)"
+              % alpha)
+
+    missing = sorted(set(k[0] for k in base_samples) - set(k[0] for k in cur_samples))
+    if missing:
+        print("bench_gate: %d baseline benchmarks were not run this time" % len(missing))
+
+    if regressions:
+        print("bench_gate: %d regression(s) beyond %.1f%% at p < %.3f" % (len(regressions), threshold * 100.0, alpha))
+        return EXIT_REGRESSION
+    print("bench_gate: no regressions beyond %.1f%% at p < %.3f" % (threshold * 100.0, alpha))
+    return EXIT_OK
+
+
+def cmd_compare(args):
+    try:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        with open(args.current) as f:
+            current = json.load(f)
+    except (OSError, ValueError) as e:
+        print("bench_gate: %s" % e, file=sys.stderr)
+        return EXIT_ERROR
+    return compare(baseline, current, args.threshold, args.alpha)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    def add_gate_options(p):
+        p.add_argument("--threshold", type=float, default=0.05,
+                       help="relative change in the median that counts as a regression (default 0.05)")
+        p.add_argument("--alpha", type=float, default=0.05,
+                       help="significance level for the Mann-Whitney U test (default 0.05)")
+
+    run = sub.add_parser("run", help="run benchmarks, archive the result and compare it against a baseline")
+    run.add_argument("--bench", action="append", required=True, help="benchmark binary (repeatable)")
+    run.add_argument("--results-dir", required=True, help="directory the archived results are written to")
+    run.add_argument("--baseline", help="baseline result file to compare against")
+    run.add_argument("--update-baseline", action="store_true", help="write this run to --baseline instead of comparing")
+    run.add_argument("--repetitions", type=int, default=8)
+    run.add_argument("--filter", default="", help="--benchmark_filter passed to every binary")
+    run.add_argument("--sustained-ms", type=int, default=500, help="duration of each multi-threaded run")
+    run.add_argument("--compiler", default="", help="compiler description recorded with the result")
+    run.add_argument("--build-type", default="", help="build type recorded with the result")
+    run.add_argument("--source-dir", default=os.path.dirname(os.path.abspath(__file__)),
+                     help="git checkout whose commit is recorded")
+    add_gate_options(run)
+    run.set_defaults(func=cmd_run)
+
+    cmp = sub.add_parser("compare", help="compare two archived results")
+    cmp.add_argument("baseline")
+    cmp.add_argument("current")
+    add_gate_options(cmp)
+    cmp.set_defaults(func=cmd_compare)
+
+    args = parser.parse_args()
+    return args.func(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,110 @@
+#include "../include/queue_set.h"
+#include "queue_benchmarks.h"
+#include "ring_buffer.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+using Ring = RingBuffer<uint64_t, 64>;
+
+// Queues are allocated one by one, as a strategy's feeds would be, so their counters are not packed together
+static std::vector<std::unique_ptr<Ring>> make_rings(size_t count) {
+    std::vector<std::unique_ptr<Ring>> rings;
+    for (size_t i = 0; i < count; ++i) {
+        rings.push_back(std::make_unique<Ring>());
+    }
+    return rings;
+}
+
+// Visits queues in a scattered order, so neither approach is helped by always finding the first one ready
+static size_t next_queue(size_t previous, size_t count) {
+    return (previous + 7) % count;
+}
+
+/**
+ * @brief One poll of N queues that finds one item, by trying every queue in turn
+ *
+ * Each iteration pushes one item into a queue, then the consumer loops over
+ * all N queues with try_dequeue(), as a strategy thread polling its feeds would.
+ */
+static void BM_PollEach(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    auto rings = make_rings(count);
+    size_t target = 0;
+    uint64_t value = 0;
+    uint64_t sum = 0;
+    for (auto _ : state) {
+        target = next_queue(target, count);
+        rings[target]->try_enqueue(value++);
+        for (auto& ring : rings) {
+            uint64_t item;
+            if (ring->try_dequeue(item)) {
+                sum += item;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief The same, with the queues in a QueueSet: one pass over the bitset, then only the ready queue
+ *
+ * The push goes through the Source, so its fence and bit update are counted too.
+ */
+static void BM_Select(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    auto rings = make_rings(count);
+    auto set = std::make_unique<QueueSet<256>>();
+    std::vector<QueueSet<256>::Source<Ring>> sources;
+    for (auto& ring : rings) {
+        sources.push_back(set->add(*ring));
+    }
+    size_t target = 0;
+    uint64_t value = 0;
+    uint64_t sum = 0;
+    for (auto _ : state) {
+        target = next_queue(target, count);
+        sources[target].try_enqueue(value++);
+        for (size_t index : set->poll()) {
+            uint64_t item;
+            while (set->try_dequeue(sources[index], item)) {
+                sum += item;
+            }
+        }
+    }
+    benchmark::DoNotOptimize(sum);
+    state.SetItemsProcessed(state.iterations());
+}
+
+// One poll that finds every queue empty, the common case for a strategy's feeds
+static void BM_IdlePollEach(benchmark::State& state) {
+    auto rings = make_rings(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        bool found = false;
+        for (auto& ring : rings) {
+            found |= !ring->empty();
+        }
+        benchmark::DoNotOptimize(found);
+    }
+}
+
+static void BM_IdleSelect(benchmark::State& state) {
+    auto rings = make_rings(static_cast<size_t>(state.range(0)));
+    auto set = std::make_unique<QueueSet<256>>();
+    for (auto& ring : rings) {
+        set->add(*ring);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(set->poll().any());
+    }
+}
+
+BENCHMARK(BM_PollEach)->Arg(1)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BM_Select)->Arg(1)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BM_IdlePollEach)->Arg(1)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(BM_IdleSelect)->Arg(1)->Arg(16)->Arg(64)->Arg(256);
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
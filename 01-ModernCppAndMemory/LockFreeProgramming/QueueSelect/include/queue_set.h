@@ -0,0 +1,337 @@
+/**
+ * @file queue_set.h
+ * @brief Select over many queues: one consumer finds the ready ones in one pass
+ *
+ * A consumer that polls twenty queues in a loop touches each queue's head and
+ * tail every time, even though most of them are empty. Here the consumer
+ * registers its queues with a QueueSet, and producers push through a Source
+ * that also sets the queue's bit in a shared readiness bitset. poll() reads
+ * the bitset, a few words for hundreds of queues, and returns the indices of
+ * the queues that may hold items. When every queue is empty, wait() can put
+ * the consumer to sleep until a producer sets a bit.
+ *
+ * Any queue with try_dequeue(T&) and empty() can be registered, such as
+ * RingBuffer and MPMCQueue, and one set can mix them.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "concurrency_primitives.h"
+#include "ready_mask.h"
+
+/**
+ * @brief Readiness bitset over up to MaxQueues queues, with one consumer
+ *
+ * The consumer registers queues with add() and takes items with
+ * try_dequeue() or drain() on the indices poll() or wait() return. Producers
+ * push with Source::try_enqueue(), or push to the queue directly and then
+ * call notify(). A producer writes the bitset only when the queue's bit is
+ * clear, which happens only after the consumer found the queue empty, so a
+ * busy queue costs its producers one fence and one read of a shared line.
+ *
+ * @tparam MaxQueues Queues that can be registered at once
+ */
+template <size_t MaxQueues = 256>
+class QueueSet {
+    static_assert(MaxQueues > 0, "MaxQueues must be greater than 0");
+
+    static constexpr size_t WORDS = ReadyMask<MaxQueues>::WORDS;
+
+public:
+    // Returned by add() when every index is taken
+    static constexpr size_t NO_INDEX = ~size_t{0};
+
+    /**
+     * @brief The producers' side of one registered queue
+     *
+     * A small value: copy it to each producer of the queue.
+     */
+    template <typename Queue>
+    class Source {
+    public:
+        Source() noexcept = default;
+
+        /**
+         * @brief Pushes an item into the queue and marks the queue ready
+         *
+         * @return false if the queue is full
+         */
+        template <typename U>
+        bool try_enqueue(U&& value) noexcept {
+            if (!queue_->try_enqueue(std::forward<U>(value))) {
+                return false;
+            }
+            set_->notify(index_);
+            return true;
+        }
+
+        Queue& queue() const noexcept {
+            return *queue_;
+        }
+
+        size_t index() const noexcept {
+            return index_;
+        }
+
+        bool valid() const noexcept {
+            return index_ != NO_INDEX;
+        }
+
+    private:
+        friend class QueueSet;
+
+        Source(QueueSet* set, Queue* queue, size_t index) noexcept : set_(set), queue_(queue), index_(index) {}
+
+        QueueSet* set_ = nullptr;
+        Queue* queue_ = nullptr;
+        size_t index_ = NO_INDEX;
+    };
+
+    /**
+     * @brief A snapshot of the readiness bitset; iterating it yields queue indices in order
+     */
+    class Ready {
+    public:
+        class iterator {
+        public:
+            size_t operator*() const noexcept {
+                return word_ * 64 + static_cast<size_t>(std::countr_zero(bits_));
+            }
+
+            iterator& operator++() noexcept {
+                bits_ &= bits_ - 1;
+                skip_empty_words();
+                return *this;
+            }
+
+            bool operator==(const iterator& other) const noexcept {
+                return word_ == other.word_ && bits_ == other.bits_;
+            }
+
+        private:
+            friend class Ready;
+
+            iterator(const Ready* ready, size_t word) noexcept
+                : ready_(ready), word_(word), bits_(word < WORDS ? ready->words_[word] : 0) {
+                skip_empty_words();
+            }
+
+            void skip_empty_words() noexcept {
+                while (bits_ == 0 && word_ < WORDS) {
+                    ++word_;
+                    bits_ = word_ < WORDS ? ready_->words_[word_] : 0;
+                }
+            }
+
+            const Ready* ready_;
+            size_t word_;
+            uint64_t bits_;
+        };
+
+        iterator begin() const noexcept {
+            return iterator(this, 0);
+        }
+
+        iterator end() const noexcept {
+            return iterator(this, WORDS);
+        }
+
+        bool any() const noexcept {
+            for (uint64_t word : words_) {
+                if (word != 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        size_t count() const noexcept {
+            size_t total = 0;
+            for (uint64_t word : words_) {
+                total += static_cast<size_t>(std::popcount(word));
+            }
+            return total;
+        }
+
+        bool contains(size_t index) const noexcept {
+            return (words_[index / 64] >> (index % 64) & 1) != 0;
+        }
+
+    private:
+        friend class QueueSet;
+
+        std::array<uint64_t, WORDS> words_{};
+    };
+
+    QueueSet() noexcept = default;
+
+    QueueSet(const QueueSet&) = delete;
+    QueueSet& operator=(const QueueSet&) = delete;
+
+    /**
+     * @brief Registers a queue; consumer only
+     *
+     * Items already in the queue are reported by the next poll().
+     *
+     * @return The queue's Source, or an invalid Source if all MaxQueues are taken
+     */
+    template <typename Queue>
+    Source<Queue> add(Queue& queue) noexcept {
+        for (size_t word = 0; word < WORDS; ++word) {
+            const uint64_t free = ~registered_[word] & valid_bits(word);
+            if (free == 0) {
+                continue;
+            }
+            const size_t bit = static_cast<size_t>(std::countr_zero(free));
+            registered_[word] |= uint64_t{1} << bit;
+            const size_t index = word * 64 + bit;
+            if (!queue.empty()) {
+                notify(index);
+            }
+            return Source<Queue>(this, &queue, index);
+        }
+        return Source<Queue>();
+    }
+
+    /**
+     * @brief Unregisters a queue; consumer only, once its producers have stopped using the Source
+     */
+    template <typename Queue>
+    void remove(const Source<Queue>& source) noexcept {
+        const size_t index = source.index();
+        registered_[index / 64] &= ~(uint64_t{1} << (index % 64));
+        ready_.clear(index);
+    }
+
+    /**
+     * @brief Marks a queue ready after pushing to it directly; callable from any thread
+     *
+     * Wakes the consumer if it is asleep in wait(). Source::try_enqueue()
+     * calls this for you.
+     */
+    void notify(size_t index) noexcept {
+        if (ready_.mark(index)) {
+            parker_.notify();
+        }
+    }
+
+    /**
+     * @brief Queues that may hold items; consumer only
+     *
+     * Reads the bitset once, WORDS loads in all. A queue can be listed and
+     * turn out empty if another consumer of it got there first.
+     */
+    Ready poll() const noexcept {
+        Ready ready;
+        for (size_t word = 0; word < WORDS; ++word) {
+            ready.words_[word] = ready_.load(word);
+        }
+        return ready;
+    }
+
+    /**
+     * @brief Like poll(), but sleeps until a queue is ready; consumer only
+     *
+     * Polls up to spins times before going to sleep on a futex (through
+     * std::atomic::wait). May return an empty set after wake().
+     */
+    Ready wait(size_t spins = 256) {
+        for (size_t i = 0; i < spins; ++i) {
+            Ready ready = poll();
+            if (ready.any()) {
+                return ready;
+            }
+            cpu_pause();
+        }
+        parker_.park([this]() { return poll().any(); });
+        return poll();
+    }
+
+    /**
+     * @brief Makes a sleeping wait() return even though no queue is ready, e.g. to shut down
+     */
+    void wake() noexcept {
+        parker_.notify();
+    }
+
+    /**
+     * @brief Takes one item from a registered queue; consumer only
+     *
+     * Clears the queue's bit if it is found empty.
+     *
+     * @return false if the queue is empty
+     */
+    template <typename Queue, typename T>
+    bool try_dequeue(const Source<Queue>& source, T& result) noexcept {
+        if (source.queue().try_dequeue(result)) {
+            return true;
+        }
+        settle(source);
+        return false;
+    }
+
+    /**
+     * @brief Takes up to max items from a registered queue; consumer only
+     *
+     * Clears the queue's bit if it runs dry before max.
+     *
+     * @param handler Called with each item, as handler(T&&)
+     * @return The number of items handed to handler
+     */
+    template <typename Queue, typename Handler>
+    size_t drain(const Source<Queue>& source, Handler&& handler, size_t max = 64) {
+        typename Queue::value_type value;
+        size_t taken = 0;
+        while (taken < max && source.queue().try_dequeue(value)) {
+            handler(std::move(value));
+            ++taken;
+        }
+        if (taken < max) {
+            settle(source);
+        }
+        return taken;
+    }
+
+    /**
+     * @brief Registered queues
+     */
+    size_t size() const noexcept {
+        size_t total = 0;
+        for (uint64_t word : registered_) {
+            total += static_cast<size_t>(std::popcount(word));
+        }
+        return total;
+    }
+
+    static constexpr size_t max_queues() noexcept {
+        return MaxQueues;
+    }
+
+private:
+    static constexpr uint64_t valid_bits(size_t word) noexcept {
+        const size_t bits = MaxQueues - word * 64;
+        return bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+    }
+
+    // Clears the bit of a queue found empty, keeping it if an item arrived meanwhile
+    template <typename Queue>
+    void settle(const Source<Queue>& source) noexcept {
+        ready_.settle(source.index(), [&source]() { return !source.queue().empty(); });
+    }
+
+    // Queues that may hold items
+    ReadyMask<MaxQueues> ready_;
+
+    // The consumer sleeps here in wait(); producers look for it only when a bit goes from clear to set
+    ThreadParker parker_;
+
+    // Indices in use (consumer only)
+    alignas(CACHE_LINE_SIZE) std::array<uint64_t, WORDS> registered_{};
+};
@@ -0,0 +1,87 @@
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "../include/queue_set.h"
+#include "mpmc_queue.h"
+#include "ring_buffer.h"
+
+struct FeedEvent {
+    uint32_t feed = 0;
+    uint64_t sequence = 0;
+};
+
+int main() {
+    std::cout << "Queue Set Demo\n";
+    std::cout << "==============\n\n";
+
+    constexpr size_t FEEDS = 24;
+    constexpr uint64_t PER_FEED = 2000;
+    constexpr uint64_t ACKS = 4000;
+
+    // One SPSC ring per market data feed, and one MPMCQueue that every gateway thread acks into
+    using FeedRing = RingBuffer<FeedEvent, 256>;
+    using AckQueue = MPMCQueue<FeedEvent, 256>;
+    auto feeds = std::make_unique<std::array<FeedRing, FEEDS>>();
+    auto acks = std::make_unique<AckQueue>();
+    QueueSet<64> set;
+
+    std::vector<QueueSet<64>::Source<FeedRing>> feed_sources;
+    for (auto& ring : *feeds) {
+        feed_sources.push_back(set.add(ring));
+    }
+    auto ack_source = set.add(*acks);
+
+    // Feeds tick at different rates, so most rings are empty at any moment
+    std::vector<std::thread> producers;
+    for (uint32_t f = 0; f < FEEDS; ++f) {
+        producers.emplace_back([&, f]() {
+            for (uint64_t s = 0; s < PER_FEED; ++s) {
+                while (!feed_sources[f].try_enqueue(FeedEvent{f, s})) {
+                    std::this_thread::yield();
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(50 * (f % 4 + 1)));
+            }
+        });
+    }
+    for (uint32_t g = 0; g < 2; ++g) {
+        producers.emplace_back([&, g]() {
+            for (uint64_t s = 0; s < ACKS / 2; ++s) {
+                while (!ack_source.try_enqueue(FeedEvent{g, s})) {
+                    std::this_thread::yield();
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+    }
+
+    // The strategy thread: sleeps when nothing is ready, and visits only the queues that are
+    std::array<uint64_t, FEEDS> per_feed{};
+    uint64_t acked = 0;
+    uint64_t wakeups = 0;
+    uint64_t visits = 0;
+    uint64_t received = 0;
+    while (received < FEEDS * PER_FEED + ACKS) {
+        ++wakeups;
+        for (size_t index : set.wait()) {
+            ++visits;
+            if (index == ack_source.index()) {
+                received += set.drain(ack_source, [&](FeedEvent&&) { ++acked; });
+            } else {
+                received += set.drain(feed_sources[index], [&](FeedEvent&& event) { ++per_feed[event.feed]; });
+            }
+        }
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    std::cout << "Events: " << received << " from " << set.size() << " queues (" << acked << " acks)\n";
+    std::cout << "Feed 0: " << per_feed[0] << ", feed " << FEEDS - 1 << ": " << per_feed[FEEDS - 1] << "\n";
+    std::cout << "Polls: " << wakeups << ", queues visited per poll: "
+              << static_cast<double>(visits) / static_cast<double>(wakeups) << " of " << set.size() << "\n";
+    return 0;
+}
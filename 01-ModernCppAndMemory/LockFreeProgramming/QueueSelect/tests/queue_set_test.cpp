@@ -0,0 +1,195 @@
+#include "../include/queue_set.h"
+#include "mpmc_queue.h"
+#include "ring_buffer.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using Ring = RingBuffer<uint64_t, 16>;
+using Shared = MPMCQueue<uint64_t, 16>;
+
+template <size_t MaxQueues>
+static std::vector<size_t> indices(const typename QueueSet<MaxQueues>::Ready& ready) {
+    std::vector<size_t> result;
+    for (size_t index : ready) {
+        result.push_back(index);
+    }
+    return result;
+}
+
+// Test that queues get distinct indices until MaxQueues are taken, and a removed index is reused
+TEST(QueueSetTest, AddUpToMaxQueues) {
+    QueueSet<4> set;
+    std::array<Ring, 5> rings;
+    for (size_t i = 0; i < 4; ++i) {
+        auto source = set.add(rings[i]);
+        ASSERT_TRUE(source.valid());
+        EXPECT_EQ(source.index(), i);
+    }
+    auto refused = set.add(rings[4]);
+    EXPECT_FALSE(refused.valid());
+    EXPECT_EQ(set.size(), 4u);
+
+    QueueSet<4> other;
+    auto first = other.add(rings[0]);
+    auto second = other.add(rings[1]);
+    other.remove(first);
+    EXPECT_EQ(other.add(rings[2]).index(), first.index());
+    EXPECT_EQ(second.index(), 1u);
+}
+
+// Test that poll() lists exactly the queues that hold items, whatever their type
+TEST(QueueSetTest, PollListsReadyQueues) {
+    QueueSet<8> set;
+    Ring ring_a;
+    Ring ring_b;
+    Shared shared;
+    auto a = set.add(ring_a);
+    auto b = set.add(ring_b);
+    auto s = set.add(shared);
+    EXPECT_FALSE(set.poll().any());
+
+    ASSERT_TRUE(s.try_enqueue(uint64_t{3}));
+    ASSERT_TRUE(a.try_enqueue(uint64_t{1}));
+    EXPECT_EQ(indices<8>(set.poll()), (std::vector<size_t>{a.index(), s.index()}));
+    EXPECT_FALSE(set.poll().contains(b.index()));
+
+    uint64_t value = 0;
+    ASSERT_TRUE(set.try_dequeue(s, value));
+    EXPECT_EQ(value, 3u);
+    // The bit stays set until the consumer finds the queue empty
+    EXPECT_TRUE(set.poll().contains(s.index()));
+    EXPECT_FALSE(set.try_dequeue(s, value));
+    EXPECT_EQ(indices<8>(set.poll()), (std::vector<size_t>{a.index()}));
+}
+
+// Test that indices past the first word are found, in order
+TEST(QueueSetTest, ReadyAcrossWords) {
+    QueueSet<256> set;
+    auto rings = std::make_unique<std::array<Ring, 256>>();
+    std::vector<QueueSet<256>::Source<Ring>> sources;
+    for (auto& ring : *rings) {
+        sources.push_back(set.add(ring));
+    }
+    for (size_t index : {255u, 3u, 64u, 130u}) {
+        ASSERT_TRUE(sources[index].try_enqueue(uint64_t{index}));
+    }
+    const auto ready = set.poll();
+    EXPECT_EQ(ready.count(), 4u);
+    EXPECT_EQ(indices<256>(ready), (std::vector<size_t>{3, 64, 130, 255}));
+}
+
+// Test that a queue holding items when added is reported, and drain() clears it once dry
+TEST(QueueSetTest, AddNonEmptyAndDrain) {
+    QueueSet<8> set;
+    Ring ring;
+    for (uint64_t i = 1; i <= 5; ++i) {
+        ASSERT_TRUE(ring.try_enqueue(i));
+    }
+    auto source = set.add(ring);
+    EXPECT_TRUE(set.poll().contains(source.index()));
+
+    std::vector<uint64_t> taken;
+    auto collect = [&](uint64_t&& value) { taken.push_back(value); };
+    EXPECT_EQ(set.drain(source, collect, 3), 3u);
+    EXPECT_TRUE(set.poll().any());
+    EXPECT_EQ(set.drain(source, collect, 3), 2u);
+    EXPECT_FALSE(set.poll().any());
+    EXPECT_EQ(taken, (std::vector<uint64_t>{1, 2, 3, 4, 5}));
+}
+
+// Test that wait() sleeps until a producer pushes, and wake() releases it with nothing ready
+TEST(QueueSetTest, WaitAndWake) {
+    QueueSet<8> set;
+    Ring ring;
+    auto source = set.add(ring);
+
+    std::thread producer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        source.try_enqueue(uint64_t{42});
+    });
+    const auto ready = set.wait();
+    producer.join();
+    EXPECT_TRUE(ready.contains(source.index()));
+    uint64_t value = 0;
+    ASSERT_TRUE(set.try_dequeue(source, value));
+    EXPECT_EQ(value, 42u);
+    EXPECT_FALSE(set.try_dequeue(source, value));
+
+    std::thread waker([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        set.wake();
+    });
+    EXPECT_FALSE(set.wait(0).any());
+    waker.join();
+}
+
+// Test that a blocking consumer receives every item from many producers exactly once
+TEST(QueueSetTest, ConcurrentProducersWithBlockingConsumer) {
+    constexpr size_t PRODUCERS = 4;
+    constexpr uint64_t PER_PRODUCER = 50000;
+    QueueSet<64> set;
+    std::array<Ring, PRODUCERS> rings;
+    Shared shared;
+    std::vector<QueueSet<64>::Source<Ring>> sources;
+    for (auto& ring : rings) {
+        sources.push_back(set.add(ring));
+    }
+    auto shared_source = set.add(shared);
+
+    std::vector<uint64_t> seen(PRODUCERS * PER_PRODUCER * 2);
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p]() {
+            for (uint64_t i = 0; i < PER_PRODUCER; ++i) {
+                const uint64_t own = p * PER_PRODUCER + i;
+                while (!sources[p].try_enqueue(own)) {
+                    std::this_thread::yield();
+                }
+                // Every producer also feeds the shared queue now and then
+                if (i % 4 == 0) {
+                    while (!shared_source.try_enqueue(PRODUCERS * PER_PRODUCER + own)) {
+                        std::this_thread::yield();
+                    }
+                }
+                if (i % 1024 == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+        });
+    }
+
+    const uint64_t expected = PRODUCERS * PER_PRODUCER + PRODUCERS * PER_PRODUCER / 4;
+    uint64_t received = 0;
+    auto record = [&](uint64_t&& value) {
+        ++seen[value];
+        ++received;
+    };
+    while (received < expected) {
+        for (size_t index : set.wait()) {
+            if (index == shared_source.index()) {
+                set.drain(shared_source, record);
+            } else {
+                set.drain(sources[index], record);
+            }
+        }
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_EQ(received, expected);
+    size_t duplicates = 0;
+    for (uint64_t count : seen) {
+        duplicates += count > 1 ? 1 : 0;
+    }
+    EXPECT_EQ(duplicates, 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,50 @@
+#include "../include/traced_queue.h"
+#include "mpmc_queue.h"
+#include "ring_buffer.h"
+#include "queue_benchmarks.h"
+#include <benchmark/benchmark.h>
+
+// The cost of tracing: each queue untraced, traced 1 in 64 (the default) and traced on every message
+using queue_bench::BM_SingleThreaded;
+using queue_bench::BM_MultiThreaded;
+using queue_bench::BM_Latency;
+
+using PlainMPMC = MPMCQueue<int, 1024>;
+using TracedMPMC64 = TracedQueue<MPMCQueue<Stamped<int>, 1024>, 64>;
+using TracedMPMC1 = TracedQueue<MPMCQueue<Stamped<int>, 1024>, 1>;
+
+using PlainRing = RingBuffer<int, 1024>;
+using TracedRing64 = TracedQueue<RingBuffer<Stamped<int>, 1024>, 64>;
+using TracedRing1 = TracedQueue<RingBuffer<Stamped<int>, 1024>, 1>;
+
+// Single-threaded enqueue + dequeue of a 256 item batch
+BENCHMARK_TEMPLATE(BM_SingleThreaded, PlainMPMC)->Arg(256);
+BENCHMARK_TEMPLATE(BM_SingleThreaded, TracedMPMC64)->Arg(256);
+BENCHMARK_TEMPLATE(BM_SingleThreaded, TracedMPMC1)->Arg(256);
+BENCHMARK_TEMPLATE(BM_SingleThreaded, PlainRing)->Arg(256);
+BENCHMARK_TEMPLATE(BM_SingleThreaded, TracedRing64)->Arg(256);
+BENCHMARK_TEMPLATE(BM_SingleThreaded, TracedRing1)->Arg(256);
+
+// Sustained producer-consumer throughput
+BENCHMARK_TEMPLATE(BM_MultiThreaded, PlainMPMC)->Args({2, 2})->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MultiThreaded, TracedMPMC64)->Args({2, 2})->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MultiThreaded, TracedMPMC1)->Args({2, 2})->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MultiThreaded, PlainRing)->Args({1, 1})->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MultiThreaded, TracedRing64)->Args({1, 1})->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MultiThreaded, TracedRing1)->Args({1, 1})->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond);
+
+// Round-trip latency, where the extra TSC reads show up directly
+BENCHMARK_TEMPLATE(BM_Latency, PlainMPMC)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Latency, TracedMPMC1)->UseRealTime();
+
+// Raw cost of the clock itself
+static void BM_ReadTsc(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(read_tsc());
+    }
+}
+BENCHMARK(BM_ReadTsc);
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
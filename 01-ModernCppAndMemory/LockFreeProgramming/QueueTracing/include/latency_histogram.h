@@ -0,0 +1,260 @@
+/**
+ * @file latency_histogram.h
+ * @brief Lock-free log-linear latency histograms that can live in shared memory
+ *
+ * Each consumer thread records into its own histogram, so recording is a
+ * single relaxed increment on a line no other writer touches. Readers sum the
+ * buckets at any time without pausing the writers. The whole set is a
+ * fixed-size block of address-free atomics, so it can be mapped into a second
+ * process (see open_shared_histograms()) and read from there.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "concurrency_primitives.h"
+
+/**
+ * @brief Bucket layout shared by the histogram and its snapshots
+ *
+ * Values below 8 get a bucket each; above that, every power of two is split
+ * into 8 linear sub-buckets, so a bucket is never wider than 12.5% of its
+ * lower bound. Covers the full uint64_t range in 496 buckets.
+ */
+struct HistogramBuckets {
+    static constexpr size_t SUB_BUCKET_BITS = 3;
+    static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+    static constexpr size_t COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static constexpr size_t index_of(uint64_t value) noexcept {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        const size_t msb = static_cast<size_t>(std::bit_width(value)) - 1;
+        const size_t shift = msb - SUB_BUCKET_BITS;
+        const size_t sub = static_cast<size_t>(value >> shift) & (SUB_BUCKETS - 1);
+        return (shift + 1) * SUB_BUCKETS + sub;
+    }
+
+    // Smallest value that falls into bucket `index`
+    static constexpr uint64_t lower_bound(size_t index) noexcept {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        const size_t shift = index / SUB_BUCKETS - 1;
+        const uint64_t sub = index % SUB_BUCKETS;
+        return (SUB_BUCKETS + sub) << shift;
+    }
+
+    // Largest value that falls into bucket `index`
+    static constexpr uint64_t upper_bound(size_t index) noexcept {
+        return index + 1 < COUNT ? lower_bound(index + 1) - 1 : UINT64_MAX;
+    }
+};
+
+static_assert(HistogramBuckets::index_of(UINT64_MAX) == HistogramBuckets::COUNT - 1);
+
+/**
+ * @brief A point-in-time copy of one or more histograms
+ */
+struct HistogramSnapshot {
+    std::array<uint64_t, HistogramBuckets::COUNT> counts{};
+    uint64_t total = 0;
+    uint64_t max = 0;
+
+    /**
+     * @brief Value at quantile q (0..1), reported as the upper bound of its bucket
+     *
+     * @return 0 if the histogram is empty
+     */
+    uint64_t percentile(double q) const noexcept {
+        if (total == 0) {
+            return 0;
+        }
+        const uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return HistogramBuckets::upper_bound(i) < max ? HistogramBuckets::upper_bound(i) : max;
+            }
+        }
+        return max;
+    }
+
+    HistogramSnapshot& operator+=(const HistogramSnapshot& other) noexcept {
+        for (size_t i = 0; i < counts.size(); ++i) {
+            counts[i] += other.counts[i];
+        }
+        total += other.total;
+        max = other.max > max ? other.max : max;
+        return *this;
+    }
+};
+
+/**
+ * @brief One writer's histogram
+ *
+ * record() is meant to be called by a single thread; concurrent writers stay
+ * correct (increments are atomic) but would share the cache lines.
+ */
+class alignas(CACHE_LINE_SIZE) LatencyHistogram {
+public:
+    void record(uint64_t value) noexcept {
+        counts_[HistogramBuckets::index_of(value)].fetch_add(1, std::memory_order_relaxed);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Copies the buckets; safe to call while record() runs on another thread
+     *
+     * The copy is not one atomic cut: samples recorded during the copy may or
+     * may not be included.
+     */
+    HistogramSnapshot snapshot() const noexcept {
+        HistogramSnapshot result;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            result.counts[i] = counts_[i].load(std::memory_order_relaxed);
+            result.total += result.counts[i];
+        }
+        result.max = max_.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    void reset() noexcept {
+        for (auto& count : counts_) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, HistogramBuckets::COUNT> counts_{};
+    std::atomic<uint64_t> max_{0};
+};
+
+/**
+ * @brief Per-consumer residency histograms for one traced queue
+ *
+ * The layout is fixed and contains only lock-free atomics and plain numbers,
+ * so the same block works in private memory and in a shared mapping. Values
+ * are recorded in TSC ticks; ticks_per_ns is stored alongside so a reader in
+ * another process can convert without recalibrating.
+ */
+struct ResidencyHistograms {
+    static constexpr uint64_t MAGIC = 0x5253444e48495354ull;  // "RSDNHIST"
+    static constexpr size_t MAX_CONSUMERS = 16;
+
+    std::atomic<uint64_t> magic{0};
+    double ticks_per_ns = 1.0;
+    uint64_t sample_every = 1;
+    std::array<LatencyHistogram, MAX_CONSUMERS> per_consumer{};
+
+    /**
+     * @brief Records the conversion parameters and marks the block ready for readers
+     */
+    void publish(double rate, uint64_t sampling) noexcept {
+        ticks_per_ns = rate;
+        sample_every = sampling;
+        magic.store(MAGIC, std::memory_order_release);
+    }
+
+    bool ready() const noexcept {
+        return magic.load(std::memory_order_acquire) == MAGIC;
+    }
+
+    LatencyHistogram& for_consumer(size_t consumer_index) noexcept {
+        return per_consumer[consumer_index % MAX_CONSUMERS];
+    }
+
+    // All consumers merged
+    HistogramSnapshot snapshot() const noexcept {
+        HistogramSnapshot result;
+        for (const auto& histogram : per_consumer) {
+            result += histogram.snapshot();
+        }
+        return result;
+    }
+
+    void reset() noexcept {
+        for (auto& histogram : per_consumer) {
+            histogram.reset();
+        }
+    }
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Shared-memory histograms need address-free (lock-free) 64-bit atomics");
+
+#ifndef _WIN32
+
+/**
+ * @brief Maps a named POSIX shared-memory block holding ResidencyHistograms
+ *
+ * The creating process (the pipeline) passes create = true, which sizes and
+ * resets the block; it must then call publish(). Other processes pass
+ * create = false and wait for ready() before reading.
+ *
+ * @param name Shared memory name, starting with '/'
+ * @return nullptr on failure, or if the block is smaller than ResidencyHistograms
+ *         (not sized by its creator yet, or from an incompatible build)
+ */
+inline ResidencyHistograms* open_shared_histograms(const std::string& name, bool create) {
+    int flags = create ? (O_CREAT | O_RDWR) : O_RDWR;
+    int fd = shm_open(name.c_str(), flags, 0600);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (create && ftruncate(fd, sizeof(ResidencyHistograms)) != 0) {
+        close(fd);
+        return nullptr;
+    }
+    // A block the creator has not sized yet, or one left by a build with a smaller
+    // layout, would fault (SIGBUS) on first access past its end
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ResidencyHistograms)) {
+        close(fd);
+        return nullptr;
+    }
+    void* memory = mmap(nullptr, sizeof(ResidencyHistograms), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+    if (create) {
+        // Construct over the mapping, which also clears anything left by an earlier run
+        return new (memory) ResidencyHistograms();
+    }
+    return static_cast<ResidencyHistograms*>(memory);
+}
+
+/**
+ * @brief Unmaps a block returned by open_shared_histograms(), optionally removing the name
+ */
+inline void close_shared_histograms(ResidencyHistograms* histograms, const std::string& name, bool unlink_name) {
+    if (histograms != nullptr) {
+        munmap(histograms, sizeof(ResidencyHistograms));
+    }
+    if (unlink_name) {
+        shm_unlink(name.c_str());
+    }
+}
+
+#endif
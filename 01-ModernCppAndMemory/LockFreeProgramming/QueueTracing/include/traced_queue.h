@@ -0,0 +1,250 @@
+/**
+ * @file traced_queue.h
+ * @brief Optional residency tracing for RingBuffer and MPMCQueue
+ *
+ * TracedQueue wraps a queue of Stamped<T> and exposes a queue of T. One in
+ * every SampleEvery messages a producer enqueues is stamped with the TSC; when
+ * a consumer dequeues a stamped message it records how many ticks it spent in
+ * the queue into that consumer's histogram. Unsampled messages cost one
+ * thread-local increment and a branch on each side.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "concurrent_queue.h"
+#include "latency_histogram.h"
+#include "tsc_clock.h"
+
+/**
+ * @brief A message together with the TSC value it was enqueued at
+ *
+ * @tparam T The payload type
+ */
+template <typename T>
+struct Stamped {
+    using payload_type = T;
+
+    T value{};
+    uint64_t tsc = 0;  // 0 when the message was not sampled
+};
+
+namespace traced_queue_detail {
+
+static_assert(ResidencyHistograms::MAX_CONSUMERS <= 64, "Histogram indices are claimed from one 64-bit mask");
+
+// Histogram indices held by live dequeuing threads, one bit each
+inline std::atomic<uint64_t>& claimed_consumer_indices() noexcept {
+    static std::atomic<uint64_t> claimed{0};
+    return claimed;
+}
+
+/**
+ * @brief A dequeuing thread's histogram index, handed back when the thread exits
+ *
+ * Live threads get distinct indices, lowest free first, so threads that come
+ * and go do not walk the index past MAX_CONSUMERS. Only with more than
+ * MAX_CONSUMERS dequeuing threads alive at once do some of them share.
+ */
+class ConsumerIndex {
+public:
+    ConsumerIndex() noexcept {
+        constexpr size_t COUNT = ResidencyHistograms::MAX_CONSUMERS;
+        constexpr uint64_t ALL = COUNT == 64 ? ~uint64_t{0} : (uint64_t{1} << COUNT) - 1;
+        auto& claimed = claimed_consumer_indices();
+        uint64_t current = claimed.load(std::memory_order_relaxed);
+        while ((current & ALL) != ALL) {
+            const size_t candidate = static_cast<size_t>(std::countr_zero(~current));
+            if (claimed.compare_exchange_weak(current, current | (uint64_t{1} << candidate),
+                                              std::memory_order_relaxed)) {
+                index_ = candidate;
+                owned_ = true;
+                return;
+            }
+        }
+        // Every index is held: share one, spreading the extra threads round-robin
+        static std::atomic<size_t> overflow{0};
+        index_ = overflow.fetch_add(1, std::memory_order_relaxed) % COUNT;
+    }
+
+    ~ConsumerIndex() {
+        if (owned_) {
+            claimed_consumer_indices().fetch_and(~(uint64_t{1} << index_), std::memory_order_relaxed);
+        }
+    }
+
+    ConsumerIndex(const ConsumerIndex&) = delete;
+    ConsumerIndex& operator=(const ConsumerIndex&) = delete;
+
+    size_t value() const noexcept {
+        return index_;
+    }
+
+private:
+    size_t index_ = 0;
+    bool owned_ = false;
+};
+
+// Gives each live dequeuing thread its own histogram
+inline size_t this_consumer_index() noexcept {
+    thread_local const ConsumerIndex index;
+    return index.value();
+}
+
+}  // namespace traced_queue_detail
+
+/**
+ * @brief Wraps a queue of Stamped<T> and records queue residency of sampled messages
+ *
+ * Usage: `TracedQueue<MPMCQueue<Stamped<Order>, 1024>> queue;`, then use it as
+ * a queue of Order. The wrapper satisfies ConcurrentQueue and inherits the
+ * producer/consumer limits of the wrapped queue.
+ *
+ * The sampling counter is per producer thread (shared by all TracedQueues of
+ * the same type on that thread), so each producer stamps every SampleEvery-th
+ * message it successfully enqueues. Each dequeuing thread records into the
+ * histogram whose index it holds while it lives; see ConsumerIndex. Residency is measured across cores, which
+ * relies on the TSC being synchronised between them (see TscClock::invariant()).
+ *
+ * @tparam Queue A ConcurrentQueue whose value_type is Stamped<T>
+ * @tparam SampleEvery Sampling period (must be a power of two; 1 traces every message)
+ */
+template <typename Queue, size_t SampleEvery = 64>
+class TracedQueue {
+    static_assert(ConcurrentQueue<Queue>, "Queue must satisfy ConcurrentQueue");
+    static_assert(SampleEvery > 0 && (SampleEvery & (SampleEvery - 1)) == 0,
+                  "SampleEvery must be a power of two");
+
+    using Envelope = typename Queue::value_type;
+    static_assert(std::is_same_v<Envelope, Stamped<typename Envelope::payload_type>>,
+                  "The wrapped queue must hold Stamped<T>");
+
+public:
+    using value_type = typename Envelope::payload_type;
+    using queue_type = Queue;
+
+    static constexpr bool multi_producer = queue_supports_multi_producer<Queue>();
+    static constexpr bool multi_consumer = queue_supports_multi_consumer<Queue>();
+
+    /**
+     * @brief Records into histograms owned by this queue
+     *
+     * The first TracedQueue in a process calibrates the TSC (about 100 ms).
+     */
+    TracedQueue()
+        : owned_histograms_(std::make_unique<ResidencyHistograms>()),
+          histograms_(owned_histograms_.get()) {
+        histograms_->publish(TscClock::shared().ticks_per_ns(), SampleEvery);
+    }
+
+    /**
+     * @brief Records into caller-provided histograms, e.g. a shared-memory block
+     *
+     * @param histograms Must outlive the queue
+     */
+    explicit TracedQueue(ResidencyHistograms& histograms)
+        : histograms_(&histograms) {
+        histograms_->publish(TscClock::shared().ticks_per_ns(), SampleEvery);
+    }
+
+    TracedQueue(const TracedQueue&) = delete;
+    TracedQueue& operator=(const TracedQueue&) = delete;
+
+    /**
+     * @brief Attempts to enqueue a copy of the item
+     *
+     * @return true if successful, false if the queue is full
+     */
+    bool try_enqueue(const value_type& item) noexcept(std::is_nothrow_copy_constructible_v<value_type>) {
+        Envelope envelope{item, next_stamp()};
+        if (!queue_->try_enqueue(std::move(envelope))) {
+            return false;
+        }
+        ++sample_counter();
+        return true;
+    }
+
+    /**
+     * @brief Attempts to enqueue the item by moving it
+     *
+     * @return true if successful; false if the queue is full, in which case
+     *         the item is left intact for a retry
+     */
+    bool try_enqueue(value_type&& item) noexcept(std::is_nothrow_move_constructible_v<value_type> &&
+                                                 std::is_nothrow_move_assignable_v<value_type>) {
+        Envelope envelope{std::move(item), next_stamp()};
+        if (!queue_->try_enqueue(std::move(envelope))) {
+            // The wrapped queues leave the argument untouched on failure, so hand it back
+            item = std::move(envelope.value);
+            return false;
+        }
+        ++sample_counter();
+        return true;
+    }
+
+    /**
+     * @brief Attempts to dequeue an item, recording its residency if it was sampled
+     *
+     * @param[out] result Receives the item
+     * @return true if successful, false if the queue is empty
+     */
+    bool try_dequeue(value_type& result) noexcept {
+        Envelope envelope;
+        if (!queue_->try_dequeue(envelope)) {
+            return false;
+        }
+        if (envelope.tsc != 0) {
+            const uint64_t now = read_tsc();
+            histograms_->for_consumer(traced_queue_detail::this_consumer_index())
+                .record(now > envelope.tsc ? now - envelope.tsc : 0);
+        }
+        result = std::move(envelope.value);
+        return true;
+    }
+
+    bool empty() const noexcept { return queue_->empty(); }
+
+    size_t capacity() const noexcept { return queue_->capacity(); }
+
+    /**
+     * @brief The histograms being written; safe to read while the queue is in use
+     */
+    const ResidencyHistograms& histograms() const noexcept { return *histograms_; }
+
+    /**
+     * @brief Residency of sampled messages across all consumers, in TSC ticks
+     */
+    HistogramSnapshot residency() const noexcept { return histograms_->snapshot(); }
+
+    /**
+     * @brief Converts a value from residency() to nanoseconds
+     */
+    double to_ns(uint64_t ticks) const noexcept { return static_cast<double>(ticks) / histograms_->ticks_per_ns; }
+
+    /**
+     * @brief Clears the histograms; samples recorded concurrently may survive
+     */
+    void reset_residency() noexcept { histograms_->reset(); }
+
+private:
+    static uint64_t& sample_counter() noexcept {
+        thread_local uint64_t counter = 0;
+        return counter;
+    }
+
+    static uint64_t next_stamp() noexcept {
+        return ((sample_counter() + 1) & (SampleEvery - 1)) == 0 ? read_tsc() : 0;
+    }
+
+    // The wrapped queues are large and pinned in place, so keep them on the heap
+    std::unique_ptr<Queue> queue_ = std::make_unique<Queue>();
+    std::unique_ptr<ResidencyHistograms> owned_histograms_;
+    ResidencyHistograms* histograms_;
+};
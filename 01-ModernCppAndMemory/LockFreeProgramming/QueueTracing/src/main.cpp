@@ -0,0 +1,139 @@
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+#include "../include/traced_queue.h"
+#include "mpmc_queue.h"
+
+namespace {
+
+const char* SHM_NAME = "/queue_tracing_demo";
+
+void print_residency(const ResidencyHistograms& histograms) {
+    HistogramSnapshot snapshot = histograms.snapshot();
+    auto ns = [&](uint64_t ticks) { return static_cast<double>(ticks) / histograms.ticks_per_ns; };
+
+    std::cout << std::fixed << std::setprecision(0)
+              << "  samples: " << std::setw(8) << snapshot.total
+              << "  p50: " << std::setw(7) << ns(snapshot.percentile(0.50)) << " ns"
+              << "  p99: " << std::setw(7) << ns(snapshot.percentile(0.99)) << " ns"
+              << "  p99.9: " << std::setw(8) << ns(snapshot.percentile(0.999)) << " ns"
+              << "  max: " << std::setw(9) << ns(snapshot.max) << " ns\n";
+}
+
+#ifndef _WIN32
+// Reads the histograms a running pipeline publishes in shared memory
+int attach() {
+    ResidencyHistograms* histograms = open_shared_histograms(SHM_NAME, false);
+    if (histograms == nullptr || !histograms->ready()) {
+        std::cerr << "No pipeline is publishing " << SHM_NAME << "; start queue_tracing_demo first\n";
+        return 1;
+    }
+    std::cout << "Attached to " << SHM_NAME << " (1 in " << histograms->sample_every << " messages sampled)\n";
+    for (int i = 0; i < 5; ++i) {
+        print_residency(*histograms);
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+    close_shared_histograms(histograms, SHM_NAME, false);
+    return 0;
+}
+#endif
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    int seconds = 2;
+    for (int i = 1; i < argc; ++i) {
+#ifndef _WIN32
+        if (std::strcmp(argv[i], "--attach") == 0) {
+            return attach();
+        }
+#endif
+        if (std::strncmp(argv[i], "--seconds=", 10) == 0) {
+            seconds = std::atoi(argv[i] + 10);
+        }
+    }
+
+    std::cout << "Queue Residency Tracing Demo\n";
+    std::cout << "----------------------------\n";
+    std::cout << "Invariant TSC: " << (TscClock::invariant() ? "yes" : "no") << "\n";
+    std::cout << "Calibrated TSC: " << std::setprecision(3) << TscClock::shared().ticks_per_ns() << " ticks/ns\n";
+
+    // Publish the histograms in shared memory so `queue_tracing_demo --attach` can read them
+#ifndef _WIN32
+    ResidencyHistograms* histograms = open_shared_histograms(SHM_NAME, true);
+    if (histograms == nullptr) {
+        std::cerr << "Could not create " << SHM_NAME << "\n";
+        return 1;
+    }
+#else
+    auto owned = std::make_unique<ResidencyHistograms>();
+    ResidencyHistograms* histograms = owned.get();
+#endif
+
+    TracedQueue<MPMCQueue<Stamped<int>, 1024>, 16> queue(*histograms);
+
+    constexpr int NUM_PRODUCERS = 2;
+    constexpr int NUM_CONSUMERS = 2;
+    std::atomic<bool> running(true);
+    std::atomic<uint64_t> consumed(0);
+
+    std::cout << "\nRunning " << NUM_PRODUCERS << " producers and " << NUM_CONSUMERS
+              << " consumers for " << seconds << " s, sampling 1 in 16 messages.\n";
+#ifndef _WIN32
+    std::cout << "Run `queue_tracing_demo --attach` in another terminal to read the live histograms.\n";
+#endif
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < NUM_PRODUCERS; ++p) {
+        threads.emplace_back([&queue, &running, p]() {
+            int value = p;
+            while (running.load(std::memory_order_relaxed)) {
+                if (!queue.try_enqueue(value)) {
+                    std::this_thread::yield();
+                }
+                value += NUM_PRODUCERS;
+            }
+        });
+    }
+    for (int c = 0; c < NUM_CONSUMERS; ++c) {
+        threads.emplace_back([&queue, &running, &consumed]() {
+            int value;
+            while (running.load(std::memory_order_relaxed)) {
+                if (queue.try_dequeue(value)) {
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Read the histograms while the pipeline keeps running
+    for (int tick = 0; tick < seconds * 2; ++tick) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        print_residency(*histograms);
+    }
+
+    running.store(false, std::memory_order_relaxed);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::cout << "\nConsumed " << consumed.load() << " messages. Per-consumer residency:\n";
+    for (size_t c = 0; c < NUM_CONSUMERS; ++c) {
+        HistogramSnapshot snapshot = histograms->per_consumer[c].snapshot();
+        std::cout << "  consumer " << c << ": " << snapshot.total << " samples, p99 "
+                  << std::setprecision(0) << queue.to_ns(snapshot.percentile(0.99)) << " ns\n";
+    }
+
+#ifndef _WIN32
+    close_shared_histograms(histograms, SHM_NAME, true);
+#endif
+    return 0;
+}
@@ -0,0 +1,240 @@
+#include "../include/traced_queue.h"
+#include "ring_buffer.h"
+#include "mpmc_queue.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+
+static_assert(ConcurrentQueue<TracedQueue<MPMCQueue<Stamped<int>, 16>>>);
+static_assert(!queue_supports_multi_producer<TracedQueue<RingBuffer<Stamped<int>, 16>>>());
+
+// Test that every value lands in a bucket whose bounds contain it
+TEST(LatencyHistogramTest, BucketBounds) {
+    for (uint64_t value : {0ull, 1ull, 7ull, 8ull, 9ull, 15ull, 16ull, 100ull, 1000ull, 123456789ull, ~0ull}) {
+        size_t index = HistogramBuckets::index_of(value);
+        ASSERT_LT(index, HistogramBuckets::COUNT);
+        EXPECT_LE(HistogramBuckets::lower_bound(index), value) << value;
+        EXPECT_GE(HistogramBuckets::upper_bound(index), value) << value;
+    }
+
+    // Buckets are contiguous
+    for (size_t i = 1; i < HistogramBuckets::COUNT; ++i) {
+        ASSERT_EQ(HistogramBuckets::lower_bound(i), HistogramBuckets::upper_bound(i - 1) + 1) << i;
+    }
+}
+
+// Test percentiles against a known distribution
+TEST(LatencyHistogramTest, Percentiles) {
+    auto histogram = std::make_unique<LatencyHistogram>();
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram->record(value);
+    }
+
+    HistogramSnapshot snapshot = histogram->snapshot();
+    EXPECT_EQ(snapshot.total, 1000u);
+    EXPECT_EQ(snapshot.max, 1000u);
+
+    // Buckets are at most 12.5% wide, and percentile() reports the bucket's upper bound
+    EXPECT_GE(snapshot.percentile(0.5), 500u);
+    EXPECT_LE(snapshot.percentile(0.5), 500u * 9 / 8);
+    EXPECT_GE(snapshot.percentile(0.99), 990u);
+    EXPECT_LE(snapshot.percentile(0.99), 1000u);
+    EXPECT_EQ(snapshot.percentile(1.0), 1000u);
+
+    histogram->reset();
+    EXPECT_EQ(histogram->snapshot().total, 0u);
+    EXPECT_EQ(histogram->snapshot().percentile(0.5), 0u);
+}
+
+// Test that calibration produces a plausible rate that measures a known interval
+TEST(TscClockTest, Calibration) {
+    TscClock clock = TscClock::calibrate(std::chrono::milliseconds(10), 3);
+    EXPECT_GT(clock.ticks_per_ns(), 0.0);
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t start_tsc = read_tsc();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20)) {
+    }
+    double measured_ns = clock.to_ns(read_tsc() - start_tsc);
+    double expected_ns = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+    // Generous bounds: the test machine may be virtualised and loaded
+    EXPECT_GT(measured_ns, expected_ns * 0.8);
+    EXPECT_LT(measured_ns, expected_ns * 1.2);
+}
+
+// Test that the wrapper preserves FIFO order and samples 1 in N messages
+TEST(TracedQueueTest, SamplesOneInN) {
+    TracedQueue<MPMCQueue<Stamped<int>, 128>, 4> queue;
+    int value;
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(queue.try_enqueue(i));
+    }
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(queue.try_dequeue(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.try_dequeue(value));
+
+    EXPECT_EQ(queue.residency().total, 25u);
+    EXPECT_EQ(queue.histograms().sample_every, 4u);
+    EXPECT_TRUE(queue.histograms().ready());
+
+    queue.reset_residency();
+    EXPECT_EQ(queue.residency().total, 0u);
+}
+
+// Test that residency reflects how long messages actually waited
+TEST(TracedQueueTest, MeasuresResidency) {
+    TracedQueue<RingBuffer<Stamped<int>, 16>, 1> queue;
+    int value;
+
+    EXPECT_TRUE(queue.try_enqueue(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_TRUE(queue.try_dequeue(value));
+
+    HistogramSnapshot snapshot = queue.residency();
+    ASSERT_EQ(snapshot.total, 1u);
+    EXPECT_GE(queue.to_ns(snapshot.max), 4e6);
+}
+
+// Test that a failed move-enqueue leaves the item with the caller
+TEST(TracedQueueTest, FailedMoveKeepsItem) {
+    TracedQueue<MPMCQueue<Stamped<std::unique_ptr<int>>, 2>, 1> queue;
+
+    EXPECT_TRUE(queue.try_enqueue(std::make_unique<int>(1)));
+    EXPECT_TRUE(queue.try_enqueue(std::make_unique<int>(2)));
+
+    auto item = std::make_unique<int>(3);
+    EXPECT_FALSE(queue.try_enqueue(std::move(item)));
+    ASSERT_NE(item, nullptr);
+    EXPECT_EQ(*item, 3);
+}
+
+// Test that each consumer records into its own histogram and nothing is lost
+TEST(TracedQueueTest, PerConsumerHistograms) {
+    constexpr size_t NUM_CONSUMERS = 3;
+    constexpr size_t NUM_ITEMS = 30000;
+    TracedQueue<MPMCQueue<Stamped<int>, 256>, 1> queue;
+    std::atomic<size_t> consumed(0);
+
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() {
+        for (size_t i = 0; i < NUM_ITEMS; ++i) {
+            while (!queue.try_enqueue(static_cast<int>(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (size_t c = 0; c < NUM_CONSUMERS; ++c) {
+        threads.emplace_back([&]() {
+            int value;
+            while (consumed.load(std::memory_order_relaxed) < NUM_ITEMS) {
+                if (queue.try_dequeue(value)) {
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Reading while the pipeline runs must be safe
+    while (consumed.load(std::memory_order_relaxed) < NUM_ITEMS) {
+        EXPECT_LE(queue.residency().total, NUM_ITEMS);
+        std::this_thread::yield();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(queue.residency().total, NUM_ITEMS);
+
+    size_t consumers_with_samples = 0;
+    for (const auto& histogram : queue.histograms().per_consumer) {
+        consumers_with_samples += histogram.snapshot().total > 0 ? 1 : 0;
+    }
+    EXPECT_GE(consumers_with_samples, 1u);
+    EXPECT_LE(consumers_with_samples, NUM_CONSUMERS);
+}
+
+// Test that threads hand their histogram index back on exit, so churn does not make live consumers share
+TEST(TracedQueueTest, ConsumerIndicesAreRecycled) {
+    for (size_t i = 0; i < 3 * ResidencyHistograms::MAX_CONSUMERS; ++i) {
+        size_t index = ResidencyHistograms::MAX_CONSUMERS;
+        std::thread([&]() { index = traced_queue_detail::this_consumer_index(); }).join();
+        EXPECT_LT(index, ResidencyHistograms::MAX_CONSUMERS);
+    }
+
+    // Two consumers alive at the same time, after all that churn
+    std::atomic<int> arrived{0};
+    size_t first = 0;
+    size_t second = 0;
+    auto hold = [&](size_t& index) {
+        index = traced_queue_detail::this_consumer_index();
+        arrived.fetch_add(1, std::memory_order_acq_rel);
+        while (arrived.load(std::memory_order_acquire) < 2) {
+            std::this_thread::yield();
+        }
+    };
+    std::thread a(hold, std::ref(first));
+    std::thread b(hold, std::ref(second));
+    a.join();
+    b.join();
+    EXPECT_NE(first, second);
+}
+
+#ifndef _WIN32
+// Test that a second mapping of the shared block sees the writer's samples
+TEST(TracedQueueTest, SharedMemoryReader) {
+    const std::string name = "/queue_tracing_test_" + std::to_string(::getpid());
+    ResidencyHistograms* writer = open_shared_histograms(name, true);
+    ASSERT_NE(writer, nullptr);
+
+    {
+        TracedQueue<MPMCQueue<Stamped<int>, 16>, 1> queue(*writer);
+        int value;
+        for (int i = 0; i < 10; ++i) {
+            EXPECT_TRUE(queue.try_enqueue(i));
+            EXPECT_TRUE(queue.try_dequeue(value));
+        }
+    }
+
+    ResidencyHistograms* reader = open_shared_histograms(name, false);
+    ASSERT_NE(reader, nullptr);
+    EXPECT_NE(static_cast<void*>(reader), static_cast<void*>(writer));
+    EXPECT_TRUE(reader->ready());
+    EXPECT_EQ(reader->sample_every, 1u);
+    EXPECT_DOUBLE_EQ(reader->ticks_per_ns, writer->ticks_per_ns);
+    EXPECT_EQ(reader->snapshot().total, 10u);
+
+    close_shared_histograms(reader, name, false);
+    close_shared_histograms(writer, name, true);
+}
+
+// Test that attaching to a block not yet sized by its creator fails instead of faulting later
+TEST(TracedQueueTest, SharedMemoryRejectsShortBlock) {
+    const std::string name = "/queue_tracing_short_" + std::to_string(::getpid());
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(open_shared_histograms(name, false), nullptr);
+
+    ASSERT_EQ(ftruncate(fd, sizeof(ResidencyHistograms) / 2), 0);
+    EXPECT_EQ(open_shared_histograms(name, false), nullptr);
+    close(fd);
+    shm_unlink(name.c_str());
+}
+#endif
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
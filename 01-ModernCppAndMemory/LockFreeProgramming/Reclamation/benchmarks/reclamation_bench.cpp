@@ -0,0 +1,135 @@
+#include "../include/epoch_reclamation.h"
+#include "../include/hazard_pointers.h"
+#include "../include/concurrent_list.h"
+#include "queue_benchmarks.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Baseline with no read-side cost at all: nothing is freed until the domain is destroyed
+class LeakingDomain {
+public:
+    class Guard {
+    public:
+        explicit Guard(LeakingDomain&) noexcept {}
+        template <typename T>
+        T* protect(const std::atomic<T*>& source) noexcept {
+            return source.load(std::memory_order_acquire);
+        }
+        void reset() noexcept {}
+    };
+
+    ~LeakingDomain() {
+        for (const Retired& item : retired_) {
+            item.reclaim();
+        }
+    }
+
+    template <typename T>
+    void retire(T* pointer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired_.push_back(Retired{pointer, &delete_retired<T>});
+    }
+    void collect() {}
+    size_t pending() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return retired_.size();
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<Retired> retired_;
+};
+
+struct Level {
+    uint64_t price = 0;
+    uint64_t quantity = 0;
+};
+
+// Cost of entering a read-side section and protecting one pointer
+template <typename D>
+static void BM_GuardAndProtect(benchmark::State& state) {
+    D domain;
+    Level level;
+    std::atomic<Level*> source(&level);
+    for (auto _ : state) {
+        typename D::Guard guard(domain);
+        benchmark::DoNotOptimize(guard.protect(source)->quantity);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+/**
+ * @brief Lookups in a price-level list of state.range(0) levels
+ *
+ * With state.range(1) set, a pinned writer thread keeps replacing levels the
+ * whole time, so every scheme also pays for retiring and freeing.
+ */
+template <typename D>
+static void BM_ListFind(benchmark::State& state) {
+    const uint64_t levels = static_cast<uint64_t>(state.range(0));
+    const bool with_writer = state.range(1) != 0;
+
+    D domain;
+    std::atomic<size_t> max_pending(0);
+    std::atomic<uint64_t> updates(0);
+    {
+        ConcurrentSortedList<uint64_t, Level, D> list(domain);
+        for (uint64_t price = 0; price < levels; ++price) {
+            list.insert_or_assign(price, Level{price, 1});
+        }
+
+        std::atomic<bool> stop(false);
+        std::thread writer;
+        if (with_writer) {
+            writer = std::thread([&]() {
+                queue_bench::pin_current_thread(1);
+                std::mt19937_64 rng(7);
+                uint64_t count = 0;
+                size_t pending = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    const uint64_t price = rng() % levels;
+                    list.insert_or_assign(price, Level{price, count});
+                    pending = std::max(pending, domain.pending());
+                    if (++count % 64 == 0) {
+                        std::this_thread::yield();  // Leave the reader some time on small machines
+                    }
+                }
+                updates.store(count);
+                max_pending.store(pending);
+            });
+        }
+
+        queue_bench::pin_current_thread(0);
+        std::mt19937_64 rng(42);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(list.find(rng() % levels));
+        }
+
+        stop.store(true);
+        if (writer.joinable()) {
+            writer.join();
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+    if (with_writer) {
+        state.counters["updates"] = static_cast<double>(updates.load());
+        state.counters["max_pending"] = static_cast<double>(max_pending.load());
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_GuardAndProtect, LeakingDomain);
+BENCHMARK_TEMPLATE(BM_GuardAndProtect, EpochDomain);
+BENCHMARK_TEMPLATE(BM_GuardAndProtect, HazardDomain<>);
+
+BENCHMARK_TEMPLATE(BM_ListFind, LeakingDomain)->ArgsProduct({{16, 128}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_ListFind, EpochDomain)->ArgsProduct({{16, 128}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_ListFind, HazardDomain<>)->ArgsProduct({{16, 128}, {0, 1}});
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
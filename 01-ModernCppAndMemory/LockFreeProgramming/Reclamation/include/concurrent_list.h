@@ -0,0 +1,156 @@
+/**
+ * @file concurrent_list.h
+ * @brief Sorted linked list with lock-free readers, written once for any Reclaimer
+ *
+ * The shape of an order book's price levels: one book-builder thread changes
+ * the list while many strategy threads look levels up. Writers serialise on
+ * a mutex. Readers take no lock and never write shared memory apart from
+ * their reclamation guards.
+ *
+ * A write never changes a node that readers can see. Updating a value links
+ * a copy in place of the old node, and erasing links past it. The removed
+ * node's next pointer is then tagged, so a reader standing on it restarts
+ * from the head instead of trusting a stale link. That tag is what makes
+ * hand-over-hand hazard pointers safe here.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "reclamation.h"
+
+/**
+ * @tparam Key Ordered with < and ==
+ * @tparam Value Copied out by find()
+ * @tparam Domain EpochDomain or HazardDomain<> (needs two hazard slots per reader)
+ */
+template <typename Key, typename Value, Reclaimer Domain>
+class ConcurrentSortedList {
+    struct Node {
+        Key key;
+        Value value;
+        std::atomic<Node*> next;
+    };
+
+public:
+    explicit ConcurrentSortedList(Domain& domain) noexcept : domain_(domain) {}
+
+    /**
+     * @brief Deletes the live nodes; removed nodes belong to the domain, which must outlive the list
+     */
+    ~ConcurrentSortedList() {
+        Node* node = head_.load(std::memory_order_relaxed);
+        while (node != nullptr) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            delete node;
+            node = next;
+        }
+    }
+
+    ConcurrentSortedList(const ConcurrentSortedList&) = delete;
+    ConcurrentSortedList& operator=(const ConcurrentSortedList&) = delete;
+
+    /**
+     * @brief Looks up a key without locking; safe against concurrent writers
+     */
+    std::optional<Value> find(const Key& key) const {
+        typename Domain::Guard first(domain_);
+        typename Domain::Guard second(domain_);
+        typename Domain::Guard* guards[2] = {&first, &second};
+
+        while (true) {
+            // Each step protects the next node while the current one is still protected
+            const std::atomic<Node*>* link = &head_;
+            size_t step = 0;
+            Node* node;
+            while (!is_tagged(node = guards[step++ & 1]->protect(*link))) {
+                if (node == nullptr || key < node->key) {
+                    return std::nullopt;
+                }
+                if (node->key == key) {
+                    return node->value;
+                }
+                link = &node->next;
+            }
+            // Stood on a removed node; start again
+        }
+    }
+
+    /**
+     * @brief Inserts a key or replaces its value
+     *
+     * @return true if the key was inserted, false if an existing value was replaced
+     */
+    bool insert_or_assign(const Key& key, Value value) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        auto [link, node] = locate(key);
+        if (node != nullptr && node->key == key) {
+            Node* next = node->next.load(std::memory_order_relaxed);
+            link->store(new Node{key, std::move(value), next}, std::memory_order_seq_cst);
+            remove(node, next);
+            return false;
+        }
+        link->store(new Node{key, std::move(value), node}, std::memory_order_seq_cst);
+        size_.store(size_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Removes a key
+     *
+     * @return true if the key was present
+     */
+    bool erase(const Key& key) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        auto [link, node] = locate(key);
+        if (node == nullptr || !(node->key == key)) {
+            return false;
+        }
+        Node* next = node->next.load(std::memory_order_relaxed);
+        link->store(next, std::memory_order_seq_cst);
+        remove(node, next);
+        size_.store(size_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    size_t size() const noexcept {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static bool is_tagged(Node* node) noexcept {
+        return (reinterpret_cast<uintptr_t>(node) & 1) != 0;
+    }
+
+    static Node* tagged(Node* node) noexcept {
+        return reinterpret_cast<Node*>(reinterpret_cast<uintptr_t>(node) | 1);
+    }
+
+    // Writer-side search: the link to update and the first node not less than key
+    std::pair<std::atomic<Node*>*, Node*> locate(const Key& key) noexcept {
+        std::atomic<Node*>* link = &head_;
+        Node* node = link->load(std::memory_order_relaxed);
+        while (node != nullptr && node->key < key) {
+            link = &node->next;
+            node = link->load(std::memory_order_relaxed);
+        }
+        return {link, node};
+    }
+
+    // Called once node is unlinked: turn away readers standing on it, then hand it over
+    void remove(Node* node, Node* next) {
+        node->next.store(tagged(next), std::memory_order_seq_cst);
+        domain_.retire(node);
+    }
+
+    Domain& domain_;
+    std::atomic<Node*> head_{nullptr};
+    std::atomic<size_t> size_{0};
+    std::mutex write_mutex_;
+};
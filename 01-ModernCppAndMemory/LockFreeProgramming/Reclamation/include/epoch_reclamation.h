@@ -0,0 +1,199 @@
+/**
+ * @file epoch_reclamation.h
+ * @brief Epoch-based reclamation: cheap read-side guards, batched frees
+ *
+ * A global epoch counter advances only when every thread inside a guard has
+ * announced the current epoch. A node retired in epoch e was unlinked before
+ * any reader that announced e + 1 started, so once the global epoch reaches
+ * e + 2 no reader can hold it and it is freed.
+ *
+ * Each thread keeps three limbo lists, one per epoch modulo 3. Retiring into
+ * a list whose epoch is stale first frees that whole list, so frees are
+ * batched and the lists' storage is reused.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include "concurrency_primitives.h"
+#include "reclamation.h"
+#include "thread_slot.h"
+
+class EpochDomain {
+    struct Record {
+        // (epoch << 1) | 1 while the owner is inside a guard, 0 otherwise
+        std::atomic<uint64_t> announced{0};
+
+        // Owner-only from here on
+        uint32_t nesting = 0;
+        uint64_t retires = 0;
+        struct Limbo {
+            uint64_t epoch = 0;
+            std::vector<Retired> items;
+        };
+        std::array<Limbo, 3> limbo;
+    };
+
+public:
+    // Retires between attempts to advance the global epoch
+    static constexpr uint64_t ADVANCE_INTERVAL = 64;
+
+    /**
+     * @brief Read-side critical section; guards nest freely and cost nothing after the outermost
+     */
+    class Guard {
+    public:
+        explicit Guard(EpochDomain& domain) noexcept : record_(domain.local_record()) {
+            if (record_.nesting++ == 0) {
+                const uint64_t epoch = domain.epoch_.data.load(std::memory_order_seq_cst);
+                record_.announced.store((epoch << 1) | 1, std::memory_order_relaxed);
+                // The announcement must be visible before any pointer is read (store-load ordering)
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        ~Guard() {
+            if (--record_.nesting == 0) {
+                record_.announced.store(0, std::memory_order_release);
+            }
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        /**
+         * @brief Loads a pointer; it stays valid until the outermost guard ends
+         */
+        template <typename T>
+        T* protect(const std::atomic<T*>& source) noexcept {
+            return source.load(std::memory_order_acquire);
+        }
+
+        // Nothing to release per pointer
+        void reset() noexcept {}
+
+    private:
+        Record& record_;
+    };
+
+    EpochDomain() : records_(new CacheLineAligned<Record>[MAX_THREAD_SLOTS]) {
+        epoch_.data.store(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Frees everything still retired; no thread may be using the domain
+     */
+    ~EpochDomain() {
+        const size_t limit = slot_limit_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < limit; ++i) {
+            for (auto& limbo : records_[i].data.limbo) {
+                free_limbo(limbo);
+            }
+        }
+    }
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    /**
+     * @brief Hands over an unlinked node; it is deleted once no guard can still see it
+     */
+    template <typename T>
+    void retire(T* pointer) {
+        retire(pointer, &delete_retired<T>);
+    }
+
+    void retire(void* pointer, void (*deleter)(void*)) {
+        Record& record = local_record();
+        // Orders the caller's unlink before the epoch read, so a reader that announces a
+        // later epoch cannot still find the node
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const uint64_t epoch = epoch_.data.load(std::memory_order_seq_cst);
+        auto& limbo = record.limbo[epoch % 3];
+        if (limbo.epoch != epoch) {
+            // Same slot, so at least three epochs old
+            free_limbo(limbo);
+            limbo.epoch = epoch;
+        }
+        limbo.items.push_back(Retired{pointer, deleter});
+
+        if (++record.retires % ADVANCE_INTERVAL == 0) {
+            collect();
+        }
+    }
+
+    /**
+     * @brief Tries to advance the epoch, then frees the calling thread's lists that became safe
+     */
+    void collect() {
+        try_advance();
+        Record& record = local_record();
+        const uint64_t epoch = epoch_.data.load(std::memory_order_acquire);
+        for (auto& limbo : record.limbo) {
+            if (limbo.epoch + 2 <= epoch) {
+                free_limbo(limbo);
+            }
+        }
+    }
+
+    /**
+     * @brief Nodes the calling thread has retired but not yet freed
+     */
+    size_t pending() noexcept {
+        size_t count = 0;
+        for (const auto& limbo : local_record().limbo) {
+            count += limbo.items.size();
+        }
+        return count;
+    }
+
+    uint64_t epoch() const noexcept {
+        return epoch_.data.load(std::memory_order_relaxed);
+    }
+
+private:
+    // Advances the global epoch if every active thread has announced the current one
+    bool try_advance() noexcept {
+        uint64_t epoch = epoch_.data.load(std::memory_order_seq_cst);
+        const size_t limit = slot_limit_.load();
+        for (size_t i = 0; i < limit; ++i) {
+            const uint64_t announced = records_[i].data.announced.load(std::memory_order_seq_cst);
+            if ((announced & 1) != 0 && (announced >> 1) != epoch) {
+                return false;
+            }
+        }
+        return epoch_.data.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+    }
+
+    static void free_limbo(Record::Limbo& limbo) noexcept {
+        for (const Retired& item : limbo.items) {
+            item.reclaim();
+        }
+        limbo.items.clear();
+    }
+
+    Record& local_record() noexcept {
+        const size_t slot = this_thread_slot();
+        if (slot == NO_THREAD_SLOT) {
+            // More than MAX_THREAD_SLOTS live threads; there is nowhere to announce an epoch
+            std::terminate();
+        }
+        // Scans only cover slots that have used this domain. Sequentially consistent, so a
+        // scan that could have missed this thread's announcement also sees the larger limit.
+        size_t limit = slot_limit_.load();
+        while (limit <= slot && !slot_limit_.compare_exchange_weak(limit, slot + 1)) {
+        }
+        return records_[slot].data;
+    }
+
+    CacheLineAligned<std::atomic<uint64_t>> epoch_;
+    std::atomic<size_t> slot_limit_{0};
+    std::unique_ptr<CacheLineAligned<Record>[]> records_;
+};
@@ -0,0 +1,202 @@
+/**
+ * @file hazard_pointers.h
+ * @brief Hazard-pointer reclamation: per-pointer protection, bounded garbage
+ *
+ * Each thread owns a few hazard slots. protect() publishes the pointer it is
+ * about to use in one of them, then re-reads the source to check the pointer
+ * was not unlinked in between. A retired node is freed by a scan that finds
+ * it in no thread's hazard slots.
+ *
+ * A thread scans once its retired list reaches twice the number of hazard
+ * slots across the threads using the domain (and at least MIN_SCAN_THRESHOLD).
+ * Each slot can keep at most one node alive through a scan, so each thread
+ * holds a bounded amount of garbage however long readers stall, and at least
+ * half the list is freed per scan: O(1) amortised work per retire.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include "concurrency_primitives.h"
+#include "reclamation.h"
+#include "thread_slot.h"
+
+/**
+ * @tparam HazardsPerThread Guards a thread may hold at once in this domain
+ */
+template <size_t HazardsPerThread = 4>
+class HazardDomain {
+    static_assert(HazardsPerThread > 0 && HazardsPerThread <= 32, "Hazard slots are tracked in a 32-bit mask");
+
+    struct Record {
+        // Read by every scanning thread
+        std::array<std::atomic<const void*>, HazardsPerThread> hazards{};
+
+        // Owner-only from here on
+        uint32_t in_use = 0;
+        std::vector<Retired> retired;
+        std::vector<const void*> scan_buffer;  // Reused, so steady-state scans do not allocate
+    };
+
+public:
+    static constexpr size_t MIN_SCAN_THRESHOLD = 64;
+
+    /**
+     * @brief Owns one hazard slot; protects the last pointer passed through protect()
+     */
+    class Guard {
+    public:
+        explicit Guard(HazardDomain& domain) noexcept : record_(domain.local_record()) {
+            index_ = static_cast<size_t>(std::countr_zero(~record_.in_use));
+            if (index_ >= HazardsPerThread) {
+                // More live guards on this thread than HazardsPerThread
+                std::terminate();
+            }
+            record_.in_use |= 1u << index_;
+        }
+
+        ~Guard() {
+            reset();
+            record_.in_use &= ~(1u << index_);
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        /**
+         * @brief Loads and publishes a pointer until it is stable
+         *
+         * The result may be dereferenced until the next protect() or reset()
+         * on this guard. The exact value read is published, so a pointer with
+         * tag bits set protects nothing; callers restart on a tagged value.
+         */
+        template <typename T>
+        T* protect(const std::atomic<T*>& source) noexcept {
+            T* pointer = source.load(std::memory_order_relaxed);
+            while (true) {
+                // Sequentially consistent: the hazard is visible before the source is re-read
+                record_.hazards[index_].store(pointer, std::memory_order_seq_cst);
+                T* again = source.load(std::memory_order_seq_cst);
+                if (again == pointer) {
+                    return pointer;
+                }
+                pointer = again;
+            }
+        }
+
+        void reset() noexcept {
+            record_.hazards[index_].store(nullptr, std::memory_order_release);
+        }
+
+    private:
+        Record& record_;
+        size_t index_ = 0;
+    };
+
+    HazardDomain() : records_(new CacheLineAligned<Record>[MAX_THREAD_SLOTS]) {}
+
+    /**
+     * @brief Frees everything still retired; no thread may be using the domain
+     */
+    ~HazardDomain() {
+        const size_t limit = slot_limit_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < limit; ++i) {
+            for (const Retired& item : records_[i].data.retired) {
+                item.reclaim();
+            }
+        }
+    }
+
+    HazardDomain(const HazardDomain&) = delete;
+    HazardDomain& operator=(const HazardDomain&) = delete;
+
+    /**
+     * @brief Hands over an unlinked node; it is deleted once no hazard slot holds it
+     */
+    template <typename T>
+    void retire(T* pointer) {
+        retire(pointer, &delete_retired<T>);
+    }
+
+    void retire(void* pointer, void (*deleter)(void*)) {
+        Record& record = local_record();
+        record.retired.push_back(Retired{pointer, deleter});
+        if (record.retired.size() >= scan_threshold()) {
+            scan(record);
+        }
+    }
+
+    /**
+     * @brief Frees every node retired by the calling thread that no hazard slot holds
+     */
+    void collect() {
+        scan(local_record());
+    }
+
+    /**
+     * @brief Nodes the calling thread has retired but not yet freed
+     */
+    size_t pending() noexcept {
+        return local_record().retired.size();
+    }
+
+    /**
+     * @brief Retired nodes that trigger a scan; also bounds each thread's garbage
+     */
+    size_t scan_threshold() const noexcept {
+        return std::max(MIN_SCAN_THRESHOLD, 2 * HazardsPerThread * slot_limit_.load(std::memory_order_relaxed));
+    }
+
+private:
+    void scan(Record& record) {
+        // Pairs with the readers' publish-then-validate: the caller's unlink is visible
+        // before any hazard slot is read
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        auto& hazards = record.scan_buffer;
+        hazards.clear();
+        const size_t limit = slot_limit_.load();
+        for (size_t i = 0; i < limit; ++i) {
+            for (const auto& hazard : records_[i].data.hazards) {
+                if (const void* pointer = hazard.load(std::memory_order_seq_cst)) {
+                    hazards.push_back(pointer);
+                }
+            }
+        }
+        std::sort(hazards.begin(), hazards.end());
+
+        // Keep protected nodes at the front, free the rest
+        auto kept = std::partition(record.retired.begin(), record.retired.end(), [&](const Retired& item) {
+            return std::binary_search(hazards.begin(), hazards.end(), static_cast<const void*>(item.pointer));
+        });
+        for (auto it = kept; it != record.retired.end(); ++it) {
+            it->reclaim();
+        }
+        record.retired.erase(kept, record.retired.end());
+    }
+
+    Record& local_record() noexcept {
+        const size_t slot = this_thread_slot();
+        if (slot == NO_THREAD_SLOT) {
+            // More than MAX_THREAD_SLOTS live threads; there is nowhere to publish hazards
+            std::terminate();
+        }
+        // Scans only cover slots that have used this domain
+        size_t limit = slot_limit_.load();
+        while (limit <= slot && !slot_limit_.compare_exchange_weak(limit, slot + 1)) {
+        }
+        return records_[slot].data;
+    }
+
+    std::atomic<size_t> slot_limit_{0};
+    std::unique_ptr<CacheLineAligned<Record>[]> records_;
+};
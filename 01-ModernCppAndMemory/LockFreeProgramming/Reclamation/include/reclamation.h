@@ -0,0 +1,62 @@
+/**
+ * @file reclamation.h
+ * @brief The retire/protect interface shared by the reclamation schemes
+ *
+ * A lock-free structure that unlinks a node cannot free it straight away: a
+ * reader that loaded the pointer just before the unlink may still be about to
+ * dereference it. A reclamation domain holds retired nodes until no reader
+ * can reach them. Structures are written once against this interface and
+ * instantiated with either scheme:
+ *
+ *  - EpochDomain (epoch_reclamation.h): a guard is one store and a fence,
+ *    protect() is a plain load, and frees happen in batches. One stalled
+ *    reader holds back all garbage.
+ *  - HazardDomain (hazard_pointers.h): protect() publishes and re-validates
+ *    each pointer, which costs a fence per node visited. In exchange each
+ *    thread's garbage is bounded, however slow the readers are.
+ *
+ * Usage (a guard protects the last pointer passed through it; with epochs
+ * every guard protects everything):
+ *
+ *   typename D::Guard guard(domain);
+ *   Node* node = guard.protect(head);   // Safe to dereference until the guard dies
+ *   ...
+ *   head.store(next);                   // Writer unlinks...
+ *   domain.retire(node);                // ...and hands the node over
+ */
+
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+
+/**
+ * @brief A retired pointer and the function that frees it
+ */
+struct Retired {
+    void* pointer;
+    void (*deleter)(void*);
+
+    void reclaim() const noexcept {
+        deleter(pointer);
+    }
+};
+
+template <typename T>
+void delete_retired(void* pointer) noexcept {
+    delete static_cast<T*>(pointer);
+}
+
+/**
+ * @brief What a structure may rely on from a reclamation domain
+ */
+template <typename D>
+concept Reclaimer = requires(D& domain, typename D::Guard& guard, const std::atomic<int*>& source, int* pointer) {
+    requires std::constructible_from<typename D::Guard, D&>;
+    { guard.protect(source) } -> std::same_as<int*>;
+    guard.reset();
+    domain.retire(pointer);
+    domain.collect();
+    { domain.pending() } -> std::convertible_to<size_t>;
+};
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include "../include/epoch_reclamation.h"
+#include "../include/hazard_pointers.h"
+#include "../include/concurrent_list.h"
+
+struct Level {
+    uint64_t price = 0;
+    uint64_t quantity = 0;
+};
+
+// One book-builder thread updates the levels while strategy threads read them
+template <typename D>
+void run_book(const char* name) {
+    constexpr uint64_t NUM_LEVELS = 64;
+    constexpr uint64_t NUM_UPDATES = 500000;
+    constexpr int NUM_READERS = 2;
+
+    D domain;
+    ConcurrentSortedList<uint64_t, Level, D> book(domain);
+    for (uint64_t price = 0; price < NUM_LEVELS; ++price) {
+        book.insert_or_assign(price, Level{price, 100});
+    }
+
+    std::atomic<bool> done(false);
+    std::atomic<uint64_t> lookups(0);
+    size_t max_pending = 0;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < NUM_READERS; ++r) {
+        readers.emplace_back([&, r]() {
+            uint64_t count = 0;
+            uint64_t price = static_cast<uint64_t>(r);
+            while (!done.load(std::memory_order_relaxed)) {
+                auto level = book.find(price);
+                if (level && level->price != price) {
+                    std::cout << "Inconsistent level!\n";
+                }
+                price = (price + 7) % NUM_LEVELS;
+                ++count;
+            }
+            lookups.fetch_add(count);
+        });
+    }
+
+    for (uint64_t update = 0; update < NUM_UPDATES; ++update) {
+        book.insert_or_assign(update % NUM_LEVELS, Level{update % NUM_LEVELS, update});
+        max_pending = std::max(max_pending, domain.pending());
+        if (update % 1024 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+    std::cout << name << ": " << NUM_UPDATES << " updates and " << lookups.load() << " lookups in " << duration
+              << " ms, at most " << max_pending << " retired levels awaiting reclamation\n";
+}
+
+int main() {
+    std::cout << "Memory Reclamation Demo\n";
+    std::cout << "-----------------------\n";
+
+    // Basic operations demo
+    EpochDomain epochs;
+    {
+        ConcurrentSortedList<uint64_t, Level, EpochDomain> book(epochs);
+        book.insert_or_assign(10050, Level{10050, 300});
+        book.insert_or_assign(10050, Level{10050, 200});  // Replaces and retires the old node
+        std::cout << "Level 10050 quantity: " << book.find(10050)->quantity << "\n";
+        std::cout << "Retired nodes pending: " << epochs.pending() << "\n";
+        for (int i = 0; i < 3; ++i) {
+            epochs.collect();
+        }
+        std::cout << "After collect(): " << epochs.pending() << " (epoch " << epochs.epoch() << ")\n\n";
+    }
+
+    run_book<EpochDomain>("Epochs         ");
+    run_book<HazardDomain<>>("Hazard pointers");
+
+    return 0;
+}
@@ -0,0 +1,310 @@
+#include "../include/epoch_reclamation.h"
+#include "../include/hazard_pointers.h"
+#include "../include/concurrent_list.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <random>
+
+// Both schemes satisfy the shared interface the list is written against
+static_assert(Reclaimer<EpochDomain>);
+static_assert(Reclaimer<HazardDomain<>>);
+
+namespace {
+
+// Counts live instances, so leaks and double frees both show up
+struct Tracked {
+    static inline std::atomic<int> live{0};
+    uint64_t value;
+
+    explicit Tracked(uint64_t v = 0) : value(v) { live.fetch_add(1); }
+    Tracked(const Tracked& other) : value(other.value) { live.fetch_add(1); }
+    Tracked& operator=(const Tracked&) = default;
+    ~Tracked() { live.fetch_sub(1); }
+};
+
+// A price level whose fields must always agree, so a torn or freed read is detected
+struct Level {
+    uint64_t price = 0;
+    uint64_t quantity = 0;
+    uint64_t check = 0;
+    Tracked tracked;
+
+    static Level make(uint64_t price, uint64_t quantity) {
+        return Level{price, quantity, price * 31 + quantity, Tracked()};
+    }
+    bool consistent() const { return check == price * 31 + quantity; }
+};
+
+}  // namespace
+
+// The same suite runs against every scheme
+template <typename D>
+class ReclamationTest : public ::testing::Test {
+protected:
+    void SetUp() override { Tracked::live.store(0); }
+
+    // Enough rounds for epochs to advance past everything retired
+    static void collect_fully(D& domain) {
+        for (int i = 0; i < 4; ++i) {
+            domain.collect();
+        }
+    }
+};
+
+using Domains = ::testing::Types<EpochDomain, HazardDomain<>>;
+TYPED_TEST_SUITE(ReclamationTest, Domains);
+
+// Test that retired nodes nobody reads are freed
+TYPED_TEST(ReclamationTest, RetiredNodesAreFreed) {
+    TypeParam domain;
+    for (int i = 0; i < 10; ++i) {
+        domain.retire(new Tracked(i));
+    }
+    EXPECT_EQ(Tracked::live.load(), 10);
+
+    TestFixture::collect_fully(domain);
+    EXPECT_EQ(domain.pending(), 0u);
+    EXPECT_EQ(Tracked::live.load(), 0);
+}
+
+// Test that a node protected by another thread survives until that thread lets go
+TYPED_TEST(ReclamationTest, ProtectedNodeIsNotFreed) {
+    TypeParam domain;
+    std::atomic<Tracked*> source(new Tracked(42));
+    std::atomic<int> stage(0);
+
+    std::thread reader([&]() {
+        typename TypeParam::Guard guard(domain);
+        Tracked* node = guard.protect(source);
+        stage.store(1);
+        while (stage.load() != 2) {
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(node->value, 42u);  // Still valid after being retired
+    });
+    while (stage.load() != 1) {
+        std::this_thread::yield();
+    }
+
+    Tracked* node = source.exchange(nullptr);
+    domain.retire(node);
+    TestFixture::collect_fully(domain);
+    EXPECT_EQ(Tracked::live.load(), 1);
+    EXPECT_EQ(domain.pending(), 1u);
+
+    stage.store(2);
+    reader.join();
+    TestFixture::collect_fully(domain);
+    EXPECT_EQ(Tracked::live.load(), 0);
+}
+
+// Test that destroying the domain frees whatever is still pending
+TYPED_TEST(ReclamationTest, DestructorFreesPending) {
+    {
+        TypeParam domain;
+        typename TypeParam::Guard guard(domain);
+        std::atomic<Tracked*> source(new Tracked(1));
+        Tracked* node = guard.protect(source);
+        source.store(nullptr);
+        domain.retire(node);
+        domain.collect();
+        EXPECT_EQ(Tracked::live.load(), 1);
+        guard.reset();
+    }
+    EXPECT_EQ(Tracked::live.load(), 0);
+}
+
+// Test the list's single-threaded behaviour
+TYPED_TEST(ReclamationTest, ListOperations) {
+    TypeParam domain;
+    {
+        ConcurrentSortedList<uint64_t, Level, TypeParam> list(domain);
+        EXPECT_FALSE(list.find(100).has_value());
+
+        EXPECT_TRUE(list.insert_or_assign(102, Level::make(102, 5)));
+        EXPECT_TRUE(list.insert_or_assign(100, Level::make(100, 7)));
+        EXPECT_TRUE(list.insert_or_assign(101, Level::make(101, 9)));
+        EXPECT_EQ(list.size(), 3u);
+        EXPECT_EQ(list.find(101)->quantity, 9u);
+
+        EXPECT_FALSE(list.insert_or_assign(101, Level::make(101, 11)));  // Replaces
+        EXPECT_EQ(list.find(101)->quantity, 11u);
+        EXPECT_EQ(list.size(), 3u);
+
+        EXPECT_TRUE(list.erase(100));
+        EXPECT_FALSE(list.erase(100));
+        EXPECT_FALSE(list.find(100).has_value());
+        EXPECT_EQ(list.find(102)->quantity, 5u);
+        EXPECT_FALSE(list.find(103).has_value());
+        EXPECT_EQ(list.size(), 2u);
+    }
+    TestFixture::collect_fully(domain);
+    EXPECT_EQ(Tracked::live.load(), 0);
+}
+
+// Test readers against a writer that keeps replacing and erasing levels
+TYPED_TEST(ReclamationTest, ListConcurrentReadersAndWriter) {
+    constexpr uint64_t NUM_LEVELS = 64;
+    constexpr uint64_t NUM_UPDATES = 50000;
+    constexpr int NUM_READERS = 3;
+    {
+        TypeParam domain;
+        ConcurrentSortedList<uint64_t, Level, TypeParam> list(domain);
+        for (uint64_t price = 0; price < NUM_LEVELS; ++price) {
+            list.insert_or_assign(price, Level::make(price, 0));
+        }
+
+        std::atomic<bool> done(false);
+        std::atomic<bool> inconsistent(false);
+        std::atomic<uint64_t> hits(0);
+        std::vector<std::thread> readers;
+        for (int r = 0; r < NUM_READERS; ++r) {
+            readers.emplace_back([&, r]() {
+                std::mt19937_64 rng(r);
+                uint64_t found = 0;
+                while (!done.load(std::memory_order_relaxed)) {
+                    const uint64_t price = rng() % NUM_LEVELS;
+                    if (auto level = list.find(price)) {
+                        if (!level->consistent() || level->price != price) {
+                            inconsistent.store(true);
+                        }
+                        ++found;
+                    }
+                }
+                hits.fetch_add(found);
+            });
+        }
+
+        size_t max_pending = 0;
+        std::mt19937_64 rng(99);
+        for (uint64_t update = 1; update <= NUM_UPDATES; ++update) {
+            const uint64_t price = rng() % NUM_LEVELS;
+            if (update % 8 == 0) {
+                list.erase(price);
+            } else {
+                list.insert_or_assign(price, Level::make(price, update));
+            }
+            max_pending = std::max(max_pending, domain.pending());
+            if (update % 1024 == 0) {
+                std::this_thread::yield();  // Let readers run on machines with few cores
+            }
+        }
+        done.store(true);
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        EXPECT_FALSE(inconsistent.load());
+        EXPECT_GT(hits.load(), 0u);
+        EXPECT_LT(max_pending, NUM_UPDATES / 2);  // Garbage is being freed while the readers run
+    }
+    EXPECT_EQ(Tracked::live.load(), 0);
+}
+
+// Test that epoch guards nest and only the outermost one announces
+TEST(EpochReclamationTest, GuardsNest) {
+    EpochDomain domain;
+    Tracked::live.store(0);
+    std::atomic<Tracked*> source(new Tracked(7));
+    std::atomic<int> stage(0);
+
+    std::thread reader([&]() {
+        EpochDomain::Guard outer(domain);
+        Tracked* node;
+        {
+            EpochDomain::Guard inner(domain);
+            node = inner.protect(source);
+        }
+        stage.store(1);
+        while (stage.load() != 2) {
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(node->value, 7u);  // The outer guard still protects it
+    });
+    while (stage.load() != 1) {
+        std::this_thread::yield();
+    }
+
+    const uint64_t epoch = domain.epoch();
+    domain.retire(source.exchange(nullptr));
+    for (int i = 0; i < 4; ++i) {
+        domain.collect();
+    }
+    EXPECT_LE(domain.epoch(), epoch + 1);  // The reader holds the epoch back
+    EXPECT_EQ(Tracked::live.load(), 1);
+
+    stage.store(2);
+    reader.join();
+    for (int i = 0; i < 4; ++i) {
+        domain.collect();
+    }
+    EXPECT_GE(domain.epoch(), epoch + 2);
+    EXPECT_EQ(Tracked::live.load(), 0);
+}
+
+// Test that a stalled reader cannot make a hazard-pointer thread hoard garbage
+TEST(HazardPointerTest, GarbageIsBounded) {
+    HazardDomain<> domain;
+    Tracked::live.store(0);
+    std::atomic<Tracked*> source(new Tracked(1));
+    std::atomic<int> stage(0);
+
+    std::thread reader([&]() {
+        HazardDomain<>::Guard guard(domain);
+        Tracked* node = guard.protect(source);
+        stage.store(1);
+        while (stage.load() != 2) {
+            std::this_thread::yield();
+        }
+        EXPECT_EQ(node->value, 1u);
+    });
+    while (stage.load() != 1) {
+        std::this_thread::yield();
+    }
+
+    domain.retire(source.exchange(nullptr));
+    size_t max_pending = 0;
+    for (int i = 0; i < 10000; ++i) {
+        domain.retire(new Tracked(i));
+        max_pending = std::max(max_pending, domain.pending());
+    }
+    EXPECT_LE(max_pending, domain.scan_threshold());
+    EXPECT_GE(Tracked::live.load(), 1);
+
+    stage.store(2);
+    reader.join();
+    domain.collect();
+    EXPECT_EQ(Tracked::live.load(), 0);
+}
+
+// Test that guards on one thread take distinct hazard slots and give them back
+TEST(HazardPointerTest, GuardsUseDistinctSlots) {
+    HazardDomain<2> domain;
+    Tracked::live.store(0);
+    std::atomic<Tracked*> a(new Tracked(1));
+    std::atomic<Tracked*> b(new Tracked(2));
+    {
+        HazardDomain<2>::Guard first(domain);
+        HazardDomain<2>::Guard second(domain);
+        Tracked* pa = first.protect(a);
+        Tracked* pb = second.protect(b);
+        domain.retire(a.exchange(nullptr));
+        domain.retire(b.exchange(nullptr));
+        domain.collect();
+        EXPECT_EQ(Tracked::live.load(), 2);
+        EXPECT_EQ(pa->value + pb->value, 3u);
+    }
+    // Both slots are free again
+    HazardDomain<2>::Guard first(domain);
+    HazardDomain<2>::Guard second(domain);
+    domain.collect();
+    EXPECT_EQ(Tracked::live.load(), 0);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,113 @@
+#include "../include/retransmit_ring.h"
+#include "queue_benchmarks.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// A market data message as the feed handler keeps it
+struct FeedMessage {
+    uint64_t seq = 0;
+    uint64_t exchange_tsc = 0;
+    uint32_t symbol = 0;
+    uint32_t quantity = 0;
+    int64_t price = 0;
+    uint64_t order_id = 0;
+    uint64_t flags = 0;
+};
+
+constexpr size_t CAPACITY = 1 << 16;
+constexpr uint64_t REPLAY_LENGTH = 256;
+constexpr uint64_t BATCH = 1024;
+
+using Ring = RetransmitRing<FeedMessage, CAPACITY>;
+
+/**
+ * @brief Writer throughput while state.range(0) threads replay ranges
+ *
+ * Readers replay REPLAY_LENGTH messages at a time, alternately from the
+ * newest messages and from the oldest, which the writer is overwriting.
+ * Each iteration publishes BATCH messages. Reports the writer's rate, the
+ * messages readers delivered per message written, and the share of replays
+ * cut short by an overrun.
+ */
+static void BM_WriterWithReaders(benchmark::State& state) {
+    const int reader_count = static_cast<int>(state.range(0));
+    auto ring = std::make_unique<Ring>();
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> replays{0};
+    std::atomic<uint64_t> overruns{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < reader_count; ++r) {
+        readers.emplace_back([&, r]() {
+            queue_bench::pin_current_thread(static_cast<unsigned>(r + 1));
+            uint64_t local_delivered = 0;
+            uint64_t local_replays = 0;
+            uint64_t local_overruns = 0;
+            uint64_t checksum = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const uint64_t end = ring->end();
+                const uint64_t first = local_replays % 2 == 0 ? ring->oldest()
+                                                              : (end > REPLAY_LENGTH ? end - REPLAY_LENGTH : 0);
+                const auto result = ring->read_range(first, first + REPLAY_LENGTH,
+                                                     [&](uint64_t, const FeedMessage& message) {
+                                                         checksum += message.price;
+                                                         ++local_delivered;
+                                                     });
+                ++local_replays;
+                local_overruns += result.status == ReadStatus::OVERWRITTEN ? 1 : 0;
+            }
+            benchmark::DoNotOptimize(checksum);
+            delivered.fetch_add(local_delivered, std::memory_order_relaxed);
+            replays.fetch_add(local_replays, std::memory_order_relaxed);
+            overruns.fetch_add(local_overruns, std::memory_order_relaxed);
+        });
+    }
+
+    queue_bench::pin_current_thread(0);
+    uint64_t seq = 0;
+    FeedMessage message;
+    for (auto _ : state) {
+        for (uint64_t i = 0; i < BATCH; ++i) {
+            message.seq = seq;
+            message.price = static_cast<int64_t>(seq);
+            ring->publish(seq++, message);
+        }
+    }
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(seq));
+    state.counters["read_per_write"] = static_cast<double>(delivered.load()) / static_cast<double>(seq);
+    state.counters["overrun_share"] =
+        replays.load() > 0 ? static_cast<double>(overruns.load()) / static_cast<double>(replays.load()) : 0.0;
+}
+
+// Cost of one lookup by sequence number, with the writer idle
+static void BM_Lookup(benchmark::State& state) {
+    auto ring = std::make_unique<Ring>();
+    FeedMessage message;
+    for (uint64_t seq = 0; seq < CAPACITY; ++seq) {
+        ring->publish(seq, message);
+    }
+    uint64_t seq = 0;
+    for (auto _ : state) {
+        seq = (seq + 4099) & (CAPACITY - 1);
+        benchmark::DoNotOptimize(ring->read(seq, message));
+        benchmark::DoNotOptimize(message);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_WriterWithReaders)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+BENCHMARK(BM_Lookup);
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
@@ -0,0 +1,258 @@
+/**
+ * @file retransmit_ring.h
+ * @brief The last Capacity messages of a feed, indexed by sequence number, for replay
+ *
+ * A feed handler keeps recent messages to answer internal replay requests,
+ * and must notice when the feed skips sequence numbers. Message seq lives in
+ * slot seq & (Capacity - 1), RingBuffer's power-of-two indexing, so a lookup
+ * is one mask, and a new message overwrites the one Capacity places before it.
+ *
+ * The writer never waits for readers. Each slot carries a version, as in a
+ * seqlock, derived from the sequence number it holds and saying whether the
+ * slot is being written, holds the message, or marks it missing. A reader
+ * checks the version before and after copying a message out, and reports the
+ * message as overwritten if the writer got there first. The message is a
+ * SeqLockPayload, so the copy that races the writer is well defined.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "concurrency_primitives.h"
+#include "seqlock_payload.h"
+
+/**
+ * @brief Outcome of reading one sequence number
+ */
+enum class ReadStatus {
+    OK,           // The message was copied out
+    NOT_YET,      // Not published yet
+    OVERWRITTEN,  // Older than the ring holds, or overwritten while being read
+    MISSING       // The feed skipped this sequence number
+};
+
+/**
+ * @brief Outcome of publishing one message
+ */
+enum class PublishStatus {
+    IN_ORDER,  // The sequence number followed the last one
+    GAP,       // Sequence numbers were skipped; see last_gap()
+    STALE      // Not after the last one published; ignored
+};
+
+/**
+ * @brief A run of sequence numbers the feed skipped, first to last inclusive
+ */
+struct SequenceGap {
+    uint64_t first = 0;
+    uint64_t last = 0;
+};
+
+/**
+ * @brief Sequence-indexed history of one writer's messages, readable by any number of threads
+ *
+ * One thread publishes. Any thread may read single messages or ranges; a
+ * read never blocks the writer, and fails cleanly if the writer overwrites
+ * the slot meanwhile.
+ *
+ * @tparam T The message type (must be trivially copyable: readers copy it while it may be changing)
+ * @tparam Capacity Messages kept (must be a power of 2)
+ */
+template <typename T, size_t Capacity>
+class RetransmitRing {
+    static_assert(Capacity > 0, "Capacity must be greater than 0");
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    using value_type = T;
+
+    /**
+     * @brief Where a range read stopped: the first sequence number not delivered, and why
+     */
+    struct RangeResult {
+        uint64_t next = 0;
+        ReadStatus status = ReadStatus::OK;
+    };
+
+    RetransmitRing() noexcept {
+        for (auto& slot : slots_) {
+            slot.version.store(0, std::memory_order_relaxed);
+        }
+        begin_.store(0, std::memory_order_relaxed);
+        end_.data.store(0, std::memory_order_relaxed);
+    }
+
+    RetransmitRing(const RetransmitRing&) = delete;
+    RetransmitRing& operator=(const RetransmitRing&) = delete;
+
+    /**
+     * @brief Stores message seq, overwriting the one Capacity places before it; writer only
+     *
+     * The first message may have any sequence number. After that, skipped
+     * sequence numbers are recorded as missing (only those that still fit in
+     * the ring; older ones would be overwritten anyway).
+     */
+    PublishStatus publish(uint64_t seq, const T& value) noexcept {
+        const uint64_t end = end_.data.load(std::memory_order_relaxed);
+        PublishStatus status = PublishStatus::IN_ORDER;
+        if (end == 0) {
+            begin_.store(seq, std::memory_order_relaxed);
+        } else if (seq < end) {
+            ++stale_;
+            return PublishStatus::STALE;
+        } else if (seq > end) {
+            last_gap_ = SequenceGap{end, seq - 1};
+            ++gaps_;
+            missing_ += seq - end;
+            for (uint64_t gap = seq - end >= Capacity ? seq - Capacity + 1 : end; gap < seq; ++gap) {
+                write(gap, nullptr);
+            }
+            status = PublishStatus::GAP;
+        }
+        write(seq, &value);
+        // Release: a reader that sees the new end sees the slot's version too
+        end_.data.store(seq + 1, std::memory_order_release);
+        return status;
+    }
+
+    /**
+     * @brief Copies out message seq; callable from any thread
+     */
+    ReadStatus read(uint64_t seq, T& out) const noexcept {
+        if (seq >= end_.data.load(std::memory_order_acquire)) {
+            return ReadStatus::NOT_YET;
+        }
+        if (seq < begin_.load(std::memory_order_relaxed)) {
+            return ReadStatus::OVERWRITTEN;
+        }
+        const Slot& slot = slots_[seq & MASK];
+        const uint64_t before = slot.version.load(std::memory_order_acquire);
+        if (before == version(seq, MISSING)) {
+            return ReadStatus::MISSING;
+        }
+        if (before != version(seq, PRESENT)) {
+            // A larger version means a later message has taken, or is taking, the slot
+            return before > version(seq, MISSING) ? ReadStatus::OVERWRITTEN : ReadStatus::NOT_YET;
+        }
+        slot.value.load(out);
+        // Keep the copy above the second version load
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) != before) {
+            return ReadStatus::OVERWRITTEN;
+        }
+        return ReadStatus::OK;
+    }
+
+    /**
+     * @brief Hands messages first, first + 1, ... up to last (exclusive) to handler, in order
+     *
+     * Each message is checked before handler sees it, so handler only ever
+     * gets whole messages. Stops at the first sequence number that cannot be
+     * delivered; a caller replaying across a gap can resume at result.next + 1.
+     *
+     * @param handler Called as handler(seq, const T&)
+     */
+    template <typename Handler>
+    RangeResult read_range(uint64_t first, uint64_t last, Handler&& handler) const {
+        T value;
+        for (uint64_t seq = first; seq < last; ++seq) {
+            const ReadStatus status = read(seq, value);
+            if (status != ReadStatus::OK) {
+                return RangeResult{seq, status};
+            }
+            handler(seq, static_cast<const T&>(value));
+        }
+        return RangeResult{last, ReadStatus::OK};
+    }
+
+    /**
+     * @brief One past the newest sequence number published, or 0 before the first
+     */
+    uint64_t end() const noexcept {
+        return end_.data.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief The oldest sequence number still held, or end() when nothing is
+     *
+     * Only a hint while the writer is active: it may be overwritten by the time it is read.
+     */
+    uint64_t oldest() const noexcept {
+        const uint64_t end = end_.data.load(std::memory_order_acquire);
+        const uint64_t begin = begin_.load(std::memory_order_relaxed);
+        return end - begin > Capacity ? end - Capacity : begin;
+    }
+
+    // Gap and duplicate statistics (writer only)
+
+    uint64_t gaps() const noexcept {
+        return gaps_;
+    }
+
+    uint64_t missing() const noexcept {
+        return missing_;
+    }
+
+    uint64_t stale() const noexcept {
+        return stale_;
+    }
+
+    SequenceGap last_gap() const noexcept {
+        return last_gap_;
+    }
+
+    static constexpr size_t capacity() noexcept {
+        return Capacity;
+    }
+
+private:
+    static constexpr size_t MASK = Capacity - 1;
+
+    // What a slot's version says about message seq; a later message's versions are all larger
+    static constexpr uint64_t WRITING = 1;
+    static constexpr uint64_t PRESENT = 2;
+    static constexpr uint64_t MISSING = 3;
+
+    struct Slot {
+        // version(seq, WRITING) while message seq is written, then PRESENT or MISSING
+        std::atomic<uint64_t> version;
+        SeqLockPayload<T> value;
+    };
+
+    static constexpr uint64_t version(uint64_t seq, uint64_t state) noexcept {
+        return 4 * seq + state;
+    }
+
+    // Writes message seq, or marks it missing when value is null
+    void write(uint64_t seq, const T* value) noexcept {
+        Slot& slot = slots_[seq & MASK];
+        if (value == nullptr) {
+            // Nothing to copy: readers look only at the version
+            slot.version.store(version(seq, MISSING), std::memory_order_release);
+            return;
+        }
+        slot.version.store(version(seq, WRITING), std::memory_order_relaxed);
+        // Make the writing version visible before any word of the new message
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.value.store(*value);
+        slot.version.store(version(seq, PRESENT), std::memory_order_release);
+    }
+
+    // Read by every reader; written once per message
+    CacheLineAligned<std::atomic<uint64_t>> end_;
+    std::atomic<uint64_t> begin_;
+
+    // Writer-only statistics
+    alignas(CACHE_LINE_SIZE) uint64_t gaps_ = 0;
+    uint64_t missing_ = 0;
+    uint64_t stale_ = 0;
+    SequenceGap last_gap_;
+
+    alignas(CACHE_LINE_SIZE) std::array<Slot, Capacity> slots_;
+};
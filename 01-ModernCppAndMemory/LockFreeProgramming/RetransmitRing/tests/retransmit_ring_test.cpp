@@ -0,0 +1,165 @@
+#include "../include/retransmit_ring.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+struct Message {
+    uint64_t seq = 0;
+    uint64_t check = 0;  // ~seq, so a torn copy shows
+};
+
+using SmallRing = RetransmitRing<Message, 8>;
+
+static Message make_message(uint64_t seq) {
+    return Message{seq, ~seq};
+}
+
+// Test that published messages are found by sequence number, and later ones are not yet there
+TEST(RetransmitRingTest, LookupBySequence) {
+    SmallRing ring;
+    Message message;
+    EXPECT_EQ(ring.read(0, message), ReadStatus::NOT_YET);
+    EXPECT_EQ(ring.end(), 0u);
+
+    for (uint64_t seq = 100; seq < 105; ++seq) {
+        EXPECT_EQ(ring.publish(seq, make_message(seq)), PublishStatus::IN_ORDER);
+    }
+    EXPECT_EQ(ring.end(), 105u);
+    EXPECT_EQ(ring.oldest(), 100u);
+    ASSERT_EQ(ring.read(102, message), ReadStatus::OK);
+    EXPECT_EQ(message.seq, 102u);
+    EXPECT_EQ(ring.read(105, message), ReadStatus::NOT_YET);
+    EXPECT_EQ(ring.read(99, message), ReadStatus::OVERWRITTEN);
+}
+
+// Test that the oldest messages are overwritten once more than Capacity are published
+TEST(RetransmitRingTest, OverwritesOldest) {
+    SmallRing ring;
+    for (uint64_t seq = 0; seq < 20; ++seq) {
+        ring.publish(seq, make_message(seq));
+    }
+    EXPECT_EQ(ring.oldest(), 12u);
+    Message message;
+    EXPECT_EQ(ring.read(11, message), ReadStatus::OVERWRITTEN);
+    EXPECT_EQ(ring.read(3, message), ReadStatus::OVERWRITTEN);
+    for (uint64_t seq = 12; seq < 20; ++seq) {
+        ASSERT_EQ(ring.read(seq, message), ReadStatus::OK);
+        EXPECT_EQ(message.seq, seq);
+    }
+}
+
+// Test that skipped sequence numbers are reported as a gap and read back as missing
+TEST(RetransmitRingTest, DetectsGaps) {
+    SmallRing ring;
+    ring.publish(1, make_message(1));
+    ring.publish(2, make_message(2));
+    EXPECT_EQ(ring.publish(5, make_message(5)), PublishStatus::GAP);
+    EXPECT_EQ(ring.gaps(), 1u);
+    EXPECT_EQ(ring.missing(), 2u);
+    EXPECT_EQ(ring.last_gap().first, 3u);
+    EXPECT_EQ(ring.last_gap().last, 4u);
+
+    Message message;
+    EXPECT_EQ(ring.read(3, message), ReadStatus::MISSING);
+    EXPECT_EQ(ring.read(4, message), ReadStatus::MISSING);
+    EXPECT_EQ(ring.read(5, message), ReadStatus::OK);
+
+    // A duplicate or late message is ignored
+    EXPECT_EQ(ring.publish(4, make_message(4)), PublishStatus::STALE);
+    EXPECT_EQ(ring.publish(5, make_message(5)), PublishStatus::STALE);
+    EXPECT_EQ(ring.stale(), 2u);
+    EXPECT_EQ(ring.read(4, message), ReadStatus::MISSING);
+}
+
+// Test that a gap wider than the ring leaves only the slots it still covers marked missing
+TEST(RetransmitRingTest, GapWiderThanRing) {
+    SmallRing ring;
+    ring.publish(0, make_message(0));
+    EXPECT_EQ(ring.publish(100, make_message(100)), PublishStatus::GAP);
+    EXPECT_EQ(ring.missing(), 99u);
+    EXPECT_EQ(ring.oldest(), 93u);
+    Message message;
+    EXPECT_EQ(ring.read(92, message), ReadStatus::OVERWRITTEN);
+    for (uint64_t seq = 93; seq < 100; ++seq) {
+        EXPECT_EQ(ring.read(seq, message), ReadStatus::MISSING);
+    }
+    EXPECT_EQ(ring.read(100, message), ReadStatus::OK);
+}
+
+// Test that a range read delivers in order and stops where a message cannot be delivered
+TEST(RetransmitRingTest, RangeReads) {
+    SmallRing ring;
+    for (uint64_t seq = 10; seq < 14; ++seq) {
+        ring.publish(seq, make_message(seq));
+    }
+    ring.publish(16, make_message(16));
+
+    std::vector<uint64_t> seen;
+    auto collect = [&](uint64_t seq, const Message& message) {
+        EXPECT_EQ(message.seq, seq);
+        seen.push_back(seq);
+    };
+    auto result = ring.read_range(11, 20, collect);
+    EXPECT_EQ(seen, (std::vector<uint64_t>{11, 12, 13}));
+    EXPECT_EQ(result.next, 14u);
+    EXPECT_EQ(result.status, ReadStatus::MISSING);
+
+    result = ring.read_range(result.next + 2, 20, collect);
+    EXPECT_EQ(result.next, 17u);
+    EXPECT_EQ(result.status, ReadStatus::NOT_YET);
+    EXPECT_EQ(seen.back(), 16u);
+
+    result = ring.read_range(12, 14, collect);
+    EXPECT_EQ(result.next, 14u);
+    EXPECT_EQ(result.status, ReadStatus::OK);
+}
+
+// Test that concurrent readers never see a torn message, only whole ones or an overrun
+TEST(RetransmitRingTest, ReadersDetectOverrun) {
+    constexpr uint64_t COUNT = 500000;
+    RetransmitRing<Message, 64> ring;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> delivered{0};
+    std::atomic<uint64_t> overruns{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            while (!done.load(std::memory_order_relaxed)) {
+                // Replay from the oldest message, which the writer is about to overwrite
+                const uint64_t first = ring.oldest();
+                const auto result = ring.read_range(first, first + 64, [&](uint64_t seq, const Message& message) {
+                    if (message.seq != seq || message.check != ~seq) {
+                        torn.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    delivered.fetch_add(1, std::memory_order_relaxed);
+                });
+                if (result.status == ReadStatus::OVERWRITTEN) {
+                    overruns.fetch_add(1, std::memory_order_relaxed);
+                }
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (uint64_t seq = 0; seq < COUNT; ++seq) {
+        ring.publish(seq, make_message(seq));
+        if (seq % 4096 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true, std::memory_order_relaxed);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_GT(delivered.load(), 0u);
+    EXPECT_EQ(ring.gaps(), 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -6,31 +6,9 @@
 #include <optional>
 #include <type_traits>
 
-// Ensure cache line alignment to prevent false sharing
-constexpr size_t CACHE_LINE_SIZE = 64;
-
-// Helper class for cache line padding
-template<typename T>
-struct alignas(CACHE_LINE_SIZE) CacheLineAligned {
-    T data;
-    
-    CacheLineAligned() noexcept = default;
-    explicit CacheLineAligned(const T& value) : data(value) {}
-    explicit CacheLineAligned(T&& value) : data(std::move(value)) {}
-    
-    operator T&() noexcept { return data; }
-    operator const T&() const noexcept { return data; }
-    
-    T& operator=(const T& value) noexcept {
-        data = value;
-        return data;
-    }
-    
-    T& operator=(T&& value) noexcept {
-        data = std::move(value);
-        return data;
-    }
-};
+#include "concurrency_primitives.h"
+#include "numa.h"
+#include "queue_stats.h"
 
 /**
  * @brief A lock-free ring buffer implementation optimized for high-performance trading applications
@@ -41,14 +19,25 @@ struct alignas(CACHE_LINE_SIZE) CacheLineAligned {
  * 
  * @tparam T The type of elements stored in the buffer
  * @tparam Capacity The fixed capacity of the buffer (must be a power of 2)
+ * @tparam Stats Telemetry policy (NoStats or CountingStats<>, see queue_stats.h)
+ * @tparam Padding Padding around head_ and tail_ (default: 64 bytes; 128 also keeps
+ *         them apart from the adjacent-line prefetcher, see DESTRUCTIVE_INTERFERENCE_SIZE)
  */
-template<typename T, size_t Capacity>
+template<typename T, size_t Capacity, typename Stats = NoStats, size_t Padding = CACHE_LINE_SIZE>
 class RingBuffer {
     static_assert(Capacity > 0, "Capacity must be greater than 0");
     static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
     static_assert(std::is_move_constructible_v<T>, "T must be move constructible");
 
 public: 
+    using value_type = T;
+
+    // Only one thread may call try_enqueue at a time (head_ is published with a plain store)
+    static constexpr bool multi_producer = false;
+
+    // Bytes that separate head_, tail_ and the slots
+    static constexpr size_t padding = Padding;
+
     /**
      * @brief Constructs a new Ring Buffer with the specified capacity
      */
@@ -57,7 +46,8 @@ public:
         head_.data.store(0, std::memory_order_relaxed);
         tail_.data.store(0, std::memory_order_relaxed);
 
-        // Pre-fault the memory to avoid page faults during operation
+        // Writes every slot, which faults the storage in but does not lock it;
+        // see MemoryManagement/MemoryWarmup for locking and pre-faulting at startup
         for (size_t i = 0; i < Capacity; ++i) {
             new (&buffer_[i]) T();
         }
@@ -65,17 +55,11 @@ public:
 
     /**
      * @brief Destroys the Ring Buffer and its contents
+     * 
+     * Every slot is a live element of buffer_, so std::array destroys them all,
+     * including any items that were never dequeued.
      */
-    ~RingBuffer() {
-        // Destroy all elements still in the buffer
-        size_t head = head_.data.load(std::memory_order_relaxed);
-        size_t tail = tail_.data.load(std::memory_order_relaxed);
-        
-        while (head != tail) {
-            buffer_[head & mask_].~T();
-            head++;
-        }
-    }
+    ~RingBuffer() = default;
 
     // Disable copying to avoid concurrent access issues
     RingBuffer(const RingBuffer&) = delete;
@@ -94,6 +78,7 @@ public:
         
         // Check if buffer is full
         if (next_head - tail > Capacity) {
+            stats_.on_full();
             return false;
         }
         
@@ -102,6 +87,7 @@ public:
         
         // Update the head pointer with a release operation to ensure visibility
         head_.data.store(next_head, std::memory_order_release);
+        stats_.on_enqueue(next_head - tail);
         return true;
     }
 
@@ -118,6 +104,7 @@ public:
         
         // Check if buffer is full
         if (next_head - tail > Capacity) {
+            stats_.on_full();
             return false;
         }
         
@@ -126,6 +113,7 @@ public:
         
         // Update the head pointer with a release operation
         head_.data.store(next_head, std::memory_order_release);
+        stats_.on_enqueue(next_head - tail);
         return true;
     }
 
@@ -141,6 +129,7 @@ public:
         
         // Check if buffer is empty
         if (head <= tail) {
+            stats_.on_empty();
             return false;
         }
         
@@ -151,9 +140,12 @@ public:
         if (tail_.data.compare_exchange_strong(tail, tail + 1, 
                 std::memory_order_release, 
                 std::memory_order_relaxed)) {
+            stats_.on_dequeue();
             return true;  // Successfully dequeued
         }
 
+        // Another consumer took this element first
+        stats_.on_dequeue_retry();
         return false;
     }
 
@@ -168,6 +160,7 @@ public:
         
         // Check if buffer is empty
         if (head <= tail) {
+            stats_.on_empty();
             return std::nullopt;
         }
         
@@ -178,10 +171,12 @@ public:
         if (tail_.data.compare_exchange_strong(tail, tail + 1, 
                 std::memory_order_release, 
                 std::memory_order_relaxed)) {
+            stats_.on_dequeue();
             return std::optional<T>(std::move(result));  // Successfully dequeued
         }
 
         // If compare_exchange fails, return empty result
+        stats_.on_dequeue_retry();
         return std::nullopt;
     }
 
@@ -227,14 +222,49 @@ public:
         return Capacity;
     }
 
+    /**
+     * @brief Moves the buffer's memory to a NUMA node
+     * 
+     * The default is the calling thread's node, so the consumer can call it
+     * once at startup to pull the slots onto its own socket. Call it before
+     * traffic starts.
+     * 
+     * @return false if the node cannot be used (memory stays where it is)
+     */
+    bool bind_to_node(int node = numa_current_node()) noexcept {
+        return numa_bind(this, sizeof(*this), node);
+    }
+
+    /**
+     * @brief Returns the telemetry gathered so far (all zero with NoStats)
+     * 
+     * The occupancy high-water mark is measured by the producer against the
+     * tail it last saw, so it can overstate the true peak slightly.
+     * 
+     * @return QueueStatsSnapshot Counters summed over all threads
+     */
+    QueueStatsSnapshot stats() const noexcept {
+        return stats_.snapshot();
+    }
+
+    /**
+     * @brief Zeroes the telemetry counters; call only while the buffer is idle
+     */
+    void reset_stats() noexcept {
+        stats_.reset();
+    }
+
 private:
     // Mask for fast modulo calculation (works because Capacity is power of 2)
     static constexpr size_t mask_ = Capacity - 1;
     
-    // Head and tail pointers, aligned to cache lines to prevent false sharing
-    CacheLineAligned<std::atomic<size_t>> head_;
-    CacheLineAligned<std::atomic<size_t>> tail_;
+    // Head and tail pointers, each padded to Padding bytes to prevent false sharing
+    CacheAligned<std::atomic<size_t>, Padding> head_;
+    CacheAligned<std::atomic<size_t>, Padding> tail_;
     
     // Storage for elements
     std::array<T, Capacity> buffer_;
+
+    // Telemetry; takes no space with NoStats
+    NO_UNIQUE_ADDRESS Stats stats_;
 };
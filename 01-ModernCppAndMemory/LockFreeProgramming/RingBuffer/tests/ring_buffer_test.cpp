@@ -1,5 +1,10 @@
 #include "../include/ring_buffer.h"
+#include "alloc_guard.h"
+#include "numa.h"
 #include <gtest/gtest.h>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 #include <thread>
 #include <vector>
 #include <atomic>
@@ -307,6 +312,254 @@ TEST(RingBufferTest, MultiThreaded) {
         << "Buffer should be empty after processing all items";
 }
 
+// Test that the no-op stats policy adds no storage
+TEST(RingBufferTest, NoStatsHasNoOverhead) {
+    struct Plain {
+        CacheLineAligned<std::atomic<size_t>> head;
+        CacheLineAligned<std::atomic<size_t>> tail;
+        std::array<int, 64> buffer;
+    };
+    EXPECT_EQ(sizeof(RingBuffer<int, 64>), sizeof(Plain));
+
+    RingBuffer<int, 64> buffer;
+    buffer.try_enqueue(1);
+    EXPECT_EQ(buffer.stats().enqueues, 0u);
+}
+
+// Test that the padding width is set per instance and still behaves as a buffer
+TEST(RingBufferTest, PaddingWidth) {
+    using Wide = RingBuffer<int, 64, NoStats, DESTRUCTIVE_INTERFERENCE_SIZE>;
+    struct Plain {
+        CacheAligned<std::atomic<size_t>, 128> head;
+        CacheAligned<std::atomic<size_t>, 128> tail;
+        std::array<int, 64> buffer;
+    };
+    EXPECT_EQ((RingBuffer<int, 64>::padding), 64u);
+    EXPECT_EQ(Wide::padding, 128u);
+    EXPECT_EQ(alignof(Wide), 128u);
+    EXPECT_EQ(sizeof(Wide), sizeof(Plain));
+
+    Wide buffer;
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_TRUE(buffer.try_enqueue(i));
+    }
+    EXPECT_FALSE(buffer.try_enqueue(64));
+    int value = -1;
+    for (int i = 0; i < 64; ++i) {
+        ASSERT_TRUE(buffer.try_dequeue(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_TRUE(buffer.empty());
+}
+
+// Test the counting stats policy on a single thread
+TEST(RingBufferTest, CountingStats) {
+    RingBuffer<int, 4, CountingStats<>> buffer;
+    int value;
+
+    EXPECT_FALSE(buffer.try_dequeue(value));  // Empty poll
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(buffer.try_enqueue(i));
+    }
+    EXPECT_FALSE(buffer.try_enqueue(4));      // Full
+    EXPECT_TRUE(buffer.try_dequeue(value));
+    EXPECT_TRUE(buffer.try_dequeue().has_value());
+
+    QueueStatsSnapshot stats = buffer.stats();
+    EXPECT_EQ(stats.enqueues, 4u);
+    EXPECT_EQ(stats.dequeues, 2u);
+    EXPECT_EQ(stats.full_failures, 1u);
+    EXPECT_EQ(stats.empty_polls, 1u);
+    EXPECT_EQ(stats.high_water_mark, 4u);
+
+    buffer.reset_stats();
+    EXPECT_EQ(buffer.stats().enqueues, 0u);
+    EXPECT_EQ(buffer.stats().high_water_mark, 0u);
+}
+
+// Test that counts from several threads are aggregated without loss
+TEST(RingBufferTest, CountingStatsMultiThreaded) {
+    constexpr size_t NUM_ITEMS = 10000;
+    constexpr size_t NUM_CONSUMERS = 2;
+    RingBuffer<int, 64, CountingStats<>> buffer;
+    std::atomic<size_t> total_consumed(0);
+
+    std::thread producer([&]() {
+        for (size_t i = 0; i < NUM_ITEMS; ++i) {
+            while (!buffer.try_enqueue(static_cast<int>(i))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < NUM_CONSUMERS; ++c) {
+        consumers.emplace_back([&]() {
+            int value;
+            while (total_consumed.load(std::memory_order_relaxed) < NUM_ITEMS) {
+                if (buffer.try_dequeue(value)) {
+                    total_consumed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    producer.join();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    QueueStatsSnapshot stats = buffer.stats();
+    EXPECT_EQ(stats.enqueues, NUM_ITEMS);
+    EXPECT_EQ(stats.dequeues, NUM_ITEMS);
+    EXPECT_LE(stats.high_water_mark, buffer.capacity());
+}
+
+namespace {
+
+// Trivially copyable message, as carried on the hot path
+struct Quote {
+    uint64_t sequence;
+    int64_t price;
+    uint32_t quantity;
+};
+
+}  // namespace
+
+// Test that the guard itself sees allocations, so a zero count below means something
+TEST(RingBufferTest, AllocationGuardDetectsAllocations) {
+    NoAllocScope scope;
+    int* volatile pointer = new int(1);
+    delete pointer;
+    EXPECT_EQ(scope.allocations(), 1u);
+    EXPECT_EQ(scope.deallocations(), 1u);
+
+    if (alloc_guard_wraps_malloc()) {
+        void* volatile block = std::malloc(32);
+        std::free(block);
+        EXPECT_EQ(scope.allocations(), 2u);
+    }
+}
+
+// Test that enqueue and dequeue never touch the heap for trivially copyable T
+TEST(RingBufferTest, HotPathIsAllocationFree) {
+    auto queue = std::make_unique<RingBuffer<Quote, 64>>();
+    auto counted = std::make_unique<RingBuffer<Quote, 64, CountingStats<>>>();
+    Quote quote{};
+
+    NoAllocScope scope(AllocGuardMode::Abort);
+    for (uint64_t round = 0; round < 100; ++round) {
+        while (queue->try_enqueue(Quote{round, 100, 1})) {
+        }
+        EXPECT_TRUE(queue->full());
+        EXPECT_EQ(queue->size(), 64u);
+        while (queue->try_dequeue(quote)) {
+        }
+        EXPECT_FALSE(queue->try_dequeue().has_value());
+
+        EXPECT_TRUE(counted->try_enqueue(quote));
+        EXPECT_TRUE(counted->try_dequeue(quote));
+    }
+    EXPECT_EQ(counted->stats().enqueues, 100u);
+    EXPECT_EQ(scope.allocations(), 0u);
+}
+
+// Test the same under concurrency, with every producer and consumer thread guarded
+TEST(RingBufferTest, ConcurrentHotPathIsAllocationFree) {
+    constexpr size_t NUM_ITEMS = 20000;
+    auto queue = std::make_unique<RingBuffer<Quote, 256>>();
+    std::atomic<size_t> consumed(0);
+    std::atomic<uint64_t> allocations(0);
+
+    std::thread producer([&]() {
+        NoAllocScope scope(AllocGuardMode::Count);
+        for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+            while (!queue->try_enqueue(Quote{i, 100, 1})) {
+                std::this_thread::yield();
+            }
+        }
+        allocations.fetch_add(scope.allocations());
+    });
+    std::thread consumer([&]() {
+        NoAllocScope scope(AllocGuardMode::Count);
+        Quote quote;
+        while (consumed.load(std::memory_order_relaxed) < NUM_ITEMS) {
+            if (queue->try_dequeue(quote)) {
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        allocations.fetch_add(scope.allocations());
+    });
+    producer.join();
+    consumer.join();
+
+    EXPECT_EQ(consumed.load(), NUM_ITEMS);
+    EXPECT_EQ(allocations.load(), 0u);
+}
+
+// Test the NUMA queries; a kernel without NUMA support answers node 0 or "unknown"
+TEST(RingBufferTest, NumaQueries) {
+    const int nodes = numa_node_count();
+    ASSERT_GE(nodes, 1);
+    EXPECT_GE(numa_current_node(), 0);
+    EXPECT_LT(numa_current_node(), nodes);
+    EXPECT_GE(numa_node_of_cpu(0), 0);
+    EXPECT_LT(numa_node_of_cpu(0), nodes);
+
+    const int node = numa_current_node();
+    void* memory = numa_allocate(1 << 16, node);
+    ASSERT_NE(memory, nullptr);
+    const int resident = numa_node_of(memory);
+    if (resident != NUMA_NO_NODE) {
+        EXPECT_EQ(resident, node);
+    }
+    numa_deallocate(memory, 1 << 16);
+}
+
+// Test the fallback path: a node that does not exist leaves placement to first touch
+TEST(RingBufferTest, NumaFallback) {
+    const int missing = numa_node_count();
+    RingBuffer<int, 16> buffer;
+    EXPECT_FALSE(buffer.bind_to_node(missing));
+    EXPECT_FALSE(buffer.bind_to_node(NUMA_NO_NODE));
+    EXPECT_FALSE(numa_bind(nullptr, 64, 0));
+
+    auto* memory = static_cast<unsigned char*>(numa_allocate(1 << 16, missing, 4096));
+    ASSERT_NE(memory, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(memory) % 4096, 0u);
+    std::memset(memory, 7, 1 << 16);
+    EXPECT_EQ(memory[(1 << 16) - 1], 7);
+    numa_deallocate(memory, 1 << 16, 4096);
+
+    auto queue = numa_make_unique<RingBuffer<int, 1024>>(missing);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(queue.get()) % CACHE_LINE_SIZE, 0u);
+    EXPECT_TRUE(queue->try_enqueue(1));
+    EXPECT_EQ(queue->try_dequeue(), 1);
+}
+
+// Test that the consumer can pull a live buffer onto its node without disturbing its contents
+TEST(RingBufferTest, BindToConsumerNode) {
+    auto queue = numa_make_unique<RingBuffer<uint64_t, 4096>>(NUMA_NO_NODE);
+    for (uint64_t i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(queue->try_enqueue(i));
+    }
+    const bool numa_supported = numa_node_of(queue.get()) != NUMA_NO_NODE;
+
+    std::thread consumer([&]() {
+        EXPECT_EQ(queue->bind_to_node(), numa_supported);
+        if (numa_supported) {
+            EXPECT_EQ(numa_node_of(queue.get()), numa_current_node());
+        }
+        uint64_t value;
+        for (uint64_t i = 0; i < 1000; ++i) {
+            ASSERT_TRUE(queue->try_dequeue(value));
+            EXPECT_EQ(value, i);
+        }
+    });
+    consumer.join();
+    EXPECT_TRUE(queue->empty());
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,166 @@
+#include "../include/seqlock.h"
+#include "queue_benchmarks.h"
+#include "tsc_clock.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct TopOfBook {
+    uint64_t n = 0;
+    int64_t bid = 0;
+    int64_t ask = 0;
+    uint32_t bid_qty = 0;
+    uint32_t ask_qty = 0;
+    uint64_t exchange_tsc = 0;
+    uint64_t local_tsc = 0;
+};
+
+// The baseline: every reader takes the same mutex as the writer
+class MutexLock {
+public:
+    using value_type = TopOfBook;
+
+    explicit MutexLock(const TopOfBook& initial = TopOfBook{}) : value_(initial) {}
+
+    void store(const TopOfBook& value) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        value_ = value;
+    }
+
+    bool try_load(TopOfBook& out) const {
+        std::lock_guard<std::mutex> guard(mutex_);
+        out = value_;
+        return true;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    TopOfBook value_;
+};
+
+constexpr auto WINDOW = std::chrono::milliseconds(50);
+
+/**
+ * @brief Reader throughput with state.range(0) readers and a store every state.range(1) ns
+ *
+ * An interval of 0 means the writer stores back to back. Runs for a fixed
+ * window and reports loads per second per reader, the share of load
+ * attempts that had to be retried, and the stores made.
+ */
+template <typename Lock>
+static void BM_Readers(benchmark::State& state) {
+    const int reader_count = static_cast<int>(state.range(0));
+    const uint64_t interval = TscClock::shared().to_ticks(static_cast<double>(state.range(1)));
+    auto lock = std::make_unique<Lock>();
+
+    for (auto _ : state) {
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> loads{0};
+        std::atomic<uint64_t> retries{0};
+        std::atomic<uint64_t> stores{0};
+
+        std::thread writer([&]() {
+            queue_bench::pin_current_thread(0);
+            TopOfBook book;
+            uint64_t next = read_tsc();
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (interval != 0) {
+                    while (read_tsc() < next && !stop.load(std::memory_order_relaxed)) {
+                        cpu_pause();
+                    }
+                    next += interval;
+                }
+                ++book.n;
+                book.bid = static_cast<int64_t>(book.n);
+                book.ask = book.bid + 1;
+                lock->store(book);
+            }
+            stores.store(book.n, std::memory_order_relaxed);
+        });
+
+        std::vector<std::thread> readers;
+        for (int r = 0; r < reader_count; ++r) {
+            readers.emplace_back([&, r]() {
+                queue_bench::pin_current_thread(static_cast<unsigned>(r + 1));
+                uint64_t local_loads = 0;
+                uint64_t local_retries = 0;
+                int64_t spread = 0;
+                TopOfBook book;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    while (!lock->try_load(book)) {
+                        ++local_retries;
+                    }
+                    spread += book.ask - book.bid;
+                    ++local_loads;
+                }
+                benchmark::DoNotOptimize(spread);
+                loads.fetch_add(local_loads, std::memory_order_relaxed);
+                retries.fetch_add(local_retries, std::memory_order_relaxed);
+            });
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(WINDOW);
+        stop.store(true, std::memory_order_relaxed);
+        writer.join();
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        state.SetIterationTime(seconds);
+
+        const double attempts = static_cast<double>(loads.load() + retries.load());
+        state.counters["loads_per_reader_per_s"] =
+            static_cast<double>(loads.load()) / static_cast<double>(reader_count) / seconds;
+        state.counters["retry_share"] = attempts > 0 ? static_cast<double>(retries.load()) / attempts : 0.0;
+        state.counters["stores_per_s"] = static_cast<double>(stores.load()) / seconds;
+    }
+}
+
+// One uncontended load, the cost a reader pays when the writer is idle
+template <typename Lock>
+static void BM_Load(benchmark::State& state) {
+    auto lock = std::make_unique<Lock>();
+    TopOfBook book;
+    for (auto _ : state) {
+        lock->try_load(book);
+        benchmark::DoNotOptimize(book);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// One uncontended store
+template <typename Lock>
+static void BM_Store(benchmark::State& state) {
+    auto lock = std::make_unique<Lock>();
+    TopOfBook book;
+    for (auto _ : state) {
+        ++book.n;
+        lock->store(book);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Lock>
+static void register_lock(const std::string& name) {
+    for (int64_t interval : {0, 100, 10000}) {
+        for (int64_t readers : {1, 2, 4}) {
+            benchmark::RegisterBenchmark(("BM_Readers/" + name).c_str(), BM_Readers<Lock>)
+                ->Args({readers, interval})->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond);
+        }
+    }
+    benchmark::RegisterBenchmark(("BM_Load/" + name).c_str(), BM_Load<Lock>);
+    benchmark::RegisterBenchmark(("BM_Store/" + name).c_str(), BM_Store<Lock>);
+}
+
+int main(int argc, char** argv) {
+    register_lock<SeqLock<TopOfBook>>("SeqLock");
+    register_lock<MultiSlotSeqLock<TopOfBook, 4>>("MultiSlotSeqLock");
+    register_lock<MutexLock>("Mutex");
+    return queue_bench::run_benchmarks(argc, argv);
+}
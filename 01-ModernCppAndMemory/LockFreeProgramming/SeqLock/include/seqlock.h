@@ -0,0 +1,285 @@
+/**
+ * @file seqlock.h
+ * @brief Sequence locks: one writer, any number of readers, no waiting on either side
+ *
+ * Top of book, positions and strategy parameters are written by one thread
+ * and read by many. A mutex makes every reader write the lock's cache line;
+ * a queue delivers every update when readers only want the latest. A seqlock
+ * keeps one copy and a sequence counter. The writer makes the counter odd,
+ * writes, and makes it even again. A reader copies the value between two
+ * reads of the counter and keeps the copy only if the counter was even and
+ * unchanged. Readers write nothing, so they do not slow each other or the writer.
+ *
+ * The payload is a SeqLockPayload (seqlock_payload.h): 64-bit atomics
+ * copied with relaxed loads and stores, so the racy copy is well defined and
+ * the fences can order it against the counter. The same layout works in a
+ * shared-memory mapping.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "concurrency_primitives.h"
+#include "seqlock_payload.h"
+
+/**
+ * @brief Single-writer, multi-reader snapshot of a T
+ *
+ * A reader retries while the writer is in the middle of a store, so under
+ * constant writes a reader can retry many times; see MultiSlotSeqLock.
+ *
+ * @tparam T The value type (must be trivially copyable)
+ */
+template <typename T>
+class SeqLock {
+public:
+    using value_type = T;
+
+    explicit SeqLock(const T& initial = T{}) noexcept {
+        sequence_.data.store(0, std::memory_order_relaxed);
+        payload_.store(initial);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * @brief Replaces the value; one writer only
+     */
+    void store(const T& value) noexcept {
+        const uint64_t sequence = sequence_.data.load(std::memory_order_relaxed);
+        sequence_.data.store(sequence + 1, std::memory_order_relaxed);
+        // The odd count must be visible before any word of the new value
+        std::atomic_thread_fence(std::memory_order_release);
+        payload_.store(value);
+        sequence_.data.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief One attempt at a consistent copy
+     *
+     * @return false if the writer was storing meanwhile; out is then unspecified
+     */
+    bool try_load(T& out) const noexcept {
+        const uint64_t before = sequence_.data.load(std::memory_order_acquire);
+        if ((before & 1) != 0) {
+            return false;
+        }
+        payload_.load(out);
+        // Keep the copy above the second read of the count
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return sequence_.data.load(std::memory_order_relaxed) == before;
+    }
+
+    /**
+     * @brief A consistent copy, retrying until the writer leaves it alone
+     */
+    T load() const noexcept {
+        T out;
+        while (!try_load(out)) {
+            cpu_pause();
+        }
+        return out;
+    }
+
+    /**
+     * @brief Stores completed so far
+     */
+    uint64_t version() const noexcept {
+        return sequence_.data.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    CacheLineAligned<std::atomic<uint64_t>> sequence_;
+    SeqLockPayload<T> payload_;
+};
+
+/**
+ * @brief A seqlock over Slots copies, so readers are not turned away by the writer
+ *
+ * The writer fills the slots in turn and then publishes which one is newest.
+ * A reader copies the newest slot while the writer is busy with the next
+ * one, so it only retries if the writer completes Slots - 1 further stores
+ * and starts on the same slot during a single copy.
+ *
+ * @tparam T The value type (must be trivially copyable)
+ * @tparam Slots Copies kept (at least 2)
+ */
+template <typename T, size_t Slots = 4>
+class MultiSlotSeqLock {
+    static_assert(Slots >= 2, "MultiSlotSeqLock needs at least two slots");
+
+public:
+    using value_type = T;
+
+    explicit MultiSlotSeqLock(const T& initial = T{}) noexcept {
+        for (auto& slot : slots_) {
+            slot.version.store(0, std::memory_order_relaxed);
+        }
+        stores_.data.store(0, std::memory_order_relaxed);
+        store(initial);
+    }
+
+    MultiSlotSeqLock(const MultiSlotSeqLock&) = delete;
+    MultiSlotSeqLock& operator=(const MultiSlotSeqLock&) = delete;
+
+    /**
+     * @brief Replaces the value; one writer only
+     */
+    void store(const T& value) noexcept {
+        const uint64_t index = stores_.data.load(std::memory_order_relaxed);
+        Slot& slot = slots_[index % Slots];
+        slot.version.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.payload.store(value);
+        slot.version.store(2 * index + 2, std::memory_order_release);
+        stores_.data.store(index + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief One attempt at a copy of the newest value
+     *
+     * @return false if the writer lapped the slots during the copy
+     */
+    bool try_load(T& out) const noexcept {
+        const uint64_t index = stores_.data.load(std::memory_order_acquire) - 1;
+        const Slot& slot = slots_[index % Slots];
+        const uint64_t expected = 2 * index + 2;
+        if (slot.version.load(std::memory_order_acquire) != expected) {
+            return false;
+        }
+        slot.payload.load(out);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.version.load(std::memory_order_relaxed) == expected;
+    }
+
+    T load() const noexcept {
+        T out;
+        while (!try_load(out)) {
+            cpu_pause();
+        }
+        return out;
+    }
+
+    /**
+     * @brief Stores completed so far, counting the initial value
+     */
+    uint64_t version() const noexcept {
+        return stores_.data.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t slots() noexcept {
+        return Slots;
+    }
+
+private:
+    // Each slot on its own lines, so the writer filling one does not disturb readers of another
+    struct alignas(CACHE_LINE_SIZE) Slot {
+        // 2 * n + 1 while the writer fills it with store n, 2 * n + 2 once done
+        std::atomic<uint64_t> version;
+        SeqLockPayload<T> payload;
+    };
+
+    CacheLineAligned<std::atomic<uint64_t>> stores_;
+    std::array<Slot, Slots> slots_;
+};
+
+/**
+ * @brief A seqlock in a block that other processes can map
+ *
+ * The layout is fixed and holds only lock-free atomics, which are
+ * address-free, so the writer and readers may be in different processes.
+ * The writer publishes the block once it has stored the first value;
+ * readers wait for ready().
+ *
+ * @tparam Lock SeqLock<T> or MultiSlotSeqLock<T, Slots>
+ */
+template <typename Lock>
+struct SharedSeqLock {
+    static constexpr uint64_t MAGIC = 0x5345514c4f434b31ull;  // "SEQLOCK1"
+
+    std::atomic<uint64_t> magic{0};
+    // sizeof(value_type), so a reader built against a different T refuses the block
+    uint64_t value_size = 0;
+    Lock lock;
+
+    void publish() noexcept {
+        value_size = sizeof(typename Lock::value_type);
+        magic.store(MAGIC, std::memory_order_release);
+    }
+
+    bool ready() const noexcept {
+        return magic.load(std::memory_order_acquire) == MAGIC &&
+               value_size == sizeof(typename Lock::value_type);
+    }
+};
+
+#ifndef _WIN32
+
+/**
+ * @brief Maps a named POSIX shared-memory block holding a SharedSeqLock
+ *
+ * The writer's process passes create = true, which sizes and resets the
+ * block; it must then call publish(). Readers pass create = false and wait
+ * for ready() before loading.
+ *
+ * @param name Shared memory name, starting with '/'
+ * @return nullptr on failure, or if the block is smaller than a SharedSeqLock<Lock>
+ */
+template <typename Lock>
+SharedSeqLock<Lock>* open_shared_seqlock(const std::string& name, bool create) {
+    int flags = create ? (O_CREAT | O_RDWR) : O_RDWR;
+    int fd = shm_open(name.c_str(), flags, 0600);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (create && ftruncate(fd, sizeof(SharedSeqLock<Lock>)) != 0) {
+        close(fd);
+        return nullptr;
+    }
+    // A block the creator has not sized yet, or one left by a build with a smaller
+    // layout, would fault (SIGBUS) on first access past its end
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SharedSeqLock<Lock>)) {
+        close(fd);
+        return nullptr;
+    }
+    void* memory = mmap(nullptr, sizeof(SharedSeqLock<Lock>), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+    if (create) {
+        // Construct over the mapping, which also clears anything left by an earlier run
+        return new (memory) SharedSeqLock<Lock>();
+    }
+    return static_cast<SharedSeqLock<Lock>*>(memory);
+}
+
+/**
+ * @brief Unmaps a block returned by open_shared_seqlock(), optionally removing the name
+ */
+template <typename Lock>
+void close_shared_seqlock(SharedSeqLock<Lock>* block, const std::string& name, bool unlink_name) {
+    if (block != nullptr) {
+        munmap(block, sizeof(SharedSeqLock<Lock>));
+    }
+    if (unlink_name) {
+        shm_unlink(name.c_str());
+    }
+}
+
+#endif
@@ -0,0 +1,105 @@
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../include/seqlock.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+struct TopOfBook {
+    uint64_t update = 0;
+    int64_t bid = 0;
+    int64_t ask = 0;
+    uint32_t bid_qty = 0;
+    uint32_t ask_qty = 0;
+};
+
+static TopOfBook make_book(uint64_t update) {
+    const int64_t mid = 10000 + static_cast<int64_t>(update % 50);
+    return TopOfBook{update, mid - 1, mid + 1, static_cast<uint32_t>(100 + update % 7),
+                     static_cast<uint32_t>(200 + update % 11)};
+}
+
+template <typename Lock>
+static void run(const char* name) {
+    auto lock = std::make_unique<Lock>(make_book(0));
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> snapshots{0};
+    std::atomic<uint64_t> retries{0};
+    std::atomic<uint64_t> crossed{0};
+
+    // Strategy threads snapshot the book whenever they like; they never see a half-written one
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t local_snapshots = 0;
+            uint64_t local_retries = 0;
+            TopOfBook book;
+            while (!done.load(std::memory_order_acquire)) {
+                if (!lock->try_load(book)) {
+                    ++local_retries;
+                    continue;
+                }
+                crossed.fetch_add(book.bid >= book.ask ? 1 : 0, std::memory_order_relaxed);
+                ++local_snapshots;
+            }
+            snapshots.fetch_add(local_snapshots, std::memory_order_relaxed);
+            retries.fetch_add(local_retries, std::memory_order_relaxed);
+        });
+    }
+
+    // The market data thread updates the book as fast as it can
+    for (uint64_t update = 1; update <= 1000000; ++update) {
+        lock->store(make_book(update));
+        if (update % 4096 == 0) {
+            std::this_thread::yield();  // Give the readers a turn on a small machine
+        }
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    const TopOfBook last = lock->load();
+    std::cout << name << ": " << lock->version() << " versions, last update " << last.update << " ("
+              << last.bid << " / " << last.ask << ")\n";
+    std::cout << "  " << snapshots.load() << " snapshots, " << retries.load() << " retries, " << crossed.load()
+              << " torn\n";
+}
+
+int main() {
+    std::cout << "SeqLock Demo\n";
+    std::cout << "============\n\n";
+
+    run<SeqLock<TopOfBook>>("SeqLock");
+    run<MultiSlotSeqLock<TopOfBook, 4>>("MultiSlotSeqLock<4>");
+
+#ifndef _WIN32
+    // The same lock in shared memory, as a separate process would map it
+    using Shared = SharedSeqLock<MultiSlotSeqLock<TopOfBook, 4>>;
+    const std::string name = "/seqlock_demo_" + std::to_string(::getpid());
+    Shared* writer = open_shared_seqlock<MultiSlotSeqLock<TopOfBook, 4>>(name, true);
+    Shared* reader = open_shared_seqlock<MultiSlotSeqLock<TopOfBook, 4>>(name, false);
+    if (writer == nullptr || reader == nullptr) {
+        std::cout << "\nShared memory unavailable\n";
+        close_shared_seqlock(reader, name, false);
+        close_shared_seqlock(writer, name, true);
+        return 0;
+    }
+    writer->lock.store(make_book(7));
+    writer->publish();
+    if (reader->ready()) {
+        const TopOfBook book = reader->lock.load();
+        std::cout << "\nShared mapping " << name << ": update " << book.update << " (" << book.bid << " / "
+                  << book.ask << ")\n";
+    }
+    close_shared_seqlock(reader, name, false);
+    close_shared_seqlock(writer, name, true);
+#endif
+    return 0;
+}
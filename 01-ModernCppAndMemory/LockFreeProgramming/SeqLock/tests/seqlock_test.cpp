@@ -0,0 +1,171 @@
+#include "../include/seqlock.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// Every field derives from n, so a reader can tell a torn copy from a whole one
+struct TopOfBook {
+    uint64_t n = 0;
+    int64_t bid = 0;
+    int64_t ask = 1;
+    uint32_t bid_qty = 0;
+    uint32_t ask_qty = 0;
+    uint64_t check = ~uint64_t{0};
+};
+
+static TopOfBook make_book(uint64_t n) {
+    const int64_t price = static_cast<int64_t>(n);
+    return TopOfBook{n, price, price + 1, static_cast<uint32_t>(n * 3), static_cast<uint32_t>(n * 5), ~n};
+}
+
+static bool whole(const TopOfBook& book) {
+    const int64_t price = static_cast<int64_t>(book.n);
+    return book.bid == price && book.ask == price + 1 && book.bid_qty == static_cast<uint32_t>(book.n * 3) &&
+           book.ask_qty == static_cast<uint32_t>(book.n * 5) && book.check == ~book.n;
+}
+
+// Test that a payload whose size is not a multiple of 8 survives the word-wise copy
+TEST(SeqLockTest, OddSizedPayload) {
+    struct Params {
+        char name[13];
+        uint16_t level;
+    };
+    SeqLockPayload<Params> payload;
+    EXPECT_EQ(SeqLockPayload<Params>::WORDS, 2u);
+    payload.store(Params{"momentum-fx", 7});
+    Params out{};
+    payload.load(out);
+    EXPECT_STREQ(out.name, "momentum-fx");
+    EXPECT_EQ(out.level, 7);
+}
+
+// Test that loads return the initial value, then each stored value, with the version counting stores
+TEST(SeqLockTest, StoreAndLoad) {
+    SeqLock<TopOfBook> lock(make_book(1));
+    EXPECT_EQ(lock.load().n, 1u);
+    EXPECT_EQ(lock.version(), 0u);
+
+    lock.store(make_book(2));
+    lock.store(make_book(3));
+    TopOfBook book;
+    ASSERT_TRUE(lock.try_load(book));
+    EXPECT_EQ(book.n, 3u);
+    EXPECT_TRUE(whole(book));
+    EXPECT_EQ(lock.version(), 2u);
+}
+
+// Test that the multi-slot variant always returns the newest store, across several laps of its slots
+TEST(SeqLockTest, MultiSlotReturnsNewest) {
+    MultiSlotSeqLock<TopOfBook, 3> lock(make_book(0));
+    EXPECT_EQ(lock.load().n, 0u);
+    EXPECT_EQ(lock.version(), 1u);
+    for (uint64_t n = 1; n <= 10; ++n) {
+        lock.store(make_book(n));
+        TopOfBook book;
+        ASSERT_TRUE(lock.try_load(book));
+        EXPECT_EQ(book.n, n);
+    }
+    EXPECT_EQ(lock.version(), 11u);
+}
+
+// Test that readers see whole values, in non-decreasing order, while the writer stores constantly
+template <typename Lock>
+static void check_concurrent_readers() {
+    constexpr uint64_t STORES = 300000;
+    Lock lock(make_book(0));
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> backwards{0};
+    std::atomic<uint64_t> loads{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            uint64_t last = 0;
+            uint64_t count = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                const TopOfBook book = lock.load();
+                torn.fetch_add(whole(book) ? 0 : 1, std::memory_order_relaxed);
+                backwards.fetch_add(book.n < last ? 1 : 0, std::memory_order_relaxed);
+                last = book.n;
+                ++count;
+            }
+            loads.fetch_add(count, std::memory_order_relaxed);
+        });
+    }
+    for (uint64_t n = 1; n <= STORES; ++n) {
+        lock.store(make_book(n));
+        if (n % 4096 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    done.store(true, std::memory_order_relaxed);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(backwards.load(), 0u);
+    EXPECT_GT(loads.load(), 0u);
+    EXPECT_EQ(lock.load().n, STORES);
+}
+
+TEST(SeqLockTest, ConcurrentReaders) {
+    check_concurrent_readers<SeqLock<TopOfBook>>();
+}
+
+TEST(SeqLockTest, MultiSlotConcurrentReaders) {
+    check_concurrent_readers<MultiSlotSeqLock<TopOfBook, 4>>();
+}
+
+#ifndef _WIN32
+// Test that a second mapping of the shared block sees the writer's stores
+TEST(SeqLockTest, SharedMemoryReader) {
+    using Lock = MultiSlotSeqLock<TopOfBook, 4>;
+    const std::string name = "/seqlock_test_" + std::to_string(::getpid());
+    SharedSeqLock<Lock>* writer = open_shared_seqlock<Lock>(name, true);
+    ASSERT_NE(writer, nullptr);
+    SharedSeqLock<Lock>* reader = open_shared_seqlock<Lock>(name, false);
+    ASSERT_NE(reader, nullptr);
+    EXPECT_NE(static_cast<void*>(reader), static_cast<void*>(writer));
+    EXPECT_FALSE(reader->ready());
+
+    writer->lock.store(make_book(41));
+    writer->publish();
+    writer->lock.store(make_book(42));
+    ASSERT_TRUE(reader->ready());
+    const TopOfBook book = reader->lock.load();
+    EXPECT_EQ(book.n, 42u);
+    EXPECT_TRUE(whole(book));
+
+    close_shared_seqlock(reader, name, false);
+    close_shared_seqlock(writer, name, true);
+}
+
+// Test that a block not yet sized, or sized for a smaller layout, is refused rather than mapped
+TEST(SeqLockTest, SharedMemoryRejectsShortBlock) {
+    using Lock = MultiSlotSeqLock<TopOfBook, 4>;
+    const std::string name = "/seqlock_short_" + std::to_string(::getpid());
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0600);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(open_shared_seqlock<Lock>(name, false), nullptr);
+
+    ASSERT_EQ(ftruncate(fd, sizeof(SharedSeqLock<Lock>) / 2), 0);
+    EXPECT_EQ(open_shared_seqlock<Lock>(name, false), nullptr);
+    close(fd);
+    shm_unlink(name.c_str());
+}
+#endif
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
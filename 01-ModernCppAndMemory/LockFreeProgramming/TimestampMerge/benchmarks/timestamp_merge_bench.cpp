@@ -0,0 +1,145 @@
+#include "../include/timestamp_merger.h"
+#include "queue_benchmarks.h"
+#include "ring_buffer.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+struct Event {
+    uint64_t timestamp = 0;
+    uint64_t payload = 0;
+};
+
+constexpr size_t RING_CAPACITY = 256;
+using EventRing = RingBuffer<Event, RING_CAPACITY>;
+
+/**
+ * @brief K full input rings, refilled between timed passes
+ *
+ * Input i carries timestamps base + j * K + i, so every pass is a perfect
+ * interleave and the merger switches inputs on every event, the worst case
+ * for the tree. `active` inputs get data; the rest stay empty.
+ */
+template <size_t K>
+struct MergeInputs {
+    std::vector<EventRing> rings;
+    std::array<EventRing*, K> pointers{};
+    uint64_t base = 0;
+
+    MergeInputs() : rings(K) {
+        for (size_t i = 0; i < K; ++i) {
+            pointers[i] = &rings[i];
+        }
+    }
+
+    size_t refill(size_t active) {
+        for (uint64_t j = 0; j < RING_CAPACITY; ++j) {
+            for (size_t i = 0; i < active; ++i) {
+                rings[i].try_enqueue(Event{base + j * K + i, j});
+            }
+        }
+        base += RING_CAPACITY * K;
+        return RING_CAPACITY * active;
+    }
+};
+
+// Ordered merge of K interleaved inputs; the cost per event grows with log2(K)
+template <size_t K>
+static void BM_Merge(benchmark::State& state) {
+    auto inputs = std::make_unique<MergeInputs<K>>();
+    // Nothing is late here; a zero window only saves polling the drained inputs at the end of a pass
+    TimestampMerger<EventRing, K> merger(inputs->pointers, 0);
+    uint64_t total = 0;
+    for (auto _ : state) {
+        const size_t events = inputs->refill(K);
+        Event event;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < events;) {
+            if (merger.try_dequeue(event, 0)) {
+                benchmark::DoNotOptimize(event);
+                ++n;
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+        total += events;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(total));
+    state.counters["time_per_event"] = benchmark::Counter(static_cast<double>(total),
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert, benchmark::Counter::kIs1000);
+    state.counters["late"] = static_cast<double>(merger.late_dropped());
+    state.SetLabel("K=" + std::to_string(K));
+}
+
+// The same inputs taken round-robin with no ordering: the floor the merge is measured against
+template <size_t K>
+static void BM_RoundRobin(benchmark::State& state) {
+    auto inputs = std::make_unique<MergeInputs<K>>();
+    uint64_t total = 0;
+    for (auto _ : state) {
+        const size_t events = inputs->refill(K);
+        Event event;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t n = 0, i = 0; n < events; i = (i + 1) % K) {
+            if (inputs->rings[i].try_dequeue(event)) {
+                benchmark::DoNotOptimize(event);
+                ++n;
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+        total += events;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(total));
+    state.counters["time_per_event"] = benchmark::Counter(static_cast<double>(total),
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert, benchmark::Counter::kIs1000);
+    state.SetLabel("K=" + std::to_string(K));
+}
+
+// Half the inputs are open but idle and past a zero window: each one costs a ring poll per event
+template <size_t K>
+static void BM_MergeIdleInputs(benchmark::State& state) {
+    auto inputs = std::make_unique<MergeInputs<K>>();
+    TimestampMerger<EventRing, K> merger(inputs->pointers, 0);
+    uint64_t total = 0;
+    for (auto _ : state) {
+        const size_t events = inputs->refill(K / 2);
+        Event event;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < events;) {
+            if (merger.try_dequeue(event, 0)) {
+                benchmark::DoNotOptimize(event);
+                ++n;
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+        total += events;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(total));
+    state.counters["time_per_event"] = benchmark::Counter(static_cast<double>(total),
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert, benchmark::Counter::kIs1000);
+    state.SetLabel("K=" + std::to_string(K) + ", " + std::to_string(K / 2) + " idle");
+}
+
+#define MERGE_RUN ->UseManualTime()
+
+BENCHMARK_TEMPLATE(BM_RoundRobin, 2) MERGE_RUN;
+BENCHMARK_TEMPLATE(BM_RoundRobin, 8) MERGE_RUN;
+BENCHMARK_TEMPLATE(BM_RoundRobin, 64) MERGE_RUN;
+
+BENCHMARK_TEMPLATE(BM_Merge, 2) MERGE_RUN;
+BENCHMARK_TEMPLATE(BM_Merge, 4) MERGE_RUN;
+BENCHMARK_TEMPLATE(BM_Merge, 8) MERGE_RUN;
+BENCHMARK_TEMPLATE(BM_Merge, 16) MERGE_RUN;
+BENCHMARK_TEMPLATE(BM_Merge, 32) MERGE_RUN;
+BENCHMARK_TEMPLATE(BM_Merge, 64) MERGE_RUN;
+
+BENCHMARK_TEMPLATE(BM_MergeIdleInputs, 4) MERGE_RUN;
+BENCHMARK_TEMPLATE(BM_MergeIdleInputs, 16) MERGE_RUN;
+BENCHMARK_TEMPLATE(BM_MergeIdleInputs, 64) MERGE_RUN;
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
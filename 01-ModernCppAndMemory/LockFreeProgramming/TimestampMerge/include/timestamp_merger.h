@@ -0,0 +1,283 @@
+/**
+ * @file timestamp_merger.h
+ * @brief Timestamp-ordered k-way merge across several SPSC RingBuffer inputs
+ *
+ * Each feed writes into its own RingBuffer in timestamp order. The merger
+ * holds the oldest item of every input and picks the smallest with a
+ * tournament tree, so choosing the next event costs log2(K) comparisons
+ * instead of a scan over all K heads.
+ *
+ * An event can only be emitted once every input has something older or
+ * equal, or could never produce an older one. An input that is empty holds
+ * the merge back, but only for the lateness window. After that the merge goes
+ * on without it, and anything it sends later that is older than the last
+ * emitted event is dropped and counted as late.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "concurrency_primitives.h"
+#include "tsc_clock.h"
+
+/**
+ * @brief Reads the timestamp from a `timestamp` member
+ *
+ * The default key for TimestampMerger; pass another functor for messages that
+ * carry their timestamp under a different name.
+ */
+struct TimestampMember {
+    template <typename T>
+    uint64_t operator()(const T& value) const noexcept {
+        return value.timestamp;
+    }
+};
+
+/**
+ * @brief Merges K SPSC inputs into one stream in non-decreasing timestamp order
+ *
+ * The rings belong to the caller: each producer pushes to its ring as usual,
+ * and calls close_input() once it will push nothing more. One thread at a
+ * time may call try_dequeue().
+ *
+ * Every input must be in non-decreasing timestamp order on its own, and
+ * UINT64_MAX is reserved. Equal timestamps from different inputs come out
+ * lowest input first.
+ *
+ * @tparam Ring The input queue type, a RingBuffer instantiation
+ * @tparam K Number of inputs (at most 64, one bit each)
+ * @tparam TimestampOf Functor returning an item's uint64_t timestamp
+ */
+template <typename Ring, size_t K, typename TimestampOf = TimestampMember>
+class TimestampMerger {
+    static_assert(K > 0 && K <= 64, "K must be between 1 and 64");
+
+public:
+    using value_type = typename Ring::value_type;
+    using T = value_type;
+
+    // Lateness that never gives up on an empty input
+    static constexpr uint64_t WAIT_FOREVER = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * @param inputs The K rings to merge; they must outlive the merger
+     * @param lateness_ticks How long an empty input may hold the merge back, in
+     *        TSC ticks (TscClock::to_ticks() converts from nanoseconds)
+     */
+    explicit TimestampMerger(const std::array<Ring*, K>& inputs, uint64_t lateness_ticks = WAIT_FOREVER) noexcept
+        : inputs_(inputs), lateness_(lateness_ticks) {
+        closed_.data.store(0, std::memory_order_relaxed);
+        keys_.fill(EMPTY_KEY);
+        for (size_t node = LEAVES - 1; node > 0; --node) {
+            winners_[node] = match(winner_of(2 * node), winner_of(2 * node + 1));
+        }
+    }
+
+    TimestampMerger(const TimestampMerger&) = delete;
+    TimestampMerger& operator=(const TimestampMerger&) = delete;
+
+    /**
+     * @brief Tells the merger an input will push nothing more; called by that input's producer
+     *
+     * Items already pushed are still delivered. Once a closed input is
+     * drained, it no longer holds back the others.
+     */
+    void close_input(size_t input) noexcept {
+        closed_.data.fetch_or(uint64_t{1} << input, std::memory_order_release);
+    }
+
+    /**
+     * @brief Takes the oldest event across all inputs
+     *
+     * Tries to refill every empty input, then emits the winner of the tree
+     * unless an open input is still empty and inside its lateness window.
+     * Each empty input costs one poll of its ring per call.
+     *
+     * @param now The current TSC value; pass it in to reuse a read the caller already made
+     * @return false if nothing can be emitted yet
+     */
+    bool try_dequeue(T& result, uint64_t now = read_tsc()) noexcept {
+        // Load before refilling: a producer's last push happens before its close
+        const uint64_t closed = closed_.data.load(std::memory_order_acquire);
+        uint64_t empty = empty_;
+        while (empty != 0) {
+            const size_t input = static_cast<size_t>(std::countr_zero(empty));
+            empty &= empty - 1;
+            refill(input);
+        }
+
+        const size_t winner = winners_[1];
+        if (keys_[winner] == EMPTY_KEY) {
+            return false;
+        }
+        // The lateness clock of an input starts the first time it holds an event back
+        uint64_t waiting = empty_ & ~closed;
+        bool hold = false;
+        while (waiting != 0) {
+            const size_t input = static_cast<size_t>(std::countr_zero(waiting));
+            const uint64_t bit = uint64_t{1} << input;
+            waiting &= waiting - 1;
+            if ((timed_ & bit) == 0) {
+                timed_ |= bit;
+                empty_since_[input] = now;
+            }
+            hold = hold || now - empty_since_[input] < lateness_;
+        }
+        if (hold) {
+            ++stalls_;
+            return false;
+        }
+
+        result = std::move(heads_[winner]);
+        last_emitted_ = keys_[winner];
+        ++emitted_;
+        refill(winner);
+        return true;
+    }
+
+    /**
+     * @brief Whether every input is closed and fully delivered
+     */
+    bool finished() const noexcept {
+        if ((closed_.data.load(std::memory_order_acquire) & ALL_INPUTS) != ALL_INPUTS || empty_ != ALL_INPUTS) {
+            return false;
+        }
+        for (const Ring* ring : inputs_) {
+            if (!ring->empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Changes the lateness window; consumer thread only
+     */
+    void set_lateness(uint64_t lateness_ticks) noexcept {
+        lateness_ = lateness_ticks;
+    }
+
+    uint64_t lateness() const noexcept {
+        return lateness_;
+    }
+
+    /**
+     * @brief Timestamp of the last event emitted; later events are never older
+     */
+    uint64_t watermark() const noexcept {
+        return last_emitted_;
+    }
+
+    /**
+     * @brief Inputs with no item waiting in the merger, one bit per input
+     */
+    uint64_t empty_mask() const noexcept {
+        return empty_;
+    }
+
+    // Counters, read on the consumer thread
+    uint64_t emitted() const noexcept {
+        return emitted_;
+    }
+
+    // Items dropped because they arrived older than the watermark
+    uint64_t late_dropped() const noexcept {
+        return late_;
+    }
+
+    // try_dequeue() calls that had an event but waited for an empty input
+    uint64_t stalls() const noexcept {
+        return stalls_;
+    }
+
+    static constexpr size_t inputs() noexcept {
+        return K;
+    }
+
+private:
+    // Leaves of the tree, padded to a power of two; padding leaves stay empty
+    static constexpr size_t LEAVES = std::bit_ceil(K) < 2 ? 2 : std::bit_ceil(K);
+    static constexpr uint64_t EMPTY_KEY = std::numeric_limits<uint64_t>::max();
+    static constexpr uint64_t ALL_INPUTS = K == 64 ? ~uint64_t{0} : (uint64_t{1} << K) - 1;
+
+    /**
+     * @brief Pulls the next item of an input into its head, dropping items older than the watermark
+     */
+    void refill(size_t input) noexcept {
+        const uint64_t bit = uint64_t{1} << input;
+        while (inputs_[input]->try_dequeue(heads_[input])) {
+            const uint64_t key = timestamp_of_(heads_[input]);
+            if (key < last_emitted_) {
+                ++late_;
+                continue;
+            }
+            keys_[input] = key;
+            empty_ &= ~bit;
+            timed_ &= ~bit;
+            replay(input);
+            return;
+        }
+        if (keys_[input] != EMPTY_KEY) {
+            // Its head was just emitted and nothing followed it
+            keys_[input] = EMPTY_KEY;
+            empty_ |= bit;
+            replay(input);
+        }
+    }
+
+    /**
+     * @brief Replays the matches from a leaf up to the root after its key changed
+     *
+     * A winner tree rather than a loser tree, so that any leaf can change, not
+     * only the last winner: an empty input refilling while another wins is
+     * the common case here.
+     */
+    void replay(size_t leaf) noexcept {
+        size_t winner = leaf;
+        for (size_t node = LEAVES + leaf; node > 1; node >>= 1) {
+            winner = match(winner, winner_of(node ^ 1));
+            winners_[node >> 1] = winner;
+        }
+    }
+
+    // Lower key wins; equal keys go to the lower input
+    size_t match(size_t a, size_t b) const noexcept {
+        return keys_[b] < keys_[a] || (keys_[b] == keys_[a] && b < a) ? b : a;
+    }
+
+    size_t winner_of(size_t node) const noexcept {
+        return node >= LEAVES ? node - LEAVES : winners_[node];
+    }
+
+    std::array<Ring*, K> inputs_;
+    uint64_t lateness_;
+
+    // The oldest item of each input, and its timestamp (EMPTY_KEY when there is none)
+    std::array<T, K> heads_{};
+    std::array<uint64_t, LEAVES> keys_{};
+
+    // winners_[1] is the overall winner; node n has children 2n and 2n+1, leaves are LEAVES + input
+    std::array<size_t, LEAVES> winners_{};
+
+    // Inputs with no head; those whose lateness clock is running, and when it started
+    uint64_t empty_ = ALL_INPUTS;
+    uint64_t timed_ = 0;
+    std::array<uint64_t, K> empty_since_{};
+
+    uint64_t last_emitted_ = 0;
+    uint64_t emitted_ = 0;
+    uint64_t late_ = 0;
+    uint64_t stalls_ = 0;
+
+    NO_UNIQUE_ADDRESS TimestampOf timestamp_of_;
+
+    // Written by producers, once each
+    CacheLineAligned<std::atomic<uint64_t>> closed_;
+};
@@ -0,0 +1,186 @@
+#include "../include/timestamp_merger.h"
+#include "ring_buffer.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+struct Event {
+    uint64_t timestamp = 0;
+    uint32_t source = 0;
+};
+
+using EventRing = RingBuffer<Event, 16>;
+using Merger3 = TimestampMerger<EventRing, 3>;
+
+// Pops every event the merger will give at the given time
+template <typename Merger>
+static std::vector<uint64_t> take_all(Merger& merger, uint64_t now) {
+    std::vector<uint64_t> stamps;
+    Event event;
+    while (merger.try_dequeue(event, now)) {
+        stamps.push_back(event.timestamp);
+    }
+    return stamps;
+}
+
+// Test that closed inputs merge into one non-decreasing stream
+TEST(TimestampMergerTest, MergesInTimestampOrder) {
+    EventRing a, b, c;
+    Merger3 merger({&a, &b, &c});
+    for (uint64_t ts : {1, 4, 7, 10}) a.try_enqueue(Event{ts, 0});
+    for (uint64_t ts : {2, 3, 8}) b.try_enqueue(Event{ts, 1});
+    for (uint64_t ts : {5, 6, 9, 11}) c.try_enqueue(Event{ts, 2});
+    for (size_t i = 0; i < 3; ++i) merger.close_input(i);
+
+    EXPECT_EQ(take_all(merger, 0), (std::vector<uint64_t>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}));
+    EXPECT_EQ(merger.emitted(), 11u);
+    EXPECT_EQ(merger.watermark(), 11u);
+    EXPECT_TRUE(merger.finished());
+}
+
+// Test that equal timestamps come out lowest input first
+TEST(TimestampMergerTest, TiesGoToLowerInput) {
+    EventRing a, b, c;
+    Merger3 merger({&a, &b, &c});
+    c.try_enqueue(Event{5, 2});
+    a.try_enqueue(Event{5, 0});
+    b.try_enqueue(Event{5, 1});
+    for (size_t i = 0; i < 3; ++i) merger.close_input(i);
+
+    std::vector<uint32_t> sources;
+    Event event;
+    while (merger.try_dequeue(event, 0)) {
+        sources.push_back(event.source);
+    }
+    EXPECT_EQ(sources, (std::vector<uint32_t>{0, 1, 2}));
+}
+
+// Test that an open, empty input holds the merge back when lateness is unbounded
+TEST(TimestampMergerTest, WaitsForEmptyInput) {
+    EventRing a, b, c;
+    Merger3 merger({&a, &b, &c});
+    a.try_enqueue(Event{10, 0});
+    b.try_enqueue(Event{20, 1});
+
+    Event event;
+    EXPECT_FALSE(merger.try_dequeue(event, 1000));
+    EXPECT_EQ(merger.stalls(), 1u);
+    EXPECT_EQ(merger.empty_mask(), 0b100u);
+
+    // The slow input catches up with an older event, which must come first
+    c.try_enqueue(Event{5, 2});
+    ASSERT_TRUE(merger.try_dequeue(event, 2000));
+    EXPECT_EQ(event.timestamp, 5u);
+
+    // c is empty again, so 10 still waits until c is closed
+    EXPECT_FALSE(merger.try_dequeue(event, 3000));
+    merger.close_input(2);
+    EXPECT_EQ(take_all(merger, 4000), (std::vector<uint64_t>{10}));  // Then a is open and empty, holding back 20
+}
+
+// Test that the lateness window bounds how long an empty input can stall the others
+TEST(TimestampMergerTest, LatenessReleasesStalledMerge) {
+    EventRing a, b, c;
+    Merger3 merger({&a, &b, &c}, 100);
+    a.try_enqueue(Event{10, 0});
+    a.try_enqueue(Event{30, 0});
+    b.try_enqueue(Event{20, 1});
+    merger.close_input(0);
+    merger.close_input(1);
+
+    // The window opens on the first call that c holds back
+    Event event;
+    EXPECT_FALSE(merger.try_dequeue(event, 1000));
+    EXPECT_FALSE(merger.try_dequeue(event, 1099));
+    EXPECT_EQ(take_all(merger, 1100), (std::vector<uint64_t>{10, 20, 30}));
+
+    // Anything c sends older than the watermark is dropped; the rest is merged
+    c.try_enqueue(Event{15, 2});
+    c.try_enqueue(Event{40, 2});
+    merger.close_input(2);
+    EXPECT_EQ(take_all(merger, 1200), (std::vector<uint64_t>{40}));
+    EXPECT_EQ(merger.late_dropped(), 1u);
+    EXPECT_TRUE(merger.finished());
+}
+
+// Test that an input refilled within the window restarts its clock next time it runs dry
+TEST(TimestampMergerTest, LatenessClockRestarts) {
+    EventRing a, b;
+    TimestampMerger<EventRing, 2> merger({&a, &b}, 100);
+    a.try_enqueue(Event{1, 0});
+    a.try_enqueue(Event{3, 0});
+
+    Event event;
+    EXPECT_FALSE(merger.try_dequeue(event, 0));
+    b.try_enqueue(Event{2, 1});
+    EXPECT_EQ(take_all(merger, 50), (std::vector<uint64_t>{1, 2}));
+
+    // b ran dry again and held 3 back at 50, so its new window runs from 50, not 0
+    EXPECT_FALSE(merger.try_dequeue(event, 120));
+    EXPECT_FALSE(merger.try_dequeue(event, 149));
+    EXPECT_EQ(take_all(merger, 150), (std::vector<uint64_t>{3}));
+}
+
+// Test that a zero window never waits and that K need not be a power of two
+TEST(TimestampMergerTest, ZeroLatenessNeverWaits) {
+    std::vector<EventRing> rings(5);
+    TimestampMerger<EventRing, 5> merger({&rings[0], &rings[1], &rings[2], &rings[3], &rings[4]}, 0);
+    rings[4].try_enqueue(Event{7, 4});
+    rings[1].try_enqueue(Event{3, 1});
+    EXPECT_EQ(take_all(merger, 0), (std::vector<uint64_t>{3, 7}));
+    EXPECT_EQ(merger.stalls(), 0u);
+    EXPECT_FALSE(merger.finished());
+}
+
+// Test that concurrent producers on every input are merged completely and in order
+TEST(TimestampMergerTest, ConcurrentProducers) {
+    constexpr size_t INPUTS = 8;
+    constexpr uint64_t PER_INPUT = 50000;
+    std::vector<RingBuffer<Event, 256>> rings(INPUTS);
+    std::array<RingBuffer<Event, 256>*, INPUTS> inputs{};
+    for (size_t i = 0; i < INPUTS; ++i) {
+        inputs[i] = &rings[i];
+    }
+    TimestampMerger<RingBuffer<Event, 256>, INPUTS> merger(inputs);
+
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < INPUTS; ++p) {
+        producers.emplace_back([&, p]() {
+            // Interleaved clocks, with every input stepping at its own rate
+            for (uint64_t i = 0; i < PER_INPUT; ++i) {
+                Event event{i * (p + 1) + p, static_cast<uint32_t>(p)};
+                while (!rings[p].try_enqueue(event)) {
+                    std::this_thread::yield();
+                }
+            }
+            merger.close_input(p);
+        });
+    }
+
+    bool in_order = true;
+    uint64_t previous = 0;
+    uint64_t received = 0;
+    Event event;
+    while (!merger.finished()) {
+        if (merger.try_dequeue(event)) {
+            in_order = in_order && event.timestamp >= previous;
+            previous = event.timestamp;
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+
+    EXPECT_TRUE(in_order);
+    EXPECT_EQ(received, INPUTS * PER_INPUT);
+    EXPECT_EQ(merger.late_dropped(), 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,105 @@
+#include "../include/work_stealing_pool.h"
+#include "../include/shared_queue_pool.h"
+#include "queue_benchmarks.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+// Below this, fib() recurses serially; each task is then a few microseconds of work
+constexpr int FIB_CUTOFF = 12;
+
+static uint64_t serial_fib(int n) {
+    return n < 2 ? static_cast<uint64_t>(n) : serial_fib(n - 1) + serial_fib(n - 2);
+}
+
+template <typename Pool>
+static uint64_t parallel_fib(Pool& pool, int n, std::atomic<uint64_t>& tasks) {
+    if (n <= FIB_CUTOFF) {
+        return serial_fib(n);
+    }
+    tasks.fetch_add(1, std::memory_order_relaxed);
+    uint64_t left = 0;
+    TaskGroup<Pool> group(pool);
+    group.run([&]() { left = parallel_fib(pool, n - 1, tasks); });
+    const uint64_t right = parallel_fib(pool, n - 2, tasks);
+    group.wait();
+    return left + right;
+}
+
+template <typename Pool>
+static void report_steals([[maybe_unused]] benchmark::State& state, [[maybe_unused]] Pool& pool) {
+    if constexpr (requires { pool.steal_count(); }) {
+        state.counters["steals"] = static_cast<double>(pool.steal_count());
+    }
+}
+
+// Recursive fork/join: every task spawns one child and waits for it
+template <typename Pool>
+static void BM_ForkJoinFib(benchmark::State& state) {
+    Pool pool(static_cast<size_t>(state.range(0)));
+    constexpr int N = 27;
+    std::atomic<uint64_t> tasks(0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(parallel_fib(pool, N, tasks));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(tasks.load()));
+    report_steals(state, pool);
+    state.SetLabel(std::to_string(state.range(0)) + " workers");
+}
+
+// Flat data parallelism: parallel_for over an array, split recursively down to the grain
+template <typename Pool>
+static void BM_ParallelFor(benchmark::State& state) {
+    Pool pool(static_cast<size_t>(state.range(0)));
+    const size_t grain = static_cast<size_t>(state.range(1));
+    std::vector<double> values(1 << 20, 1.5);
+    for (auto _ : state) {
+        parallel_for(pool, 0, values.size(), grain, [&](size_t i) { values[i] = std::sqrt(values[i] + 1.0); });
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+    report_steals(state, pool);
+    state.SetLabel(std::to_string(state.range(0)) + " workers, grain " + std::to_string(grain));
+}
+
+// Flat submission: the calling thread submits every chunk itself, through the
+// injection queue (or the one shared queue), then waits
+template <typename Pool>
+static void BM_FlatSubmit(benchmark::State& state) {
+    Pool pool(static_cast<size_t>(state.range(0)));
+    constexpr size_t CHUNK = 1024;
+    std::vector<double> values(1 << 20, 1.5);
+    for (auto _ : state) {
+        TaskGroup<Pool> group(pool);
+        for (size_t begin = 0; begin < values.size(); begin += CHUNK) {
+            group.run([&values, begin]() {
+                for (size_t i = begin; i < begin + CHUNK; ++i) {
+                    values[i] = std::sqrt(values[i] + 1.0);
+                }
+            });
+        }
+        group.wait();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+    report_steals(state, pool);
+    state.SetLabel(std::to_string(state.range(0)) + " workers");
+}
+
+#define WORKER_COUNTS ->Arg(1)->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond)
+
+BENCHMARK_TEMPLATE(BM_ForkJoinFib, WorkStealingPool) WORKER_COUNTS;
+BENCHMARK_TEMPLATE(BM_ForkJoinFib, SharedQueuePool) WORKER_COUNTS;
+
+BENCHMARK_TEMPLATE(BM_ParallelFor, WorkStealingPool)
+    ->Args({1, 256})->Args({2, 256})->Args({4, 256})->Args({4, 4096})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ParallelFor, SharedQueuePool)
+    ->Args({1, 256})->Args({2, 256})->Args({4, 256})->Args({4, 4096})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_TEMPLATE(BM_FlatSubmit, WorkStealingPool) WORKER_COUNTS;
+BENCHMARK_TEMPLATE(BM_FlatSubmit, SharedQueuePool) WORKER_COUNTS;
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
@@ -0,0 +1,183 @@
+/**
+ * @file chase_lev_deque.h
+ * @brief Chase-Lev work-stealing deque with a growable circular array
+ *
+ * One owner thread pushes and pops at the bottom, like a stack. Any number of
+ * thieves take from the top. Owner operations touch only bottom_ unless the
+ * deque is nearly empty, so the owner and thieves rarely meet on a cache line.
+ *
+ * Memory orderings follow Lê, Pop, Cohen and Zappa Nardelli, "Correct and
+ * Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include "concurrency_primitives.h"
+
+/**
+ * @brief Single-owner, multi-thief deque
+ *
+ * When the array fills, push() copies the live range into one twice the
+ * size. A thief may still be reading the old array, so old arrays are kept
+ * until the deque is destroyed. They add up to less than the current one.
+ *
+ * @tparam T Element type; trivially copyable, since slots are atomics
+ *         (typically a pointer to a task)
+ */
+template <typename T>
+class ChaseLevDeque {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+    using value_type = T;
+
+    /**
+     * @param initial_capacity Starting slot count, rounded up to a power of 2
+     */
+    explicit ChaseLevDeque(size_t initial_capacity = 1024) {
+        size_t capacity = 1;
+        while (capacity < initial_capacity) {
+            capacity <<= 1;
+        }
+        arrays_.push_back(std::make_unique<Array>(capacity));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+        top_.data.store(0, std::memory_order_relaxed);
+        bottom_.data.store(0, std::memory_order_relaxed);
+    }
+
+    ChaseLevDeque(const ChaseLevDeque&) = delete;
+    ChaseLevDeque& operator=(const ChaseLevDeque&) = delete;
+
+    /**
+     * @brief Adds an element at the bottom; owner thread only
+     */
+    void push(T value) {
+        const int64_t bottom = bottom_.data.load(std::memory_order_relaxed);
+        const int64_t top = top_.data.load(std::memory_order_acquire);
+        Array* array = array_.load(std::memory_order_relaxed);
+        if (bottom - top > static_cast<int64_t>(array->capacity) - 1) {
+            array = grow(array, top, bottom);
+        }
+        array->put(bottom, value);
+        // The element must be visible before a thief can see the new bottom. The paper
+        // uses a release fence and a relaxed store; a release store is the same on x86
+        // and ARM, and it is a pairing ThreadSanitizer understands
+        bottom_.data.store(bottom + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Takes the most recently pushed element; owner thread only
+     *
+     * @return The element, or nullopt if the deque is empty or a thief took the last one
+     */
+    std::optional<T> pop() noexcept {
+        const int64_t bottom = bottom_.data.load(std::memory_order_relaxed) - 1;
+        Array* array = array_.load(std::memory_order_relaxed);
+        bottom_.data.store(bottom, std::memory_order_relaxed);
+        // Claim the bottom slot before reading top; pairs with the fence in steal()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = top_.data.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            // Empty
+            bottom_.data.store(bottom + 1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        T value = array->get(bottom);
+        if (top == bottom) {
+            // Last element: race the thieves for it through top
+            const bool won = top_.data.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                               std::memory_order_relaxed);
+            bottom_.data.store(bottom + 1, std::memory_order_relaxed);
+            if (!won) {
+                return std::nullopt;
+            }
+        }
+        return value;
+    }
+
+    /**
+     * @brief Takes the oldest element; any thread
+     *
+     * @return The element, or nullopt if the deque looked empty or another
+     *         thread won the race for the top element
+     */
+    std::optional<T> steal() noexcept {
+        int64_t top = top_.data.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = bottom_.data.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return std::nullopt;
+        }
+        // Acquire pairs with the release store in grow(), so the copied slots are visible
+        Array* array = array_.load(std::memory_order_acquire);
+        T value = array->get(top);
+        if (!top_.data.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                               std::memory_order_relaxed)) {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    /**
+     * @brief Approximate element count; exact only while no thread is using the deque
+     */
+    size_t size() const noexcept {
+        const int64_t bottom = bottom_.data.load(std::memory_order_relaxed);
+        const int64_t top = top_.data.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Current slot count; grows as push() needs it
+     */
+    size_t capacity() const noexcept {
+        return array_.load(std::memory_order_relaxed)->capacity;
+    }
+
+private:
+    struct Array {
+        const size_t capacity;
+        const size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Array(size_t size) : capacity(size), mask(size - 1), slots(new std::atomic<T>[size]) {}
+
+        T get(int64_t index) const noexcept {
+            return slots[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed);
+        }
+        void put(int64_t index, T value) noexcept {
+            slots[static_cast<size_t>(index) & mask].store(value, std::memory_order_relaxed);
+        }
+    };
+
+    Array* grow(Array* old, int64_t top, int64_t bottom) {
+        arrays_.push_back(std::make_unique<Array>(old->capacity * 2));
+        Array* array = arrays_.back().get();
+        for (int64_t i = top; i < bottom; ++i) {
+            array->put(i, old->get(i));
+        }
+        array_.store(array, std::memory_order_release);
+        return array;
+    }
+
+    // Thieves advance top_, the owner moves bottom_; each on its own line
+    CacheLineAligned<std::atomic<int64_t>> top_;
+    CacheLineAligned<std::atomic<int64_t>> bottom_;
+    std::atomic<Array*> array_;
+
+    // Every array this deque has used; only the owner touches the vector
+    std::vector<std::unique_ptr<Array>> arrays_;
+};
@@ -0,0 +1,107 @@
+/**
+ * @file shared_queue_pool.h
+ * @brief Baseline: a worker pool that shares one MPMCQueue of tasks
+ *
+ * Every submit and every task fetch goes through the same head_ and tail_,
+ * from every worker. The benchmarks run it beside WorkStealingPool to show
+ * what the per-worker deques save. It has the same submit()/run_one()
+ * interface, so TaskGroup and parallel_for() work with it unchanged.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "concurrency_primitives.h"
+#include "mpmc_queue.h"
+#include "task.h"
+
+class SharedQueuePool {
+public:
+    static constexpr size_t QUEUE_CAPACITY = 65536;
+
+    explicit SharedQueuePool(size_t num_workers = std::max(1u, std::thread::hardware_concurrency()))
+        : queue_(std::make_unique<MPMCQueue<Task*, QUEUE_CAPACITY>>()) {
+        num_workers = std::max<size_t>(num_workers, 1);
+        for (size_t i = 0; i < num_workers; ++i) {
+            workers_.emplace_back([this]() { worker_loop(); });
+        }
+    }
+
+    // Tasks still queued are deleted without running
+    ~SharedQueuePool() {
+        stop_.store(true, std::memory_order_release);
+        parking_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+        Task* task = nullptr;
+        while (queue_->try_dequeue(task)) {
+            delete task;
+        }
+    }
+
+    SharedQueuePool(const SharedQueuePool&) = delete;
+    SharedQueuePool& operator=(const SharedQueuePool&) = delete;
+
+    // Waits for room while the queue is full, helping to drain it
+    void submit(Task* task) {
+        while (!queue_->try_enqueue(task)) {
+            if (!run_one()) {
+                std::this_thread::yield();
+            }
+        }
+        parking_.notify();
+    }
+
+    template <typename F>
+    void submit(F&& function) {
+        submit(make_task(std::forward<F>(function)));
+    }
+
+    bool run_one() {
+        Task* task = nullptr;
+        if (!queue_->try_dequeue(task)) {
+            return false;
+        }
+        task->run();
+        delete task;
+        return true;
+    }
+
+    size_t num_workers() const noexcept {
+        return workers_.size();
+    }
+
+private:
+    static constexpr uint32_t SPIN_ROUNDS = 64;
+    static constexpr uint32_t YIELD_ROUNDS = 128;
+
+    void worker_loop() {
+        uint32_t idle = 0;
+        while (!stop_.load(std::memory_order_acquire)) {
+            if (run_one()) {
+                idle = 0;
+            } else if (++idle < SPIN_ROUNDS) {
+                cpu_pause();
+            } else if (idle < YIELD_ROUNDS) {
+                std::this_thread::yield();
+            } else {
+                parking_.park([this]() { return !queue_->empty() || stop_.load(std::memory_order_acquire); });
+                idle = 0;
+            }
+        }
+    }
+
+    std::unique_ptr<MPMCQueue<Task*, QUEUE_CAPACITY>> queue_;
+    std::vector<std::thread> workers_;
+    ThreadParker parking_;
+    std::atomic<bool> stop_{false};
+};
@@ -0,0 +1,132 @@
+/**
+ * @file task.h
+ * @brief Tasks and fork/join groups shared by the task pools
+ *
+ * A pool runs heap-allocated Task objects and deletes each after it runs.
+ * TaskGroup and parallel_for() work with any pool that provides:
+ *  - submit(Task*): queue a task from any thread;
+ *  - run_one(): run one queued task on the calling thread, if there is one.
+ *
+ * A thread waiting on a group runs other tasks meanwhile, so a task may
+ * wait for the tasks it spawned without tying up a worker.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "concurrency_primitives.h"
+
+/**
+ * @brief A unit of work; the pool deletes it after run()
+ */
+class Task {
+public:
+    virtual ~Task() = default;
+    virtual void run() = 0;
+};
+
+template <typename F>
+class FunctionTask final : public Task {
+public:
+    explicit FunctionTask(F function) : function_(std::move(function)) {}
+
+    void run() override {
+        function_();
+    }
+
+private:
+    F function_;
+};
+
+template <typename F>
+Task* make_task(F&& function) {
+    return new FunctionTask<std::decay_t<F>>(std::forward<F>(function));
+}
+
+/**
+ * @brief Spawns tasks into a pool and waits for all of them
+ *
+ * wait() runs other queued tasks while the group's tasks are pending, so a
+ * group can be used from inside a task. Tasks that throw terminate the
+ * process; catch inside the task if that matters.
+ */
+template <typename Pool>
+class TaskGroup {
+public:
+    explicit TaskGroup(Pool& pool) noexcept : pool_(pool) {}
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    ~TaskGroup() {
+        wait();
+    }
+
+    template <typename F>
+    void run(F&& function) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        pool_.submit(make_task([this, function = std::forward<F>(function)]() mutable {
+            function();
+            // Release: the waiter sees everything the task wrote
+            pending_.fetch_sub(1, std::memory_order_release);
+        }));
+    }
+
+    void wait() {
+        uint32_t idle = 0;
+        while (pending_.load(std::memory_order_acquire) != 0) {
+            if (pool_.run_one()) {
+                idle = 0;
+            } else if (++idle < 64) {
+                cpu_pause();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    Pool& pool_;
+    std::atomic<size_t> pending_{0};
+};
+
+namespace task_detail {
+
+template <typename Pool, typename Body>
+void split_range(Pool& pool, TaskGroup<Pool>& group, size_t begin, size_t end, size_t grain, const Body& body) {
+    // Hand the upper halves to the pool and keep splitting the lower half
+    while (end - begin > grain) {
+        const size_t middle = begin + (end - begin) / 2;
+        group.run([&pool, &group, middle, end, grain, &body]() {
+            split_range(pool, group, middle, end, grain, body);
+        });
+        end = middle;
+    }
+    for (size_t i = begin; i < end; ++i) {
+        body(i);
+    }
+}
+
+}  // namespace task_detail
+
+/**
+ * @brief Calls body(i) for every i in [begin, end) on the pool, and waits
+ *
+ * The range is split in halves until pieces are at most grain long. The
+ * caller runs the first piece itself and helps with the rest while it waits.
+ */
+template <typename Pool, typename Body>
+void parallel_for(Pool& pool, size_t begin, size_t end, size_t grain, const Body& body) {
+    if (begin >= end) {
+        return;
+    }
+    TaskGroup<Pool> group(pool);
+    task_detail::split_range(pool, group, begin, end, grain == 0 ? 1 : grain, body);
+    group.wait();
+}
@@ -0,0 +1,236 @@
+/**
+ * @file work_stealing_pool.h
+ * @brief Fork/join worker pool on per-worker Chase-Lev deques
+ *
+ * Each worker pushes the tasks it spawns onto its own deque and pops them
+ * back LIFO, so recursive work stays hot in that worker's cache. A worker
+ * that runs dry takes from the injection queue, where tasks submitted from
+ * outside the pool arrive, and then steals the oldest task of a random
+ * victim. The oldest task is usually the biggest piece of work left.
+ * Workers that stay idle park in a ThreadParker until work arrives.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "chase_lev_deque.h"
+#include "concurrency_primitives.h"
+#include "mpmc_queue.h"
+#include "task.h"
+
+class WorkStealingPool {
+public:
+    // Tasks submitted from outside the pool that can wait at once
+    static constexpr size_t INJECTION_CAPACITY = 4096;
+    static constexpr size_t NO_WORKER = SIZE_MAX;
+
+    explicit WorkStealingPool(size_t num_workers = std::max(1u, std::thread::hardware_concurrency())) {
+        num_workers = std::max<size_t>(num_workers, 1);
+        // Every deque exists before any worker starts looking for victims
+        for (size_t i = 0; i < num_workers; ++i) {
+            workers_.push_back(std::make_unique<Worker>(this, i));
+        }
+        for (auto& worker : workers_) {
+            worker->thread = std::thread([this, w = worker.get()]() { worker_loop(w); });
+        }
+    }
+
+    /**
+     * @brief Stops the workers; tasks still queued are deleted without running
+     *
+     * Wait for outstanding work (TaskGroup::wait) first.
+     */
+    ~WorkStealingPool() {
+        stop_.store(true, std::memory_order_release);
+        parking_.notify_all();
+        for (auto& worker : workers_) {
+            worker->thread.join();
+        }
+        for (auto& worker : workers_) {
+            while (auto task = worker->deque.pop()) {
+                delete *task;
+            }
+        }
+        Task* task = nullptr;
+        while (injection_.try_dequeue(task)) {
+            delete task;
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Queues a task; the pool owns it from here on
+     *
+     * From one of this pool's workers the task goes on that worker's deque.
+     * From any other thread it goes through the injection queue. If
+     * INJECTION_CAPACITY tasks are already queued there, the caller runs
+     * queued tasks until there is room.
+     */
+    void submit(Task* task) {
+        if (Worker* self = local_worker()) {
+            self->deque.push(task);
+        } else {
+            while (!injection_.try_enqueue(task)) {
+                if (!run_one()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+        parking_.notify();
+    }
+
+    template <typename F>
+    void submit(F&& function) {
+        submit(make_task(std::forward<F>(function)));
+    }
+
+    /**
+     * @brief Runs one queued task on the calling thread
+     *
+     * Workers check their own deque first; every thread then tries the
+     * injection queue and the other workers' deques.
+     *
+     * @return false if no task was found
+     */
+    bool run_one() {
+        Task* task = find_task(local_worker());
+        if (task == nullptr) {
+            return false;
+        }
+        execute(task);
+        return true;
+    }
+
+    size_t num_workers() const noexcept {
+        return workers_.size();
+    }
+
+    /**
+     * @brief The calling thread's index in this pool, or NO_WORKER
+     */
+    size_t current_worker() const noexcept {
+        const Worker* self = local_worker();
+        return self != nullptr ? self->index : NO_WORKER;
+    }
+
+    /**
+     * @brief Tasks taken from another worker's deque so far, summed over workers
+     */
+    uint64_t steal_count() const noexcept {
+        uint64_t total = 0;
+        for (const auto& worker : workers_) {
+            total += worker->steals.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+private:
+    // Idle rounds spent spinning, then yielding, before a worker parks
+    static constexpr uint32_t SPIN_ROUNDS = 64;
+    static constexpr uint32_t YIELD_ROUNDS = 128;
+
+    struct alignas(CACHE_LINE_SIZE) Worker {
+        WorkStealingPool* pool;
+        size_t index;
+        ChaseLevDeque<Task*> deque;
+        std::thread thread;
+        uint64_t rng;
+        std::atomic<uint64_t> steals{0};
+
+        Worker(WorkStealingPool* owner, size_t i) : pool(owner), index(i), rng(0x9E3779B97F4A7C15ull * (i + 1)) {}
+    };
+
+    static inline thread_local Worker* current_ = nullptr;
+
+    Worker* local_worker() const noexcept {
+        return current_ != nullptr && current_->pool == this ? current_ : nullptr;
+    }
+
+    static uint64_t next_random(uint64_t& state) noexcept {
+        // xorshift64
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    Task* find_task(Worker* self) {
+        if (self != nullptr) {
+            if (auto task = self->deque.pop()) {
+                return *task;
+            }
+        }
+        Task* task = nullptr;
+        if (injection_.try_dequeue(task)) {
+            parking_.notify();  // There may be more; let a sleeper look
+            return task;
+        }
+        return steal_task(self);
+    }
+
+    Task* steal_task(Worker* self) {
+        thread_local uint64_t outsider_rng = 0x2545F4914F6CDD1Dull;
+        const size_t count = workers_.size();
+        const size_t start = static_cast<size_t>(next_random(self != nullptr ? self->rng : outsider_rng) % count);
+        for (size_t i = 0; i < count; ++i) {
+            Worker* victim = workers_[(start + i) % count].get();
+            if (victim == self) {
+                continue;
+            }
+            if (auto task = victim->deque.steal()) {
+                if (self != nullptr) {
+                    self->steals.store(self->steals.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                }
+                parking_.notify();
+                return *task;
+            }
+        }
+        return nullptr;
+    }
+
+    bool has_work() const noexcept {
+        if (!injection_.empty()) {
+            return true;
+        }
+        return std::any_of(workers_.begin(), workers_.end(), [](const auto& worker) { return !worker->deque.empty(); });
+    }
+
+    static void execute(Task* task) {
+        task->run();
+        delete task;
+    }
+
+    void worker_loop(Worker* self) {
+        current_ = self;
+        uint32_t idle = 0;
+        while (!stop_.load(std::memory_order_acquire)) {
+            if (Task* task = find_task(self)) {
+                execute(task);
+                idle = 0;
+            } else if (++idle < SPIN_ROUNDS) {
+                cpu_pause();
+            } else if (idle < YIELD_ROUNDS) {
+                std::this_thread::yield();
+            } else {
+                parking_.park([this]() { return has_work() || stop_.load(std::memory_order_acquire); });
+                idle = 0;
+            }
+        }
+        current_ = nullptr;
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    MPMCQueue<Task*, INJECTION_CAPACITY> injection_;
+    ThreadParker parking_;
+    std::atomic<bool> stop_{false};
+};
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../include/work_stealing_pool.h"
+
+// P&L of a moving-average crossover with the given fast and slow windows
+double backtest(const std::vector<double>& prices, size_t fast, size_t slow) {
+    double pnl = 0.0;
+    double fast_sum = 0.0;
+    double slow_sum = 0.0;
+    int position = 0;
+    for (size_t i = 0; i < prices.size(); ++i) {
+        fast_sum += prices[i];
+        slow_sum += prices[i];
+        if (i >= fast) fast_sum -= prices[i - fast];
+        if (i >= slow) slow_sum -= prices[i - slow];
+        if (i > 0) pnl += position * (prices[i] - prices[i - 1]);
+        if (i + 1 >= slow) {
+            position = fast_sum / static_cast<double>(fast) > slow_sum / static_cast<double>(slow) ? 1 : -1;
+        }
+    }
+    return pnl;
+}
+
+// Sums a range by splitting it in halves, one half per task
+uint64_t parallel_sum(WorkStealingPool& pool, const std::vector<uint64_t>& values, size_t begin, size_t end) {
+    if (end - begin <= 4096) {
+        uint64_t total = 0;
+        for (size_t i = begin; i < end; ++i) total += values[i];
+        return total;
+    }
+    const size_t middle = begin + (end - begin) / 2;
+    uint64_t upper = 0;
+    TaskGroup<WorkStealingPool> group(pool);
+    group.run([&]() { upper = parallel_sum(pool, values, middle, end); });
+    const uint64_t lower = parallel_sum(pool, values, begin, middle);
+    group.wait();
+    return lower + upper;
+}
+
+int main() {
+    std::cout << "Work-Stealing Pool Demo\n";
+    std::cout << "=======================\n\n";
+
+    WorkStealingPool pool;
+    std::cout << "Workers: " << pool.num_workers() << "\n\n";
+
+    // Parameter sweep: one backtest per (fast, slow) pair
+    std::mt19937_64 rng(42);
+    std::normal_distribution<double> returns(0.0, 0.001);
+    std::vector<double> prices(200000);
+    double price = 100.0;
+    for (double& p : prices) {
+        price *= 1.0 + returns(rng);
+        p = price;
+    }
+
+    constexpr size_t NUM_FAST = 16;
+    constexpr size_t NUM_SLOW = 16;
+    std::vector<double> pnl(NUM_FAST * NUM_SLOW);
+    const auto start = std::chrono::steady_clock::now();
+    parallel_for(pool, 0, pnl.size(), 1, [&](size_t i) {
+        const size_t fast = 5 + 5 * (i / NUM_SLOW);
+        const size_t slow = 100 + 50 * (i % NUM_SLOW);
+        pnl[i] = backtest(prices, fast, slow);
+    });
+    const auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+    const size_t best = static_cast<size_t>(std::max_element(pnl.begin(), pnl.end()) - pnl.begin());
+    std::cout << "Backtested " << pnl.size() << " parameter sets in " << elapsed.count() << " ms\n";
+    std::cout << "Best: fast " << 5 + 5 * (best / NUM_SLOW) << ", slow " << 100 + 50 * (best % NUM_SLOW)
+              << ", P&L " << pnl[best] << "\n\n";
+
+    // Recursive fork/join
+    std::vector<uint64_t> values(1 << 22);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = i;
+    std::cout << "Fork/join sum of 0.." << values.size() - 1 << ": " << parallel_sum(pool, values, 0, values.size())
+              << " (expected " << static_cast<uint64_t>(values.size()) * (values.size() - 1) / 2 << ")\n";
+    std::cout << "Tasks stolen between workers: " << pool.steal_count() << "\n";
+
+    std::cout << "\nDemo completed successfully!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include "../include/chase_lev_deque.h"
+#include "../include/work_stealing_pool.h"
+#include "../include/shared_queue_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+// Test that the owner sees LIFO order and a thief sees FIFO order
+TEST(ChaseLevDequeTest, OwnerLifoThiefFifo) {
+    ChaseLevDeque<int> deque(8);
+    EXPECT_TRUE(deque.empty());
+    EXPECT_FALSE(deque.pop().has_value());
+    EXPECT_FALSE(deque.steal().has_value());
+
+    for (int i = 0; i < 5; ++i) {
+        deque.push(i);
+    }
+    EXPECT_EQ(deque.size(), 5u);
+    EXPECT_EQ(deque.pop(), 4);
+    EXPECT_EQ(deque.steal(), 0);
+    EXPECT_EQ(deque.steal(), 1);
+    EXPECT_EQ(deque.pop(), 3);
+    EXPECT_EQ(deque.pop(), 2);
+    EXPECT_FALSE(deque.pop().has_value());
+    EXPECT_FALSE(deque.steal().has_value());
+    EXPECT_TRUE(deque.empty());
+}
+
+// Test that growing keeps every element in order, including across the wrap
+TEST(ChaseLevDequeTest, GrowsPastCapacity) {
+    ChaseLevDeque<int> deque(4);
+    EXPECT_EQ(deque.capacity(), 4u);
+
+    // Move top and bottom past the end of the first array before it grows
+    for (int i = 0; i < 3; ++i) {
+        deque.push(-1);
+        EXPECT_EQ(deque.steal(), -1);
+    }
+    for (int i = 0; i < 100; ++i) {
+        deque.push(i);
+    }
+    EXPECT_GE(deque.capacity(), 100u);
+    EXPECT_EQ(deque.size(), 100u);
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(deque.steal(), i);
+    }
+    for (int i = 99; i >= 50; --i) {
+        EXPECT_EQ(deque.pop(), i);
+    }
+    EXPECT_TRUE(deque.empty());
+}
+
+// Test that the initial capacity is rounded up to a power of 2
+TEST(ChaseLevDequeTest, CapacityRoundsUp) {
+    EXPECT_EQ(ChaseLevDeque<int>(5).capacity(), 8u);
+    EXPECT_EQ(ChaseLevDeque<int>(1).capacity(), 1u);
+    ChaseLevDeque<int> single(1);
+    single.push(1);
+    single.push(2);
+    EXPECT_EQ(single.pop(), 2);
+    EXPECT_EQ(single.pop(), 1);
+}
+
+// Test that under an owner racing several thieves every element is taken exactly once
+TEST(ChaseLevDequeTest, ConcurrentStealsTakeEachElementOnce) {
+    constexpr int NUM_ITEMS = 200000;
+    constexpr int NUM_THIEVES = 3;
+    ChaseLevDeque<int> deque(16);  // Small, so it grows while thieves are reading
+    std::vector<std::atomic<int>> taken(NUM_ITEMS);
+    std::atomic<bool> done(false);
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < NUM_THIEVES; ++t) {
+        thieves.emplace_back([&]() {
+            while (!done.load(std::memory_order_acquire) || !deque.empty()) {
+                if (auto value = deque.steal()) {
+                    taken[*value].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    // The owner pushes in bursts and pops some back, racing for the last element
+    int next = 0;
+    while (next < NUM_ITEMS) {
+        for (int i = 0; i < 64 && next < NUM_ITEMS; ++i) {
+            deque.push(next++);
+        }
+        for (int i = 0; i < 16; ++i) {
+            if (auto value = deque.pop()) {
+                taken[*value].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    while (auto value = deque.pop()) {
+        taken[*value].fetch_add(1, std::memory_order_relaxed);
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& thief : thieves) {
+        thief.join();
+    }
+
+    for (int i = 0; i < NUM_ITEMS; ++i) {
+        ASSERT_EQ(taken[i].load(), 1) << "element " << i;
+    }
+}
+
+template <typename Pool>
+class TaskPoolTest : public ::testing::Test {};
+
+using PoolTypes = ::testing::Types<WorkStealingPool, SharedQueuePool>;
+TYPED_TEST_SUITE(TaskPoolTest, PoolTypes);
+
+template <typename Pool>
+uint64_t fib(Pool& pool, int n) {
+    if (n < 2) {
+        return static_cast<uint64_t>(n);
+    }
+    uint64_t left = 0;
+    TaskGroup<Pool> group(pool);
+    group.run([&]() { left = fib(pool, n - 1); });
+    const uint64_t right = fib(pool, n - 2);
+    group.wait();
+    return left + right;
+}
+
+// Test that tasks submitted from outside all run
+TYPED_TEST(TaskPoolTest, SubmitFromOutside) {
+    TypeParam pool(4);
+    TaskGroup<TypeParam> group(pool);
+    std::atomic<int> count(0);
+    for (int i = 0; i < 10000; ++i) {
+        group.run([&]() { count.fetch_add(1, std::memory_order_relaxed); });
+    }
+    group.wait();
+    EXPECT_EQ(count.load(), 10000);
+}
+
+// Test recursive fork/join, where every task waits on tasks it spawned
+TYPED_TEST(TaskPoolTest, RecursiveForkJoin) {
+    TypeParam pool(4);
+    EXPECT_EQ(fib(pool, 20), 6765u);
+}
+
+// Test that parallel_for visits every index exactly once, for awkward grains
+TYPED_TEST(TaskPoolTest, ParallelForCoversRange) {
+    TypeParam pool(3);
+    for (size_t grain : {size_t{0}, size_t{1}, size_t{7}, size_t{1000}, size_t{100000}}) {
+        std::vector<std::atomic<int>> visits(10007);
+        parallel_for(pool, 0, visits.size(), grain, [&](size_t i) { visits[i].fetch_add(1, std::memory_order_relaxed); });
+        for (size_t i = 0; i < visits.size(); ++i) {
+            ASSERT_EQ(visits[i].load(), 1) << "index " << i << " grain " << grain;
+        }
+    }
+    parallel_for(pool, 5, 5, 1, [](size_t) { FAIL(); });
+}
+
+// Test that a single worker still completes nested work, with the caller helping
+TYPED_TEST(TaskPoolTest, SingleWorker) {
+    TypeParam pool(1);
+    EXPECT_EQ(pool.num_workers(), 1u);
+    EXPECT_EQ(fib(pool, 15), 610u);
+
+    std::vector<uint64_t> values(5000);
+    parallel_for(pool, 0, values.size(), 16, [&](size_t i) { values[i] = i; });
+    EXPECT_EQ(std::accumulate(values.begin(), values.end(), uint64_t{0}), 5000u * 4999u / 2);
+}
+
+// Test that the pool can be destroyed with tasks still queued, and that idle workers wake up
+TYPED_TEST(TaskPoolTest, IdleAndShutdown) {
+    std::atomic<int> count(0);
+    {
+        TypeParam pool(2);
+        // Long enough for every worker to give up spinning and park
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        TaskGroup<TypeParam> group(pool);
+        group.run([&]() { count.fetch_add(1); });
+        group.wait();
+        EXPECT_EQ(count.load(), 1);
+
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&]() { count.fetch_add(1); });
+        }
+    }
+    EXPECT_LE(count.load(), 101);
+}
+
+// Test that a task spawned by a worker runs exactly once, wherever it is stolen to
+TEST(WorkStealingPoolTest, SpawnedTasksRunOnce) {
+    WorkStealingPool pool(4);
+    EXPECT_EQ(pool.current_worker(), WorkStealingPool::NO_WORKER);
+
+    std::atomic<size_t> spawner(WorkStealingPool::NO_WORKER);
+    std::vector<std::atomic<int>> runs(2000);
+    {
+        TaskGroup<WorkStealingPool> outer(pool);
+        outer.run([&]() {
+            spawner = pool.current_worker();
+            TaskGroup<WorkStealingPool> inner(pool);
+            for (size_t i = 0; i < runs.size(); ++i) {
+                inner.run([&, i]() {
+                    runs[i].fetch_add(1, std::memory_order_relaxed);
+                    volatile uint64_t sink = 0;
+                    for (int spin = 0; spin < 2000; ++spin) {
+                        sink = sink + static_cast<uint64_t>(spin);
+                    }
+                });
+            }
+            inner.wait();
+        });
+        outer.wait();
+    }
+
+    // The caller may have run the outer task itself while waiting
+    EXPECT_TRUE(spawner.load() < pool.num_workers() || spawner.load() == WorkStealingPool::NO_WORKER);
+    for (size_t i = 0; i < runs.size(); ++i) {
+        ASSERT_EQ(runs[i].load(), 1) << "task " << i;
+    }
+    EXPECT_LE(pool.steal_count(), runs.size() + 1);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
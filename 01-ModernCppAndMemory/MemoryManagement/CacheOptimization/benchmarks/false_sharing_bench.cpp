@@ -0,0 +1,92 @@
+#include "../include/experiment_counters.h"
+#include "concurrency_primitives.h"
+#include <benchmark/benchmark.h>
+#include <atomic>
+
+// Eight counters to a cache line
+struct PackedCounter {
+    std::atomic<uint64_t> data{0};
+};
+
+// One counter per 64-byte line, via the queues' own padding wrapper
+using LineCounter = CacheLineAligned<std::atomic<uint64_t>>;
+
+// One counter per 128 bytes: also clear of the adjacent-line prefetcher
+using PairCounter = CacheAligned<std::atomic<uint64_t>, DESTRUCTIVE_INTERFERENCE_SIZE>;
+
+constexpr int MAX_THREADS = 8;
+constexpr size_t INCREMENTS_PER_ITERATION = 1000;
+
+/**
+ * @brief Each thread increments its own counter in a shared array
+ *
+ * No data is shared, only cache lines: with PackedCounter every increment
+ * invalidates the line in the other threads' caches.
+ */
+template <typename Slot>
+static void BM_PerThreadCounters(benchmark::State& state) {
+    static Slot slots[MAX_THREADS];
+    auto& mine = slots[state.thread_index() % MAX_THREADS].data;
+
+    pin_current_thread(static_cast<unsigned>(state.thread_index()));
+    ExperimentCounters counters;
+    counters.start();
+    for (auto _ : state) {
+        for (size_t i = 0; i < INCREMENTS_PER_ITERATION; ++i) {
+            mine.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    counters.stop(state, static_cast<double>(state.iterations() * INCREMENTS_PER_ITERATION));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * INCREMENTS_PER_ITERATION));
+}
+
+/**
+ * @brief Thread 0 writes slot 0 while every other thread reads its own slot
+ *
+ * No reader touches the writer's counter. With PackedCounter the readers'
+ * slots share the writer's line, so each store invalidates it under them, as
+ * a queue's consumer-side index does when it sits next to the producer's;
+ * with the padded slots the readers hit their own lines undisturbed.
+ */
+template <typename Slot>
+static void BM_WriterAndReaders(benchmark::State& state) {
+    static Slot slots[MAX_THREADS];
+    const int index = state.thread_index() % MAX_THREADS;
+
+    pin_current_thread(static_cast<unsigned>(state.thread_index()));
+    ExperimentCounters counters;
+    counters.start();
+    for (auto _ : state) {
+        if (index == 0) {
+            for (size_t i = 0; i < INCREMENTS_PER_ITERATION; ++i) {
+                slots[0].data.store(i, std::memory_order_release);
+            }
+        } else {
+            uint64_t total = 0;
+            for (size_t i = 0; i < INCREMENTS_PER_ITERATION; ++i) {
+                total += slots[index].data.load(std::memory_order_acquire);
+            }
+            benchmark::DoNotOptimize(total);
+        }
+    }
+    counters.stop(state, static_cast<double>(state.iterations() * INCREMENTS_PER_ITERATION));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * INCREMENTS_PER_ITERATION));
+}
+
+static_assert(sizeof(PackedCounter) == 8);
+static_assert(sizeof(LineCounter) == 64);
+static_assert(sizeof(PairCounter) == 128);
+
+#define THREAD_COUNTS ->Threads(1)->Threads(2)->Threads(4)->UseRealTime()
+
+BENCHMARK_TEMPLATE(BM_PerThreadCounters, PackedCounter) THREAD_COUNTS;
+BENCHMARK_TEMPLATE(BM_PerThreadCounters, LineCounter) THREAD_COUNTS;
+BENCHMARK_TEMPLATE(BM_PerThreadCounters, PairCounter) THREAD_COUNTS;
+
+BENCHMARK_TEMPLATE(BM_WriterAndReaders, PackedCounter) THREAD_COUNTS;
+BENCHMARK_TEMPLATE(BM_WriterAndReaders, LineCounter) THREAD_COUNTS;
+BENCHMARK_TEMPLATE(BM_WriterAndReaders, PairCounter) THREAD_COUNTS;
+
+int main(int argc, char** argv) {
+    return run_experiments(argc, argv);
+}
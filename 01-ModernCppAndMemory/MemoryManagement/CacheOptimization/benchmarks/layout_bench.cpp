@@ -0,0 +1,99 @@
+#include "../include/book_layouts.h"
+#include "../include/experiment_counters.h"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+
+constexpr size_t UPDATES_PER_ITERATION = 1 << 14;
+
+// Updates spread uniformly over the book, so larger books fall out of cache
+static std::vector<LevelUpdate> make_updates(size_t levels) {
+    std::mt19937_64 rng(levels);
+    std::vector<LevelUpdate> updates(UPDATES_PER_ITERATION);
+    uint64_t timestamp = 0;
+    for (auto& update : updates) {
+        update.level = static_cast<uint32_t>(rng() % levels);
+        update.order_delta = (rng() & 1) ? 1 : -1;
+        update.quantity_delta = static_cast<int64_t>(rng() % 200) - 100;
+        update.timestamp_ns = timestamp += 250;
+    }
+    return updates;
+}
+
+// Applies a stream of level updates; each touches three fields of one level
+template <typename Book>
+static void BM_LevelUpdate(benchmark::State& state) {
+    const size_t levels = static_cast<size_t>(state.range(0));
+    Book book(levels);
+    const auto updates = make_updates(levels);
+
+    ExperimentCounters counters;
+    counters.start();
+    for (auto _ : state) {
+        for (const LevelUpdate& update : updates) {
+            book.apply(update);
+        }
+        benchmark::ClobberMemory();
+    }
+    counters.stop(state, static_cast<double>(state.iterations() * updates.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * updates.size()));
+}
+
+// Sums the quantity of every level; reads one field of each
+template <typename Book>
+static void BM_DepthScan(benchmark::State& state) {
+    const size_t levels = static_cast<size_t>(state.range(0));
+    Book book(levels);
+    for (const LevelUpdate& update : make_updates(levels)) {
+        book.apply(update);
+    }
+
+    ExperimentCounters counters;
+    counters.start();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.depth(levels));
+    }
+    counters.stop(state, static_cast<double>(state.iterations() * levels));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * levels));
+}
+
+// The feed handler's loop: apply an update, then recompute the top-of-book depth it affects
+template <typename Book>
+static void BM_UpdateAndTopDepth(benchmark::State& state) {
+    const size_t levels = static_cast<size_t>(state.range(0));
+    constexpr size_t TOP_LEVELS = 16;
+    Book book(levels);
+    const auto updates = make_updates(levels);
+
+    ExperimentCounters counters;
+    counters.start();
+    for (auto _ : state) {
+        int64_t total = 0;
+        for (const LevelUpdate& update : updates) {
+            book.apply(update);
+            total += book.depth(TOP_LEVELS);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    counters.stop(state, static_cast<double>(state.iterations() * updates.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * updates.size()));
+}
+
+// 1K levels fit in L1/L2, 16K in L2/L3, 256K (12 MiB) mostly in memory
+#define LAYOUT_SIZES ->Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18)
+
+BENCHMARK_TEMPLATE(BM_LevelUpdate, AosBook) LAYOUT_SIZES;
+BENCHMARK_TEMPLATE(BM_LevelUpdate, SoaBook) LAYOUT_SIZES;
+BENCHMARK_TEMPLATE(BM_LevelUpdate, AosoaBook<8>) LAYOUT_SIZES;
+
+BENCHMARK_TEMPLATE(BM_DepthScan, AosBook) LAYOUT_SIZES;
+BENCHMARK_TEMPLATE(BM_DepthScan, SoaBook) LAYOUT_SIZES;
+BENCHMARK_TEMPLATE(BM_DepthScan, AosoaBook<8>) LAYOUT_SIZES;
+
+BENCHMARK_TEMPLATE(BM_UpdateAndTopDepth, AosBook) LAYOUT_SIZES;
+BENCHMARK_TEMPLATE(BM_UpdateAndTopDepth, SoaBook) LAYOUT_SIZES;
+BENCHMARK_TEMPLATE(BM_UpdateAndTopDepth, AosoaBook<8>) LAYOUT_SIZES;
+
+int main(int argc, char** argv) {
+    return run_experiments(argc, argv);
+}
@@ -0,0 +1,87 @@
+#include "../include/prefetch_workloads.h"
+#include "../include/experiment_counters.h"
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 32 MiB of values and 16 MiB of list nodes: well past the last-level cache
+constexpr size_t NUM_VALUES = 4 << 20;
+constexpr size_t NUM_GATHERS = 1 << 20;
+constexpr size_t CHAIN_LENGTH = 256 << 10;
+
+struct SharedData {
+    std::vector<uint64_t> values;
+    std::vector<uint32_t> indices;
+
+    SharedData() : values(NUM_VALUES), indices(NUM_GATHERS) {
+        std::mt19937_64 rng(3);
+        for (auto& value : values) {
+            value = rng() & 0xFFFF;
+        }
+        for (auto& index : indices) {
+            index = static_cast<uint32_t>(rng() % NUM_VALUES);
+        }
+    }
+};
+
+static const SharedData& shared_data() {
+    static const SharedData data;
+    return data;
+}
+
+template <size_t Distance>
+static void BM_ArrayScan(benchmark::State& state) {
+    const auto& values = shared_data().values;
+    ExperimentCounters counters;
+    counters.start();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sum_array<Distance>(values));
+    }
+    counters.stop(state, static_cast<double>(state.iterations() * values.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+}
+
+template <size_t Distance>
+static void BM_Gather(benchmark::State& state) {
+    const auto& data = shared_data();
+    ExperimentCounters counters;
+    counters.start();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sum_gather<Distance>(data.values, data.indices));
+    }
+    counters.stop(state, static_cast<double>(state.iterations() * data.indices.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.indices.size()));
+}
+
+template <size_t Distance>
+static void BM_PointerChase(benchmark::State& state) {
+    const Chain chain(CHAIN_LENGTH, Distance);
+    ExperimentCounters counters;
+    counters.start();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sum_chain<Distance>(chain.head()));
+    }
+    counters.stop(state, static_cast<double>(state.iterations() * CHAIN_LENGTH));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * CHAIN_LENGTH));
+}
+
+template <size_t Distance>
+static void register_distance() {
+    const std::string suffix = "/distance:" + std::to_string(Distance);
+    benchmark::RegisterBenchmark(("BM_ArrayScan" + suffix).c_str(), BM_ArrayScan<Distance>);
+    benchmark::RegisterBenchmark(("BM_Gather" + suffix).c_str(), BM_Gather<Distance>);
+    benchmark::RegisterBenchmark(("BM_PointerChase" + suffix).c_str(), BM_PointerChase<Distance>);
+}
+
+template <size_t... Distances>
+static void register_sweep(std::index_sequence<Distances...>) {
+    (register_distance<Distances>(), ...);
+}
+
+int main(int argc, char** argv) {
+    // Distances in elements; 0 is the no-prefetch baseline
+    register_sweep(std::index_sequence<0, 1, 2, 4, 8, 16, 32, 64>{});
+    return run_experiments(argc, argv);
+}
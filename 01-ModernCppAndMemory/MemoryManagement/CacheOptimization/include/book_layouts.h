@@ -0,0 +1,188 @@
+/**
+ * @file book_layouts.h
+ * @brief One price-level table in three memory layouts
+ *
+ * The same book, with the same operations, stored three ways:
+ *  - AosBook: an array of Level structs. An update touches one or two cache
+ *    lines, but a scan of one field drags every other field through the cache.
+ *  - SoaBook: one array per field. A scan of quantities reads only
+ *    quantities, but an update writes to three separate arrays.
+ *  - AosoaBook: blocks of Lanes levels, each block stored field by field. An
+ *    update stays within one block, and a scan still reads runs of one field.
+ *
+ * The experiments apply the same update stream to each and compare.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "concurrency_primitives.h"
+
+// The fields of one price level, as the feed handler keeps them
+struct Level {
+    int64_t price = 0;
+    int64_t quantity = 0;
+    int64_t implied_quantity = 0;
+    uint64_t last_update_ns = 0;
+    uint64_t sequence = 0;
+    uint32_t order_count = 0;
+    uint32_t flags = 0;
+};
+
+// One market-data event: a change to the quantity resting at a level
+struct LevelUpdate {
+    uint32_t level;
+    int32_t order_delta;
+    int64_t quantity_delta;
+    uint64_t timestamp_ns;
+};
+
+class AosBook {
+public:
+    explicit AosBook(size_t levels) : levels_(levels) {
+        for (size_t i = 0; i < levels; ++i) {
+            levels_[i].price = static_cast<int64_t>(10000 + i);
+        }
+    }
+
+    void apply(const LevelUpdate& update) noexcept {
+        Level& level = levels_[update.level];
+        level.quantity += update.quantity_delta;
+        level.order_count += static_cast<uint32_t>(update.order_delta);
+        level.last_update_ns = update.timestamp_ns;
+    }
+
+    // Total quantity across the first n levels
+    int64_t depth(size_t n) const noexcept {
+        int64_t total = 0;
+        for (size_t i = 0; i < n; ++i) {
+            total += levels_[i].quantity;
+        }
+        return total;
+    }
+
+    Level level(size_t index) const noexcept {
+        return levels_[index];
+    }
+
+    size_t size() const noexcept {
+        return levels_.size();
+    }
+
+private:
+    std::vector<Level> levels_;
+};
+
+class SoaBook {
+public:
+    explicit SoaBook(size_t levels)
+        : price_(levels),
+          quantity_(levels),
+          implied_quantity_(levels),
+          last_update_ns_(levels),
+          sequence_(levels),
+          order_count_(levels),
+          flags_(levels) {
+        for (size_t i = 0; i < levels; ++i) {
+            price_[i] = static_cast<int64_t>(10000 + i);
+        }
+    }
+
+    void apply(const LevelUpdate& update) noexcept {
+        quantity_[update.level] += update.quantity_delta;
+        order_count_[update.level] += static_cast<uint32_t>(update.order_delta);
+        last_update_ns_[update.level] = update.timestamp_ns;
+    }
+
+    int64_t depth(size_t n) const noexcept {
+        int64_t total = 0;
+        for (size_t i = 0; i < n; ++i) {
+            total += quantity_[i];
+        }
+        return total;
+    }
+
+    Level level(size_t index) const noexcept {
+        return Level{price_[index],          quantity_[index], implied_quantity_[index], last_update_ns_[index],
+                     sequence_[index],       order_count_[index], flags_[index]};
+    }
+
+    size_t size() const noexcept {
+        return price_.size();
+    }
+
+private:
+    std::vector<int64_t> price_;
+    std::vector<int64_t> quantity_;
+    std::vector<int64_t> implied_quantity_;
+    std::vector<uint64_t> last_update_ns_;
+    std::vector<uint64_t> sequence_;
+    std::vector<uint32_t> order_count_;
+    std::vector<uint32_t> flags_;
+};
+
+/**
+ * @tparam Lanes Levels per block; 8 puts each 8-byte field run on exactly one cache line
+ */
+template <size_t Lanes = 8>
+class AosoaBook {
+    static_assert(Lanes > 0 && (Lanes & (Lanes - 1)) == 0, "Lanes must be a power of 2");
+
+    struct alignas(CACHE_LINE_SIZE) Block {
+        int64_t price[Lanes];
+        int64_t quantity[Lanes];
+        int64_t implied_quantity[Lanes];
+        uint64_t last_update_ns[Lanes];
+        uint64_t sequence[Lanes];
+        uint32_t order_count[Lanes];
+        uint32_t flags[Lanes];
+    };
+
+public:
+    explicit AosoaBook(size_t levels) : blocks_((levels + Lanes - 1) / Lanes), size_(levels) {
+        for (size_t i = 0; i < levels; ++i) {
+            blocks_[i / Lanes].price[i % Lanes] = static_cast<int64_t>(10000 + i);
+        }
+    }
+
+    void apply(const LevelUpdate& update) noexcept {
+        Block& block = blocks_[update.level / Lanes];
+        const size_t lane = update.level % Lanes;
+        block.quantity[lane] += update.quantity_delta;
+        block.order_count[lane] += static_cast<uint32_t>(update.order_delta);
+        block.last_update_ns[lane] = update.timestamp_ns;
+    }
+
+    int64_t depth(size_t n) const noexcept {
+        int64_t total = 0;
+        const size_t full = n / Lanes;
+        for (size_t b = 0; b < full; ++b) {
+            for (size_t lane = 0; lane < Lanes; ++lane) {
+                total += blocks_[b].quantity[lane];
+            }
+        }
+        for (size_t lane = 0; lane < n % Lanes; ++lane) {
+            total += blocks_[full].quantity[lane];
+        }
+        return total;
+    }
+
+    Level level(size_t index) const noexcept {
+        const Block& block = blocks_[index / Lanes];
+        const size_t lane = index % Lanes;
+        return Level{block.price[lane],    block.quantity[lane],    block.implied_quantity[lane],
+                     block.last_update_ns[lane], block.sequence[lane], block.order_count[lane],
+                     block.flags[lane]};
+    }
+
+    size_t size() const noexcept {
+        return size_;
+    }
+
+private:
+    std::vector<Block> blocks_;
+    size_t size_;
+};
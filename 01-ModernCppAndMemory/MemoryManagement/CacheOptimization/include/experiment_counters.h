@@ -0,0 +1,92 @@
+/**
+ * @file experiment_counters.h
+ * @brief Reports cycles/op and PMU counters/op for a Google Benchmark loop
+ *
+ * Every experiment reports:
+ *  - tsc_per_op: TSC ticks per operation. This is always available and
+ *    counts at a constant rate, so it tracks wall time, not core clock.
+ *  - cycles_per_op, instr_per_op, l1d_miss_per_op, llc_miss_per_op,
+ *    dtlb_miss_per_op and br_miss_per_op, for the events this machine can
+ *    count. See perf_counters.h.
+ *
+ * Counters are per thread. Each thread of a ->Threads(n) run measures
+ * itself, and the counters are averaged across threads. Threaded
+ * experiments pin each thread with pin_current_thread() (thread_affinity.h).
+ */
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+
+#include "perf_counters.h"
+#include "thread_affinity.h"
+#include "tsc_clock.h"
+
+class ExperimentCounters {
+public:
+    ExperimentCounters() = default;
+
+    ExperimentCounters(const ExperimentCounters&) = delete;
+    ExperimentCounters& operator=(const ExperimentCounters&) = delete;
+
+    void start() noexcept {
+        pmu_.start();
+        start_tsc_ = read_tsc();
+    }
+
+    /**
+     * @brief Stops counting and adds the per-operation counters to state
+     *
+     * @param operations Operations this thread performed between start() and stop()
+     */
+    void stop(benchmark::State& state, double operations) {
+        const uint64_t ticks = read_tsc() - start_tsc_;
+        pmu_.stop();
+        if (operations <= 0) {
+            return;
+        }
+
+        const auto per_op = [&](double value) {
+            return benchmark::Counter(value / operations, benchmark::Counter::kAvgThreads);
+        };
+        state.counters["tsc_per_op"] = per_op(static_cast<double>(ticks));
+
+        static constexpr struct {
+            const char* event;
+            const char* counter;
+        } NAMES[] = {
+            {"cycles", "cycles_per_op"},          {"instructions", "instr_per_op"},
+            {"l1d_misses", "l1d_miss_per_op"},    {"llc_misses", "llc_miss_per_op"},
+            {"dtlb_misses", "dtlb_miss_per_op"},  {"branch_misses", "br_miss_per_op"},
+        };
+        for (const auto& name : NAMES) {
+            if (auto value = pmu_.find(name.event)) {
+                state.counters[name.counter] = per_op(static_cast<double>(*value));
+            }
+        }
+    }
+
+    bool pmu_available() const noexcept {
+        return pmu_.available();
+    }
+
+private:
+    PerfCounters pmu_;
+    uint64_t start_tsc_ = 0;
+};
+
+/**
+ * @brief BENCHMARK_MAIN() for experiments that register benchmarks at runtime before running
+ */
+inline int run_experiments(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file perf_counters.h
+ * @brief Hardware performance counters for the calling thread via perf_event_open
+ *
+ * Opens a set of events as one perf group, so they are scheduled together
+ * and read atomically, and scales the readings if the kernel had to
+ * multiplex the group. Events the machine cannot count are skipped: a VM
+ * without a virtual PMU, a container without perf access, or a non-Linux
+ * build. Callers check available(), or find() for a single event, and fall
+ * back to TSC timing alone.
+ *
+ * Counting user space only needs /proc/sys/kernel/perf_event_paranoid <= 2.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+/**
+ * @brief One countable event, as perf_event_attr's type and config
+ */
+struct PerfEvent {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+};
+
+#ifdef __linux__
+namespace perf_events {
+
+constexpr uint64_t cache_event(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+inline constexpr PerfEvent CYCLES{"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES};
+inline constexpr PerfEvent INSTRUCTIONS{"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS};
+inline constexpr PerfEvent L1D_MISSES{
+    "l1d_misses", PERF_TYPE_HW_CACHE,
+    cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)};
+inline constexpr PerfEvent LLC_MISSES{"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES};
+inline constexpr PerfEvent DTLB_MISSES{
+    "dtlb_misses", PERF_TYPE_HW_CACHE,
+    cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)};
+inline constexpr PerfEvent BRANCH_MISSES{"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES};
+inline constexpr PerfEvent PAGE_FAULTS{"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS};
+
+}  // namespace perf_events
+
+// The set the cache experiments report
+inline const std::initializer_list<PerfEvent> DEFAULT_PERF_EVENTS = {
+    perf_events::CYCLES,     perf_events::INSTRUCTIONS, perf_events::L1D_MISSES,
+    perf_events::LLC_MISSES, perf_events::DTLB_MISSES,  perf_events::BRANCH_MISSES,
+};
+#else
+inline const std::initializer_list<PerfEvent> DEFAULT_PERF_EVENTS = {};
+#endif
+
+class PerfCounters {
+public:
+    struct Reading {
+        const char* name;
+        uint64_t value;  // Scaled up if the group was only counting part of the time
+    };
+
+    /**
+     * @brief Opens the events for the calling thread; they count only between start() and stop()
+     */
+    explicit PerfCounters(std::initializer_list<PerfEvent> events = DEFAULT_PERF_EVENTS) {
+#ifdef __linux__
+        for (const PerfEvent& event : events) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = event.type;
+            attr.config = event.config;
+            attr.disabled = leader_ < 0 ? 1 : 0;  // Members follow the leader
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+            if (fd < 0) {
+                continue;  // Not countable here
+            }
+            if (leader_ < 0) {
+                leader_ = fd;
+            }
+            fds_.push_back(fd);
+            names_.push_back(event.name);
+        }
+#else
+        (void)events;
+#endif
+    }
+
+    ~PerfCounters() {
+#ifdef __linux__
+        for (int fd : fds_) {
+            ::close(fd);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief True if at least one event could be opened
+     */
+    bool available() const noexcept {
+        return !fds_.empty();
+    }
+
+    void start() noexcept {
+#ifdef __linux__
+        if (leader_ >= 0) {
+            ::ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ::ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    /**
+     * @brief Stops counting and returns the events that were counted
+     */
+    const std::vector<Reading>& stop() {
+        readings_.clear();
+#ifdef __linux__
+        if (leader_ < 0) {
+            return readings_;
+        }
+        ::ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+        // nr, time_enabled, time_running, then one value per event
+        std::vector<uint64_t> buffer(3 + fds_.size());
+        const ssize_t bytes = ::read(leader_, buffer.data(), buffer.size() * sizeof(uint64_t));
+        if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+            return readings_;
+        }
+        const uint64_t count = std::min<uint64_t>(buffer[0], fds_.size());
+        const uint64_t enabled = buffer[1];
+        const uint64_t running = buffer[2];
+        const double scale = running > 0 && running < enabled ? static_cast<double>(enabled) / running : 1.0;
+        for (uint64_t i = 0; i < count; ++i) {
+            readings_.push_back(Reading{names_[i], static_cast<uint64_t>(static_cast<double>(buffer[3 + i]) * scale)});
+        }
+#endif
+        return readings_;
+    }
+
+    /**
+     * @brief The last stop()'s value for an event, if it was counted
+     */
+    std::optional<uint64_t> find(std::string_view name) const noexcept {
+        for (const Reading& reading : readings_) {
+            if (name == reading.name) {
+                return reading.value;
+            }
+        }
+        return std::nullopt;
+    }
+
+private:
+    int leader_ = -1;
+    std::vector<int> fds_;
+    std::vector<const char*> names_;
+    std::vector<Reading> readings_;
+};
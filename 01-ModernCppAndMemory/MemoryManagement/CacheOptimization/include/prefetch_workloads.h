@@ -0,0 +1,116 @@
+/**
+ * @file prefetch_workloads.h
+ * @brief Memory walks with a software prefetch distance as a template parameter
+ *
+ * Three access patterns, each prefetching Distance elements ahead (0 means no
+ * prefetch):
+ *  - sum_array: a sequential scan, which the hardware prefetcher already
+ *    handles, so software prefetch mostly adds instructions.
+ *  - sum_gather: reads values[indices[i]] for random indices. The addresses
+ *    are known ahead of time but the hardware cannot predict them.
+ *  - sum_chain: walks a linked list laid out in random order. The next
+ *    address is only known once the current node arrives, so each node also
+ *    carries a jump pointer Distance nodes ahead.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "concurrency_primitives.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Hint a read of the line holding address into all cache levels
+inline void prefetch_read(const void* address) noexcept {
+#if defined(_MSC_VER)
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    __builtin_prefetch(address, 0, 3);
+#endif
+}
+
+template <size_t Distance>
+uint64_t sum_array(const std::vector<uint64_t>& values) noexcept {
+    uint64_t total = 0;
+    const size_t n = values.size();
+    for (size_t i = 0; i < n; ++i) {
+        if constexpr (Distance > 0) {
+            // Distance is in elements; clamp at the end rather than read past it
+            prefetch_read(&values[std::min(i + Distance, n - 1)]);
+        }
+        total += values[i];
+    }
+    return total;
+}
+
+template <size_t Distance>
+uint64_t sum_gather(const std::vector<uint64_t>& values, const std::vector<uint32_t>& indices) noexcept {
+    uint64_t total = 0;
+    const size_t n = indices.size();
+    for (size_t i = 0; i < n; ++i) {
+        if constexpr (Distance > 0) {
+            if (i + Distance < n) {
+                prefetch_read(&values[indices[i + Distance]]);
+            }
+        }
+        total += values[indices[i]];
+    }
+    return total;
+}
+
+// One list node per cache line, so every hop is a new line
+struct alignas(CACHE_LINE_SIZE) ChainNode {
+    ChainNode* next = nullptr;
+    ChainNode* jump = nullptr;  // The node Distance hops ahead, for prefetching
+    uint64_t value = 0;
+};
+
+/**
+ * @brief A linked list threaded through a pool in random order
+ */
+class Chain {
+public:
+    Chain(size_t length, size_t jump_distance, uint64_t seed = 1) : nodes_(length) {
+        std::vector<uint32_t> order(length);
+        std::iota(order.begin(), order.end(), 0u);
+        std::shuffle(order.begin(), order.end(), std::mt19937_64(seed));
+        for (size_t i = 0; i < length; ++i) {
+            ChainNode& node = nodes_[order[i]];
+            node.value = i;
+            node.next = i + 1 < length ? &nodes_[order[i + 1]] : nullptr;
+            node.jump = i + jump_distance < length ? &nodes_[order[i + jump_distance]] : nullptr;
+        }
+        head_ = length > 0 ? &nodes_[order[0]] : nullptr;
+    }
+
+    const ChainNode* head() const noexcept {
+        return head_;
+    }
+
+private:
+    std::vector<ChainNode> nodes_;
+    ChainNode* head_ = nullptr;
+};
+
+template <size_t Distance>
+uint64_t sum_chain(const ChainNode* node) noexcept {
+    uint64_t total = 0;
+    while (node != nullptr) {
+        if constexpr (Distance > 0) {
+            if (node->jump != nullptr) {
+                prefetch_read(node->jump);
+            }
+        }
+        total += node->value;
+        node = node->next;
+    }
+    return total;
+}
@@ -0,0 +1,179 @@
+#include "../include/book_layouts.h"
+#include "../include/perf_counters.h"
+#include "../include/prefetch_workloads.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+std::vector<LevelUpdate> random_updates(size_t levels, size_t count) {
+    std::mt19937_64 rng(7);
+    std::vector<LevelUpdate> updates(count);
+    for (size_t i = 0; i < count; ++i) {
+        updates[i] = LevelUpdate{static_cast<uint32_t>(rng() % levels), (rng() & 1) ? 1 : -1,
+                                 static_cast<int64_t>(rng() % 200) - 100, i};
+    }
+    return updates;
+}
+
+bool same_level(const Level& a, const Level& b) {
+    return a.price == b.price && a.quantity == b.quantity && a.implied_quantity == b.implied_quantity &&
+           a.last_update_ns == b.last_update_ns && a.sequence == b.sequence && a.order_count == b.order_count &&
+           a.flags == b.flags;
+}
+
+}  // namespace
+
+// Test that a level packs into 48 bytes and an AoSoA block fills whole cache lines
+TEST(BookLayoutTest, Sizes) {
+    EXPECT_EQ(sizeof(Level), 48u);
+    EXPECT_EQ(AosoaBook<8>(1).size(), 1u);
+    EXPECT_EQ(AosoaBook<8>(13).size(), 13u);
+}
+
+// Test that all three layouts hold the same book after the same updates
+TEST(BookLayoutTest, LayoutsAgree) {
+    constexpr size_t LEVELS = 203;  // Not a multiple of the AoSoA lane count
+    AosBook aos(LEVELS);
+    SoaBook soa(LEVELS);
+    AosoaBook<8> aosoa(LEVELS);
+    AosoaBook<4> narrow(LEVELS);
+
+    for (const LevelUpdate& update : random_updates(LEVELS, 5000)) {
+        aos.apply(update);
+        soa.apply(update);
+        aosoa.apply(update);
+        narrow.apply(update);
+    }
+
+    for (size_t i = 0; i < LEVELS; ++i) {
+        EXPECT_TRUE(same_level(aos.level(i), soa.level(i))) << "level " << i;
+        EXPECT_TRUE(same_level(aos.level(i), aosoa.level(i))) << "level " << i;
+        EXPECT_TRUE(same_level(aos.level(i), narrow.level(i))) << "level " << i;
+    }
+    for (size_t n : {size_t{0}, size_t{1}, size_t{7}, size_t{8}, size_t{9}, size_t{64}, LEVELS}) {
+        EXPECT_EQ(aos.depth(n), soa.depth(n)) << "depth " << n;
+        EXPECT_EQ(aos.depth(n), aosoa.depth(n)) << "depth " << n;
+        EXPECT_EQ(aos.depth(n), narrow.depth(n)) << "depth " << n;
+    }
+}
+
+// Test that an update touches only quantity, order count and timestamp
+TEST(BookLayoutTest, ApplyUpdatesOneLevel) {
+    SoaBook book(16);
+    book.apply(LevelUpdate{3, 2, 500, 1234});
+    book.apply(LevelUpdate{3, -1, -200, 5678});
+
+    const Level level = book.level(3);
+    EXPECT_EQ(level.price, 10003);
+    EXPECT_EQ(level.quantity, 300);
+    EXPECT_EQ(level.order_count, 1u);
+    EXPECT_EQ(level.last_update_ns, 5678u);
+    EXPECT_EQ(book.depth(16), 300);
+    EXPECT_EQ(book.level(2).quantity, 0);
+}
+
+// Test that prefetching never changes the result, including distances past the end
+TEST(PrefetchWorkloadTest, SumsIndependentOfDistance) {
+    std::vector<uint64_t> values(1000);
+    std::vector<uint32_t> indices(500);
+    std::mt19937_64 rng(11);
+    for (auto& value : values) {
+        value = rng() % 1000;
+    }
+    for (auto& index : indices) {
+        index = static_cast<uint32_t>(rng() % values.size());
+    }
+
+    const uint64_t array = sum_array<0>(values);
+    EXPECT_EQ(sum_array<8>(values), array);
+    EXPECT_EQ(sum_array<4096>(values), array);
+
+    const uint64_t gather = sum_gather<0>(values, indices);
+    EXPECT_EQ(sum_gather<4>(values, indices), gather);
+    EXPECT_EQ(sum_gather<4096>(values, indices), gather);
+}
+
+// Test that the chain visits every node once, in its shuffled order
+TEST(PrefetchWorkloadTest, ChainVisitsEveryNode) {
+    constexpr size_t LENGTH = 1000;
+    const uint64_t expected = LENGTH * (LENGTH - 1) / 2;
+
+    const Chain plain(LENGTH, 0);
+    EXPECT_EQ(sum_chain<0>(plain.head()), expected);
+
+    const Chain jumps(LENGTH, 8);
+    EXPECT_EQ(sum_chain<8>(jumps.head()), expected);
+
+    // The jump pointer really is 8 hops ahead
+    const ChainNode* node = jumps.head();
+    const ChainNode* ahead = node;
+    for (int i = 0; i < 8; ++i) {
+        ahead = ahead->next;
+    }
+    EXPECT_EQ(node->jump, ahead);
+
+    EXPECT_EQ(sum_chain<4>(Chain(0, 4).head()), 0u);
+}
+
+#ifdef __linux__
+// Test that a software event counts, so the group machinery works even without a PMU
+TEST(PerfCountersTest, CountsPageFaults) {
+    PerfCounters counters({perf_events::PAGE_FAULTS});
+    if (!counters.available()) {
+        GTEST_SKIP() << "perf_event_open is not permitted here";
+    }
+
+    constexpr size_t PAGES = 64;
+    const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    void* memory = ::mmap(nullptr, PAGES * page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT_NE(memory, MAP_FAILED);
+
+    counters.start();
+    auto* bytes = static_cast<volatile unsigned char*>(memory);
+    for (size_t i = 0; i < PAGES; ++i) {
+        bytes[i * page] = 1;
+    }
+    counters.stop();
+    ::munmap(memory, PAGES * page);
+
+    const auto faults = counters.find("page_faults");
+    ASSERT_TRUE(faults.has_value());
+    EXPECT_GE(*faults, PAGES / 2);  // Fault-around or huge pages may merge some
+}
+
+// Test that a group of hardware and software events still counts what it can
+TEST(PerfCountersTest, SkipsUncountableEvents) {
+    PerfCounters counters({perf_events::CYCLES, perf_events::PAGE_FAULTS, perf_events::DTLB_MISSES});
+    if (!counters.available()) {
+        GTEST_SKIP() << "perf_event_open is not permitted here";
+    }
+
+    counters.start();
+    std::vector<unsigned char> buffer(1 << 20);
+    std::memset(buffer.data(), 1, buffer.size());
+    const auto& readings = counters.stop();
+
+    EXPECT_FALSE(readings.empty());
+    EXPECT_FALSE(counters.find("no_such_event").has_value());
+    for (const auto& reading : readings) {
+        EXPECT_TRUE(counters.find(reading.name).has_value());
+    }
+}
+
+// Test that an event the kernel rejects leaves the counters empty but usable
+TEST(PerfCountersTest, InvalidEventIsSkipped) {
+    PerfCounters counters({PerfEvent{"bogus", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_MAX}});
+    EXPECT_FALSE(counters.available());
+
+    counters.start();
+    EXPECT_TRUE(counters.stop().empty());
+    EXPECT_FALSE(counters.find("bogus").has_value());
+}
+#endif
@@ -0,0 +1,139 @@
+#include "../include/arena.h"
+#include "queue_benchmarks.h"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A synthetic market-data packet: a count, then per update a length-prefixed
+// symbol followed by price, quantity and side
+using Packet = std::vector<unsigned char>;
+
+constexpr size_t NUM_PACKETS = 256;
+
+template <typename T>
+void put(Packet& packet, T value) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+    packet.insert(packet.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+T get(const unsigned char*& cursor) {
+    T value;
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return value;
+}
+
+std::vector<Packet> make_packets(size_t updates_per_packet) {
+    std::mt19937 rng(42);
+    std::vector<Packet> packets(NUM_PACKETS);
+    for (Packet& packet : packets) {
+        put<uint16_t>(packet, static_cast<uint16_t>(updates_per_packet));
+        for (size_t i = 0; i < updates_per_packet; ++i) {
+            // Option-style symbols, longer than the small-string buffer
+            std::string symbol = "XNAS:ACME " + std::to_string(240000 + rng() % 1000) + " C" +
+                                 std::to_string(100 + rng() % 50);
+            put<uint8_t>(packet, static_cast<uint8_t>(symbol.size()));
+            packet.insert(packet.end(), symbol.begin(), symbol.end());
+            put<int64_t>(packet, static_cast<int64_t>(1000000 + rng() % 10000));
+            put<uint32_t>(packet, static_cast<uint32_t>(1 + rng() % 500));
+            put<char>(packet, rng() % 2 ? 'B' : 'S');
+        }
+    }
+    return packets;
+}
+
+template <typename String>
+struct Update {
+    String symbol;
+    int64_t price;
+    uint32_t quantity;
+    char side;
+};
+
+// Decodes into a growing vector of updates, one string per symbol, the way
+// straightforward decoding code would; make_string builds the symbol
+template <typename Vector, typename MakeString>
+void decode(const Packet& packet, Vector& updates, MakeString make_string) {
+    const unsigned char* cursor = packet.data();
+    auto count = get<uint16_t>(cursor);
+    for (uint16_t i = 0; i < count; ++i) {
+        auto length = get<uint8_t>(cursor);
+        auto symbol = make_string(std::string_view(reinterpret_cast<const char*>(cursor), length));
+        cursor += length;
+        auto price = get<int64_t>(cursor);
+        auto quantity = get<uint32_t>(cursor);
+        auto side = get<char>(cursor);
+        updates.push_back({std::move(symbol), price, quantity, side});
+    }
+}
+
+template <typename Vector>
+int64_t consume(const Vector& updates) {
+    int64_t sum = 0;
+    for (const auto& update : updates) {
+        sum += update.price * update.quantity + update.symbol.back();
+    }
+    return sum;
+}
+
+// Every temporary comes from the global heap and is freed one by one
+static void BM_DecodeDefault(benchmark::State& state) {
+    auto packets = make_packets(static_cast<size_t>(state.range(0)));
+    size_t next = 0;
+
+    for (auto _ : state) {
+        std::vector<Update<std::string>> updates;
+        decode(packets[next++ % NUM_PACKETS], updates, [](std::string_view symbol) { return std::string(symbol); });
+        benchmark::DoNotOptimize(consume(updates));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Standard-library baseline: a monotonic resource over a reused buffer, released per packet
+static void BM_DecodeMonotonic(benchmark::State& state) {
+    auto packets = make_packets(static_cast<size_t>(state.range(0)));
+    auto buffer = std::make_unique<std::array<std::byte, 1 << 20>>();
+    std::pmr::monotonic_buffer_resource resource(buffer->data(), buffer->size());
+    size_t next = 0;
+
+    for (auto _ : state) {
+        {
+            std::pmr::vector<Update<std::pmr::string>> updates(&resource);
+            decode(packets[next++ % NUM_PACKETS], updates,
+                   [&](std::string_view symbol) { return std::pmr::string(symbol, &resource); });
+            benchmark::DoNotOptimize(consume(updates));
+        }
+        resource.release();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The arena: every temporary of a packet is freed by one rewind
+static void BM_DecodeArena(benchmark::State& state) {
+    auto packets = make_packets(static_cast<size_t>(state.range(0)));
+    Arena arena;
+    ArenaMemoryResource resource(arena);
+    size_t next = 0;
+
+    for (auto _ : state) {
+        ArenaScope scope(arena);
+        std::pmr::vector<Update<std::pmr::string>> updates(&resource);
+        decode(packets[next++ % NUM_PACKETS], updates,
+               [&](std::string_view symbol) { return std::pmr::string(symbol, &resource); });
+        benchmark::DoNotOptimize(consume(updates));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_DecodeDefault)->Arg(8)->Arg(64);
+BENCHMARK(BM_DecodeMonotonic)->Arg(8)->Arg(64);
+BENCHMARK(BM_DecodeArena)->Arg(8)->Arg(64);
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
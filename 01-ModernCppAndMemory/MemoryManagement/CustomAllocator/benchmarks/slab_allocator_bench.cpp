@@ -0,0 +1,207 @@
+#include "../include/slab_allocator.h"
+#include "ring_buffer.h"
+#include "queue_benchmarks.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+// Allocators under test, behind one allocate/deallocate interface
+
+struct MallocBackend {
+    void* allocate(size_t bytes) { return std::malloc(bytes); }
+    void deallocate(void* block, size_t) { std::free(block); }
+};
+
+// Size-class pools behind a mutex: the standard library's take on a pooling allocator
+struct SynchronizedPoolBackend {
+    std::pmr::synchronized_pool_resource resource;
+    void* allocate(size_t bytes) { return resource.allocate(bytes); }
+    void deallocate(void* block, size_t bytes) { resource.deallocate(block, bytes); }
+};
+
+struct SlabBackend {
+    SlabMemoryResource resource;
+    void* allocate(size_t bytes) { return resource.allocate_block(bytes); }
+    void deallocate(void* block, size_t bytes) { resource.deallocate_block(block, bytes); }
+};
+
+constexpr size_t QUEUE_CAPACITY = 1024;
+
+// Writes every byte, as a producer filling a real message would
+void fill_message(void* block, size_t bytes, uint64_t seq) {
+    std::memset(block, static_cast<int>(seq & 0xFF), bytes);
+    std::memcpy(block, &seq, sizeof(seq));
+}
+
+uint64_t read_message(const void* block, size_t bytes) {
+    uint64_t seq;
+    std::memcpy(&seq, block, sizeof(seq));
+    return seq + static_cast<const unsigned char*>(block)[bytes - 1];
+}
+
+/**
+ * @brief Runs one producer and one consumer thread for the sustained duration
+ *
+ * produce(seq) returns false when it cannot make progress; consume() returns
+ * false when there is nothing to read. after() runs once both threads have
+ * stopped, to free anything still in flight.
+ */
+template <typename Produce, typename Consume, typename After>
+void run_producer_consumer(benchmark::State& state, size_t bytes, Produce produce, Consume consume, After after) {
+    size_t total_consumed = 0;
+
+    for (auto _ : state) {
+        std::atomic<bool> stop(false);
+        std::atomic<bool> producer_done(false);
+        size_t consumed = 0;
+
+        auto start_time = std::chrono::steady_clock::now();
+        std::thread consumer([&]() {
+            queue_bench::pin_current_thread(1);
+            unsigned spins = 0;
+            while (true) {
+                if (consume()) {
+                    consumed++;
+                } else if (producer_done.load(std::memory_order_acquire)) {
+                    while (consume()) {
+                        consumed++;
+                    }
+                    break;
+                } else {
+                    queue_bench::relax(spins);
+                }
+            }
+        });
+        std::thread producer([&]() {
+            queue_bench::pin_current_thread(0);
+            unsigned spins = 0;
+            uint64_t seq = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (produce(seq)) {
+                    seq++;
+                } else {
+                    queue_bench::relax(spins);
+                }
+            }
+            producer_done.store(true, std::memory_order_release);
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(queue_bench::g_sustained.duration_ms));
+        stop.store(true, std::memory_order_relaxed);
+        producer.join();
+        consumer.join();
+        after();
+
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+        total_consumed += consumed;
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(total_consumed));
+    state.SetBytesProcessed(static_cast<int64_t>(total_consumed * bytes));
+}
+
+// Allocate and free a batch on one thread: the allocator's fast path
+template <typename Backend, size_t Bytes>
+static void BM_SameThread(benchmark::State& state) {
+    constexpr size_t BATCH = 64;
+    auto backend = std::make_unique<Backend>();
+    void* blocks[BATCH];
+
+    for (auto _ : state) {
+        for (void*& block : blocks) {
+            block = backend->allocate(Bytes);
+            benchmark::DoNotOptimize(block);
+        }
+        for (void* block : blocks) {
+            backend->deallocate(block, Bytes);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BATCH));
+}
+
+// The producer allocates and the consumer frees: every free is cross-thread
+template <typename Backend, size_t Bytes>
+static void BM_ConsumerFrees(benchmark::State& state) {
+    auto backend = std::make_unique<Backend>();
+    auto ring = std::make_unique<RingBuffer<void*, QUEUE_CAPACITY>>();
+
+    run_producer_consumer(state, Bytes,
+        [&](uint64_t seq) {
+            void* block = backend->allocate(Bytes);
+            fill_message(block, Bytes, seq);
+            if (!ring->try_enqueue(block)) {
+                backend->deallocate(block, Bytes);
+                return false;
+            }
+            return true;
+        },
+        [&]() {
+            void* block;
+            if (!ring->try_dequeue(block)) {
+                return false;
+            }
+            benchmark::DoNotOptimize(read_message(block, Bytes));
+            backend->deallocate(block, Bytes);
+            return true;
+        },
+        []() {});
+}
+
+// The consumer hands blocks back and the producer frees them: frees are local,
+// but the memory was last touched by the other core
+template <typename Backend, size_t Bytes>
+static void BM_ProducerFrees(benchmark::State& state) {
+    auto backend = std::make_unique<Backend>();
+    auto ring = std::make_unique<RingBuffer<void*, QUEUE_CAPACITY>>();
+    // The producer empties this before every allocation, so at most QUEUE_CAPACITY + 1 blocks are out
+    auto returns = std::make_unique<RingBuffer<void*, 2 * QUEUE_CAPACITY>>();
+
+    auto free_returns = [&]() {
+        void* block;
+        while (returns->try_dequeue(block)) {
+            backend->deallocate(block, Bytes);
+        }
+    };
+
+    run_producer_consumer(state, Bytes,
+        [&](uint64_t seq) {
+            free_returns();
+            void* block = backend->allocate(Bytes);
+            fill_message(block, Bytes, seq);
+            if (!ring->try_enqueue(block)) {
+                backend->deallocate(block, Bytes);
+                return false;
+            }
+            return true;
+        },
+        [&]() {
+            void* block;
+            if (!ring->try_dequeue(block)) {
+                return false;
+            }
+            benchmark::DoNotOptimize(read_message(block, Bytes));
+            while (!returns->try_enqueue(block)) {
+            }
+            return true;
+        },
+        free_returns);
+}
+
+#define REGISTER_ALLOCATOR(Backend, Bytes)                                                                             \
+    BENCHMARK_TEMPLATE(BM_SameThread, Backend, Bytes);                                                                 \
+    BENCHMARK_TEMPLATE(BM_ConsumerFrees, Backend, Bytes)->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond); \
+    BENCHMARK_TEMPLATE(BM_ProducerFrees, Backend, Bytes)->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond)
+
+REGISTER_ALLOCATOR(MallocBackend, 64);
+REGISTER_ALLOCATOR(SynchronizedPoolBackend, 64);
+REGISTER_ALLOCATOR(SlabBackend, 64);
+REGISTER_ALLOCATOR(MallocBackend, 512);
+REGISTER_ALLOCATOR(SynchronizedPoolBackend, 512);
+REGISTER_ALLOCATOR(SlabBackend, 512);
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
@@ -0,0 +1,378 @@
+/**
+ * @file arena.h
+ * @brief Monotonic bump-pointer arena for per-event scratch memory
+ *
+ * Decoding one packet creates many short-lived temporaries (vectors of
+ * updates, symbol strings) that all die together once the packet has been
+ * handled. An arena serves them by bumping a pointer and frees them all at
+ * once by moving the pointer back, so there is no per-object free and no
+ * allocator metadata on the hot path.
+ *
+ * Memory comes in blocks chained through a header at the start of each
+ * block. Blocks are never returned before the arena is destroyed: after
+ * reset() the same blocks are bumped through again, so a warmed-up arena
+ * never calls the operating system. On Linux, blocks whose size is a
+ * multiple of 2 MiB are mapped with explicit huge pages when the system has
+ * some reserved, and otherwise advised as transparent huge pages.
+ *
+ * With ARENA_POISON (on by default unless NDEBUG), rewound memory is filled
+ * with ARENA_POISON_BYTE so stale pointers read obvious garbage, and under
+ * AddressSanitizer it is also marked unaddressable.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory_resource>
+#include <new>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+#ifndef ARENA_POISON
+#ifdef NDEBUG
+#define ARENA_POISON 0
+#else
+#define ARENA_POISON 1
+#endif
+#endif
+
+#if defined(__SANITIZE_ADDRESS__)
+#define ARENA_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define ARENA_ASAN 1
+#endif
+#endif
+
+#ifdef ARENA_ASAN
+#include <sanitizer/asan_interface.h>
+#endif
+
+constexpr unsigned char ARENA_POISON_BYTE = 0xDD;
+
+/**
+ * @brief Bump-pointer arena over a chain of blocks
+ *
+ * Not thread-safe: give each thread (or each event loop) its own arena.
+ */
+class Arena {
+public:
+    static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    static constexpr size_t BASE_PAGE_SIZE = 4096;
+
+    /**
+     * @brief Position in the arena, to rewind to later
+     */
+    struct Checkpoint {
+        void* block = nullptr;
+        std::byte* cursor = nullptr;
+    };
+
+    /**
+     * @param block_size Size of each block; requests larger than a block get a block of their own
+     */
+    explicit Arena(size_t block_size = HUGE_PAGE_SIZE) noexcept
+        : block_size_(std::max(round_up(block_size, BASE_PAGE_SIZE), BASE_PAGE_SIZE)) {}
+
+    ~Arena() {
+        BlockHeader* block = head_;
+        while (block != nullptr) {
+            BlockHeader* next = block->next;
+            unmap_block(block);
+            block = next;
+        }
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Bumps out `bytes` bytes aligned to `alignment` (a power of two)
+     *
+     * @throws std::bad_alloc if a new block cannot be mapped, or bytes is too large to map at all
+     */
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        auto cursor = reinterpret_cast<uintptr_t>(cursor_);
+        uintptr_t start = (cursor + alignment - 1) & ~(uintptr_t{alignment} - 1);
+        // Compared piece by piece so that a size read off the wire cannot wrap the sum
+        const auto remaining = static_cast<size_t>(end_ - cursor_);
+        const size_t padding = start - cursor;
+        if (current_ != nullptr && bytes <= remaining && padding <= remaining - bytes) {
+            cursor_ += padding + bytes;
+            unpoison(reinterpret_cast<void*>(start), bytes);
+            return reinterpret_cast<void*>(start);
+        }
+        return allocate_slow(bytes, alignment);
+    }
+
+    /**
+     * @brief Typed allocation of `count` uninitialised objects
+     *
+     * @throws std::bad_alloc if sizeof(T) * count overflows
+     */
+    template <typename T>
+    T* allocate_array(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Maps and touches at least `bytes` contiguous bytes ahead of the cursor
+     *
+     * For startup warm-up: the next `bytes` of allocations then need neither a
+     * new block nor a page fault. Nothing is allocated.
+     */
+    void reserve(size_t bytes) {
+        Checkpoint mark = checkpoint();
+        std::memset(allocate(bytes, 1), 0, bytes);
+        rewind(mark);
+    }
+
+    Checkpoint checkpoint() const noexcept {
+        return {current_, cursor_};
+    }
+
+    /**
+     * @brief Frees everything allocated since the checkpoint was taken
+     *
+     * Blocks stay chained, so the space is reused by later allocations.
+     */
+    void rewind(Checkpoint checkpoint) noexcept {
+        if (checkpoint.block == nullptr) {
+            reset();
+            return;
+        }
+        auto* block = static_cast<BlockHeader*>(checkpoint.block);
+        poison_from(block, checkpoint.cursor);
+        current_ = block;
+        cursor_ = checkpoint.cursor;
+        end_ = block_end(block);
+    }
+
+    /**
+     * @brief Frees everything, keeping all blocks for reuse
+     */
+    void reset() noexcept {
+        if (head_ == nullptr) {
+            return;
+        }
+        poison_from(head_, block_begin(head_));
+        current_ = head_;
+        cursor_ = block_begin(head_);
+        end_ = block_end(head_);
+    }
+
+    size_t block_count() const noexcept {
+        return block_count_;
+    }
+
+    size_t huge_block_count() const noexcept {
+        return huge_block_count_;
+    }
+
+    /**
+     * @brief Bytes mapped for blocks, including their headers
+     */
+    size_t bytes_reserved() const noexcept {
+        return bytes_reserved_;
+    }
+
+    /**
+     * @brief Bytes between the first block's start and the cursor, including alignment gaps
+     */
+    size_t bytes_used() const noexcept {
+        size_t used = 0;
+        for (BlockHeader* block = head_; block != nullptr; block = block->next) {
+            if (block == current_) {
+                return used + static_cast<size_t>(cursor_ - block_begin(block));
+            }
+            used += static_cast<size_t>(block_end(block) - block_begin(block));
+        }
+        return used;
+    }
+
+private:
+    struct alignas(std::max_align_t) BlockHeader {
+        BlockHeader* next;
+        size_t size;  // Including this header
+        bool huge;
+    };
+
+    static constexpr size_t round_up(size_t value, size_t multiple) noexcept {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    static std::byte* block_begin(BlockHeader* block) noexcept {
+        return reinterpret_cast<std::byte*>(block) + sizeof(BlockHeader);
+    }
+
+    static std::byte* block_end(BlockHeader* block) noexcept {
+        return reinterpret_cast<std::byte*>(block) + block->size;
+    }
+
+    void* allocate_slow(size_t bytes, size_t alignment) {
+        // Room for the padding, the block header and rounding up to a page must not wrap
+        constexpr size_t MAX_BYTES = std::numeric_limits<size_t>::max() - sizeof(BlockHeader) - BASE_PAGE_SIZE;
+        if (alignment > MAX_BYTES || bytes > MAX_BYTES - alignment) {
+            throw std::bad_alloc();
+        }
+        size_t needed = bytes + alignment;
+
+        // Move on to the next chained block if it is big enough (after a rewind or reset)
+        BlockHeader* next = current_ != nullptr ? current_->next : head_;
+        if (next == nullptr || static_cast<size_t>(block_end(next) - block_begin(next)) < needed) {
+            // Otherwise map a new one and splice it in after the current block
+            BlockHeader* block = map_block(std::max(block_size_, round_up(needed + sizeof(BlockHeader), BASE_PAGE_SIZE)));
+            if (current_ == nullptr) {
+                block->next = head_;
+                head_ = block;
+            } else {
+                block->next = current_->next;
+                current_->next = block;
+            }
+            next = block;
+        }
+
+        current_ = next;
+        cursor_ = block_begin(next);
+        end_ = block_end(next);
+        return allocate(bytes, alignment);
+    }
+
+    BlockHeader* map_block(size_t size) {
+        void* memory = nullptr;
+        bool huge = false;
+#ifndef _WIN32
+#ifdef MAP_HUGETLB
+        if (size % HUGE_PAGE_SIZE == 0) {
+            memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            huge = memory != MAP_FAILED;
+        }
+#endif
+        if (!huge) {
+            memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+#ifdef MADV_HUGEPAGE
+            if (size >= HUGE_PAGE_SIZE) {
+                ::madvise(memory, size, MADV_HUGEPAGE);  // Best effort: ignored if THP is disabled
+            }
+#endif
+        }
+#else
+        memory = ::operator new(size, std::align_val_t{BASE_PAGE_SIZE});
+#endif
+        auto* block = ::new (memory) BlockHeader{nullptr, size, huge};
+        poison(block_begin(block), size - sizeof(BlockHeader));
+
+        block_count_++;
+        huge_block_count_ += huge ? 1 : 0;
+        bytes_reserved_ += size;
+        return block;
+    }
+
+    static void unmap_block(BlockHeader* block) noexcept {
+        unpoison(block_begin(block), block->size - sizeof(BlockHeader));
+#ifndef _WIN32
+        ::munmap(block, block->size);
+#else
+        ::operator delete(block, std::align_val_t{BASE_PAGE_SIZE});
+#endif
+    }
+
+    // Poisons what was allocated from `cursor` in `block` up to the current position
+    void poison_from([[maybe_unused]] BlockHeader* block, [[maybe_unused]] std::byte* cursor) noexcept {
+#if ARENA_POISON || defined(ARENA_ASAN)
+        while (block != current_) {
+            poison(cursor, static_cast<size_t>(block_end(block) - cursor));
+            block = block->next;
+            cursor = block_begin(block);
+        }
+        poison(cursor, static_cast<size_t>(cursor_ - cursor));
+#endif
+    }
+
+    static void poison([[maybe_unused]] void* memory, [[maybe_unused]] size_t bytes) noexcept {
+#if ARENA_POISON
+#ifdef ARENA_ASAN
+        ASAN_UNPOISON_MEMORY_REGION(memory, bytes);
+#endif
+        std::memset(memory, ARENA_POISON_BYTE, bytes);
+#endif
+#ifdef ARENA_ASAN
+        ASAN_POISON_MEMORY_REGION(memory, bytes);
+#endif
+    }
+
+    static void unpoison([[maybe_unused]] void* memory, [[maybe_unused]] size_t bytes) noexcept {
+#ifdef ARENA_ASAN
+        ASAN_UNPOISON_MEMORY_REGION(memory, bytes);
+#endif
+    }
+
+    size_t block_size_;
+
+    // Allocation state: the block being bumped through and the free range left in it
+    BlockHeader* current_ = nullptr;
+    std::byte* cursor_ = nullptr;
+    std::byte* end_ = nullptr;
+
+    BlockHeader* head_ = nullptr;
+    size_t block_count_ = 0;
+    size_t huge_block_count_ = 0;
+    size_t bytes_reserved_ = 0;
+};
+
+/**
+ * @brief Rewinds an arena to where it was when the scope was entered
+ */
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena& arena) noexcept : arena_(arena), checkpoint_(arena.checkpoint()) {}
+    ~ArenaScope() { arena_.rewind(checkpoint_); }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena& arena_;
+    Arena::Checkpoint checkpoint_;
+};
+
+/**
+ * @brief std::pmr adapter: allocations come from the arena, deallocations are no-ops
+ *
+ * Memory is reclaimed by Arena::reset(), rewind() or an ArenaScope, after
+ * every container using the resource has been destroyed or abandoned.
+ */
+class ArenaMemoryResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaMemoryResource(Arena& arena) noexcept : arena_(arena) {}
+
+    Arena& arena() const noexcept {
+        return arena_;
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return arena_.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    Arena& arena_;
+};
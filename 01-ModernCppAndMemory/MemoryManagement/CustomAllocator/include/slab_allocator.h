@@ -0,0 +1,347 @@
+/**
+ * @file slab_allocator.h
+ * @brief Size-class slab allocator with thread-local heaps and remote-free queues
+ *
+ * Built for pipelines where one thread allocates (a feed handler building
+ * messages) and another frees (the strategy thread that consumed them). With
+ * a general-purpose malloc that pattern makes every free contend on the
+ * allocating thread's arena. Here each thread allocates from its own heap of
+ * slabs without any atomic operation, and a block freed on a different thread
+ * is handed back to its owning heap through that heap's MPSC remote-free
+ * queue, which the owner drains the next time it allocates.
+ *
+ * Layout:
+ *  - a slab is SLAB_SIZE bytes aligned to SLAB_SIZE, so the slab of any block
+ *    is found by masking its address; the slab header records the owning heap
+ *    and the block size class
+ *  - a heap keeps, per size class, an intrusive free list and a bump range in
+ *    its newest slab for that class
+ *  - remote frees go into an MPMCQueue<void*> used as MPSC; if it is full they
+ *    fall back to an intrusive lock-free stack that the owner takes whole
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "concurrency_primitives.h"
+#include "mpmc_queue.h"
+#include "thread_slot.h"
+
+/**
+ * @brief std::pmr::memory_resource serving small blocks from per-thread slabs
+ *
+ * Blocks up to MAX_BLOCK_SIZE bytes with alignment up to CACHE_LINE_SIZE come
+ * from slabs; anything larger or more aligned is forwarded to the upstream
+ * resource. Memory freed into a heap is reused by that heap but slabs are only
+ * returned upstream when the resource is destroyed, which must happen after
+ * every block is freed and every thread that used it has stopped.
+ *
+ * Heaps are indexed by the process-wide thread slot (see thread_slot.h); a
+ * thread that gets a recycled slot inherits the heap of the thread that had it.
+ * Threads beyond MAX_THREAD_SLOTS share one heap behind a mutex.
+ */
+class SlabMemoryResource : public std::pmr::memory_resource {
+public:
+    static constexpr size_t SLAB_SIZE = 64 * 1024;
+    static constexpr size_t MAX_BLOCK_SIZE = 4096;
+    static constexpr size_t REMOTE_QUEUE_CAPACITY = 512;
+
+    static constexpr std::array<size_t, 16> CLASS_SIZES = {
+        16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096};
+    static constexpr size_t NUM_CLASSES = CLASS_SIZES.size();
+    static constexpr size_t LARGE = NUM_CLASSES;
+
+    /**
+     * @param upstream Source of slabs and of blocks too large for a size class
+     */
+    explicit SlabMemoryResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+        : upstream_(upstream) {}
+
+    ~SlabMemoryResource() override {
+        for (ThreadHeap* heap : heaps_) {
+            if (heap != nullptr) {
+                release_slabs(*heap);
+                delete heap;
+            }
+        }
+        release_slabs(shared_heap_);
+    }
+
+    SlabMemoryResource(const SlabMemoryResource&) = delete;
+    SlabMemoryResource& operator=(const SlabMemoryResource&) = delete;
+
+    /**
+     * @brief Size class serving a request, or LARGE if it goes upstream
+     */
+    static constexpr size_t size_class_for(size_t bytes, size_t alignment) noexcept {
+        if (bytes > MAX_BLOCK_SIZE || alignment > CACHE_LINE_SIZE) {
+            return LARGE;
+        }
+        // Blocks start at a multiple of their size past a cache-line-aligned header,
+        // so a class whose size is a multiple of the alignment gives aligned blocks
+        for (size_t i = 0; i < NUM_CLASSES; ++i) {
+            if (CLASS_SIZES[i] >= bytes && CLASS_SIZES[i] % alignment == 0) {
+                return i;
+            }
+        }
+        return LARGE;
+    }
+
+    /**
+     * @brief Non-virtual allocation, for callers that know the concrete resource
+     *
+     * @throws std::bad_alloc if the upstream resource cannot supply a new slab
+     */
+    void* allocate_block(size_t bytes, size_t alignment = alignof(std::max_align_t)) {
+        size_t size_class = size_class_for(bytes, alignment);
+        if (size_class == LARGE) {
+            return upstream_->allocate(bytes, alignment);
+        }
+        if (ThreadHeap* heap = local_heap()) {
+            return allocate_from(*heap, size_class);
+        }
+        std::lock_guard<std::mutex> lock(shared_mutex_);
+        return allocate_from(shared_heap_, size_class);
+    }
+
+    /**
+     * @brief Frees a block from allocate_block() on any thread
+     *
+     * @param bytes, alignment Must match the allocation, as for any memory_resource
+     */
+    void deallocate_block(void* block, size_t bytes, size_t alignment = alignof(std::max_align_t)) noexcept {
+        if (block == nullptr) {
+            return;
+        }
+        if (size_class_for(bytes, alignment) == LARGE) {
+            upstream_->deallocate(block, bytes, alignment);
+            return;
+        }
+
+        SlabHeader* slab = slab_of(block);
+        ThreadHeap* heap = current_heap();
+        if (slab->owner == heap) {
+            push_local(*heap, slab->size_class, block);
+        } else if (slab->owner == &shared_heap_) {
+            std::lock_guard<std::mutex> lock(shared_mutex_);
+            push_local(shared_heap_, slab->size_class, block);
+        } else {
+            push_remote(*slab->owner, block);
+        }
+    }
+
+    /**
+     * @brief Slabs taken from upstream so far
+     */
+    size_t slab_count() const noexcept {
+        return slab_count_.load(std::memory_order_relaxed);
+    }
+
+    std::pmr::memory_resource* upstream_resource() const noexcept {
+        return upstream_;
+    }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        return allocate_block(bytes, alignment);
+    }
+
+    void do_deallocate(void* block, size_t bytes, size_t alignment) override {
+        deallocate_block(block, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    struct ThreadHeap;
+
+    // Occupies the first cache line of every slab
+    struct alignas(CACHE_LINE_SIZE) SlabHeader {
+        ThreadHeap* owner;
+        uint32_t size_class;
+    };
+
+    struct SizeClassState {
+        void* free_list = nullptr;  // Linked through the first word of each free block
+        std::byte* bump = nullptr;
+        std::byte* bump_end = nullptr;
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ThreadHeap {
+        // Touched only by the owning thread (or under shared_mutex_ for the shared heap)
+        std::array<SizeClassState, NUM_CLASSES> classes{};
+        std::vector<void*> slabs;
+
+        // Written by other threads freeing this heap's blocks
+        MPMCQueue<void*, REMOTE_QUEUE_CAPACITY> remote_queue;
+        CacheLineAligned<std::atomic<void*>> remote_overflow{};
+    };
+
+    static void* next_of(void* block) noexcept {
+        void* next;
+        std::memcpy(&next, block, sizeof(next));
+        return next;
+    }
+
+    static void set_next(void* block, void* next) noexcept {
+        std::memcpy(block, &next, sizeof(next));
+    }
+
+    static SlabHeader* slab_of(void* block) noexcept {
+        return reinterpret_cast<SlabHeader*>(reinterpret_cast<uintptr_t>(block) & ~(uintptr_t{SLAB_SIZE} - 1));
+    }
+
+    // The calling thread's heap if it has one yet; freeing never creates a heap
+    ThreadHeap* current_heap() const noexcept {
+        size_t slot = this_thread_slot();
+        return slot == NO_THREAD_SLOT ? nullptr : heaps_[slot];
+    }
+
+    ThreadHeap* local_heap() {
+        size_t slot = this_thread_slot();
+        if (slot == NO_THREAD_SLOT) {
+            return nullptr;
+        }
+        // Only the slot's current holder reads or writes its entry
+        if (heaps_[slot] == nullptr) {
+            heaps_[slot] = new ThreadHeap();
+        }
+        return heaps_[slot];
+    }
+
+    void* allocate_from(ThreadHeap& heap, size_t size_class) {
+        SizeClassState& state = heap.classes[size_class];
+        if (state.free_list == nullptr) {
+            drain_remote(heap);
+        }
+        if (void* block = state.free_list) {
+            state.free_list = next_of(block);
+            return block;
+        }
+        if (state.bump == state.bump_end) {
+            add_slab(heap, size_class);
+        }
+        void* block = state.bump;
+        state.bump += CLASS_SIZES[size_class];
+        return block;
+    }
+
+    static void push_local(ThreadHeap& heap, size_t size_class, void* block) noexcept {
+        SizeClassState& state = heap.classes[size_class];
+        set_next(block, state.free_list);
+        state.free_list = block;
+    }
+
+    static void push_remote(ThreadHeap& owner, void* block) noexcept {
+        if (owner.remote_queue.try_enqueue(block)) {
+            return;
+        }
+        // Queue full: push onto the overflow stack; the owner only ever takes the
+        // whole stack with exchange(), so pushes cannot suffer ABA
+        void* head = owner.remote_overflow.data.load(std::memory_order_relaxed);
+        do {
+            set_next(block, head);
+        } while (!owner.remote_overflow.data.compare_exchange_weak(head, block, std::memory_order_release,
+                                                                   std::memory_order_relaxed));
+    }
+
+    // Moves every remotely freed block back onto the owner's free lists
+    static void drain_remote(ThreadHeap& heap) noexcept {
+        void* block;
+        while (heap.remote_queue.try_dequeue(block)) {
+            push_local(heap, slab_of(block)->size_class, block);
+        }
+        if (heap.remote_overflow.data.load(std::memory_order_relaxed) != nullptr) {
+            block = heap.remote_overflow.data.exchange(nullptr, std::memory_order_acquire);
+            while (block != nullptr) {
+                void* next = next_of(block);
+                push_local(heap, slab_of(block)->size_class, block);
+                block = next;
+            }
+        }
+    }
+
+    void add_slab(ThreadHeap& heap, size_t size_class) {
+        heap.slabs.reserve(heap.slabs.size() + 1);  // So a throw below cannot leak the slab
+        void* memory = upstream_->allocate(SLAB_SIZE, SLAB_SIZE);
+        heap.slabs.push_back(memory);
+        slab_count_.fetch_add(1, std::memory_order_relaxed);
+
+        auto* slab = ::new (memory) SlabHeader{&heap, static_cast<uint32_t>(size_class)};
+        size_t block_size = CLASS_SIZES[size_class];
+        size_t blocks = (SLAB_SIZE - sizeof(SlabHeader)) / block_size;
+
+        SizeClassState& state = heap.classes[size_class];
+        state.bump = reinterpret_cast<std::byte*>(slab) + sizeof(SlabHeader);
+        state.bump_end = state.bump + blocks * block_size;
+    }
+
+    void release_slabs(ThreadHeap& heap) noexcept {
+        for (void* slab : heap.slabs) {
+            upstream_->deallocate(slab, SLAB_SIZE, SLAB_SIZE);
+        }
+        heap.slabs.clear();
+    }
+
+    std::pmr::memory_resource* upstream_;
+
+    // Heaps for slotted threads, created on first use by the slot's holder
+    std::array<ThreadHeap*, MAX_THREAD_SLOTS> heaps_{};
+
+    // Heap for threads without a slot
+    ThreadHeap shared_heap_;
+    std::mutex shared_mutex_;
+
+    std::atomic<size_t> slab_count_{0};
+};
+
+/**
+ * @brief STL allocator over a SlabMemoryResource, without the virtual call of
+ *        std::pmr::polymorphic_allocator
+ */
+template <typename T>
+class SlabAllocator {
+public:
+    using value_type = T;
+
+    explicit SlabAllocator(SlabMemoryResource& resource) noexcept : resource_(&resource) {}
+
+    template <typename U>
+    SlabAllocator(const SlabAllocator<U>& other) noexcept : resource_(other.resource()) {}
+
+    T* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(resource_->allocate_block(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept {
+        resource_->deallocate_block(pointer, count * sizeof(T), alignof(T));
+    }
+
+    SlabMemoryResource* resource() const noexcept {
+        return resource_;
+    }
+
+    template <typename U>
+    friend bool operator==(const SlabAllocator& lhs, const SlabAllocator<U>& rhs) noexcept {
+        return lhs.resource() == rhs.resource();
+    }
+
+private:
+    SlabMemoryResource* resource_;
+};
@@ -0,0 +1,110 @@
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "../include/slab_allocator.h"
+#include "../include/arena.h"
+#include "ring_buffer.h"
+
+// Variable-size message, as a feed handler would build per update
+struct Message {
+    uint64_t sequence;
+    uint32_t length;
+    char payload[1];  // length bytes follow
+};
+
+int main() {
+    std::cout << "Slab Allocator Demo\n";
+    std::cout << "-------------------\n";
+    std::cout << "Slab size: " << SlabMemoryResource::SLAB_SIZE / 1024 << " KiB, size classes up to "
+              << SlabMemoryResource::MAX_BLOCK_SIZE << " bytes\n\n";
+
+    SlabMemoryResource resource;
+
+    // Basic operations demo
+    std::cout << "Basic operations:\n";
+    void* block = resource.allocate(100);
+    std::cout << "Allocated 100 bytes from the " << SlabMemoryResource::CLASS_SIZES[SlabMemoryResource::size_class_for(100, 16)]
+              << "-byte class\n";
+    resource.deallocate(block, 100);
+    std::cout << "Freed it; the next allocation of that class reuses it: "
+              << (resource.allocate(100) == block ? "yes" : "no") << "\n";
+    resource.deallocate(block, 100);
+
+    std::pmr::vector<int> values(&resource);
+    for (int i = 0; i < 100; ++i) {
+        values.push_back(i);
+    }
+    std::cout << "std::pmr::vector with " << values.size() << " ints on the slab resource\n";
+
+    // Pipeline demo: the feed thread allocates, the strategy thread frees
+    std::cout << "\nFeed thread allocates, strategy thread frees, via RingBuffer<Message*, 1024>...\n";
+    constexpr uint64_t NUM_MESSAGES = 1000000;
+    RingBuffer<Message*, 1024> ring;
+    std::atomic<uint64_t> checksum(0);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::thread feed([&]() {
+        for (uint64_t seq = 0; seq < NUM_MESSAGES; ++seq) {
+            uint32_t length = 32 + static_cast<uint32_t>(seq % 7) * 64;
+            auto* message = static_cast<Message*>(resource.allocate(sizeof(Message) + length));
+            message->sequence = seq;
+            message->length = length;
+            std::memset(message->payload, static_cast<int>(seq & 0xFF), length);
+            while (!ring.try_enqueue(message)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::thread strategy([&]() {
+        uint64_t sum = 0;
+        Message* message;
+        for (uint64_t received = 0; received < NUM_MESSAGES;) {
+            if (ring.try_dequeue(message)) {
+                sum += message->sequence + static_cast<unsigned char>(message->payload[message->length - 1]);
+                resource.deallocate(message, sizeof(Message) + message->length);
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        checksum.store(sum);
+    });
+
+    feed.join();
+    strategy.join();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+    std::cout << "Transferred " << NUM_MESSAGES << " messages in " << duration << " ms";
+    if (duration > 0) {
+        std::cout << " (" << (NUM_MESSAGES * 1000 / duration) << " messages/sec)";
+    }
+    std::cout << "\nChecksum: " << checksum.load() << "\n";
+    std::cout << "Slabs taken from upstream: " << resource.slab_count()
+              << " (remote frees are recycled by the feed thread's heap)\n";
+
+    // Arena demo: per-packet scratch memory freed by one rewind
+    std::cout << "\nArena:\n";
+    Arena arena;
+    ArenaMemoryResource scratch(arena);
+    for (int packet = 0; packet < 3; ++packet) {
+        ArenaScope scope(arena);
+        std::pmr::vector<std::pmr::string> symbols(&scratch);
+        for (int i = 0; i < 100; ++i) {
+            symbols.emplace_back("XNAS:ACME 240" + std::to_string(100 + i) + " C" + std::to_string(packet));
+        }
+        std::cout << "Packet " << packet << ": " << symbols.size() << " symbols, " << arena.bytes_used()
+                  << " bytes of scratch\n";
+    }
+    std::cout << "After the last packet: " << arena.bytes_used() << " bytes used, " << arena.block_count()
+              << " block(s) kept for reuse (" << arena.huge_block_count() << " on explicit huge pages)\n";
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include "../include/arena.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// Test alignment and that consecutive allocations do not overlap
+TEST(ArenaTest, AllocateAligned) {
+    Arena arena(Arena::BASE_PAGE_SIZE);
+
+    std::byte* previous_end = nullptr;
+    for (size_t alignment : {1u, 2u, 8u, 16u, 64u, 256u}) {
+        auto* block = static_cast<std::byte*>(arena.allocate(24, alignment));
+        ASSERT_NE(block, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % alignment, 0u) << alignment;
+        if (previous_end != nullptr) {
+            EXPECT_GE(block, previous_end);
+        }
+        std::memset(block, 0x11, 24);
+        previous_end = block + 24;
+    }
+
+    int* values = arena.allocate_array<int>(10);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(values) % alignof(int), 0u);
+    EXPECT_EQ(arena.block_count(), 1u);
+}
+
+// Test chaining into new blocks and oversized requests
+TEST(ArenaTest, ChainsBlocks) {
+    Arena arena(Arena::BASE_PAGE_SIZE);
+
+    for (int i = 0; i < 100; ++i) {
+        std::memset(arena.allocate(1000), i, 1000);
+    }
+    EXPECT_GT(arena.block_count(), 20u);
+    EXPECT_GE(arena.bytes_used(), 100u * 1000u);
+
+    // Bigger than a block: gets a block of its own
+    void* large = arena.allocate(5 * Arena::BASE_PAGE_SIZE);
+    std::memset(large, 0x22, 5 * Arena::BASE_PAGE_SIZE);
+    EXPECT_GE(arena.bytes_reserved(), 100u * 1000u + 5 * Arena::BASE_PAGE_SIZE);
+}
+
+// Test that sizes near SIZE_MAX throw instead of wrapping the cursor around
+TEST(ArenaTest, RejectsOverflowingSizes) {
+    Arena arena(Arena::BASE_PAGE_SIZE);
+
+    EXPECT_THROW(arena.allocate(SIZE_MAX), std::bad_alloc);
+    // Leave the cursor unaligned, so alignment padding plus the size wraps to a small number
+    auto* first = static_cast<std::byte*>(arena.allocate(1, 1));
+    EXPECT_THROW(arena.allocate(SIZE_MAX - 6, 8), std::bad_alloc);
+    EXPECT_THROW(arena.allocate_array<uint64_t>(SIZE_MAX / 4), std::bad_alloc);
+
+    // The failed requests left the arena where it was
+    auto* next = static_cast<std::byte*>(arena.allocate(1, 1));
+    EXPECT_EQ(next, first + 1);
+    EXPECT_EQ(arena.block_count(), 1u);
+}
+
+// Test that reset reuses the same blocks without reserving more
+TEST(ArenaTest, ResetReusesBlocks) {
+    Arena arena(Arena::BASE_PAGE_SIZE);
+
+    std::vector<void*> first;
+    for (int i = 0; i < 50; ++i) {
+        first.push_back(arena.allocate(500));
+    }
+    size_t blocks = arena.block_count();
+    size_t reserved = arena.bytes_reserved();
+
+    arena.reset();
+    EXPECT_EQ(arena.bytes_used(), 0u);
+
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(arena.allocate(500), first[i]) << i;
+    }
+    EXPECT_EQ(arena.block_count(), blocks);
+    EXPECT_EQ(arena.bytes_reserved(), reserved);
+}
+
+// Test checkpoints, including nested scopes and a rewind across blocks
+TEST(ArenaTest, CheckpointAndRewind) {
+    Arena arena(Arena::BASE_PAGE_SIZE);
+    void* keep = arena.allocate(100);
+    std::memset(keep, 0x33, 100);
+
+    Arena::Checkpoint mark = arena.checkpoint();
+    void* first = arena.allocate(64);
+    for (int i = 0; i < 20; ++i) {
+        arena.allocate(1000);  // Crosses into later blocks
+    }
+    arena.rewind(mark);
+    EXPECT_EQ(arena.allocate(64), first);
+
+    {
+        ArenaScope outer(arena);
+        void* a = arena.allocate(32);
+        {
+            ArenaScope inner(arena);
+            arena.allocate(2000);
+        }
+        EXPECT_EQ(static_cast<std::byte*>(arena.allocate(1)), static_cast<std::byte*>(a) + 32);
+    }
+
+    // Memory from before the checkpoint is untouched
+    EXPECT_EQ(static_cast<unsigned char*>(keep)[99], 0x33);
+}
+
+#if ARENA_POISON && !defined(ARENA_ASAN)
+// Test that rewound memory is poisoned in debug builds
+TEST(ArenaTest, PoisonsRewoundMemory) {
+    Arena arena(Arena::BASE_PAGE_SIZE);
+    auto* bytes = static_cast<unsigned char*>(arena.allocate(64));
+    std::memset(bytes, 0x44, 64);
+
+    arena.reset();
+    for (size_t i = 0; i < 64; ++i) {
+        ASSERT_EQ(bytes[i], ARENA_POISON_BYTE) << i;
+    }
+}
+#endif
+
+// Test std::pmr containers on the arena, freed in bulk
+TEST(ArenaTest, PmrContainers) {
+    Arena arena;
+    ArenaMemoryResource resource(arena);
+
+    for (int packet = 0; packet < 10; ++packet) {
+        ArenaScope scope(arena);
+        std::pmr::vector<std::pmr::string> symbols(&resource);
+        for (int i = 0; i < 1000; ++i) {
+            symbols.emplace_back("a symbol long enough to leave SSO " + std::to_string(i));
+        }
+        EXPECT_EQ(symbols[999], "a symbol long enough to leave SSO 999");
+        EXPECT_EQ(symbols.get_allocator().resource(), &resource);
+    }
+
+    // Everything fit in the first 2 MiB block and was reused each time
+    EXPECT_EQ(arena.block_count(), 1u);
+    EXPECT_EQ(arena.bytes_used(), 0u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,311 @@
+#include "../include/slab_allocator.h"
+#include "ring_buffer.h"
+#include "numa.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <list>
+#include <map>
+#include <string>
+
+namespace {
+
+// Counts what reaches the upstream resource
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t deallocations = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        ++deallocations;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+}  // namespace
+
+// Test that every request maps to the smallest class that fits and keeps alignment
+TEST(SlabAllocatorTest, SizeClasses) {
+    EXPECT_EQ(SlabMemoryResource::size_class_for(1, 8), 0u);
+    EXPECT_EQ(SlabMemoryResource::size_class_for(16, 16), 0u);
+    EXPECT_EQ(SlabMemoryResource::size_class_for(17, 16), 1u);
+    EXPECT_EQ(SlabMemoryResource::size_class_for(40, 16), 2u);
+    EXPECT_EQ(SlabMemoryResource::size_class_for(40, 64), 3u);    // 48 is not a multiple of 64
+    EXPECT_EQ(SlabMemoryResource::size_class_for(65, 64), 5u);    // Neither is 96
+    EXPECT_EQ(SlabMemoryResource::size_class_for(4096, 16), SlabMemoryResource::NUM_CLASSES - 1);
+    EXPECT_EQ(SlabMemoryResource::size_class_for(4097, 16), SlabMemoryResource::LARGE);
+    EXPECT_EQ(SlabMemoryResource::size_class_for(64, 128), SlabMemoryResource::LARGE);
+}
+
+// Test allocation and reuse on a single thread
+TEST(SlabAllocatorTest, AllocateAndReuse) {
+    SlabMemoryResource resource;
+
+    for (size_t bytes : {1u, 8u, 16u, 24u, 48u, 100u, 500u, 1000u, 4096u}) {
+        for (size_t alignment : {8u, 16u, 32u, 64u}) {
+            void* block = resource.allocate(bytes, alignment);
+            ASSERT_NE(block, nullptr);
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(block) % alignment, 0u) << bytes << "/" << alignment;
+            std::memset(block, 0xAB, bytes);
+            resource.deallocate(block, bytes, alignment);
+
+            // Freed blocks are reused first
+            void* again = resource.allocate(bytes, alignment);
+            EXPECT_EQ(again, block);
+            resource.deallocate(again, bytes, alignment);
+        }
+    }
+}
+
+// Test that live blocks never overlap and a slab holds many of them
+TEST(SlabAllocatorTest, DistinctBlocks) {
+    SlabMemoryResource resource;
+    std::vector<uint64_t*> blocks;
+
+    for (uint64_t i = 0; i < 10000; ++i) {
+        auto* block = static_cast<uint64_t*>(resource.allocate(sizeof(uint64_t) * 4));
+        block[0] = i;
+        block[3] = ~i;
+        blocks.push_back(block);
+    }
+    for (uint64_t i = 0; i < blocks.size(); ++i) {
+        ASSERT_EQ(blocks[i][0], i);
+        ASSERT_EQ(blocks[i][3], ~i);
+    }
+    // 32-byte blocks: about 2000 per 64 KiB slab
+    EXPECT_LE(resource.slab_count(), 6u);
+
+    for (uint64_t* block : blocks) {
+        resource.deallocate(block, sizeof(uint64_t) * 4);
+    }
+}
+
+// Test that oversized or over-aligned requests bypass the slabs
+TEST(SlabAllocatorTest, LargeGoesUpstream) {
+    CountingResource upstream;
+    {
+        SlabMemoryResource resource(&upstream);
+        EXPECT_EQ(resource.upstream_resource(), &upstream);
+
+        void* large = resource.allocate(10000);
+        EXPECT_EQ(upstream.allocations, 1u);
+        resource.deallocate(large, 10000);
+        EXPECT_EQ(upstream.deallocations, 1u);
+
+        void* aligned = resource.allocate(64, 256);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 256, 0u);
+        resource.deallocate(aligned, 64, 256);
+
+        void* small = resource.allocate(64);  // First slab
+        EXPECT_EQ(upstream.allocations, 3u);
+        resource.deallocate(small, 64);
+    }
+    // Slabs go back when the resource is destroyed
+    EXPECT_EQ(upstream.deallocations, upstream.allocations);
+}
+
+// Test that blocks freed on another thread return to the owner's free lists
+TEST(SlabAllocatorTest, RemoteFreeIsReused) {
+    SlabMemoryResource resource;
+    constexpr size_t NUM_BLOCKS = 5000;  // More than the remote queue holds, so the overflow path runs too
+    std::vector<void*> blocks;
+
+    for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+        blocks.push_back(resource.allocate(64));
+    }
+    size_t slabs = resource.slab_count();
+
+    std::thread freer([&]() {
+        for (void* block : blocks) {
+            resource.deallocate(block, 64);
+        }
+    });
+    freer.join();
+
+    // The owner gets them all back without new slabs
+    std::vector<void*> again;
+    for (size_t i = 0; i < NUM_BLOCKS; ++i) {
+        again.push_back(resource.allocate(64));
+    }
+    EXPECT_EQ(resource.slab_count(), slabs);
+
+    std::sort(blocks.begin(), blocks.end());
+    std::sort(again.begin(), again.end());
+    EXPECT_EQ(blocks, again);
+
+    for (void* block : again) {
+        resource.deallocate(block, 64);
+    }
+}
+
+// Test use through std::pmr containers and the STL allocator
+TEST(SlabAllocatorTest, Containers) {
+    SlabMemoryResource resource;
+
+    std::pmr::map<int, std::pmr::string> names(&resource);
+    for (int i = 0; i < 1000; ++i) {
+        names.emplace(i, "instrument number " + std::to_string(i));
+    }
+    EXPECT_EQ(names.size(), 1000u);
+    EXPECT_EQ(names.at(500), "instrument number 500");
+
+    std::list<double, SlabAllocator<double>> prices{SlabAllocator<double>(resource)};
+    for (int i = 0; i < 1000; ++i) {
+        prices.push_back(100.0 + i);
+    }
+    EXPECT_EQ(prices.back(), 1099.0);
+
+    std::vector<int, SlabAllocator<int>> grow{SlabAllocator<int>(resource)};
+    for (int i = 0; i < 100000; ++i) {  // Grows past MAX_BLOCK_SIZE into upstream allocations
+        grow.push_back(i);
+    }
+    EXPECT_EQ(grow[99999], 99999);
+
+    SlabAllocator<int> a(resource);
+    SlabAllocator<double> b(a);
+    EXPECT_TRUE(a == b);
+}
+
+// Test the producer-allocates, consumer-frees pipeline
+TEST(SlabAllocatorTest, ConsumerFreesPipeline) {
+    constexpr size_t NUM_ITEMS = 100000;
+    SlabMemoryResource resource;
+    RingBuffer<uint64_t*, 256> ring;
+    std::atomic<bool> data_error(false);
+
+    std::thread producer([&]() {
+        for (uint64_t i = 0; i < NUM_ITEMS; ++i) {
+            size_t bytes = 16 + (i % 8) * 40;
+            auto* message = static_cast<uint64_t*>(resource.allocate(bytes));
+            message[0] = i;
+            message[1] = bytes;
+            while (!ring.try_enqueue(message)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::thread consumer([&]() {
+        uint64_t* message;
+        for (uint64_t expected = 0; expected < NUM_ITEMS;) {
+            if (ring.try_dequeue(message)) {
+                if (message[0] != expected || message[1] != 16 + (expected % 8) * 40) {
+                    data_error.store(true);
+                }
+                resource.deallocate(message, message[1]);
+                ++expected;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    EXPECT_FALSE(data_error.load());
+    // Remote frees are recycled, so the working set stays within a handful of slabs per class
+    EXPECT_LE(resource.slab_count(), 8u * 4u);
+}
+
+// Test that several threads freeing into each other's heaps lose nothing
+TEST(SlabAllocatorTest, ConcurrentCrossFrees) {
+    constexpr size_t NUM_THREADS = 4;
+    constexpr size_t NUM_ROUNDS = 200;
+    constexpr size_t BATCH = 100;
+    SlabMemoryResource resource;
+    std::vector<RingBuffer<uint64_t*, 1024>> mailboxes(NUM_THREADS);
+    std::atomic<bool> data_error(false);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&, t]() {
+            auto& outbox = mailboxes[(t + 1) % NUM_THREADS];
+            auto& inbox = mailboxes[t];
+            size_t received = 0;
+            for (size_t round = 0; round < NUM_ROUNDS; ++round) {
+                for (size_t i = 0; i < BATCH; ++i) {
+                    auto* block = static_cast<uint64_t*>(resource.allocate(48));
+                    block[0] = t;
+                    while (!outbox.try_enqueue(block)) {
+                        uint64_t* incoming;
+                        if (inbox.try_dequeue(incoming)) {
+                            if (incoming[0] != (t + NUM_THREADS - 1) % NUM_THREADS) {
+                                data_error.store(true);
+                            }
+                            resource.deallocate(incoming, 48);
+                            ++received;
+                        }
+                        std::this_thread::yield();
+                    }
+                }
+            }
+            while (received < NUM_ROUNDS * BATCH) {
+                uint64_t* incoming;
+                if (inbox.try_dequeue(incoming)) {
+                    if (incoming[0] != (t + NUM_THREADS - 1) % NUM_THREADS) {
+                        data_error.store(true);
+                    }
+                    resource.deallocate(incoming, 48);
+                    ++received;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_FALSE(data_error.load());
+}
+
+// Test slabs taken from a NUMA node through NumaMemoryResource
+TEST(SlabAllocatorTest, NumaUpstream) {
+    NumaMemoryResource upstream(numa_current_node());
+    SlabMemoryResource resource(&upstream);
+    EXPECT_EQ(resource.upstream_resource(), &upstream);
+
+    std::vector<void*> blocks;
+    for (int i = 0; i < 2000; ++i) {
+        blocks.push_back(resource.allocate(100));
+        std::memset(blocks.back(), i & 0xFF, 100);
+    }
+    EXPECT_GE(resource.slab_count(), 2u);
+    const int resident = numa_node_of(blocks.front());
+    if (resident != NUMA_NO_NODE) {
+        EXPECT_EQ(resident, numa_current_node());
+    }
+    void* large = resource.allocate(100000);
+    std::memset(large, 1, 100000);
+    resource.deallocate(large, 100000);
+    for (void* block : blocks) {
+        resource.deallocate(block, 100);
+    }
+
+    // A node that does not exist still yields usable slabs
+    NumaMemoryResource missing(numa_node_count());
+    SlabMemoryResource fallback(&missing);
+    void* block = fallback.allocate(64);
+    std::memset(block, 2, 64);
+    fallback.deallocate(block, 64);
+    EXPECT_TRUE(upstream.is_equal(NumaMemoryResource(numa_current_node())));
+    EXPECT_FALSE(upstream.is_equal(missing));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
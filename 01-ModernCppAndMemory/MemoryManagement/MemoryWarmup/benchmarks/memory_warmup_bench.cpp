@@ -0,0 +1,80 @@
+#include "../include/memory_warmup.h"
+#include "arena.h"
+#include "queue_benchmarks.h"
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <memory>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+
+constexpr size_t REGION_BYTES = 4 * 1024 * 1024;
+
+// First pass over freshly mapped memory, as the first messages through a new
+// queue or pool would see it; Prefault runs the warm-up pass outside the timing
+template <bool Prefault>
+static void BM_FirstPassOverRegion(benchmark::State& state) {
+    uint64_t faults = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        void* memory = ::mmap(nullptr, REGION_BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            state.SkipWithError("mmap failed");
+            break;
+        }
+        auto* data = static_cast<unsigned char*>(memory);
+        if (Prefault) {
+            prefault_region(data, REGION_BYTES);
+        }
+        FaultCounts before = read_fault_counts(FaultScope::Thread);
+        state.ResumeTiming();
+
+        // One write per cache line, as a stream of small messages would do
+        for (size_t offset = 0; offset < REGION_BYTES; offset += 64) {
+            data[offset] = static_cast<unsigned char>(offset);
+        }
+        benchmark::ClobberMemory();
+
+        state.PauseTiming();
+        faults += (read_fault_counts(FaultScope::Thread) - before).minor;
+        ::munmap(memory, REGION_BYTES);
+        state.ResumeTiming();
+    }
+    state.counters["faults_per_pass"] = benchmark::Counter(static_cast<double>(faults), benchmark::Counter::kAvgIterations);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * REGION_BYTES));
+}
+
+BENCHMARK_TEMPLATE(BM_FirstPassOverRegion, false);
+BENCHMARK_TEMPLATE(BM_FirstPassOverRegion, true);
+#endif
+
+// First packet's worth of scratch allocations from a new arena, with or without reserve()
+template <bool Reserve>
+static void BM_FirstPassOverArena(benchmark::State& state) {
+    constexpr size_t SCRATCH_BYTES = 1024 * 1024;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto arena = std::make_unique<Arena>();
+        if (Reserve) {
+            arena->reserve(SCRATCH_BYTES);
+        }
+        state.ResumeTiming();
+
+        for (size_t used = 0; used < SCRATCH_BYTES; used += 256) {
+            std::memset(arena->allocate(256), 1, 256);
+        }
+        benchmark::ClobberMemory();
+
+        state.PauseTiming();
+        arena.reset();
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * SCRATCH_BYTES));
+}
+
+BENCHMARK_TEMPLATE(BM_FirstPassOverArena, false);
+BENCHMARK_TEMPLATE(BM_FirstPassOverArena, true);
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
@@ -0,0 +1,255 @@
+/**
+ * @file memory_warmup.h
+ * @brief Startup warm-up: lock memory, pre-fault registered regions, warm queues
+ *
+ * Constructing a queue or pool does not guarantee that its pages are resident:
+ * a value-initialised array may sit in zero pages that are only backed on the
+ * first write, and nothing stops the kernel from reclaiming them later. The
+ * first message through each page then takes a page fault on the hot path.
+ *
+ * MemoryWarmup runs once at startup, before the hot threads start:
+ *  1. mlockall(MCL_CURRENT | MCL_FUTURE), so nothing mapped now or later is
+ *     paged out (needs CAP_IPC_LOCK or a large enough RLIMIT_MEMLOCK; failure
+ *     is reported, not fatal)
+ *  2. writes one byte in every page of each registered region, storing back
+ *     the value it read so live contents are unchanged
+ *  3. runs the registered warm-up tasks, e.g. a number of dummy messages
+ *     through each queue to warm caches and branch predictors
+ * and reports the minor and major page faults taken, from getrusage().
+ * faults_since_warmup() then shows whether the steady state stays fault-free.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include "concurrent_queue.h"
+
+/**
+ * @brief Page-fault counters from getrusage()
+ */
+struct FaultCounts {
+    uint64_t minor = 0;  // Served without I/O (first touch, copy-on-write)
+    uint64_t major = 0;  // Needed I/O (swap-in, file read)
+
+    FaultCounts operator-(const FaultCounts& other) const noexcept {
+        return {minor - other.minor, major - other.major};
+    }
+};
+
+enum class FaultScope {
+    Process,
+    Thread  // Linux only; falls back to Process elsewhere
+};
+
+/**
+ * @brief Faults taken so far by the process or the calling thread (zero where unsupported)
+ */
+inline FaultCounts read_fault_counts(FaultScope scope = FaultScope::Process) noexcept {
+#ifndef _WIN32
+    int who = RUSAGE_SELF;
+#ifdef RUSAGE_THREAD
+    if (scope == FaultScope::Thread) {
+        who = RUSAGE_THREAD;
+    }
+#endif
+    struct rusage usage {};
+    if (::getrusage(who, &usage) == 0) {
+        return {static_cast<uint64_t>(usage.ru_minflt), static_cast<uint64_t>(usage.ru_majflt)};
+    }
+#endif
+    (void)scope;
+    return {};
+}
+
+/**
+ * @brief Size of a virtual memory page
+ */
+inline size_t page_size() noexcept {
+#ifndef _WIN32
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+#else
+    return 4096;
+#endif
+}
+
+/**
+ * @brief Writes one byte per page of [data, data + bytes) without changing the contents
+ *
+ * @return Number of pages touched
+ */
+inline size_t prefault_region(void* data, size_t bytes) noexcept {
+    if (data == nullptr || bytes == 0) {
+        return 0;
+    }
+    const size_t page = page_size();
+    auto* begin = static_cast<volatile unsigned char*>(data);
+    auto* end = begin + bytes;
+
+    // First byte of the region, then the first byte of every later page it covers
+    size_t pages = 0;
+    auto address = reinterpret_cast<uintptr_t>(begin);
+    for (volatile unsigned char* p = begin; p < end;) {
+        *p = *p;
+        ++pages;
+        uintptr_t next_page = (address / page + 1) * page;
+        p += next_page - address;
+        address = next_page;
+    }
+    return pages;
+}
+
+struct WarmupOptions {
+    bool lock_memory = true;  // mlockall(MCL_CURRENT | MCL_FUTURE) before touching anything
+};
+
+struct WarmupReport {
+    struct RegionReport {
+        std::string name;
+        size_t bytes;
+        size_t pages;
+    };
+
+    bool memory_locked = false;
+    int lock_error = 0;  // errno from mlockall, 0 on success
+    std::vector<RegionReport> regions;
+    size_t pages_touched = 0;
+    size_t tasks = 0;
+    FaultCounts faults;  // Taken by the process during the warm-up
+    double seconds = 0.0;
+};
+
+/**
+ * @brief Registry of memory to pre-fault and warm-up work to run at startup
+ *
+ * Registration and run() are meant for the startup thread, before any hot
+ * thread touches the registered objects.
+ */
+class MemoryWarmup {
+public:
+    /**
+     * @brief Registers a raw region (e.g. a pool's slot array or an arena block)
+     */
+    void add_region(std::string name, void* data, size_t bytes) {
+        regions_.push_back({std::move(name), data, bytes});
+    }
+
+    /**
+     * @brief Registers an object whose storage is inline, such as RingBuffer or MPMCQueue
+     */
+    template <typename T>
+    void add_object(std::string name, T& object) {
+        add_region(std::move(name), static_cast<void*>(&object), sizeof(T));
+    }
+
+    /**
+     * @brief Registers a queue's storage and, optionally, dummy messages to pass through it
+     *
+     * The dummy messages are value-initialised T; the queue is left empty.
+     *
+     * @param warm_messages Messages to enqueue and dequeue, in batches of up to the capacity
+     */
+    template <ConcurrentQueue Q>
+    void add_queue(std::string name, Q& queue, size_t warm_messages = 0) {
+        add_object(name, queue);
+        if (warm_messages > 0) {
+            add_task(std::move(name), [&queue, warm_messages]() {
+                using T = typename Q::value_type;
+                T value{};
+                for (size_t sent = 0; sent < warm_messages;) {
+                    while (sent < warm_messages && queue.try_enqueue(T{})) {
+                        ++sent;
+                    }
+                    while (queue.try_dequeue(value)) {
+                    }
+                }
+            });
+        }
+    }
+
+    /**
+     * @brief Registers custom warm-up work, e.g. cycling a pool or reserving an arena
+     */
+    void add_task(std::string name, std::function<void()> task) {
+        tasks_.push_back({std::move(name), std::move(task)});
+    }
+
+    /**
+     * @brief Locks memory, pre-faults every region and runs every task
+     */
+    WarmupReport run(const WarmupOptions& options = {}) {
+        WarmupReport report;
+        auto start_time = std::chrono::steady_clock::now();
+        FaultCounts before = read_fault_counts();
+
+#ifndef _WIN32
+        if (options.lock_memory) {
+            report.memory_locked = ::mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+            report.lock_error = report.memory_locked ? 0 : errno;
+        }
+#else
+        (void)options;
+#endif
+
+        for (const Region& region : regions_) {
+            size_t pages = prefault_region(region.data, region.bytes);
+            report.regions.push_back({region.name, region.bytes, pages});
+            report.pages_touched += pages;
+        }
+        for (const Task& task : tasks_) {
+            task.run();
+        }
+
+        report.tasks = tasks_.size();
+        baseline_ = read_fault_counts();
+        report.faults = baseline_ - before;
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        return report;
+    }
+
+    /**
+     * @brief Faults the process has taken since run() finished; zero means a fault-free steady state
+     */
+    FaultCounts faults_since_warmup() const noexcept {
+        return read_fault_counts() - baseline_;
+    }
+
+    /**
+     * @brief Undoes the mlockall() of run()
+     */
+    static void unlock_memory() noexcept {
+#ifndef _WIN32
+        ::munlockall();
+#endif
+    }
+
+private:
+    struct Region {
+        std::string name;
+        void* data;
+        size_t bytes;
+    };
+
+    struct Task {
+        std::string name;  // For debugging; tasks are not reported individually
+        std::function<void()> run;
+    };
+
+    std::vector<Region> regions_;
+    std::vector<Task> tasks_;
+    FaultCounts baseline_;
+};
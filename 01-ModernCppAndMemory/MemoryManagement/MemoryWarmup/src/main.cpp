@@ -0,0 +1,86 @@
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <cstring>
+#include "../include/memory_warmup.h"
+#include "ring_buffer.h"
+#include "mpmc_queue.h"
+#include "object_pool.h"
+#include "arena.h"
+
+struct Order {
+    uint64_t id = 0;
+    double price = 0.0;
+    int quantity = 0;
+};
+
+int main() {
+    std::cout << "Memory Warm-up Demo\n";
+    std::cout << "-------------------\n";
+    std::cout << "Page size: " << page_size() << " bytes\n\n";
+
+    // The long-lived structures a trading process sets up before its hot threads start
+    auto ring = std::make_unique<RingBuffer<Order, 65536>>();
+    auto mpmc = std::make_unique<MPMCQueue<Order, 65536>>();
+    auto pool = std::make_unique<ObjectPool<Order, 65536>>();
+    Arena arena;
+
+    MemoryWarmup warmup;
+    warmup.add_queue("ring", *ring, 100000);
+    warmup.add_queue("mpmc", *mpmc, 100000);
+    warmup.add_region("pool slots", pool->storage(), pool->storage_bytes());
+    warmup.add_task("arena", [&]() { arena.reserve(4 * 1024 * 1024); });
+
+    WarmupReport report = warmup.run();
+
+    std::cout << "Warm-up took " << report.seconds * 1000.0 << " ms\n";
+    if (report.memory_locked) {
+        std::cout << "mlockall: locked\n";
+    } else {
+        std::cout << "mlockall: failed (" << std::strerror(report.lock_error)
+                  << "); raise RLIMIT_MEMLOCK or grant CAP_IPC_LOCK\n";
+    }
+    for (const auto& region : report.regions) {
+        std::cout << "  " << region.name << ": " << region.bytes / 1024 << " KiB, " << region.pages << " pages\n";
+    }
+    std::cout << "Faults during warm-up: " << report.faults.minor << " minor, " << report.faults.major << " major\n";
+
+    // Steady state: a producer and a consumer pass orders through the warmed ring
+    std::cout << "\nRunning 1000000 orders through the warmed RingBuffer...\n";
+    constexpr uint64_t NUM_ORDERS = 1000000;
+    std::atomic<uint64_t> thread_faults(0);
+
+    std::thread producer([&]() {
+        FaultCounts before = read_fault_counts(FaultScope::Thread);
+        for (uint64_t i = 0; i < NUM_ORDERS; ++i) {
+            while (!ring->try_enqueue(Order{i, 100.0, 1})) {
+                std::this_thread::yield();
+            }
+        }
+        thread_faults += (read_fault_counts(FaultScope::Thread) - before).minor;
+    });
+    std::thread consumer([&]() {
+        FaultCounts before = read_fault_counts(FaultScope::Thread);
+        Order order;
+        for (uint64_t received = 0; received < NUM_ORDERS;) {
+            if (ring->try_dequeue(order)) {
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        thread_faults += (read_fault_counts(FaultScope::Thread) - before).minor;
+    });
+    producer.join();
+    consumer.join();
+
+    std::cout << "Faults in the producer and consumer loops: " << thread_faults.load() << "\n";
+    FaultCounts since = warmup.faults_since_warmup();
+    std::cout << "Faults in the whole process since warm-up: " << since.minor << " minor, " << since.major
+              << " major (includes starting the two threads)\n";
+
+    MemoryWarmup::unlock_memory();
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include "../include/memory_warmup.h"
+#include "ring_buffer.h"
+#include "mpmc_queue.h"
+#include "object_pool.h"
+#include "arena.h"
+#include <gtest/gtest.h>
+#include <cstring>
+#include <memory>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+
+namespace {
+
+// Fresh anonymous pages that nothing has touched yet
+struct FreshPages {
+    size_t bytes;
+    unsigned char* data;
+
+    explicit FreshPages(size_t pages) : bytes(pages * page_size()) {
+        void* memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        data = memory == MAP_FAILED ? nullptr : static_cast<unsigned char*>(memory);
+    }
+    ~FreshPages() {
+        if (data != nullptr) {
+            ::munmap(data, bytes);
+        }
+    }
+};
+
+}  // namespace
+
+// Test that one byte per page is touched and contents are preserved
+TEST(MemoryWarmupTest, PrefaultRegion) {
+    FreshPages region(64);
+    ASSERT_NE(region.data, nullptr);
+    region.data[100] = 42;
+
+    EXPECT_EQ(prefault_region(region.data, region.bytes), 64u);
+    EXPECT_EQ(region.data[100], 42);
+
+    // Partial pages count once each
+    EXPECT_EQ(prefault_region(region.data + 10, 1), 1u);
+    EXPECT_EQ(prefault_region(region.data + page_size() - 1, 2), 2u);
+    EXPECT_EQ(prefault_region(nullptr, 100), 0u);
+}
+
+// Test that a pre-faulted region is then used without any page fault
+TEST(MemoryWarmupTest, PrefaultedRegionDoesNotFault) {
+    FreshPages cold(256);
+    FreshPages warm(256);
+    ASSERT_NE(cold.data, nullptr);
+    ASSERT_NE(warm.data, nullptr);
+    prefault_region(warm.data, warm.bytes);
+
+    FaultCounts before = read_fault_counts(FaultScope::Thread);
+    std::memset(warm.data, 1, warm.bytes);
+    FaultCounts warm_faults = read_fault_counts(FaultScope::Thread) - before;
+
+    before = read_fault_counts(FaultScope::Thread);
+    std::memset(cold.data, 1, cold.bytes);
+    FaultCounts cold_faults = read_fault_counts(FaultScope::Thread) - before;
+
+    EXPECT_EQ(warm_faults.minor, 0u);
+    EXPECT_GT(cold_faults.minor, 0u);  // At least one (transparent huge pages may serve many pages per fault)
+}
+#endif
+
+// Test that queues, pools and arenas register, warm up, and are left ready to use
+TEST(MemoryWarmupTest, RunWarmsEverything) {
+    auto ring = std::make_unique<RingBuffer<int, 1024>>();
+    auto mpmc = std::make_unique<MPMCQueue<int, 1024>>();
+    auto pool = std::make_unique<ObjectPool<std::array<char, 200>, 256>>();
+    Arena arena;
+    int cycled = 0;
+
+    MemoryWarmup warmup;
+    warmup.add_queue("ring", *ring, 5000);
+    warmup.add_queue("mpmc", *mpmc, 5000);
+    warmup.add_queue("idle", *ring);  // Storage only, no dummy messages
+    warmup.add_region("pool", pool->storage(), pool->storage_bytes());
+    warmup.add_task("pool cycle", [&]() {
+        for (int i = 0; i < 100; ++i) {
+            pool->destroy(pool->create());
+            ++cycled;
+        }
+    });
+    warmup.add_task("arena", [&]() { arena.reserve(1 << 20); });
+
+    WarmupReport report = warmup.run(WarmupOptions{false});
+    EXPECT_FALSE(report.memory_locked);
+    ASSERT_EQ(report.regions.size(), 4u);
+    EXPECT_EQ(report.regions[0].name, "ring");
+    EXPECT_EQ(report.regions[0].bytes, sizeof(RingBuffer<int, 1024>));
+    EXPECT_GE(report.regions[3].pages, pool->storage_bytes() / page_size());
+    EXPECT_EQ(report.tasks, 4u);
+    EXPECT_GE(report.seconds, 0.0);
+
+    EXPECT_TRUE(ring->empty());
+    EXPECT_TRUE(mpmc->empty());
+    EXPECT_EQ(cycled, 100);
+    EXPECT_EQ(arena.bytes_used(), 0u);
+    EXPECT_GE(arena.bytes_reserved(), 1u << 20);
+}
+
+// Test the steady state after a locked warm-up: traffic through warmed queues takes no faults
+TEST(MemoryWarmupTest, SteadyStateIsFaultFree) {
+    auto ring = std::make_unique<RingBuffer<uint64_t, 4096>>();
+    auto mpmc = std::make_unique<MPMCQueue<uint64_t, 4096>>();
+
+    MemoryWarmup warmup;
+    warmup.add_queue("ring", *ring, 10000);
+    warmup.add_queue("mpmc", *mpmc, 10000);
+    WarmupReport report = warmup.run();
+    // Locking needs privileges the test machine may not grant; either outcome is reported
+    EXPECT_TRUE(report.memory_locked || report.lock_error != 0);
+
+    FaultCounts before = read_fault_counts(FaultScope::Thread);
+    uint64_t sum = 0;
+    uint64_t value;
+    for (uint64_t round = 0; round < 100; ++round) {
+        for (uint64_t i = 0; i < 4096; ++i) {
+            ring->try_enqueue(i);
+            mpmc->try_enqueue(i);
+        }
+        while (ring->try_dequeue(value)) {
+            sum += value;
+        }
+        while (mpmc->try_dequeue(value)) {
+            sum += value;
+        }
+    }
+    FaultCounts steady = read_fault_counts(FaultScope::Thread) - before;
+
+    EXPECT_EQ(sum, 2 * 100 * (4095u * 4096u / 2));
+    EXPECT_EQ(steady.minor, 0u);
+    EXPECT_EQ(steady.major, 0u);
+
+    MemoryWarmup::unlock_memory();
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
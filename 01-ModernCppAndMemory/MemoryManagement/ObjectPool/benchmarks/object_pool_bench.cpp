@@ -0,0 +1,189 @@
+#include "../include/object_pool.h"
+#include "ring_buffer.h"
+#include "mpmc_queue.h"
+#include "queue_benchmarks.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+using queue_bench::Payload;
+
+// Queue families, so each benchmark can instantiate the queue for values or pointers
+struct RingFamily {
+    template <typename T, size_t Capacity>
+    using queue = RingBuffer<T, Capacity>;
+};
+
+struct MPMCFamily {
+    template <typename T, size_t Capacity>
+    using queue = MPMCQueue<T, Capacity>;
+};
+
+constexpr size_t QUEUE_CAPACITY = 1024;
+constexpr size_t POOL_CAPACITY = 4096;  // Queue capacity plus headroom for the two threads' caches
+
+// Builds a message in place: the producer writes every byte, as it would when filling a real message
+template <size_t Bytes>
+void fill_message(Payload<Bytes>& message, uint64_t seq) {
+    message.seq = seq;
+    std::memset(message.body.data(), static_cast<int>(seq & 0xFF), message.body.size());
+}
+
+// Reads the fields a consumer would typically look at first
+template <size_t Bytes>
+uint64_t read_message(const Payload<Bytes>& message) {
+    return message.seq + static_cast<uint64_t>(message.body.front()) + static_cast<uint64_t>(message.body.back());
+}
+
+/**
+ * @brief Runs one producer and one consumer thread for the sustained duration
+ *
+ * produce(seq) returns false when the queue (or pool) is full; consume()
+ * returns false when there is nothing to read.
+ */
+template <size_t Bytes, typename Produce, typename Consume>
+void run_producer_consumer(benchmark::State& state, Produce produce, Consume consume) {
+    size_t total_consumed = 0;
+
+    for (auto _ : state) {
+        std::atomic<bool> stop(false);
+        std::atomic<bool> producer_done(false);
+        size_t consumed = 0;
+
+        auto start_time = std::chrono::steady_clock::now();
+        std::thread consumer([&]() {
+            queue_bench::pin_current_thread(1);
+            unsigned spins = 0;
+            while (true) {
+                if (consume()) {
+                    consumed++;
+                } else if (producer_done.load(std::memory_order_acquire)) {
+                    while (consume()) {
+                        consumed++;
+                    }
+                    break;
+                } else {
+                    queue_bench::relax(spins);
+                }
+            }
+        });
+        std::thread producer([&]() {
+            queue_bench::pin_current_thread(0);
+            unsigned spins = 0;
+            uint64_t seq = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                if (produce(seq)) {
+                    seq++;
+                } else {
+                    queue_bench::relax(spins);
+                }
+            }
+            producer_done.store(true, std::memory_order_release);
+        });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(queue_bench::g_sustained.duration_ms));
+        stop.store(true, std::memory_order_relaxed);
+        producer.join();
+        consumer.join();
+
+        state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count());
+        total_consumed += consumed;
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(total_consumed));
+    state.SetBytesProcessed(static_cast<int64_t>(total_consumed * Bytes));
+}
+
+// Messages are copied into the queue and copied out again
+template <typename Family, size_t Bytes>
+static void BM_ByValue(benchmark::State& state) {
+    using Message = Payload<Bytes>;
+    auto queue = std::make_unique<typename Family::template queue<Message, QUEUE_CAPACITY>>();
+
+    run_producer_consumer<Bytes>(state,
+        [&](uint64_t seq) {
+            Message message;
+            fill_message(message, seq);
+            return queue->try_enqueue(message);
+        },
+        [&]() {
+            Message message;
+            if (!queue->try_dequeue(message)) {
+                return false;
+            }
+            benchmark::DoNotOptimize(read_message(message));
+            return true;
+        });
+}
+
+// Messages are built in pool slots and only their pointers go through the queue
+template <typename Family, size_t Bytes>
+static void BM_ByPointer(benchmark::State& state) {
+    using Message = Payload<Bytes>;
+    auto pool = std::make_unique<ObjectPool<Message, POOL_CAPACITY>>();
+    auto queue = std::make_unique<typename Family::template queue<Message*, QUEUE_CAPACITY>>();
+
+    run_producer_consumer<Bytes>(state,
+        [&](uint64_t seq) {
+            Message* message = pool->create();
+            if (message == nullptr) {
+                return false;
+            }
+            fill_message(*message, seq);
+            if (!queue->try_enqueue(message)) {
+                pool->destroy(message);
+                return false;
+            }
+            return true;
+        },
+        [&]() {
+            Message* message;
+            if (!queue->try_dequeue(message)) {
+                return false;
+            }
+            benchmark::DoNotOptimize(read_message(*message));
+            pool->destroy(message);
+            return true;
+        });
+}
+
+#define REGISTER_TRANSFER(Family, Bytes)                                                                       \
+    BENCHMARK_TEMPLATE(BM_ByValue, Family, Bytes)->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond); \
+    BENCHMARK_TEMPLATE(BM_ByPointer, Family, Bytes)->UseManualTime()->Iterations(1)->Unit(benchmark::kMillisecond)
+
+REGISTER_TRANSFER(RingFamily, 256);
+REGISTER_TRANSFER(RingFamily, 1024);
+REGISTER_TRANSFER(MPMCFamily, 256);
+REGISTER_TRANSFER(MPMCFamily, 1024);
+
+// Allocation cost alone: pool slot versus the general-purpose heap
+template <size_t Bytes>
+static void BM_PoolCreateDestroy(benchmark::State& state) {
+    auto pool = std::make_unique<ObjectPool<Payload<Bytes>, POOL_CAPACITY>>();
+    for (auto _ : state) {
+        Payload<Bytes>* message = pool->create();
+        benchmark::DoNotOptimize(message);
+        pool->destroy(message);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <size_t Bytes>
+static void BM_NewDelete(benchmark::State& state) {
+    for (auto _ : state) {
+        auto* message = new Payload<Bytes>();
+        benchmark::DoNotOptimize(message);
+        delete message;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_PoolCreateDestroy, 256);
+BENCHMARK_TEMPLATE(BM_NewDelete, 256);
+BENCHMARK_TEMPLATE(BM_PoolCreateDestroy, 1024);
+BENCHMARK_TEMPLATE(BM_NewDelete, 1024);
+
+int main(int argc, char** argv) {
+    return queue_bench::run_benchmarks(argc, argv);
+}
@@ -0,0 +1,323 @@
+/**
+ * @file object_pool.h
+ * @brief Preallocated, cache-aligned, lock-free object pool
+ *
+ * Every object lives in its own cache-line-aligned slot of one preallocated
+ * array, so hot-path code can create a message, pass its pointer (or 32-bit
+ * index) through a RingBuffer or MPMCQueue, and destroy it on the consumer
+ * side without touching the heap or copying the message.
+ *
+ * Free slots are kept in two tiers:
+ *  - a per-thread cache of slot indices, touched only by its owning thread
+ *  - a global lock-free free list (a Treiber stack of slot indices), whose
+ *    head carries a 32-bit tag bumped on every change so a stale CAS cannot
+ *    succeed after the head was popped and pushed back (ABA)
+ * Caches refill from and spill to the global list in batches, so the shared
+ * head is touched once every few operations rather than on every one.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "concurrency_primitives.h"
+#include "numa.h"
+#include "thread_slot.h"
+
+/**
+ * @brief Lock-free pool of up to Capacity objects of type T
+ *
+ * create() and destroy() may be called from any thread, and an object may be
+ * destroyed on a different thread from the one that created it. Each thread
+ * keeps up to CacheSize free slots for itself, so while other threads hold
+ * cached slots create() can return nullptr before Capacity objects are live;
+ * size the pool with that headroom. All objects must be destroyed before the
+ * pool is.
+ *
+ * @tparam T The pooled type
+ * @tparam Capacity Number of slots (fewer than 2^32 - 1)
+ * @tparam CacheSize Free slots each thread keeps locally (0 disables the caches)
+ * @tparam MaxThreads Threads that get a cache in this pool; others use the global list directly
+ */
+template <typename T, size_t Capacity, size_t CacheSize = 32, size_t MaxThreads = 64>
+class ObjectPool {
+    static_assert(Capacity > 0, "Capacity must be greater than 0");
+    static_assert(Capacity < UINT32_MAX, "Slot indices must fit in 32 bits");
+    static_assert(MaxThreads <= MAX_THREAD_SLOTS,
+                  "MaxThreads cannot exceed the process-wide thread slot table");
+
+public:
+    using value_type = T;
+    using Index = uint32_t;
+
+    static constexpr Index NULL_INDEX = UINT32_MAX;
+    static constexpr size_t SLOT_ALIGNMENT = std::max(alignof(T), CACHE_LINE_SIZE);
+
+    /**
+     * @brief Deleter for std::unique_ptr that returns the object to its pool
+     */
+    struct Deleter {
+        ObjectPool* pool = nullptr;
+        void operator()(T* object) const noexcept { pool->destroy(object); }
+    };
+    using UniquePtr = std::unique_ptr<T, Deleter>;
+
+    /**
+     * @brief Allocates and pre-faults all slots and links them into the free list
+     *
+     * @param node NUMA node for the slots; NUMA_NO_NODE leaves them on the
+     *             constructing thread's node (see also bind_to_node())
+     */
+    explicit ObjectPool(int node = NUMA_NO_NODE)
+        : slots_(new Slot[Capacity]),
+          next_(new std::atomic<Index>[Capacity]) {
+        // Set the policy before the first touch below, so the pages are placed there directly
+        if (node != NUMA_NO_NODE) {
+            bind_to_node(node);
+        }
+        // Touch every slot now so the first use of each does not page-fault on the hot path
+        for (size_t i = 0; i < Capacity; ++i) {
+            std::fill(std::begin(slots_[i].storage), std::end(slots_[i].storage), std::byte{0});
+            next_[i].store(i + 1 < Capacity ? static_cast<Index>(i + 1) : NULL_INDEX, std::memory_order_relaxed);
+        }
+        head_.data.store(pack(0, 0), std::memory_order_release);
+    }
+
+    ~ObjectPool() = default;
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    /**
+     * @brief Constructs a T in a free slot
+     *
+     * @return Pointer to the new object, or nullptr if no slot is free
+     */
+    template <typename... Args>
+    T* create(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        Index index = allocate_index();
+        if (index == NULL_INDEX) {
+            return nullptr;
+        }
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+            return ::new (static_cast<void*>(slots_[index].storage)) T(std::forward<Args>(args)...);
+        } else {
+            try {
+                return ::new (static_cast<void*>(slots_[index].storage)) T(std::forward<Args>(args)...);
+            } catch (...) {
+                release_index(index);
+                throw;
+            }
+        }
+    }
+
+    /**
+     * @brief Same as create(), but owned by a unique_ptr that destroys it back into the pool
+     */
+    template <typename... Args>
+    UniquePtr make_unique(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>) {
+        return UniquePtr(create(std::forward<Args>(args)...), Deleter{this});
+    }
+
+    /**
+     * @brief Destroys an object returned by create() and frees its slot
+     *
+     * @param object Must belong to this pool; nullptr is ignored
+     */
+    void destroy(T* object) noexcept {
+        if (object == nullptr) {
+            return;
+        }
+        assert(owns(object) && "Object does not belong to this pool");
+        object->~T();
+        release_index(index_of(object));
+    }
+
+    /**
+     * @brief The 32-bit handle of an object, e.g. to pass a smaller item through a queue
+     */
+    Index index_of(const T* object) const noexcept {
+        auto* slot = reinterpret_cast<const Slot*>(object);
+        return static_cast<Index>(slot - slots_.get());
+    }
+
+    /**
+     * @brief The object behind a handle returned by index_of()
+     */
+    T* at(Index index) noexcept {
+        return std::launder(reinterpret_cast<T*>(slots_[index].storage));
+    }
+
+    /**
+     * @brief Whether a pointer points at a slot of this pool
+     */
+    bool owns(const T* object) const noexcept {
+        auto address = reinterpret_cast<uintptr_t>(object);
+        auto begin = reinterpret_cast<uintptr_t>(slots_.get());
+        return address >= begin && address < begin + Capacity * sizeof(Slot) &&
+               (address - begin) % sizeof(Slot) == 0;
+    }
+
+    constexpr size_t capacity() const noexcept {
+        return Capacity;
+    }
+
+    /**
+     * @brief The slot array, e.g. to register with MemoryWarmup for pre-faulting
+     */
+    void* storage() noexcept {
+        return slots_.get();
+    }
+
+    static constexpr size_t storage_bytes() noexcept {
+        return Capacity * sizeof(Slot);
+    }
+
+    /**
+     * @brief Moves the slots, free-list links and caches to a NUMA node
+     *
+     * The default is the calling thread's node, so the thread that uses the
+     * objects most (usually the consumer) can call it once at startup.
+     *
+     * @return false if the node cannot be used (memory stays where it is)
+     */
+    bool bind_to_node(int node = numa_current_node()) noexcept {
+        if (!numa_bind(slots_.get(), storage_bytes(), node)) {
+            return false;
+        }
+        numa_bind(next_.get(), Capacity * sizeof(std::atomic<Index>), node);
+        numa_bind(this, sizeof(*this), node);
+        return true;
+    }
+
+    /**
+     * @brief Number of slots on the global free list (excludes per-thread caches)
+     *
+     * Walks the list, so it is meant for tests and diagnostics on an idle pool.
+     */
+    size_t global_free_count() const noexcept {
+        size_t count = 0;
+        for (Index index = index_of_head(head_.data.load(std::memory_order_acquire)); index != NULL_INDEX;
+             index = next_[index].load(std::memory_order_relaxed)) {
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    struct alignas(SLOT_ALIGNMENT) Slot {
+        std::byte storage[sizeof(T)];
+    };
+
+    // Free slots owned by one thread; only that thread reads or writes it
+    struct alignas(CACHE_LINE_SIZE) ThreadCache {
+        size_t count = 0;
+        std::array<Index, CacheSize == 0 ? 1 : CacheSize> indices{};
+    };
+
+    // The head packs a 32-bit tag above the 32-bit index of the first free slot
+    static constexpr uint64_t pack(Index index, uint32_t tag) noexcept {
+        return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+    static constexpr Index index_of_head(uint64_t head) noexcept {
+        return static_cast<Index>(head & 0xFFFFFFFFu);
+    }
+    static constexpr uint32_t tag_of(uint64_t head) noexcept {
+        return static_cast<uint32_t>(head >> 32);
+    }
+
+    ThreadCache* local_cache() noexcept {
+        if constexpr (CacheSize == 0) {
+            return nullptr;
+        } else {
+            size_t slot = this_thread_slot();
+            return slot < MaxThreads ? &caches_[slot] : nullptr;
+        }
+    }
+
+    Index allocate_index() noexcept {
+        ThreadCache* cache = local_cache();
+        if (cache == nullptr) {
+            return pop_global();
+        }
+        if (cache->count == 0) {
+            // Refill half the cache so the next few creates stay local
+            while (cache->count < (CacheSize + 1) / 2) {
+                Index index = pop_global();
+                if (index == NULL_INDEX) {
+                    break;
+                }
+                cache->indices[cache->count++] = index;
+            }
+            if (cache->count == 0) {
+                return NULL_INDEX;
+            }
+        }
+        return cache->indices[--cache->count];
+    }
+
+    void release_index(Index index) noexcept {
+        ThreadCache* cache = local_cache();
+        if (cache == nullptr) {
+            push_global(index, index);
+            return;
+        }
+        if (cache->count == CacheSize) {
+            // Spill the older half to the global list as one chain, with a single CAS
+            const size_t spill = CacheSize / 2 > 0 ? CacheSize / 2 : 1;
+            for (size_t i = 0; i + 1 < spill; ++i) {
+                next_[cache->indices[i]].store(cache->indices[i + 1], std::memory_order_relaxed);
+            }
+            push_global(cache->indices[0], cache->indices[spill - 1]);
+            std::move(cache->indices.begin() + spill, cache->indices.begin() + cache->count, cache->indices.begin());
+            cache->count -= spill;
+        }
+        cache->indices[cache->count++] = index;
+    }
+
+    Index pop_global() noexcept {
+        uint64_t head = head_.data.load(std::memory_order_acquire);
+        while (true) {
+            Index index = index_of_head(head);
+            if (index == NULL_INDEX) {
+                return NULL_INDEX;
+            }
+            // May read a stale link if another thread pops this slot first; the tag makes that CAS fail
+            Index next = next_[index].load(std::memory_order_relaxed);
+            if (head_.data.compare_exchange_weak(head, pack(next, tag_of(head) + 1),
+                                                 std::memory_order_acquire, std::memory_order_acquire)) {
+                return index;
+            }
+        }
+    }
+
+    // Pushes the chain first -> ... -> last (already linked through next_)
+    void push_global(Index first, Index last) noexcept {
+        uint64_t head = head_.data.load(std::memory_order_relaxed);
+        do {
+            next_[last].store(index_of_head(head), std::memory_order_relaxed);
+        } while (!head_.data.compare_exchange_weak(head, pack(first, tag_of(head) + 1),
+                                                   std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Object storage, one aligned slot per object
+    std::unique_ptr<Slot[]> slots_;
+
+    // Free-list links, kept apart from the objects so linking never touches an object's line
+    std::unique_ptr<std::atomic<Index>[]> next_;
+
+    // Global free-list head, on its own cache line
+    CacheLineAligned<std::atomic<uint64_t>> head_;
+
+    // Per-thread caches, indexed by the process-wide thread slot (see thread_slot.h)
+    std::array<ThreadCache, CacheSize == 0 ? 1 : MaxThreads> caches_{};
+};
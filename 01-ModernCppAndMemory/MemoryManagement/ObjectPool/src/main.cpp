@@ -0,0 +1,98 @@
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include "../include/object_pool.h"
+#include "ring_buffer.h"
+
+// A message too large to copy through a queue cheaply
+struct MarketUpdate {
+    uint64_t sequence = 0;
+    uint32_t instrument_id = 0;
+    double bid_prices[10] = {};
+    double ask_prices[10] = {};
+    uint32_t bid_sizes[10] = {};
+    uint32_t ask_sizes[10] = {};
+
+    MarketUpdate() = default;
+    MarketUpdate(uint64_t seq, uint32_t instrument) : sequence(seq), instrument_id(instrument) {
+        for (int level = 0; level < 10; ++level) {
+            bid_prices[level] = 100.0 - 0.01 * level;
+            ask_prices[level] = 100.01 + 0.01 * level;
+            bid_sizes[level] = ask_sizes[level] = 100 * (level + 1);
+        }
+    }
+};
+
+int main() {
+    std::cout << "Object Pool Demo\n";
+    std::cout << "----------------\n";
+    std::cout << "sizeof(MarketUpdate): " << sizeof(MarketUpdate) << " bytes\n\n";
+
+    ObjectPool<MarketUpdate, 4096> pool;
+
+    // Basic operations demo
+    std::cout << "Basic operations:\n";
+    MarketUpdate* update = pool.create(1, 42);
+    std::cout << "Created update " << update->sequence << " for instrument " << update->instrument_id
+              << " at slot " << pool.index_of(update) << "\n";
+    pool.destroy(update);
+    std::cout << "Destroyed it again\n";
+
+    {
+        auto owned = pool.make_unique(2, 43);
+        std::cout << "unique_ptr-owned update " << owned->sequence << " returns to the pool at end of scope\n";
+    }
+
+    // Pipeline demo: the producer builds updates in pool slots and passes pointers;
+    // the consumer reads them in place and hands the slots back
+    std::cout << "\nPassing pointers through a RingBuffer<MarketUpdate*, 1024>...\n";
+    constexpr uint64_t NUM_UPDATES = 1000000;
+    RingBuffer<MarketUpdate*, 1024> ring;
+    std::atomic<uint64_t> checksum(0);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    std::thread producer([&]() {
+        for (uint64_t seq = 0; seq < NUM_UPDATES; ++seq) {
+            MarketUpdate* message;
+            while ((message = pool.create(seq, static_cast<uint32_t>(seq % 64))) == nullptr) {
+                std::this_thread::yield();
+            }
+            while (!ring.try_enqueue(message)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::thread consumer([&]() {
+        uint64_t sum = 0;
+        MarketUpdate* message;
+        for (uint64_t received = 0; received < NUM_UPDATES;) {
+            if (ring.try_dequeue(message)) {
+                sum += message->sequence + message->bid_sizes[0];
+                pool.destroy(message);
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        checksum.store(sum);
+    });
+
+    producer.join();
+    consumer.join();
+
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
+
+    std::cout << "Transferred " << NUM_UPDATES << " updates in " << duration << " ms";
+    if (duration > 0) {
+        std::cout << " (" << (NUM_UPDATES * 1000 / duration) << " updates/sec)";
+    }
+    std::cout << "\nChecksum: " << checksum.load() << "\n";
+    std::cout << "Slots back on the global free list: " << pool.global_free_count() << " of " << pool.capacity()
+              << " (the rest sit in per-thread caches)\n";
+
+    return 0;
+}
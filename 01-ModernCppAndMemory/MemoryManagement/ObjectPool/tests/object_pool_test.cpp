@@ -0,0 +1,251 @@
+#include "../include/object_pool.h"
+#include "ring_buffer.h"
+#include "mpmc_queue.h"
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+
+namespace {
+
+struct Order {
+    uint64_t id = 0;
+    double price = 0.0;
+    int quantity = 0;
+
+    Order() = default;
+    Order(uint64_t i, double p, int q) : id(i), price(p), quantity(q) {}
+};
+
+// Counts live instances to check that destroy() runs destructors
+struct Tracked {
+    static inline std::atomic<int> live{0};
+    Tracked() { live.fetch_add(1); }
+    ~Tracked() { live.fetch_sub(1); }
+};
+
+struct ThrowsOnConstruction {
+    explicit ThrowsOnConstruction(bool should_throw) {
+        if (should_throw) {
+            throw std::runtime_error("construction failed");
+        }
+    }
+};
+
+}  // namespace
+
+// Basic functionality tests
+TEST(ObjectPoolTest, CreateAndDestroy) {
+    ObjectPool<Order, 16> pool;
+
+    Order* order = pool.create(42u, 101.25, 7);
+    ASSERT_NE(order, nullptr);
+    EXPECT_EQ(order->id, 42u);
+    EXPECT_EQ(order->price, 101.25);
+    EXPECT_EQ(order->quantity, 7);
+
+    // Every object starts on its own cache line
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(order) % CACHE_LINE_SIZE, 0u);
+    EXPECT_TRUE(pool.owns(order));
+
+    // Handles round-trip
+    auto index = pool.index_of(order);
+    EXPECT_LT(index, pool.capacity());
+    EXPECT_EQ(pool.at(index), order);
+
+    Order outside;
+    EXPECT_FALSE(pool.owns(&outside));
+
+    pool.destroy(order);
+    pool.destroy(nullptr);  // Ignored
+}
+
+// Test that a pool without caches hands out exactly Capacity objects
+TEST(ObjectPoolTest, ExhaustionWithoutCache) {
+    ObjectPool<int, 8, 0> pool;
+    std::vector<int*> objects;
+
+    for (int i = 0; i < 8; ++i) {
+        int* object = pool.create(i);
+        ASSERT_NE(object, nullptr);
+        objects.push_back(object);
+    }
+    EXPECT_EQ(pool.create(99), nullptr);
+    EXPECT_EQ(pool.global_free_count(), 0u);
+
+    pool.destroy(objects.back());
+    objects.pop_back();
+    EXPECT_EQ(pool.global_free_count(), 1u);
+    EXPECT_NE(pool.create(100), nullptr);
+}
+
+// Test that one thread can use the whole pool through its cache
+TEST(ObjectPoolTest, ExhaustionWithCache) {
+    ObjectPool<int, 64, 8> pool;
+    std::vector<int*> objects;
+
+    for (int i = 0; i < 64; ++i) {
+        int* object = pool.create(i);
+        ASSERT_NE(object, nullptr) << "Failed at object " << i;
+        objects.push_back(object);
+    }
+    EXPECT_EQ(pool.create(0), nullptr);
+
+    // Releasing everything spills the overflow from the cache back to the global list
+    for (int* object : objects) {
+        pool.destroy(object);
+    }
+    EXPECT_GE(pool.global_free_count(), 64u - 8u);
+}
+
+// Test that destroy() runs the destructor and create() the constructor
+TEST(ObjectPoolTest, RunsConstructorsAndDestructors) {
+    ObjectPool<Tracked, 8> pool;
+    Tracked* a = pool.create();
+    Tracked* b = pool.create();
+    EXPECT_EQ(Tracked::live.load(), 2);
+
+    pool.destroy(a);
+    EXPECT_EQ(Tracked::live.load(), 1);
+
+    {
+        auto owned = pool.make_unique();
+        EXPECT_EQ(Tracked::live.load(), 2);
+    }
+    EXPECT_EQ(Tracked::live.load(), 1);
+
+    pool.destroy(b);
+    EXPECT_EQ(Tracked::live.load(), 0);
+}
+
+// Test that a throwing constructor gives its slot back
+TEST(ObjectPoolTest, ThrowingConstructorReleasesSlot) {
+    ObjectPool<ThrowsOnConstruction, 1, 0> pool;
+
+    EXPECT_THROW(pool.create(true), std::runtime_error);
+    ThrowsOnConstruction* object = pool.create(false);
+    EXPECT_NE(object, nullptr);
+    pool.destroy(object);
+}
+
+// Test passing pooled objects by pointer through a RingBuffer, destroyed on the consumer thread
+TEST(ObjectPoolTest, PointersThroughRingBuffer) {
+    constexpr size_t NUM_ITEMS = 20000;
+    constexpr size_t POOL_SIZE = 256;
+    ObjectPool<Order, POOL_SIZE, 16> pool;
+    RingBuffer<Order*, 64> ring;
+    std::atomic<bool> order_error(false);
+
+    std::thread producer([&]() {
+        for (size_t i = 0; i < NUM_ITEMS; ++i) {
+            Order* order;
+            while ((order = pool.create(i, 1.5 * i, static_cast<int>(i % 100))) == nullptr) {
+                std::this_thread::yield();
+            }
+            while (!ring.try_enqueue(order)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    std::thread consumer([&]() {
+        Order* order;
+        for (size_t expected = 0; expected < NUM_ITEMS;) {
+            if (ring.try_dequeue(order)) {
+                if (order->id != expected || order->quantity != static_cast<int>(expected % 100)) {
+                    order_error.store(true);
+                }
+                pool.destroy(order);
+                ++expected;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    producer.join();
+    consumer.join();
+
+    EXPECT_FALSE(order_error.load());
+    EXPECT_TRUE(ring.empty());
+
+    // Everything came back: at most the two exited threads' caches are not on the global list
+    EXPECT_GE(pool.global_free_count(), POOL_SIZE - 2 * 16);
+}
+
+// Test that no slot is ever handed out twice under concurrent create/destroy
+TEST(ObjectPoolTest, ConcurrentNoDoubleAllocation) {
+    constexpr size_t NUM_PRODUCERS = 2;
+    constexpr size_t NUM_CONSUMERS = 2;
+    constexpr size_t NUM_ITEMS_PER_PRODUCER = 20000;
+    constexpr size_t POOL_SIZE = 128;
+    ObjectPool<Order, POOL_SIZE, 8> pool;
+    MPMCQueue<ObjectPool<Order, POOL_SIZE, 8>::Index, 64> queue;  // Pass 32-bit handles
+    std::vector<std::atomic<int>> live(POOL_SIZE);
+    std::atomic<bool> double_allocation(false);
+    std::atomic<size_t> consumed(0);
+
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < NUM_PRODUCERS; ++p) {
+        threads.emplace_back([&, p]() {
+            for (size_t i = 0; i < NUM_ITEMS_PER_PRODUCER; ++i) {
+                Order* order;
+                while ((order = pool.create(p * NUM_ITEMS_PER_PRODUCER + i, 0.0, 1)) == nullptr) {
+                    std::this_thread::yield();
+                }
+                auto index = pool.index_of(order);
+                if (live[index].fetch_add(1) != 0) {
+                    double_allocation.store(true);
+                }
+                while (!queue.try_enqueue(index)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (size_t c = 0; c < NUM_CONSUMERS; ++c) {
+        threads.emplace_back([&]() {
+            ObjectPool<Order, POOL_SIZE, 8>::Index index;
+            while (consumed.load(std::memory_order_relaxed) < NUM_PRODUCERS * NUM_ITEMS_PER_PRODUCER) {
+                if (queue.try_dequeue(index)) {
+                    if (live[index].fetch_sub(1) != 1) {
+                        double_allocation.store(true);
+                    }
+                    pool.destroy(pool.at(index));
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_FALSE(double_allocation.load());
+    EXPECT_EQ(consumed.load(), NUM_PRODUCERS * NUM_ITEMS_PER_PRODUCER);
+}
+
+// Test constructing on a NUMA node, and falling back for a node that does not exist
+TEST(ObjectPoolTest, NumaPlacement) {
+    auto pool = std::make_unique<ObjectPool<Order, 1024>>(numa_current_node());
+    const int resident = numa_node_of(pool->storage());
+    if (resident != NUMA_NO_NODE) {
+        EXPECT_EQ(resident, numa_current_node());
+        EXPECT_TRUE(pool->bind_to_node());
+    }
+
+    auto fallback = std::make_unique<ObjectPool<Order, 1024>>(numa_node_count());
+    EXPECT_FALSE(fallback->bind_to_node(numa_node_count()));
+    Order* order = fallback->create(1, 100.5, 10);
+    ASSERT_NE(order, nullptr);
+    EXPECT_EQ(order->quantity, 10);
+    fallback->destroy(order);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}